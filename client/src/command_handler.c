@@ -294,7 +294,7 @@ STATIC void cmd_disconnect(EventManager *eventManager, WindowManager *windowMana
         char notice[MAX_CHARS + CRLF_LEN + 1] = {'\0'};
 
         concat_tokens(notice, MAX_CHARS, get_command_arguments(cmdTokens), get_command_argument_count(cmdTokens), " ");
-        create_irc_message(message, MAX_CHARS, &(IRCMessage){{"QUIT"}, {notice}, 1, NULL, NULL});
+        create_irc_message(message, MAX_CHARS, &(IRCMessage){{"QUIT"}, {notice}, 1, NULL});
 
         enqueue_to_client_queue(tcpClient, message);
     }
@@ -336,7 +336,7 @@ STATIC void set_nickname(WindowManager *windowManager, TCPClient *tcpClient, Com
         // NICK <nickname>
         char message[MAX_CHARS + CRLF_LEN + 1] = {'\0'};
 
-        create_irc_message(message, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens)}, {get_command_argument(cmdTokens, 0)}, 0, NULL, NULL});
+        create_irc_message(message, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens)}, {get_command_argument(cmdTokens, 0)}, 0, NULL});
         enqueue_to_client_queue(tcpClient, message);
 
         if (is_allowed_state_transition(get_client_session_states(), get_client_state_type(tcpClient), START_REGISTRATION)) {
@@ -410,7 +410,7 @@ STATIC void set_user_data(WindowManager *windowManager, TCPClient *tcpClient, Co
         char ipv4Address[INET_ADDRSTRLEN] = {'\0'};
         get_local_address(ipv4Address, sizeof(ipv4Address), NULL, get_client_fd(tcpClient));
 
-        create_irc_message(message, MAX_CHARS, &(IRCMessage){{"USER", get_char_option_value(OT_USERNAME), ipv4Address, "*"}, {get_char_option_value(OT_REALNAME)}, 1, NULL, NULL});
+        create_irc_message(message, MAX_CHARS, &(IRCMessage){{"USER", get_char_option_value(OT_USERNAME), ipv4Address, "*"}, {get_char_option_value(OT_REALNAME)}, 1, NULL});
         enqueue_to_client_queue(tcpClient, message);
 
         if (is_allowed_state_transition(get_client_session_states(), get_client_state_type(tcpClient), REGISTERED)) {
@@ -440,7 +440,7 @@ STATIC void cmd_join(EventManager *eventManager, WindowManager *windowManager, T
         // JOIN <channel>
         char message[MAX_CHARS + CRLF_LEN + 1] = {'\0'};
 
-        create_irc_message(message, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens)}, {get_command_argument(cmdTokens, 0)}, 0, NULL, NULL});
+        create_irc_message(message, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens)}, {get_command_argument(cmdTokens, 0)}, 0, NULL});
         enqueue_to_client_queue(tcpClient, message);
 
         if (is_allowed_state_transition(sessionStates, get_client_state_type(tcpClient), IN_CHANNEL)) {
@@ -470,7 +470,7 @@ STATIC void cmd_part(EventManager *eventManager, WindowManager *windowManager, T
 
         if (get_command_argument_count(cmdTokens) == 1) {
 
-            create_irc_message(message, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens), get_command_argument(cmdTokens, 0)}, {NULL}, 0, NULL, NULL});
+            create_irc_message(message, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens), get_command_argument(cmdTokens, 0)}, {NULL}, 0, NULL});
         }
         else {
 
@@ -478,7 +478,7 @@ STATIC void cmd_part(EventManager *eventManager, WindowManager *windowManager, T
             const char *tokens[] = {get_command_argument(cmdTokens, 1), get_command_argument(cmdTokens, 2), get_command_argument(cmdTokens, 3), get_command_argument(cmdTokens, 4)}; 
 
             concat_tokens(notice, MAX_CHARS, tokens, get_command_argument_count(cmdTokens) - 1, " ");
-            create_irc_message(message, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens), get_command_argument(cmdTokens, 0)}, {notice}, 1, NULL, NULL});
+            create_irc_message(message, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens), get_command_argument(cmdTokens, 0)}, {notice}, 1, NULL});
 
         }
         enqueue_to_client_queue(tcpClient, message);
@@ -511,7 +511,7 @@ STATIC void cmd_privmsg(EventManager *eventManager, WindowManager *windowManager
 
         concat_tokens(notice, MAX_CHARS, tokens, get_command_argument_count(cmdTokens) - 1, " ");
 
-        create_irc_message(message, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens), get_command_argument(cmdTokens, 0)}, {notice}, 1, NULL, NULL});
+        create_irc_message(message, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens), get_command_argument(cmdTokens, 0)}, {notice}, 1, NULL});
         enqueue_to_client_queue(tcpClient, message);
     }
 }
@@ -569,7 +569,7 @@ STATIC void cmd_whois(EventManager *eventManager, WindowManager *windowManager,
 
         char message[MAX_CHARS + CRLF_LEN + 1] = {'\0'};
 
-        create_irc_message(message, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens), get_command_argument(cmdTokens, 0)}, {NULL}, 0, NULL, NULL});
+        create_irc_message(message, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens), get_command_argument(cmdTokens, 0)}, {NULL}, 0, NULL});
         enqueue_to_client_queue(tcpClient, message);
     }
 }
@@ -586,8 +586,8 @@ STATIC void cmd_quit(EventManager *eventManager, WindowManager *windowManager, T
 
     if (eventManager != NULL) {
 
-        push_event_to_queue(eventManager, &(Event){.eventType = NETWORK_EVENT, .subEventType = NE_CLIENT_DISCONNECT, .dataItem = (DataItem) {0}, .dataType = UNKNOWN_DATA_TYPE});
-        push_event_to_queue(eventManager, &(Event){.eventType = SYSTEM_EVENT, .subEventType = SE_EXIT, .dataItem = (DataItem) {0}, .dataType = UNKNOWN_DATA_TYPE});
+        push_event_to_queue(eventManager, &(Event){.eventType = NETWORK_EVENT, .subEventType = NE_CLIENT_DISCONNECT});
+        push_event_to_queue(eventManager, &(Event){.eventType = SYSTEM_EVENT, .subEventType = SE_EXIT});
     }
     
 }
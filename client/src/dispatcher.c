@@ -50,7 +50,7 @@ void process_stdin_data(EventManager *eventManager, WindowManager *windowManager
     int ch = get_char(inputBaseWindow);
     ch = remap_ctrl_key(ch);
 
-    Event event = {.eventType = UI_EVENT, .subEventType = UI_KEY, .dataItem = (DataItem) {.itemInt = ch}, .dataType = INT_TYPE};
+    Event event = {.eventType = UI_EVENT, .subEventType = UI_KEY, .key = ch};
 
     push_event_to_queue(eventManager, &event);
 }
@@ -68,7 +68,7 @@ void process_pipe_data(EventManager *eventManager, StreamPipe *streamPipe) {
 
     while (extract_message(message, ARRAY_SIZE(message), pipeBuffer, CRLF)) {
 
-        Event event = {.eventType = UNKNOWN_EVENT_TYPE, .subEventType = -1, .dataItem = (DataItem) {0}, .dataType = UNKNOWN_DATA_TYPE};
+        Event event = {.eventType = UNKNOWN_EVENT_TYPE, .subEventType = -1};
 
         detect_pipe_event_type(message, &event);
 
@@ -92,7 +92,7 @@ void process_socket_data(EventManager *eventManager, WindowManager *windowManage
 
     if (readStatus == -1) {
 
-        push_event_to_queue(eventManager, &(Event){.eventType = NETWORK_EVENT, .subEventType = NE_PEER_CLOSE, .dataItem = (DataItem) {0}, .dataType = UNKNOWN_DATA_TYPE});
+        push_event_to_queue(eventManager, &(Event){.eventType = NETWORK_EVENT, .subEventType = NE_PEER_CLOSE});
 
     }
     else if (readStatus == 1) {
@@ -101,10 +101,9 @@ void process_socket_data(EventManager *eventManager, WindowManager *windowManage
 
         while (extract_message(message, ARRAY_SIZE(message), get_client_inbuffer(tcpClient), CRLF)) {
 
-            Event event = {.eventType = NETWORK_EVENT, .subEventType = NE_SERVER_MSG, .dataItem = (DataItem) {.itemChar = ""}, .dataType = CHAR_TYPE};
-            safe_copy(event.dataItem.itemChar, ARRAY_SIZE(event.dataItem.itemChar), message);
-  
-            push_event_to_queue(eventManager, &event);
+            Event event = {.eventType = NETWORK_EVENT, .subEventType = NE_SERVER_MSG};
+
+            push_message_event_to_queue(eventManager, &event, message, strlen(message));
         }
     }
 }
@@ -137,14 +136,14 @@ void handle_ui_key_event(Event *event) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    KeyboardCmdFunc keyCmdFunc = get_keyboard_cmd_function(event->dataItem.itemInt);
+    KeyboardCmdFunc keyCmdFunc = get_keyboard_cmd_function(event->key);
 
     BaseWindow *mainBaseWindow = get_active_window(get_main_windows(eventContext.windowManager));
     BaseWindow *inputBaseWindow = get_le_base_window(get_input_window(eventContext.windowManager));
 
     if (keyCmdFunc != NULL) {
 
-        WindowType windowType = code_to_window_type(event->dataItem.itemInt);
+        WindowType windowType = code_to_window_type(event->key);
 
         if (windowType == SCROLLBACK_WINDOW) {
             keyCmdFunc(mainBaseWindow);
@@ -153,10 +152,10 @@ void handle_ui_key_event(Event *event) {
             keyCmdFunc(inputBaseWindow);
         }
     } 
-    else if (isprint(event->dataItem.itemInt)) {
-        add_char(inputBaseWindow, event->dataItem.itemInt);
+    else if (isprint(event->key)) {
+        add_char(inputBaseWindow, event->key);
     }
-    else if (event->dataItem.itemInt == KEY_NEWLINE) {
+    else if (event->key == KEY_NEWLINE) {
         parse_cli_input(get_input_window(eventContext.windowManager), eventContext.cmdTokens);
         execute_command(eventContext.eventManager, eventContext.windowManager, eventContext.tcpClient, eventContext.cmdTokens);
     } 
@@ -178,7 +177,7 @@ void handle_ne_server_msg_event(Event *event) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    display_server_message(event->dataItem.itemChar, eventContext.windowManager);
+    display_server_message(event->message, eventContext.windowManager);
 }
 
 void handle_ne_add_poll_fd_event(Event *event) {
@@ -187,7 +186,7 @@ void handle_ne_add_poll_fd_event(Event *event) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    set_poll_fd(eventContext.pollManager, event->dataItem.itemInt);
+    set_poll_fd(eventContext.pollManager, event->fd);
 }
 
 void handle_ne_remove_poll_fd_event(Event *event) {
@@ -196,8 +195,8 @@ void handle_ne_remove_poll_fd_event(Event *event) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    unset_poll_fd(eventContext.pollManager, event->dataItem.itemInt);
-    close(event->dataItem.itemInt);
+    unset_poll_fd(eventContext.pollManager, event->fd);
+    close(event->fd);
 }
 
 void handle_ne_peer_close_event(Event *event) {
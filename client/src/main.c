@@ -80,7 +80,7 @@ int main(int argc, char **argv)
 
     /* poll manager tracks input activity on stdin, socket and 
         pipe fd's */
-    appContext.pollManager = create_poll_manager(POLL_FD_COUNT, POLLIN);
+    appContext.pollManager = create_poll_manager(POLL_FD_COUNT, POLLIN, POLL_BACKEND);
 
     /* set fd for stdin and pipe */
     set_poll_fd(appContext.pollManager, STDIN_FILENO);
@@ -123,7 +123,7 @@ int main(int argc, char **argv)
 
         /*  client uses I/O multiplexing with poll() to monitor stdin,
             pipe and socket fd's for input events (readiness to read data) */
-        int fdsReady = poll(get_poll_pfds(appContext.pollManager), get_poll_fd_count(appContext.pollManager), -1);
+        int fdsReady = poll(get_poll_pfds(appContext.pollManager), get_poll_max_count(appContext.pollManager), -1);
 
         if (fdsReady < 0) {
 
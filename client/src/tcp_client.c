@@ -133,7 +133,7 @@ int client_connect(TCPClient *tcpClient, EventManager *eventManager, const char
         initialize_session(tcpClient, clientFd, serverIdentifier, identifierType, port);
 
         if (eventManager != NULL) {
-            Event event = {.eventType = NETWORK_EVENT, .subEventType = NE_ADD_POLL_FD, .dataItem = (DataItem) {.itemInt = tcpClient->fd}, .dataType = INT_TYPE};
+            Event event = {.eventType = NETWORK_EVENT, .subEventType = NE_ADD_POLL_FD, .fd = tcpClient->fd};
             push_event_to_queue(eventManager, &event);
         }
   
@@ -157,8 +157,8 @@ void client_disconnect(TCPClient *tcpClient, EventManager *eventManager) {
 
     if (eventManager != NULL) {
 
-        push_event_to_queue(eventManager, &(Event){.eventType = NETWORK_EVENT, .subEventType = NE_CLIENT_DISCONNECT, .dataItem = (DataItem) {0}, .dataType = UNKNOWN_DATA_TYPE});
-        push_event_to_queue(eventManager, &(Event){.eventType = NETWORK_EVENT, .subEventType = NE_REMOVE_POLL_FD, .dataItem = (DataItem) {.itemInt = tcpClient->fd}, .dataType = INT_TYPE});
+        push_event_to_queue(eventManager, &(Event){.eventType = NETWORK_EVENT, .subEventType = NE_CLIENT_DISCONNECT});
+        push_event_to_queue(eventManager, &(Event){.eventType = NETWORK_EVENT, .subEventType = NE_REMOVE_POLL_FD, .fd = tcpClient->fd});
     }
 
     if (is_allowed_state_transition(get_client_session_states(), get_client_state_type(tcpClient), DISCONNECTED)) {
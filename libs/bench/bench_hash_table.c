@@ -0,0 +1,199 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/hash_table.h"
+#include "../src/flat_table.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+
+#define DEF_KEYS 1024
+#define DEF_ROUNDS 1000
+#define KEY_LEN 16
+#define SEED 1
+
+/* compares the chained hash table with the flat
+    table. both tables are created for the number of
+    keys and use the same hash function. keys look
+    like nicknames and every round inserts all keys,
+    looks up each of them and a missing key, and
+    removes them. keys are looked up and removed in
+    random order, so that the items of the chained
+    table aren't visited in allocation order. the
+    result is the average time per operation */
+
+typedef struct {
+    double insert;
+    double find;
+    double miss;
+    double remove;
+} BenchResult;
+
+static double get_time(void) {
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void bench_hash_table(char (*keys)[KEY_LEN], char (*missingKeys)[KEY_LEN], int *order, int keyCount, int rounds, BenchResult *result) {
+
+    HashTable *hashTable = create_hash_table(keyCount, 0, djb2_hash, are_strings_equal, NULL, NULL);
+    volatile void *found = NULL;
+
+    for (int round = 0; round < rounds; round++) {
+
+        double startTime = get_time();
+
+        for (int i = 0; i < keyCount; i++) {
+            insert_item_to_hash_table(hashTable, create_hash_item(keys[i], keys[i]));
+        }
+
+        double insertTime = get_time();
+
+        for (int i = 0; i < keyCount; i++) {
+            found = get_value(find_item_in_hash_table(hashTable, keys[order[i]]));
+        }
+
+        double findTime = get_time();
+
+        for (int i = 0; i < keyCount; i++) {
+            found = get_value(find_item_in_hash_table(hashTable, missingKeys[i]));
+        }
+
+        double missTime = get_time();
+
+        for (int i = 0; i < keyCount; i++) {
+            remove_item_from_hash_table(hashTable, keys[order[i]]);
+        }
+
+        double removeTime = get_time();
+
+        result->insert += insertTime - startTime;
+        result->find += findTime - insertTime;
+        result->miss += missTime - findTime;
+        result->remove += removeTime - missTime;
+    }
+
+    (void) found;
+    delete_hash_table(hashTable);
+}
+
+static void bench_flat_table(char (*keys)[KEY_LEN], char (*missingKeys)[KEY_LEN], int *order, int keyCount, int rounds, BenchResult *result) {
+
+    FlatTable *flatTable = create_flat_table(keyCount, djb2_hash, are_strings_equal, NULL, NULL);
+    volatile void *found = NULL;
+
+    for (int round = 0; round < rounds; round++) {
+
+        double startTime = get_time();
+
+        for (int i = 0; i < keyCount; i++) {
+            insert_to_flat_table(flatTable, keys[i], keys[i]);
+        }
+
+        double insertTime = get_time();
+
+        for (int i = 0; i < keyCount; i++) {
+            found = find_in_flat_table(flatTable, keys[order[i]]);
+        }
+
+        double findTime = get_time();
+
+        for (int i = 0; i < keyCount; i++) {
+            found = find_in_flat_table(flatTable, missingKeys[i]);
+        }
+
+        double missTime = get_time();
+
+        for (int i = 0; i < keyCount; i++) {
+            remove_from_flat_table(flatTable, keys[order[i]]);
+        }
+
+        double removeTime = get_time();
+
+        result->insert += insertTime - startTime;
+        result->find += findTime - insertTime;
+        result->miss += missTime - findTime;
+        result->remove += removeTime - missTime;
+    }
+
+    (void) found;
+    delete_flat_table(flatTable);
+}
+
+static void print_result(const char *name, BenchResult *result, long operations) {
+
+    printf("%-12s insert: %6.1f ns, find: %6.1f ns, miss: %6.1f ns, remove: %6.1f ns\n", name, result->insert / operations * 1e9, result->find / operations * 1e9, result->miss / operations * 1e9, result->remove / operations * 1e9);
+}
+
+int main(int argc, char **argv) {
+
+    int keyCount = DEF_KEYS;
+    int rounds = DEF_ROUNDS;
+
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:r:")) != -1) {
+
+        switch (opt) {
+            case 'n': keyCount = atoi(optarg); break;
+            case 'r': rounds = atoi(optarg); break;
+            default:
+                printf("Usage: %s [-n <keys>] [-r <rounds>]\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (keyCount <= 0 || rounds <= 0) {
+        fprintf(stderr, "Invalid arguments\n");
+        exit(EXIT_FAILURE);
+    }
+
+    char (*keys)[KEY_LEN] = calloc(keyCount, KEY_LEN);
+    char (*missingKeys)[KEY_LEN] = calloc(keyCount, KEY_LEN);
+    int *order = calloc(keyCount, sizeof(int));
+
+    if (keys == NULL || missingKeys == NULL || order == NULL) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < keyCount; i++) {
+
+        snprintf(keys[i], KEY_LEN, "user%d", i);
+        snprintf(missingKeys[i], KEY_LEN, "guest%d", i);
+        order[i] = i;
+    }
+
+    srand(SEED);
+
+    for (int i = keyCount - 1; i > 0; i--) {
+
+        int j = rand() % (i + 1);
+        int idx = order[i];
+
+        order[i] = order[j];
+        order[j] = idx;
+    }
+
+    BenchResult hashResult = {0};
+    BenchResult flatResult = {0};
+
+    bench_hash_table(keys, missingKeys, order, keyCount, rounds, &hashResult);
+    bench_flat_table(keys, missingKeys, order, keyCount, rounds, &flatResult);
+
+    long operations = (long) keyCount * rounds;
+
+    printf("keys: %d, rounds: %d\n", keyCount, rounds);
+    print_result("hash table", &hashResult, operations);
+    print_result("flat table", &flatResult, operations);
+
+    free(keys);
+    free(missingKeys);
+    free(order);
+
+    return EXIT_SUCCESS;
+}
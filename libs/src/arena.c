@@ -0,0 +1,189 @@
+#ifdef TEST
+#include "priv_arena.h"
+#else
+#include "arena.h"
+#endif
+
+#include "error_control.h"
+#include "logger.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef TEST
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+/* allocations are aligned for any scalar type */
+#define ARENA_ALIGNMENT 8
+
+#ifndef TEST
+
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    int size;
+    int used;
+    unsigned char data[];
+} ArenaBlock;
+
+/* the current block is the one allocations are 
+    made from. blocks after the current one are 
+    either unused or left over from before the 
+    last reset */
+struct Arena {
+    ArenaBlock *head;
+    ArenaBlock *current;
+    int blockSize;
+    int used;
+};
+
+#endif
+
+STATIC ArenaBlock * create_arena_block(int size);
+
+Arena * create_arena(int blockSize) {
+
+    if (blockSize <= 0) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    Arena *arena = (Arena*) malloc(sizeof(Arena));
+    if (arena == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    arena->head = create_arena_block(blockSize);
+    arena->current = arena->head;
+    arena->blockSize = blockSize;
+    arena->used = 0;
+
+    return arena;
+}
+
+void delete_arena(Arena *arena) {
+
+    if (arena != NULL) {
+
+        ArenaBlock *block = arena->head;
+
+        while (block != NULL) {
+
+            ArenaBlock *next = block->next;
+            free(block);
+            block = next;
+        }
+    }
+    free(arena);
+}
+
+STATIC ArenaBlock * create_arena_block(int size) {
+
+    ArenaBlock *block = (ArenaBlock*) malloc(sizeof(ArenaBlock) + size);
+    if (block == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+
+    return block;
+}
+
+void * allocate_from_arena(Arena *arena, int size) {
+
+    if (arena == NULL || size < 0) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+
+    ArenaBlock *block = arena->current;
+
+    if (block->used + size > block->size) {
+
+        /* reuse the next block if it's large enough, 
+            otherwise insert a new block after the 
+            current one */
+        if (block->next != NULL && block->next->size >= size) {
+            block = block->next;
+        }
+        else {
+            ArenaBlock *newBlock = create_arena_block(size > arena->blockSize ? size : arena->blockSize);
+            newBlock->next = block->next;
+            block->next = newBlock;
+            block = newBlock;
+        }
+        block->used = 0;
+        arena->current = block;
+    }
+
+    void *memory = block->data + block->used;
+
+    block->used += size;
+    arena->used += size;
+
+    return memory;
+}
+
+char * copy_to_arena(Arena *arena, const char *string, int len) {
+
+    if (arena == NULL || string == NULL || len < 0) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    char *copy = (char*) allocate_from_arena(arena, len + 1);
+
+    memcpy(copy, string, len);
+    copy[len] = '\0';
+
+    return copy;
+}
+
+void trim_arena_allocation(Arena *arena, void *memory, int size) {
+
+    if (arena == NULL || memory == NULL || size < 0) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    ArenaBlock *block = arena->current;
+    unsigned char *start = (unsigned char*) memory;
+
+    /* only an allocation of the current block can be 
+        trimmed */
+    if (start < block->data || start > block->data + block->used) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+
+    int used = (start - block->data) + size;
+
+    if (used < block->used) {
+
+        arena->used -= block->used - used;
+        block->used = used;
+    }
+}
+
+void reset_arena(Arena *arena) {
+
+    if (arena == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    arena->head->used = 0;
+    arena->current = arena->head;
+    arena->used = 0;
+}
+
+int get_arena_used(Arena *arena) {
+
+    if (arena == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return arena->used;
+}
@@ -0,0 +1,32 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+/* a bump pointer allocator. memory is allocated 
+    from a chain of blocks and is released all at 
+    once by resetting the arena. blocks are never 
+    moved, so the allocated memory remains valid 
+    until the arena is reset. reset blocks are 
+    reused by later allocations */
+typedef struct Arena Arena;
+
+Arena * create_arena(int blockSize);
+void delete_arena(Arena *arena);
+
+void * allocate_from_arena(Arena *arena, int size);
+
+/* copy len bytes of the string to the arena and 
+    terminate the copy with a null character */
+char * copy_to_arena(Arena *arena, const char *string, int len);
+
+/* shrink the last allocation to size bytes, so 
+    that memory reserved for data of unknown length 
+    is returned to the arena once the data is 
+    written */
+void trim_arena_allocation(Arena *arena, void *memory, int size);
+
+void reset_arena(Arena *arena);
+
+/* number of bytes allocated since the last reset */
+int get_arena_used(Arena *arena);
+
+#endif
@@ -3,6 +3,7 @@
 #else
 #include "event.h"
 #include "queue.h"
+#include "arena.h"
 #endif
 
 #include "event.h"
@@ -21,6 +22,9 @@
 #endif
 
 #define DEF_QUEUE_CAPACITY 20
+#define MAX_QUEUE_CAPACITY 16384
+#define DROP_LOG_INTERVAL 1000
+#define MESSAGE_ARENA_BLOCK_SIZE 16384
 
 #ifndef TEST
 
@@ -30,8 +34,12 @@ struct EventManager {
     EvHandlerFunc networkHandlers[NETWORK_EVENT_TYPE_COUNT];
     EvHandlerFunc systemHandlers[SYSTEM_EVENT_TYPE_COUNT];
     Queue *eventQueue;
+    Arena *messageArena;
+    Event poppedEvent;
     pthread_mutex_t mutex;
     pthread_cond_t cond;    
+    int maxCapacity;
+    int highWaterMark;
     int droppedEvents;
     bool stopProcessing;
 };
@@ -62,10 +70,13 @@ EventManager * create_event_manager(int capacity) {
     reset_event_handlers(eventManager);
 
     eventManager->eventQueue = create_queue(capacity, sizeof(Event));
+    eventManager->messageArena = create_arena(MESSAGE_ARENA_BLOCK_SIZE);
 
     pthread_mutex_init(&eventManager->mutex, NULL);
     pthread_cond_init(&eventManager->cond, NULL);
 
+    eventManager->maxCapacity = capacity > MAX_QUEUE_CAPACITY ? capacity : MAX_QUEUE_CAPACITY;
+    eventManager->highWaterMark = 0;
     eventManager->droppedEvents = 0;
     eventManager->stopProcessing = 0;
 
@@ -78,6 +89,7 @@ void delete_event_manager(EventManager *eventManager) {
     if (eventManager != NULL) {
 
         delete_queue(eventManager->eventQueue);
+        delete_arena(eventManager->messageArena);
 
         pthread_mutex_destroy(&eventManager->mutex);
         pthread_cond_destroy(&eventManager->cond);
@@ -85,9 +97,9 @@ void delete_event_manager(EventManager *eventManager) {
     free(eventManager); 
 }
 
-Event * create_event(EventType eventType, int subEventType, DataItem dataItem, DataType dataType) {
+Event * create_event(EventType eventType, int subEventType, int fd) {
 
-    if (!is_valid_enum_type(eventType, EVENT_TYPE_COUNT) || !is_valid_enum_type(dataType, DATA_TYPE_COUNT)) {
+    if (!is_valid_enum_type(eventType, EVENT_TYPE_COUNT)) {
         FAILED(ARG_ERROR, NULL);
     }
 
@@ -96,10 +108,7 @@ Event * create_event(EventType eventType, int subEventType, DataItem dataItem, D
         FAILED(ALLOC_ERROR, NULL);
     }
 
-    event->eventType = eventType;
-    event->subEventType = subEventType;
-    event->dataItem = dataItem;
-    event->dataType = dataType;
+    *event = (Event) {.eventType = eventType, .subEventType = subEventType, .fd = fd, .len = 0, .message = NULL};
 
     return event;
 }
@@ -219,7 +228,42 @@ void push_event_to_queue(EventManager *eventManager, Event *event) {
         FAILED(ARG_ERROR, NO_ERRCODE);
     }
 
-    enqueue(eventManager->eventQueue, event);
+    Queue *queue = eventManager->eventQueue;
+
+    /* the queue grows instead of overwriting the 
+        oldest event. once the limit is reached, new 
+        events are dropped and counted */
+    if (is_queue_full(queue)) {
+
+        int capacity = get_queue_capacity(queue);
+
+        if (capacity >= eventManager->maxCapacity) {
+
+            if (eventManager->droppedEvents++ % DROP_LOG_INTERVAL == 0) {
+                LOG(WARNING, "Event queue is full, %d event(s) dropped", eventManager->droppedEvents);
+            }
+            return;
+        }
+        resize_queue(queue, capacity * 2 < eventManager->maxCapacity ? capacity * 2 : eventManager->maxCapacity);
+    }
+
+    enqueue(queue, event);
+
+    if (get_queue_count(queue) > eventManager->highWaterMark) {
+        eventManager->highWaterMark = get_queue_count(queue);
+    }
+}
+
+void push_message_event_to_queue(EventManager *eventManager, Event *event, const char *message, int len) {
+
+    if (eventManager == NULL || event == NULL || message == NULL) {
+        FAILED(ARG_ERROR, NO_ERRCODE);
+    }
+
+    event->message = copy_to_arena(eventManager->messageArena, message, len);
+    event->len = len;
+
+    push_event_to_queue(eventManager, event);
 }
 
 Event * pop_event_from_queue(EventManager *eventManager) {
@@ -228,7 +272,48 @@ Event * pop_event_from_queue(EventManager *eventManager) {
         FAILED(ARG_ERROR, NO_ERRCODE);
     }
 
-    return dequeue(eventManager->eventQueue);
+    Event *event = dequeue(eventManager->eventQueue);
+
+    /* messages of the drained queue are no longer 
+        referenced */
+    if (event == NULL) {
+        reset_arena(eventManager->messageArena);
+        return NULL;
+    }
+
+    /* handlers may push new events and grow the 
+        queue, so the popped event is copied out of 
+        the queue's buffer */
+    eventManager->poppedEvent = *event;
+
+    return &eventManager->poppedEvent;
+}
+
+bool is_event_queue_empty(EventManager *eventManager) {
+
+    if (eventManager == NULL) {
+        FAILED(ARG_ERROR, NO_ERRCODE);
+    }
+
+    return is_queue_empty(eventManager->eventQueue);
+}
+
+int get_event_queue_high_water_mark(EventManager *eventManager) {
+
+    if (eventManager == NULL) {
+        FAILED(ARG_ERROR, NO_ERRCODE);
+    }
+
+    return eventManager->highWaterMark;
+}
+
+int get_dropped_events(EventManager *eventManager) {
+
+    if (eventManager == NULL) {
+        FAILED(ARG_ERROR, NO_ERRCODE);
+    }
+
+    return eventManager->droppedEvents;
 }
 
 EventType get_event_type(Event *event) {
@@ -240,13 +325,22 @@ EventType get_event_type(Event *event) {
     return event->eventType;
 }
 
-DataItem * get_event_data_item(Event *event) {
+int get_event_fd(Event *event) {
+
+    if (event == NULL) {
+        FAILED(ARG_ERROR, NO_ERRCODE);
+    }
+
+    return event->fd;
+}
+
+const char * get_event_message(Event *event) {
 
     if (event == NULL) {
         FAILED(ARG_ERROR, NO_ERRCODE);
     }
 
-    return &event->dataItem;
+    return event->message;
 }
 
 const char ** get_event_type_strings(void) {
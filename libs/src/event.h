@@ -31,6 +31,7 @@ typedef enum {
     NE_SERVER_MSG,
     NE_CLIENT_MSG,
     NE_SEND_IMMEDIATE_MSG,
+    NE_HOSTNAME_RESOLVED,
     UNKNOWN_NETWORK_EVENT_TYPE,
     NETWORK_EVENT_TYPE_COUNT
 } NetworkEventType;
@@ -42,12 +43,19 @@ typedef enum {
     SYSTEM_EVENT_TYPE_COUNT
 } SystemEventType;
 
+/* events are small and are copied by value. text 
+    of message events is stored in the event 
+    manager's arena and remains valid until the 
+    event queue is drained */
 typedef struct {
     EventType eventType;
     int subEventType;
-    DataType dataType;
-    DataItem dataItem;
-    const char *separator;
+    union {
+        int fd;
+        int key;
+    };
+    int len;
+    const char *message;
 } Event;
 
 typedef struct EventManager EventManager;
@@ -58,7 +66,7 @@ typedef void (*EvHandlerFunc)(Event *event);
 EventManager * create_event_manager(int capacity);
 void delete_event_manager(EventManager *eventManager);
 
-Event * create_event(EventType type, int subEventType, DataItem dataItem, DataType dataType);
+Event * create_event(EventType type, int subEventType, int fd);
 void delete_event(Event *event);
 
 void register_base_event_handler(EventManager *manager, EventType type, EvHandlerFunc handler);
@@ -72,10 +80,16 @@ void dispatch_network_event(EventManager *manager, Event *event);
 void dispatch_system_event(EventManager *manager, Event *event);
 
 void push_event_to_queue(EventManager *manager, Event *event);
+void push_message_event_to_queue(EventManager *manager, Event *event, const char *message, int len);
 Event * pop_event_from_queue(EventManager *manager);
+bool is_event_queue_empty(EventManager *manager);
+
+int get_event_queue_high_water_mark(EventManager *manager);
+int get_dropped_events(EventManager *manager);
 
 EventType get_event_type(Event *event);
-DataItem * get_event_data_item(Event *event);
+int get_event_fd(Event *event);
+const char * get_event_message(Event *event);
 
 const char ** get_event_type_strings(void);
 
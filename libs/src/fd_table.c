@@ -0,0 +1,146 @@
+#ifdef TEST
+#include "priv_fd_table.h"
+#else
+#include "fd_table.h"
+#endif
+
+#include "common.h"
+#include "error_control.h"
+
+#include <stdlib.h>
+
+#ifdef TEST
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+#define DEF_FD_TABLE_CAPACITY 64
+
+#ifndef TEST
+
+/* both indices of an fd are kept in the same 
+    entry */
+typedef struct {
+    int pollIdx;
+    int clientIdx;
+} FdEntry;
+
+struct FdTable {
+    FdEntry *entries;
+    int capacity;
+};
+
+#endif
+
+STATIC FdEntry * get_fd_entry(FdTable *fdTable, int fd);
+STATIC void resize_fd_table(FdTable *fdTable, int capacity);
+
+FdTable * create_fd_table(int capacity) {
+
+    if (capacity <= 0) {
+        capacity = DEF_FD_TABLE_CAPACITY;
+    }
+
+    FdTable *fdTable = (FdTable*) malloc(sizeof(FdTable));
+    if (fdTable == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    fdTable->entries = NULL;
+    fdTable->capacity = 0;
+
+    resize_fd_table(fdTable, capacity);
+
+    return fdTable;
+}
+
+void delete_fd_table(FdTable *fdTable) {
+
+    if (fdTable != NULL) {
+        free(fdTable->entries);
+    }
+    free(fdTable);
+}
+
+void set_fd_poll_idx(FdTable *fdTable, int fd, int pollIdx) {
+
+    if (fdTable == NULL || fd < 0) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    get_fd_entry(fdTable, fd)->pollIdx = pollIdx;
+}
+
+void set_fd_client_idx(FdTable *fdTable, int fd, int clientIdx) {
+
+    if (fdTable == NULL || fd < 0) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    get_fd_entry(fdTable, fd)->clientIdx = clientIdx;
+}
+
+int get_fd_poll_idx(FdTable *fdTable, int fd) {
+
+    if (fdTable == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return fd >= 0 && fd < fdTable->capacity ? fdTable->entries[fd].pollIdx : UNASSIGNED;
+}
+
+int get_fd_client_idx(FdTable *fdTable, int fd) {
+
+    if (fdTable == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return fd >= 0 && fd < fdTable->capacity ? fdTable->entries[fd].clientIdx : UNASSIGNED;
+}
+
+int get_fd_table_capacity(FdTable *fdTable) {
+
+    if (fdTable == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return fdTable->capacity;
+}
+
+/* returns the entry of the fd, growing the table 
+    if the fd doesn't fit */
+STATIC FdEntry * get_fd_entry(FdTable *fdTable, int fd) {
+
+    if (fdTable == NULL || fd < 0) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    if (fd >= fdTable->capacity) {
+
+        int capacity = fdTable->capacity * 2;
+
+        resize_fd_table(fdTable, capacity > fd ? capacity : fd + 1);
+    }
+
+    return &fdTable->entries[fd];
+}
+
+STATIC void resize_fd_table(FdTable *fdTable, int capacity) {
+
+    if (fdTable == NULL || capacity < fdTable->capacity) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    FdEntry *entries = (FdEntry*) realloc(fdTable->entries, capacity * sizeof(FdEntry));
+    if (entries == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    for (int i = fdTable->capacity; i < capacity; i++) {
+        entries[i] = (FdEntry) {.pollIdx = UNASSIGNED, .clientIdx = UNASSIGNED};
+    }
+
+    fdTable->entries = entries;
+    fdTable->capacity = capacity;
+}
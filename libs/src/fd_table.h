@@ -0,0 +1,25 @@
+#ifndef FD_TABLE_H
+#define FD_TABLE_H
+
+/* maps fd's to their poll index and client slot. 
+    fd's are small integers, so the table is an array 
+    indexed by fd, which grows when a larger fd is 
+    added. an event loop may share one table between 
+    its poll manager and server, so that both indices 
+    of an fd are found with a single lookup */
+typedef struct FdTable FdTable;
+
+FdTable * create_fd_table(int capacity);
+void delete_fd_table(FdTable *fdTable);
+
+/* an index is removed by setting it to UNASSIGNED */
+void set_fd_poll_idx(FdTable *fdTable, int fd, int pollIdx);
+void set_fd_client_idx(FdTable *fdTable, int fd, int clientIdx);
+
+/* returns UNASSIGNED for unknown fd's */
+int get_fd_poll_idx(FdTable *fdTable, int fd);
+int get_fd_client_idx(FdTable *fdTable, int fd);
+
+int get_fd_table_capacity(FdTable *fdTable);
+
+#endif
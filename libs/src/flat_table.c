@@ -0,0 +1,530 @@
+#ifdef TEST
+#include "priv_flat_table.h"
+#else
+#include "flat_table.h"
+#endif
+
+#include "common.h"
+#include "error_control.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef TEST
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+/* the table is resized when 7/8 of the slots are
+    used, including the deleted ones */
+#define MAX_LOAD(capacity) ((capacity) - (capacity) / 8)
+#define MIGRATE_STEP 32
+
+#ifndef TEST
+
+#define GROUP_SIZE 16
+#define EMPTY_SLOT -128
+#define DELETED_SLOT -2
+
+/* the full hash is kept with the item, so that keys
+    are compared only when the hashes match and the
+    items can be moved without rehashing */
+typedef struct {
+    void *key;
+    void *value;
+    unsigned long hash;
+} FlatSlot;
+
+/* every slot has a control byte, which is either
+    EMPTY_SLOT, DELETED_SLOT or the low 7 bits of the
+    item's hash. a group of control bytes is compared
+    at once when the table is probed. the first group
+    is copied after the last control byte, so that
+    groups can be read without wrapping around */
+typedef struct {
+    signed char *ctrl;
+    FlatSlot *slots;
+    int capacity;
+    int count;
+    int deletedCount;
+} FlatArray;
+
+/* the previous array holds the items which haven't
+    been moved yet during a resize. it's empty when
+    the table isn't being resized */
+struct FlatTable {
+    FlatArray current;
+    FlatArray previous;
+    int migrateIdx;
+    HashFunc hashFunc;
+    ComparatorFunc comparatorFunc;
+    DeleteKeyFunc deleteKeyFunc;
+    DeleteValueFunc deleteValueFunc;
+};
+
+#endif
+
+STATIC void create_flat_array(FlatArray *flatArray, int capacity);
+STATIC void delete_flat_array(FlatArray *flatArray);
+STATIC int find_flat_slot(FlatTable *flatTable, FlatArray *flatArray, void *key, unsigned long hash);
+STATIC void add_flat_slot(FlatArray *flatArray, void *key, void *value, unsigned long hash);
+STATIC void clear_flat_slot(FlatArray *flatArray, int index);
+STATIC int take_flat_slot(FlatTable *flatTable, void *key, FlatSlot *slot);
+STATIC void start_flat_table_resize(FlatTable *flatTable);
+STATIC void migrate_flat_slots(FlatTable *flatTable, int slotCount);
+STATIC int calculate_flat_capacity(int itemCount);
+
+static void delete_flat_array_items(FlatTable *flatTable, FlatArray *flatArray);
+
+/* returns a bit for every control byte in the group
+    which is equal to the byte */
+static inline unsigned match_group_byte(const signed char *group, signed char byte) {
+
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128((const __m128i*) group);
+
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(byte)));
+#else
+    unsigned mask = 0;
+
+    for (int i = 0; i < GROUP_SIZE; i++) {
+        mask |= (unsigned) (group[i] == byte) << i;
+    }
+    return mask;
+#endif
+}
+
+/* empty and deleted slots have the high bit set */
+static inline unsigned match_group_free(const signed char *group) {
+
+#ifdef __SSE2__
+    return _mm_movemask_epi8(_mm_loadu_si128((const __m128i*) group));
+#else
+    unsigned mask = 0;
+
+    for (int i = 0; i < GROUP_SIZE; i++) {
+        mask |= (unsigned) (group[i] < 0) << i;
+    }
+    return mask;
+#endif
+}
+
+/* the hash functions don't spread similar keys over
+    all bits, so the hash is mixed before its bits are
+    split between the group index and the control
+    byte */
+static inline unsigned long mix_hash(unsigned long hash) {
+
+    hash *= 0x9E3779B97F4A7C15UL;
+
+    return hash ^ (hash >> 32);
+}
+
+static inline signed char get_hash_ctrl(unsigned long hash) {
+
+    return hash & 0x7F;
+}
+
+static inline int get_hash_idx(unsigned long hash, int capacity) {
+
+    return (hash >> 7) & (capacity - 1);
+}
+
+static inline void set_slot_ctrl(FlatArray *flatArray, int index, signed char ctrl) {
+
+    flatArray->ctrl[index] = ctrl;
+
+    if (index < GROUP_SIZE) {
+        flatArray->ctrl[flatArray->capacity + index] = ctrl;
+    }
+}
+
+FlatTable * create_flat_table(int capacity, HashFunc hashFunc, ComparatorFunc comparatorFunc, DeleteKeyFunc deleteKeyFunc, DeleteValueFunc deleteValueFunc) {
+
+    if (hashFunc == NULL || comparatorFunc == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    FlatTable *flatTable = (FlatTable*) malloc(sizeof(FlatTable));
+    if (flatTable == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    create_flat_array(&flatTable->current, calculate_flat_capacity(capacity));
+    memset(&flatTable->previous, 0, sizeof(FlatArray));
+
+    flatTable->migrateIdx = 0;
+    flatTable->hashFunc = hashFunc;
+    flatTable->comparatorFunc = comparatorFunc;
+    flatTable->deleteKeyFunc = deleteKeyFunc;
+    flatTable->deleteValueFunc = deleteValueFunc;
+
+    return flatTable;
+}
+
+void delete_flat_table(FlatTable *flatTable) {
+
+    if (flatTable != NULL) {
+
+        delete_flat_array_items(flatTable, &flatTable->current);
+        delete_flat_array_items(flatTable, &flatTable->previous);
+        delete_flat_array(&flatTable->current);
+        delete_flat_array(&flatTable->previous);
+    }
+    free(flatTable);
+}
+
+int insert_to_flat_table(FlatTable *flatTable, void *key, void *value) {
+
+    if (flatTable == NULL || key == NULL || value == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    unsigned long hash = mix_hash(flatTable->hashFunc(key));
+
+    if (find_flat_slot(flatTable, &flatTable->current, key, hash) != UNASSIGNED || find_flat_slot(flatTable, &flatTable->previous, key, hash) != UNASSIGNED) {
+        return 0;
+    }
+
+    FlatArray *current = &flatTable->current;
+
+    if (current->count + current->deletedCount >= MAX_LOAD(current->capacity)) {
+        start_flat_table_resize(flatTable);
+    }
+
+    add_flat_slot(&flatTable->current, key, value, hash);
+    migrate_flat_slots(flatTable, MIGRATE_STEP);
+
+    return 1;
+}
+
+int remove_from_flat_table(FlatTable *flatTable, void *key) {
+
+    if (flatTable == NULL || key == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    FlatSlot slot;
+
+    if (!take_flat_slot(flatTable, key, &slot)) {
+        return 0;
+    }
+
+    if (flatTable->deleteKeyFunc != NULL) {
+        flatTable->deleteKeyFunc(slot.key);
+    }
+    if (flatTable->deleteValueFunc != NULL) {
+        flatTable->deleteValueFunc(slot.value);
+    }
+
+    return 1;
+}
+
+void * release_from_flat_table(FlatTable *flatTable, void *key) {
+
+    if (flatTable == NULL || key == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    FlatSlot slot;
+
+    if (!take_flat_slot(flatTable, key, &slot)) {
+        return NULL;
+    }
+
+    return slot.value;
+}
+
+void * find_in_flat_table(FlatTable *flatTable, void *key) {
+
+    if (flatTable == NULL || key == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    unsigned long hash = mix_hash(flatTable->hashFunc(key));
+
+    int index = find_flat_slot(flatTable, &flatTable->current, key, hash);
+
+    if (index != UNASSIGNED) {
+        return flatTable->current.slots[index].value;
+    }
+
+    index = find_flat_slot(flatTable, &flatTable->previous, key, hash);
+
+    return index != UNASSIGNED ? flatTable->previous.slots[index].value : NULL;
+}
+
+bool is_flat_table_empty(FlatTable *flatTable) {
+
+    if (flatTable == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return get_flat_table_count(flatTable) == 0;
+}
+
+int get_flat_table_count(FlatTable *flatTable) {
+
+    if (flatTable == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return flatTable->current.count + flatTable->previous.count;
+}
+
+int get_flat_table_capacity(FlatTable *flatTable) {
+
+    if (flatTable == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return flatTable->current.capacity;
+}
+
+STATIC void create_flat_array(FlatArray *flatArray, int capacity) {
+
+    if (flatArray == NULL || capacity < GROUP_SIZE) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    flatArray->ctrl = (signed char*) malloc(capacity + GROUP_SIZE);
+    flatArray->slots = (FlatSlot*) malloc(capacity * sizeof(FlatSlot));
+
+    if (flatArray->ctrl == NULL || flatArray->slots == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    memset(flatArray->ctrl, EMPTY_SLOT, capacity + GROUP_SIZE);
+
+    flatArray->capacity = capacity;
+    flatArray->count = 0;
+    flatArray->deletedCount = 0;
+}
+
+STATIC void delete_flat_array(FlatArray *flatArray) {
+
+    if (flatArray == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    free(flatArray->ctrl);
+    free(flatArray->slots);
+
+    memset(flatArray, 0, sizeof(FlatArray));
+}
+
+static void delete_flat_array_items(FlatTable *flatTable, FlatArray *flatArray) {
+
+    for (int i = 0; i < flatArray->capacity; i++) {
+
+        if (flatArray->ctrl[i] >= 0) {
+
+            if (flatTable->deleteKeyFunc != NULL) {
+                flatTable->deleteKeyFunc(flatArray->slots[i].key);
+            }
+            if (flatTable->deleteValueFunc != NULL) {
+                flatTable->deleteValueFunc(flatArray->slots[i].value);
+            }
+        }
+    }
+}
+
+/* groups are probed in a triangular sequence, which
+    visits every group when the capacity is a power of
+    2. the probe ends at the first group with an empty
+    slot. returns the index of the slot or UNASSIGNED
+    if the key isn't found */
+STATIC int find_flat_slot(FlatTable *flatTable, FlatArray *flatArray, void *key, unsigned long hash) {
+
+    if (flatTable == NULL || flatArray == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    if (!flatArray->count) {
+        return UNASSIGNED;
+    }
+
+    int mask = flatArray->capacity - 1;
+    int position = get_hash_idx(hash, flatArray->capacity);
+    signed char ctrl = get_hash_ctrl(hash);
+
+    for (int stride = GROUP_SIZE; ; stride += GROUP_SIZE) {
+
+        const signed char *group = flatArray->ctrl + position;
+
+        for (unsigned match = match_group_byte(group, ctrl); match; match &= match - 1) {
+
+            int index = (position + __builtin_ctz(match)) & mask;
+            FlatSlot *slot = &flatArray->slots[index];
+
+            if (slot->hash == hash && flatTable->comparatorFunc(slot->key, key)) {
+                return index;
+            }
+        }
+
+        if (match_group_byte(group, EMPTY_SLOT)) {
+            return UNASSIGNED;
+        }
+        position = (position + stride) & mask;
+    }
+}
+
+/* the key must not be in the array. the item is put
+    into the first free slot of its probe sequence */
+STATIC void add_flat_slot(FlatArray *flatArray, void *key, void *value, unsigned long hash) {
+
+    if (flatArray == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int mask = flatArray->capacity - 1;
+    int position = get_hash_idx(hash, flatArray->capacity);
+    unsigned match = 0;
+
+    for (int stride = GROUP_SIZE; !(match = match_group_free(flatArray->ctrl + position)); stride += GROUP_SIZE) {
+        position = (position + stride) & mask;
+    }
+
+    int index = (position + __builtin_ctz(match)) & mask;
+
+    if (flatArray->ctrl[index] == DELETED_SLOT) {
+        flatArray->deletedCount--;
+    }
+
+    flatArray->slots[index] = (FlatSlot) {key, value, hash};
+    set_slot_ctrl(flatArray, index, get_hash_ctrl(hash));
+    flatArray->count++;
+}
+
+/* a removed slot is marked as deleted if it may be a 
+    part of another item's probe sequence. that's not 
+    the case if every group containing the slot also 
+    contains an empty slot, since a probe ends in such 
+    a group */
+STATIC void clear_flat_slot(FlatArray *flatArray, int index) {
+
+    if (flatArray == NULL || index < 0 || index >= flatArray->capacity) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int previousIdx = (index - GROUP_SIZE) & (flatArray->capacity - 1);
+
+    unsigned emptyBefore = match_group_byte(flatArray->ctrl + previousIdx, EMPTY_SLOT);
+    unsigned emptyAfter = match_group_byte(flatArray->ctrl + index, EMPTY_SLOT);
+
+    flatArray->count--;
+
+    if (emptyBefore && emptyAfter && __builtin_clz(emptyBefore) - (32 - GROUP_SIZE) + __builtin_ctz(emptyAfter) < GROUP_SIZE) {
+        set_slot_ctrl(flatArray, index, EMPTY_SLOT);
+    }
+    else {
+        set_slot_ctrl(flatArray, index, DELETED_SLOT);
+        flatArray->deletedCount++;
+    }
+}
+
+/* the slot of the key is cleared and copied to the 
+    result. returns 0 if the key isn't in the table */
+STATIC int take_flat_slot(FlatTable *flatTable, void *key, FlatSlot *slot) {
+
+    if (flatTable == NULL || key == NULL || slot == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    unsigned long hash = mix_hash(flatTable->hashFunc(key));
+
+    FlatArray *flatArray = &flatTable->current;
+    int index = find_flat_slot(flatTable, flatArray, key, hash);
+
+    if (index == UNASSIGNED) {
+
+        flatArray = &flatTable->previous;
+        index = find_flat_slot(flatTable, flatArray, key, hash);
+    }
+
+    if (index == UNASSIGNED) {
+        return 0;
+    }
+
+    *slot = flatArray->slots[index];
+    clear_flat_slot(flatArray, index);
+
+    migrate_flat_slots(flatTable, MIGRATE_STEP);
+
+    return 1;
+}
+
+/* the items are moved to a new array, which is twice
+    as large if the table is at least half full.
+    otherwise, the new array has the same capacity and
+    the deleted slots are reclaimed */
+STATIC void start_flat_table_resize(FlatTable *flatTable) {
+
+    if (flatTable == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    /* a previous resize is completed first */
+    if (flatTable->previous.capacity) {
+        migrate_flat_slots(flatTable, flatTable->previous.capacity);
+    }
+
+    int capacity = flatTable->current.capacity;
+
+    if (flatTable->current.count >= capacity / 2) {
+        capacity *= 2;
+    }
+
+    flatTable->previous = flatTable->current;
+    flatTable->migrateIdx = 0;
+
+    create_flat_array(&flatTable->current, capacity);
+}
+
+STATIC void migrate_flat_slots(FlatTable *flatTable, int slotCount) {
+
+    if (flatTable == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    FlatArray *previous = &flatTable->previous;
+
+    if (!previous->capacity) {
+        return;
+    }
+
+    for (int i = 0; i < slotCount && flatTable->migrateIdx < previous->capacity; i++, flatTable->migrateIdx++) {
+
+        int index = flatTable->migrateIdx;
+
+        if (previous->ctrl[index] >= 0) {
+
+            FlatSlot *slot = &previous->slots[index];
+
+            add_flat_slot(&flatTable->current, slot->key, slot->value, slot->hash);
+            clear_flat_slot(previous, index);
+        }
+    }
+
+    if (flatTable->migrateIdx == previous->capacity || !previous->count) {
+        delete_flat_array(previous);
+    }
+}
+
+/* the capacity is a power of 2, large enough to hold
+    the items without resizing */
+STATIC int calculate_flat_capacity(int itemCount) {
+
+    int capacity = GROUP_SIZE;
+
+    while (MAX_LOAD(capacity) < itemCount) {
+        capacity *= 2;
+    }
+
+    return capacity;
+}
@@ -0,0 +1,32 @@
+#ifndef FLAT_TABLE_H
+#define FLAT_TABLE_H
+
+#include "hash_table.h"
+
+#include <stdbool.h>
+
+/* an open addressing hash table which uses the same
+    hash and comparison functions as the chained table.
+    keys and values are stored in a flat array, so no
+    memory is allocated per item. the table grows when
+    it's filled and items are moved to the larger array
+    a few at a time, during later insertions and
+    removals */
+typedef struct FlatTable FlatTable;
+
+FlatTable * create_flat_table(int capacity, HashFunc hashFunc, ComparatorFunc comparatorFunc, DeleteKeyFunc deleteKeyFunc, DeleteValueFunc deleteValueFunc);
+void delete_flat_table(FlatTable *flatTable);
+
+/* returns 0 if the key is already in the table */
+int insert_to_flat_table(FlatTable *flatTable, void *key, void *value);
+int remove_from_flat_table(FlatTable *flatTable, void *key);
+/* removes the item without deleting it and returns 
+    its value */
+void * release_from_flat_table(FlatTable *flatTable, void *key);
+void * find_in_flat_table(FlatTable *flatTable, void *key);
+
+bool is_flat_table_empty(FlatTable *flatTable);
+int get_flat_table_count(FlatTable *flatTable);
+int get_flat_table_capacity(FlatTable *flatTable);
+
+#endif
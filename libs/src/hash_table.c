@@ -9,8 +9,12 @@
 #include "logger.h"
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/random.h>
 
 #ifdef TEST
 #define STATIC
@@ -21,6 +25,15 @@
 #define DEF_LOAD_FACTOR 1.0
 #define MAX_LOAD_FACTOR 2.0
 
+#define ROTL(x, b) (((x) << (b)) | ((x) >> (64 - (b))))
+
+#define SIPROUND(v0, v1, v2, v3) do { \
+    v0 += v1; v1 = ROTL(v1, 13); v1 ^= v0; v0 = ROTL(v0, 32); \
+    v2 += v3; v3 = ROTL(v3, 16); v3 ^= v2; \
+    v0 += v3; v3 = ROTL(v3, 21); v3 ^= v0; \
+    v2 += v1; v1 = ROTL(v1, 17); v1 ^= v2; v2 = ROTL(v2, 32); \
+} while (0)
+
 #ifndef TEST
 
 /* each item in the table consists of a key-value pair.
@@ -50,6 +63,31 @@ struct HashTable {
 #endif
 
 
+/* the key is replaced with a random one by 
+    init_hash_seed() */
+static uint64_t hashSeed[2] = {0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL};
+
+/* rfc 1459 casemapping. besides the ascii letters, 
+    {}|^ are the lowercase forms of []\~ */
+static const unsigned char rfc1459Fold[256] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+    0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f,
+    0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f,
+    0x40, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f,
+    0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x7b, 0x7c, 0x7d, 0x5e, 0x5f,
+    0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f,
+    0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x7b, 0x7c, 0x7d, 0x5e, 0x7f,
+    0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f,
+    0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f,
+    0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xab, 0xac, 0xad, 0xae, 0xaf,
+    0xb0, 0xb1, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xbb, 0xbc, 0xbd, 0xbe, 0xbf,
+    0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf,
+    0xd0, 0xd1, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xdb, 0xdc, 0xdd, 0xde, 0xdf,
+    0xe0, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xeb, 0xec, 0xed, 0xee, 0xef,
+    0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff
+};
+
 STATIC float calculate_load_factor(HashTable *hashTable);
 STATIC float get_valid_load_factor(float loadFactor);
 STATIC int calculate_table_capacity(int itemCount, float loadFactor);
@@ -315,6 +353,68 @@ unsigned long djb2_hash(void *key) {
     return hash;
 }
 
+void init_hash_seed(void) {
+
+    uint64_t seed[2];
+
+    if (getrandom(seed, sizeof(seed), 0) != sizeof(seed)) {
+
+        LOG(ERROR, "Failed to get a random hash seed");
+        seed[0] = time(NULL);
+        seed[1] = getpid();
+    }
+    set_hash_seed(seed[0], seed[1]);
+}
+
+void set_hash_seed(unsigned long key0, unsigned long key1) {
+
+    hashSeed[0] = key0;
+    hashSeed[1] = key1;
+}
+
+/* siphash-1-3 of the string folded with rfc 1459 
+    casemapping. the string is folded while it's read, 
+    so no lowercase copy is needed. with a random key, 
+    colliding keys can't be chosen in advance */
+unsigned long siphash_rfc1459(void *key) {
+
+    const unsigned char *string = (const unsigned char *) key;
+
+    uint64_t v0 = hashSeed[0] ^ 0x736f6d6570736575ULL;
+    uint64_t v1 = hashSeed[1] ^ 0x646f72616e646f6dULL;
+    uint64_t v2 = hashSeed[0] ^ 0x6c7967656e657261ULL;
+    uint64_t v3 = hashSeed[1] ^ 0x7465646279746573ULL;
+
+    uint64_t word = 0;
+    uint64_t len = 0;
+
+    for (; *string; string++) {
+
+        word |= (uint64_t) rfc1459Fold[*string] << (8 * (len & 7));
+
+        if ((++len & 7) == 0) {
+
+            v3 ^= word;
+            SIPROUND(v0, v1, v2, v3);
+            v0 ^= word;
+            word = 0;
+        }
+    }
+
+    word |= len << 56;
+
+    v3 ^= word;
+    SIPROUND(v0, v1, v2, v3);
+    v0 ^= word;
+    v2 ^= 0xff;
+
+    for (int i = 0; i < 3; i++) {
+        SIPROUND(v0, v1, v2, v3);
+    }
+
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
 unsigned long fnv1a_hash(void *key) {
 
     const unsigned char *byte_ptr = (unsigned char *)key;
@@ -328,16 +428,41 @@ unsigned long fnv1a_hash(void *key) {
     return hash;
 }
 
+/* the address is the key, so the table doesn't have 
+    to read the object */
+unsigned long pointer_hash(void *key) {
+
+    return (unsigned long)(uintptr_t) key;
+}
+
 bool are_strings_equal(void *key1, void *key2) {
 
     return strcmp((char*)key1, (char*)key2) == 0;
 }
 
+bool are_strings_equal_rfc1459(void *key1, void *key2) {
+
+    const unsigned char *string1 = (const unsigned char *) key1;
+    const unsigned char *string2 = (const unsigned char *) key2;
+
+    while (*string1 && rfc1459Fold[*string1] == rfc1459Fold[*string2]) {
+        string1++;
+        string2++;
+    }
+
+    return rfc1459Fold[*string1] == rfc1459Fold[*string2];
+}
+
 bool are_ints_equal(void *key1, void *key2) {
 
     return *(int*)key1 == *(int*)key2;
 }
 
+bool are_pointers_equal(void *key1, void *key2) {
+
+    return key1 == key2;
+}
+
 /* a load factor represents the ratio of available 
     buckets to elements in the table, including those 
     chained during conflicts. when MAX_LOAD_FACTOR 
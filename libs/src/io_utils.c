@@ -43,12 +43,7 @@ StreamPipe * create_pipe(void) {
 
     for (int i = 0; i < PIPE_FD_COUNT; i++) {
 
-        int flags = fcntl(streamPipe->pipeFd[i], F_GETFL);
-        if (flags == -1) {
-            FAILED(NO_ERRCODE, "Error getting fcntl");
-        }
-
-        if (fcntl(streamPipe->pipeFd[i], F_SETFL, flags | O_NONBLOCK) == -1) {
+        if (!set_fd_nonblocking(streamPipe->pipeFd[i])) {
             FAILED(NO_ERRCODE, "Error setting fcntl");
         }
     }
@@ -77,6 +72,17 @@ void reset_pipe_buffer(StreamPipe *streamPipe) {
     memset(streamPipe->buffer, '\0', ARRAY_SIZE(streamPipe->buffer));
 }
 
+bool set_fd_nonblocking(int fd) {
+
+    int flags = fcntl(fd, F_GETFL);
+
+    if (flags == -1) {
+        return 0;
+    }
+
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+
 ssize_t read_string(int fd, char *buffer, int size) {
 
     if (buffer == NULL) {
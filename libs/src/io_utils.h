@@ -19,6 +19,9 @@ void delete_pipe(StreamPipe *streamPipe);
 
 void reset_pipe_buffer(StreamPipe *streamPipe);
 
+/* set fd to non-blocking mode */
+bool set_fd_nonblocking(int fd);
+
 ssize_t read_string(int fd, char *buffer, int size);
 ssize_t write_string(int fd, const char *string);
 
@@ -1,55 +1,93 @@
 #include "irc_message.h"
 
-#include "common.h"
 #include "error_control.h"
 #include "logger.h"
 
 #include <stdlib.h>
 #include <string.h>
 
-#define MAX_PREFIX 64
+static int append_token(char *buffer, int size, int len, const char *token, int separated);
 
-void create_irc_message(char *buffer, int size, IRCMessage *ircMessage) {
+int create_irc_message(char *buffer, int size, IRCMessage *ircMessage) {
 
     if (buffer == NULL || ircMessage == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    char prefix[MAX_PREFIX + 1] = {'\0'}; 
-    char body[MAX_CHARS + 1] = {'\0'}; 
-    char suffix[MAX_CHARS + 1] = {'\0'}; 
+    /* the tokens are appended to the buffer in a 
+        single pass. empty tokens are skipped and the 
+        others are separated by spaces */
+    int len = append_token(buffer, size, 0, ircMessage->prefix, 1);
 
-    if (ircMessage->messagePrefixFunc != NULL && ircMessage->funcArg != NULL) {
+    for (int i = 0; i < MAX_TOKENS && len >= 0; i++) {
+        len = append_token(buffer, size, len, ircMessage->body[i], 1);
+    }
+
+    /* the first token of the multi word suffix 
+        follows ':' without a space */
+    int separated = 1;
 
-        ircMessage->messagePrefixFunc(prefix, MAX_PREFIX, ircMessage->funcArg);
+    if (ircMessage->multiWordSuffix && len >= 0) {
+        len = append_token(buffer, size, len, ":", 1);
+        separated = 0;
     }
 
-    if (strlen(prefix)) {
-        prepend_char(prefix, MAX_CHARS, prefix, ':');
+    for (int i = 0; i < MAX_TOKENS && len >= 0; i++) {
+
+        int prevLen = len;
+        len = append_token(buffer, size, len, ircMessage->suffix[i], separated);
+        separated = separated || len != prevLen;
     }
 
-    if (ircMessage->body[0] != NULL) {
-        concat_tokens(body, ARRAY_SIZE(body), ircMessage->body, ARRAY_SIZE(ircMessage->body), " ");
+    if (len < 0) {
+        LOG(ERROR, "Max message length exceeded");
+        len = 0;
     }
+    buffer[len] = '\0';
 
-    if (ircMessage->suffix[0] != NULL) {
-        concat_tokens(suffix, ARRAY_SIZE(suffix), ircMessage->suffix, ARRAY_SIZE(ircMessage->suffix), " ");
+    return len;
+}
+
+/* append the token at the end of the message of 
+    the given length. returns the new length or -1 
+    if the token doesn't fit */
+static int append_token(char *buffer, int size, int len, const char *token, int separated) {
+
+    if (len < 0 || token == NULL || token[0] == '\0') {
+        return len;
     }
 
-    if (ircMessage->multiWordSuffix) {
-        prepend_char(suffix, MAX_CHARS, suffix, ':');
+    int spaceLen = separated && len;
+    int tokenLen = strlen(token);
+
+    if (len + spaceLen + tokenLen > size) {
+        return -1;
     }
+    if (spaceLen) {
+        buffer[len++] = ' ';
+    }
+    memcpy(buffer + len, token, tokenLen);
 
-    const char *tokens[] = {prefix, body, suffix};
+    return len + tokenLen;
+}
 
-    int spaces = ARRAY_SIZE(tokens) ? ARRAY_SIZE(tokens) - 1 : 0;
-    int messageLength = strlen(prefix) + strlen(body) + strlen(suffix) + spaces;
+const char * create_irc_line(Arena *arena, int size, IRCMessage *ircMessage, int *len) {
 
-    if (messageLength <= size) {
-        concat_tokens(buffer, size, tokens, ARRAY_SIZE(tokens), " ");
+    if (arena == NULL || ircMessage == NULL) {
+        FAILED(ARG_ERROR, NULL);
     }
-    else {
-        LOG(ERROR, "Max message length exceeded");
+
+    /* the message is formatted in the space reserved 
+        for the longest message, which is then trimmed 
+        to its length */
+    char *buffer = (char*) allocate_from_arena(arena, size + 1);
+
+    int lineLen = create_irc_message(buffer, size, ircMessage);
+    trim_arena_allocation(arena, buffer, lineLen + 1);
+
+    if (len != NULL) {
+        *len = lineLen;
     }
-    
+
+    return buffer;
 }
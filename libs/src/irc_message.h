@@ -1,9 +1,10 @@
 #ifndef IRC_MESSAGE_H
 #define IRC_MESSAGE_H
 
-#define MAX_TOKENS 5
+#include "arena.h"
 
-typedef void (*MessagePrefixFunc)(char *buffer, int size, void *arg);
+#define MAX_TOKENS 5
+#define MAX_PREFIX 64
 
 /*  IRC messages may have one of two forms. 
     a) if a message is a server response, the 
@@ -21,17 +22,32 @@ typedef void (*MessagePrefixFunc)(char *buffer, int size, void *arg);
 
     IRC message consists of several tokens grouped
     into the prefix, the body and the suffix.
-    the prefix may be included with the callback
-    function */
+    the prefix is a prepared string which starts 
+    with ':' and may be NULL */
 
 typedef struct {
     const char *body[MAX_TOKENS];
     const char *suffix[MAX_TOKENS];
     int multiWordSuffix;
-    MessagePrefixFunc messagePrefixFunc;
-    void *funcArg;
+    const char *prefix;
 } IRCMessage;
 
-void create_irc_message(char *buffer, int size, IRCMessage *ircMessage);
+/* a reference to a formatted message without 
+    CRLF. queues store the reference instead of a 
+    copy of the message */
+typedef struct {
+    const char *data;
+    int len;
+} IRCLine;
+
+/* the buffer must hold size + 1 bytes. returns 
+    the length of the message or 0 if it doesn't 
+    fit */
+int create_irc_message(char *buffer, int size, IRCMessage *ircMessage);
+
+/* format the message in the arena, so that it's 
+    written once and referenced until the arena is 
+    reset. len may be NULL */
+const char * create_irc_line(Arena *arena, int size, IRCMessage *ircMessage, int *len);
 
 #endif
\ No newline at end of file
@@ -105,6 +105,30 @@ ssize_t mock_write(int fd, const void *buffer, size_t writeBytes) {
     return bytesWritten; 
 }
 
+ssize_t mock_writev(int fd, const struct iovec *iov, int iovcnt) {
+
+    ssize_t bytesWritten = -1;
+
+    if (iov != NULL && fd == mockFd) {
+
+        bytesWritten = 0;
+
+        for (int i = 0; i < iovcnt; i++) {
+
+            size_t writeBytes = iov[i].iov_len;
+
+            if (bytesWritten + writeBytes > mockBufferSize) {
+                writeBytes = mockBufferSize - bytesWritten;
+            }
+            memcpy(mockBuffer, iov[i].iov_base, writeBytes); 
+
+            mockBuffer += writeBytes; 
+            bytesWritten += writeBytes;
+        }
+    }
+    return bytesWritten; 
+}
+
 int mock_close(int fd) {
 
     int closeStatus = -1;
@@ -271,3 +271,121 @@ int get_list_count(LinkedList *linkedList) {
 
     return linkedList->count;
 }
+
+void init_intrusive_list(IntrusiveList *list) {
+
+    if (list == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    list->head = NULL;
+    list->tail = NULL;
+    list->count = 0;
+}
+
+void init_list_link(ListLink *link, void *data) {
+
+    if (link == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    link->data = data;
+    link->prev = NULL;
+    link->next = NULL;
+    link->listed = 0;
+}
+
+int append_link(IntrusiveList *list, ListLink *link) {
+
+    if (list == NULL || link == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    if (link->listed) {
+        return 0;
+    }
+
+    link->prev = list->tail;
+    link->next = NULL;
+    link->listed = 1;
+
+    if (list->tail != NULL) {
+        list->tail->next = link;
+    }
+    else {
+        list->head = link;
+    }
+
+    list->tail = link;
+    list->count++;
+
+    return 1;
+}
+
+int remove_link(IntrusiveList *list, ListLink *link) {
+
+    if (list == NULL || link == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    if (!link->listed) {
+        return 0;
+    }
+
+    if (link->prev != NULL) {
+        link->prev->next = link->next;
+    }
+    else {
+        list->head = link->next;
+    }
+
+    if (link->next != NULL) {
+        link->next->prev = link->prev;
+    }
+    else {
+        list->tail = link->prev;
+    }
+
+    link->prev = NULL;
+    link->next = NULL;
+    link->listed = 0;
+    list->count--;
+
+    return 1;
+}
+
+/* removes the first link and returns its data */
+void * pop_link(IntrusiveList *list) {
+
+    if (list == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    ListLink *link = list->head;
+
+    if (link == NULL) {
+        return NULL;
+    }
+
+    remove_link(list, link);
+
+    return link->data;
+}
+
+bool is_link_listed(ListLink *link) {
+
+    if (link == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return link->listed;
+}
+
+int get_intrusive_list_count(IntrusiveList *list) {
+
+    if (list == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return list->count;
+}
@@ -7,6 +7,22 @@ typedef bool (*ComparatorFunc)(void *data1, void *data2);
 typedef void (*DeleteDataFunc)(void *data);
 typedef void (*LinkedListFunc)(void *data, void *arg);
 
+/* a link embedded in the listed object, so that it's 
+    listed without allocating a node. the object is in
+    at most one list per link */
+typedef struct ListLink {
+    void *data;
+    struct ListLink *prev;
+    struct ListLink *next;
+    bool listed;
+} ListLink;
+
+typedef struct {
+    ListLink *head;
+    ListLink *tail;
+    int count;
+} IntrusiveList;
+
 /* a generic linked list that may use any data type */
 typedef struct Node Node;
 typedef struct LinkedList LinkedList;
@@ -32,4 +48,15 @@ Node * get_next(Node *node);
 
 int get_list_count(LinkedList *linkedList);
 
+void init_intrusive_list(IntrusiveList *list);
+void init_list_link(ListLink *link, void *data);
+
+/* returns 0 if the link is already listed */
+int append_link(IntrusiveList *list, ListLink *link);
+int remove_link(IntrusiveList *list, ListLink *link);
+void * pop_link(IntrusiveList *list);
+
+bool is_link_listed(ListLink *link);
+int get_intrusive_list_count(IntrusiveList *list);
+
 #endif
\ No newline at end of file
@@ -59,6 +59,7 @@ static Logger *logger = NULL;
 static NotifyThreadFunc notifyThreadFunc = NULL;
 static Thread *logThread = NULL;
 static pthread_mutex_t logMutex = PTHREAD_MUTEX_INITIALIZER;
+static int logLocking = 0;
 
 /* translation of log levels to strings */
 static const char *LOGLEVEL_STRINGS[] = {
@@ -215,6 +216,13 @@ void log_message(LogLevel level, const char *msg, const char *function, const ch
         return;
     }
 
+    /* event loops on several threads share the logger */
+    bool lockLog = logLocking && logThread == NULL;
+
+    if (lockLog) {
+        pthread_mutex_lock(&logMutex);
+    }
+
     if (msg != NULL) {
 
         char tsDateTime[DATETIME_LENGTH] = {'\0'};
@@ -288,6 +296,10 @@ void log_message(LogLevel level, const char *msg, const char *function, const ch
             pthread_mutex_unlock(&logMutex);
         }
     }
+
+    if (lockLog) {
+        pthread_mutex_unlock(&logMutex);
+    }
 }
 
 void log_error(ErrorCode errorCode, const char *msg, const char *function, const char *file, int line, int errnosv, ...) {
@@ -377,6 +389,11 @@ bool is_stdout_enabled(void) {
     return enabled;
 }
 
+bool is_log_level_enabled(LogLevel level) {
+
+    return logger != NULL && is_valid_enum_type(logger->logLevel, LOGLEVEL_COUNT) && logger->logLevel <= level;
+}
+
 void enable_stdout_logging(int stdoutEnabled) {
 
     if (logger != NULL) {
@@ -384,6 +401,11 @@ void enable_stdout_logging(int stdoutEnabled) {
     }
 }
 
+void enable_log_locking(int lockingEnabled) {
+
+    logLocking = lockingEnabled;
+}
+
 void set_log_thread(Thread *thread) {
 
     logThread = thread;
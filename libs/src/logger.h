@@ -49,10 +49,18 @@ const char ** get_log_level_strings(void);
 
 bool is_stdout_enabled(void);
 
+/* messages which are only formatted for logging 
+    can be skipped if their level isn't logged */
+bool is_log_level_enabled(LogLevel level);
+
 /* enable or disable the display of log
     messages in the terminal */
 void enable_stdout_logging(int stdoutEnabled);
 
+/* serialize logging from several threads, without
+    a dedicated logging thread */
+void enable_log_locking(int lockingEnabled);
+
 void set_log_thread(Thread *thread);
 void set_log_thread_callback(NotifyThreadFunc func);
 pthread_mutex_t * get_log_mutex(void);
@@ -5,6 +5,7 @@
 #include <stddef.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <ncursesw/curses.h>
 
@@ -14,6 +15,7 @@
     functions */
 #define read mock_read
 #define write mock_write
+#define writev mock_writev
 #define close mock_close
 #define socket mock_socket
 #define connect mock_connect
@@ -43,6 +45,7 @@ void set_mock_sockaddr(struct sockaddr_in *sockaddr);
 /* mock functions */
 ssize_t mock_read(int fd, void *buffer, size_t readBytes);
 ssize_t mock_write(int fd, const void *buffer, size_t writeBytes);
+ssize_t mock_writev(int fd, const struct iovec *iov, int iovcnt);
 int mock_close(int fd);
 
 int mock_socket(int domain, int type, int protocol);
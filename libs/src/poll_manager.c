@@ -9,7 +9,11 @@
 #include "../../libs/src/logger.h"
 
 #include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <assert.h>
 #include <poll.h>
+#include <sys/epoll.h>
 
 #ifdef TEST
 #define STATIC
@@ -19,24 +23,44 @@
 
 #ifndef TEST
 
-struct FdIdxPair {
-    int fd;
-    int fdIdx;
-};
-
+/* poll manager keeps registered fd's in the pfds
+    array regardless of the backend. with poll() 
+    backend, the array is passed to poll() directly,
+    while with epoll backend, the kernel keeps its 
+    own interest list and only the ready fd's are
+    returned. in both cases, the ready fd's are 
+    collected into the readyPfds array, so that the
+    caller only visits fd's with pending events.
+    the pfds array is kept compact, with registered
+    fd's in the first count entries, and the index 
+    of an fd in the array is kept in the fd table */
 struct PollManager {
     struct pollfd *pfds;
-    HashTable *fdsIdxMap;
+    struct pollfd *readyPfds;
+    struct epoll_event *epollEvents;
+    FdTable *fdTable;
+    PollBackendType backendType;
+    int epollFd;
     int events;
     int count;
+    int readyCount;
     int capacity;
 };
 
 #endif
 
-STATIC int find_poll_fd_idx(PollManager *pollManager, int fd);
+static const char *POLL_BACKEND_TYPE_STRINGS[] = {
+    "poll",
+    "epoll",
+    "Unknown"
+};
+
+ASSERT_ARRAY_SIZE(POLL_BACKEND_TYPE_STRINGS, POLL_BACKEND_TYPE_COUNT)
 
-PollManager * create_poll_manager(int capacity, int events) {
+STATIC int wait_for_poll(PollManager *pollManager, int timeout);
+STATIC int wait_for_epoll(PollManager *pollManager, int timeout);
+
+PollManager * create_poll_manager(int capacity, int events, PollBackendType backendType) {
 
     if (capacity <= 0) {
         capacity = DEF_FDS;
@@ -55,15 +79,46 @@ PollManager * create_poll_manager(int capacity, int events) {
         FAILED(ALLOC_ERROR, NULL);
     }
 
-    pollManager->fdsIdxMap = create_hash_table(capacity, 0, fnv1a_hash, are_ints_equal, NULL, delete_pfd_idx_pair);
+    pollManager->readyPfds = (struct pollfd*) malloc(capacity * sizeof(struct pollfd));
+    if (pollManager->readyPfds == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    pollManager->fdTable = create_fd_table(capacity);
 
+    /* edge triggered flag is only meaningful to epoll */
     for (int i = 0; i < capacity; i++) {
        pollManager->pfds[i].fd = UNASSIGNED;
-       pollManager->pfds[i].events = events;
+       pollManager->pfds[i].events = events & ~EDGE_TRIGGERED;
+       pollManager->pfds[i].revents = 0;
+    }
+
+    pollManager->epollEvents = NULL;
+    pollManager->epollFd = UNASSIGNED;
+
+    if (backendType == EPOLL_BACKEND) {
+
+        pollManager->epollFd = epoll_create1(EPOLL_CLOEXEC);
+
+        if (pollManager->epollFd < 0) {
+            LOG(WARNING, "Error creating epoll instance, falling back to poll()");
+            backendType = POLL_BACKEND;
+        }
+        else {
+            pollManager->epollEvents = (struct epoll_event*) malloc(capacity * sizeof(struct epoll_event));
+            if (pollManager->epollEvents == NULL) {
+                FAILED(ALLOC_ERROR, NULL);
+            }
+        }
+    }
+    else if (backendType != POLL_BACKEND) {
+        backendType = POLL_BACKEND;
     }
 
+    pollManager->backendType = backendType;
     pollManager->events = events;
     pollManager->count = 0;
+    pollManager->readyCount = 0;
     pollManager->capacity = capacity;
 
     return pollManager;
@@ -72,129 +127,263 @@ PollManager * create_poll_manager(int capacity, int events) {
 void delete_poll_manager(PollManager *pollManager) {
 
    if (pollManager != NULL) {
+
+        if (pollManager->epollFd != UNASSIGNED) {
+            close(pollManager->epollFd);
+        }
         free(pollManager->pfds);
-        delete_hash_table(pollManager->fdsIdxMap);
+        free(pollManager->readyPfds);
+        free(pollManager->epollEvents);
+        delete_fd_table(pollManager->fdTable);
     }
     free(pollManager); 
 }
 
-FdIdxPair * create_pfd_idx_pair(int fd, int fdIdx) {
+void set_poll_fd(PollManager *pollManager, int fd) {
 
-    FdIdxPair *fdIdxPair = (FdIdxPair*) malloc(sizeof(FdIdxPair));
-    if (fdIdxPair == NULL) {
-        FAILED(ALLOC_ERROR, NULL);
+    if (pollManager == NULL) {
+        FAILED(ARG_ERROR, NULL);
     }
 
-    fdIdxPair->fd = fd;
-    fdIdxPair->fdIdx = fdIdx;
+    /* the first unused entry follows the registered 
+        fd's */
+    if (pollManager->count < pollManager->capacity) {
 
-    return fdIdxPair;
-}
+        int fdIdx = pollManager->count;
+
+        if (pollManager->backendType == EPOLL_BACKEND) {
 
-void delete_pfd_idx_pair(void *fdIdxPair) {
+            struct epoll_event event = {.events = pollManager->events, .data.fd = fd};
 
-    free(fdIdxPair);
+            if (epoll_ctl(pollManager->epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+                LOG(ERROR, "Error adding fd to epoll instance (fd: %d)", fd);
+                return;
+            }
+        }
+
+        set_fd_poll_idx(pollManager->fdTable, fd, fdIdx);
+        pollManager->pfds[fdIdx].fd = fd;
+        pollManager->pfds[fdIdx].revents = 0;
+        pollManager->count++;
+    }
 }
 
-bool are_pfd_idx_equal(void *fdIdxPair1, void *fdIdxPair2) {
+void unset_poll_fd(PollManager *pollManager, int fd) {
+
+    if (pollManager == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int fdIdx = get_fd_poll_idx(pollManager->fdTable, fd);
+
+    if (fdIdx != -1) {
+
+        /* closing the fd removes it from the epoll
+            interest list, but the fd may still be
+            open at this point */
+        if (pollManager->backendType == EPOLL_BACKEND) {
+            epoll_ctl(pollManager->epollFd, EPOLL_CTL_DEL, fd, NULL);
+        }
+
+        set_fd_poll_idx(pollManager->fdTable, fd, UNASSIGNED);
+        pollManager->count--;
+
+        /* the last registered fd is moved to the 
+            removed fd's entry */
+        int lastIdx = pollManager->count;
 
-    bool equal = 0;
+        if (fdIdx != lastIdx) {
+
+            pollManager->pfds[fdIdx] = pollManager->pfds[lastIdx];
+            set_fd_poll_idx(pollManager->fdTable, pollManager->pfds[fdIdx].fd, fdIdx);
+        }
 
-    FdIdxPair *p1 = (FdIdxPair*)fdIdxPair1;
-    FdIdxPair *p2 = (FdIdxPair*)fdIdxPair2;
+        pollManager->pfds[lastIdx].fd = UNASSIGNED;
+        pollManager->pfds[lastIdx].events = pollManager->events & ~EDGE_TRIGGERED;
+        pollManager->pfds[lastIdx].revents = 0;
 
-    if (p1 != NULL && p2 != NULL) {
+        /* the fd may still be in the ready list
+            of the current iteration */
+        for (int i = 0; i < pollManager->readyCount; i++) {
 
-        equal = p1->fd == p2->fd;
+            if (pollManager->readyPfds[i].fd == fd) {
+                pollManager->readyPfds[i].revents = 0;
+            }
+        }
     }
-    return equal;
 }
 
-STATIC int find_poll_fd_idx(PollManager *pollManager, int fd) {
+/* change the events monitored on a registered fd.
+    edge triggered flag from the poll manager's 
+    events is kept */
+void set_poll_fd_events(PollManager *pollManager, int fd, int events) {
 
     if (pollManager == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    int index = UNASSIGNED;
+    int fdIdx = get_fd_poll_idx(pollManager->fdTable, fd);
+
+    events &= ~EDGE_TRIGGERED;
+
+    if (fdIdx == -1 || pollManager->pfds[fdIdx].events == events) {
+        return;
+    }
+
+    if (pollManager->backendType == EPOLL_BACKEND) {
 
-    for (int i = 0; i < pollManager->capacity; i++) {
+        struct epoll_event event = {.events = events | (pollManager->events & EDGE_TRIGGERED), .data.fd = fd};
 
-        if (pollManager->pfds[i].fd == fd) {
-            index = i;
-            break;
+        if (epoll_ctl(pollManager->epollFd, EPOLL_CTL_MOD, fd, &event) < 0) {
+            LOG(ERROR, "Error modifying fd in epoll instance (fd: %d)", fd);
+            return;
         }
     }
-    return index;
+
+    pollManager->pfds[fdIdx].events = events;
 }
 
-void add_fd_idx_to_hash_table(HashTable *hashTable, int fd, int fdIdx) {
+int get_poll_fd_events(PollManager *pollManager, int fd) {
 
-    if (hashTable == NULL) {
+    if (pollManager == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
-    FdIdxPair *fdIdxPair = create_pfd_idx_pair(fd, fdIdx);
-    HashItem *item = create_hash_item(&fdIdxPair->fd, fdIdxPair);
 
-    insert_item_to_hash_table(hashTable, item);
+    int fdIdx = get_fd_poll_idx(pollManager->fdTable, fd);
+    int events = 0;
+
+    if (fdIdx != -1) {
+        events = pollManager->pfds[fdIdx].events;
+    }
+
+    return events;
 }
 
-void remove_fd_idx_from_hash_table(HashTable *hashTable, int fd) {
+/* wait for events on registered fd's. returns the
+    number of ready fd's, which may be accessed with
+    get_ready_fd() and get_ready_revents() */
+int wait_for_poll_events(PollManager *pollManager, int timeout) {
 
-    if (hashTable == NULL) {
+    if (pollManager == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    remove_item_from_hash_table(hashTable, &fd);
+    int fdsReady = 0;
+
+    if (pollManager->backendType == EPOLL_BACKEND) {
+        fdsReady = wait_for_epoll(pollManager, timeout);
+    }
+    else {
+        fdsReady = wait_for_poll(pollManager, timeout);
+    }
+
+    return fdsReady;
 }
 
-int find_fd_idx_in_hash_table(HashTable *hashTable, int fd) {
+STATIC int wait_for_poll(PollManager *pollManager, int timeout) {
 
-    if (hashTable == NULL) {
+    if (pollManager == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    int fdIdx = -1;
+    pollManager->readyCount = 0;
+
+    /* only the registered fd's are passed to poll() */
+    int fdsReady = poll(pollManager->pfds, pollManager->count, timeout);
 
-    HashItem *item = find_item_in_hash_table(hashTable, &fd);
+    for (int i = 0; i < pollManager->count && pollManager->readyCount < fdsReady; i++) {
 
-    if (item != NULL) {
-        FdIdxPair *fdIdxPair = (FdIdxPair*)get_value(item);
-        fdIdx = fdIdxPair->fdIdx;
+        if (pollManager->pfds[i].revents) {
+            pollManager->readyPfds[pollManager->readyCount++] = pollManager->pfds[i];
+        }
     }
-    return fdIdx;
+
+    return fdsReady < 0 ? fdsReady : pollManager->readyCount;
 }
 
-void set_poll_fd(PollManager *pollManager, int fd) {
+STATIC int wait_for_epoll(PollManager *pollManager, int timeout) {
 
     if (pollManager == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    int fdIdx = find_poll_fd_idx(pollManager, UNASSIGNED);
+    /* clear events from the previous iteration, so 
+        that is_fd_input_event() only reports fd's 
+        from the current one */
+    for (int i = 0; i < pollManager->readyCount; i++) {
 
-    if (fdIdx != -1) {
+        int fdIdx = get_fd_poll_idx(pollManager->fdTable, pollManager->readyPfds[i].fd);
 
-        add_fd_idx_to_hash_table(pollManager->fdsIdxMap, fd, fdIdx);
-        pollManager->pfds[fdIdx].fd = fd;
-        pollManager->count++;
+        if (fdIdx != -1) {
+            pollManager->pfds[fdIdx].revents = 0;
+        }
+    }
+    pollManager->readyCount = 0;
+
+    int fdsReady = epoll_wait(pollManager->epollFd, pollManager->epollEvents, pollManager->capacity, timeout);
+
+    /* epoll event bits have the same values as 
+        their poll() counterparts */
+    for (int i = 0; i < fdsReady; i++) {
+
+        int fd = pollManager->epollEvents[i].data.fd;
+        int fdIdx = get_fd_poll_idx(pollManager->fdTable, fd);
+
+        if (fdIdx != -1) {
+
+            pollManager->pfds[fdIdx].revents = pollManager->epollEvents[i].events;
+            pollManager->readyPfds[pollManager->readyCount++] = pollManager->pfds[fdIdx];
+        }
     }
+
+    return fdsReady < 0 ? fdsReady : pollManager->readyCount;
 }
 
-void unset_poll_fd(PollManager *pollManager, int fd) {
+int get_ready_fd(PollManager *pollManager, int readyIdx) {
 
     if (pollManager == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    int fdIdx = find_fd_idx_in_hash_table(pollManager->fdsIdxMap, fd);
+    int fd = UNASSIGNED;
 
-    if (fdIdx != -1) {
+    if (readyIdx >= 0 && readyIdx < pollManager->readyCount) {
+        fd = pollManager->readyPfds[readyIdx].fd;
+    }
 
-        remove_fd_idx_from_hash_table(pollManager->fdsIdxMap, fd);
-        pollManager->pfds[fdIdx].fd = UNASSIGNED;
-        pollManager->count--;
+    return fd;
+}
+
+int get_ready_revents(PollManager *pollManager, int readyIdx) {
+
+    if (pollManager == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int revents = 0;
+
+    if (readyIdx >= 0 && readyIdx < pollManager->readyCount) {
+        revents = pollManager->readyPfds[readyIdx].revents;
     }
+
+    return revents;
+}
+
+bool is_ready_input_event(PollManager *pollManager, int readyIdx) {
+
+    return get_ready_revents(pollManager, readyIdx) & POLLIN;
+}
+
+bool is_ready_output_event(PollManager *pollManager, int readyIdx) {
+
+    return get_ready_revents(pollManager, readyIdx) & POLLOUT;
+}
+
+bool is_ready_error_event(PollManager *pollManager, int readyIdx) {
+
+    int revents = get_ready_revents(pollManager, readyIdx);
+
+    return revents & POLLERR || revents & POLLHUP;
 }
 
 int get_poll_fd_count(PollManager *pollManager) {
@@ -206,6 +395,15 @@ int get_poll_fd_count(PollManager *pollManager) {
     return pollManager->count;
 }
 
+int get_poll_max_count(PollManager *pollManager) {
+
+    if (pollManager == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return pollManager->count;
+}
+
 int get_poll_capacity(PollManager *pollManager) {
 
     if (pollManager == NULL) {
@@ -232,7 +430,7 @@ int get_poll_fd(PollManager *pollManager, int fd) {
 
     int pollFd = UNASSIGNED;
 
-    int fdIdx = find_fd_idx_in_hash_table(pollManager->fdsIdxMap, fd);
+    int fdIdx = get_fd_poll_idx(pollManager->fdTable, fd);
 
     if (fdIdx != -1) {
         pollFd = pollManager->pfds[fdIdx].fd;
@@ -249,7 +447,7 @@ int get_poll_revents(PollManager *pollManager, int fd) {
 
     int revents = UNASSIGNED;
 
-    int fdIdx = find_fd_idx_in_hash_table(pollManager->fdsIdxMap, fd);
+    int fdIdx = get_fd_poll_idx(pollManager->fdTable, fd);
 
     if (fdIdx != -1) {
         revents = pollManager->pfds[fdIdx].revents;
@@ -278,4 +476,27 @@ bool is_fd_error_event(PollManager *pollManager, int fd) {
     int revents = get_poll_revents(pollManager, fd);
 
     return revents & POLLERR || revents & POLLHUP;
-}
\ No newline at end of file
+}
+
+FdTable * get_poll_fd_table(PollManager *pollManager) {
+
+    if (pollManager == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return pollManager->fdTable;
+}
+
+PollBackendType get_poll_backend_type(PollManager *pollManager) {
+
+    if (pollManager == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return pollManager->backendType;
+}
+
+const char ** get_poll_backend_type_strings(void) {
+
+    return POLL_BACKEND_TYPE_STRINGS;
+}
@@ -0,0 +1,37 @@
+/* --INTERNAL HEADER--
+   used for testing */
+#ifndef ARENA_H
+#define ARENA_H
+
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    int size;
+    int used;
+    unsigned char data[];
+} ArenaBlock;
+
+typedef struct {
+    ArenaBlock *head;
+    ArenaBlock *current;
+    int blockSize;
+    int used;
+} Arena;
+
+Arena * create_arena(int blockSize);
+void delete_arena(Arena *arena);
+
+void * allocate_from_arena(Arena *arena, int size);
+char * copy_to_arena(Arena *arena, const char *string, int len);
+void trim_arena_allocation(Arena *arena, void *memory, int size);
+
+void reset_arena(Arena *arena);
+
+int get_arena_used(Arena *arena);
+
+#ifdef TEST
+
+ArenaBlock * create_arena_block(int size);
+
+#endif
+
+#endif
@@ -4,6 +4,7 @@
 #define EVENT_H
 
 #include "data_type.h"
+#include "priv_arena.h"
 #include "priv_queue.h"
 
 #include <pthread.h>
@@ -33,6 +34,7 @@ typedef enum {
     NE_SERVER_MSG,
     NE_CLIENT_MSG,
     NE_SEND_IMMEDIATE_MSG,
+    NE_HOSTNAME_RESOLVED,
     UNKNOWN_NETWORK_EVENT_TYPE,
     NETWORK_EVENT_TYPE_COUNT
 } NetworkEventType;
@@ -47,8 +49,12 @@ typedef enum {
 typedef struct {
     EventType eventType;
     int subEventType;
-    DataType dataType;
-    DataItem dataItem;
+    union {
+        int fd;
+        int key;
+    };
+    int len;
+    const char *message;
 } Event;
 
 typedef void (*EvHandlerFunc)(Event *event);
@@ -60,8 +66,12 @@ typedef struct {
     EvHandlerFunc networkHandlers[NETWORK_EVENT_TYPE_COUNT];
     EvHandlerFunc systemHandlers[SYSTEM_EVENT_TYPE_COUNT];;
     Queue *eventQueue;
+    Arena *messageArena;
+    Event poppedEvent;
     pthread_mutex_t mutex;
     pthread_cond_t cond;     
+    int maxCapacity;
+    int highWaterMark;
     int droppedEvents;
     bool stopProcessing;
 } EventManager;
@@ -69,7 +79,7 @@ typedef struct {
 EventManager * create_event_manager(int capacity);
 void delete_event_manager(EventManager *eventManager);
 
-Event * create_event(EventType type, int subEventType, DataItem dataItem, DataType dataType);
+Event * create_event(EventType type, int subEventType, int fd);
 void delete_event(Event *event);
 
 void register_base_event_handler(EventManager *manager, EventType type, EvHandlerFunc handler);
@@ -83,10 +93,16 @@ void dispatch_system_event(EventManager *manager, Event *event);
 void dispatch_network_event(EventManager *manager, Event *event);
 
 void push_event_to_queue(EventManager *manager, Event *event);
+void push_message_event_to_queue(EventManager *manager, Event *event, const char *message, int len);
 Event * pop_event_from_queue(EventManager *manager);
+bool is_event_queue_empty(EventManager *manager);
+
+int get_event_queue_high_water_mark(EventManager *manager);
+int get_dropped_events(EventManager *manager);
 
 EventType get_event_type(Event *event);
-DataItem * get_event_data_item(Event *event);
+int get_event_fd(Event *event);
+const char * get_event_message(Event *event);
 
 const char ** get_event_type_strings(void);
 
@@ -0,0 +1,34 @@
+/* --INTERNAL HEADER--
+   used for testing */
+#ifndef FD_TABLE_H
+#define FD_TABLE_H
+
+typedef struct {
+    int pollIdx;
+    int clientIdx;
+} FdEntry;
+
+typedef struct {
+    FdEntry *entries;
+    int capacity;
+} FdTable;
+
+FdTable * create_fd_table(int capacity);
+void delete_fd_table(FdTable *fdTable);
+
+void set_fd_poll_idx(FdTable *fdTable, int fd, int pollIdx);
+void set_fd_client_idx(FdTable *fdTable, int fd, int clientIdx);
+
+int get_fd_poll_idx(FdTable *fdTable, int fd);
+int get_fd_client_idx(FdTable *fdTable, int fd);
+
+int get_fd_table_capacity(FdTable *fdTable);
+
+#ifdef TEST
+
+FdEntry * get_fd_entry(FdTable *fdTable, int fd);
+void resize_fd_table(FdTable *fdTable, int capacity);
+
+#endif
+
+#endif
@@ -0,0 +1,65 @@
+/* --INTERNAL HEADER--
+   used for testing */
+#ifndef FLAT_TABLE_H
+#define FLAT_TABLE_H
+
+#include "priv_hash_table.h"
+
+#include <stdbool.h>
+
+#define GROUP_SIZE 16
+#define EMPTY_SLOT -128
+#define DELETED_SLOT -2
+#define MAX_LOAD(capacity) ((capacity) - (capacity) / 8)
+
+typedef struct {
+    void *key;
+    void *value;
+    unsigned long hash;
+} FlatSlot;
+
+typedef struct {
+    signed char *ctrl;
+    FlatSlot *slots;
+    int capacity;
+    int count;
+    int deletedCount;
+} FlatArray;
+
+typedef struct {
+    FlatArray current;
+    FlatArray previous;
+    int migrateIdx;
+    HashFunc hashFunc;
+    ComparatorFunc comparatorFunc;
+    DeleteKeyFunc deleteKeyFunc;
+    DeleteValueFunc deleteValueFunc;
+} FlatTable;
+
+FlatTable * create_flat_table(int capacity, HashFunc hashFunc, ComparatorFunc comparatorFunc, DeleteKeyFunc deleteKeyFunc, DeleteValueFunc deleteValueFunc);
+void delete_flat_table(FlatTable *flatTable);
+
+int insert_to_flat_table(FlatTable *flatTable, void *key, void *value);
+int remove_from_flat_table(FlatTable *flatTable, void *key);
+void * release_from_flat_table(FlatTable *flatTable, void *key);
+void * find_in_flat_table(FlatTable *flatTable, void *key);
+
+bool is_flat_table_empty(FlatTable *flatTable);
+int get_flat_table_count(FlatTable *flatTable);
+int get_flat_table_capacity(FlatTable *flatTable);
+
+#ifdef TEST
+
+void create_flat_array(FlatArray *flatArray, int capacity);
+void delete_flat_array(FlatArray *flatArray);
+int find_flat_slot(FlatTable *flatTable, FlatArray *flatArray, void *key, unsigned long hash);
+void add_flat_slot(FlatArray *flatArray, void *key, void *value, unsigned long hash);
+void clear_flat_slot(FlatArray *flatArray, int index);
+int take_flat_slot(FlatTable *flatTable, void *key, FlatSlot *slot);
+void start_flat_table_resize(FlatTable *flatTable);
+void migrate_flat_slots(FlatTable *flatTable, int slotCount);
+int calculate_flat_capacity(int itemCount);
+
+#endif
+
+#endif
@@ -49,9 +49,16 @@ int get_total_items(HashTable *hashTable);
 
 unsigned long djb2_hash(void *key);
 unsigned long fnv1a_hash(void *key);
+unsigned long pointer_hash(void *key);
 
 bool are_strings_equal(void *key1, void *key2);
+bool are_strings_equal_rfc1459(void *key1, void *key2);
 bool are_ints_equal(void *key1, void *key2);
+bool are_pointers_equal(void *key1, void *key2);
+
+void init_hash_seed(void);
+void set_hash_seed(unsigned long key0, unsigned long key1);
+unsigned long siphash_rfc1459(void *key);
 
 #ifdef TEST
 
@@ -9,6 +9,19 @@ typedef bool (*ComparatorFunc)(void *data1, void *data2);
 typedef void (*DeleteDataFunc)(void *data);
 typedef void (*LinkedListFunc)(void *data, void *arg);
 
+typedef struct ListLink {
+    void *data;
+    struct ListLink *prev;
+    struct ListLink *next;
+    bool listed;
+} ListLink;
+
+typedef struct {
+    ListLink *head;
+    ListLink *tail;
+    int count;
+} IntrusiveList;
+
 typedef struct Node {
     void *data;
     struct Node *next;
@@ -43,6 +56,16 @@ Node * get_next(Node *node);
 
 int get_list_count(LinkedList *linkedList);
 
+void init_intrusive_list(IntrusiveList *list);
+void init_list_link(ListLink *link, void *data);
+
+int append_link(IntrusiveList *list, ListLink *link);
+int remove_link(IntrusiveList *list, ListLink *link);
+void * pop_link(IntrusiveList *list);
+
+bool is_link_listed(ListLink *link);
+int get_intrusive_list_count(IntrusiveList *list);
+
 #ifdef TEST
 
 void delete_node(Node *node, DeleteDataFunc deleteDataFunc);
@@ -47,8 +47,13 @@ void log_error(ErrorCode errorCode, const char *msg, const char *function, const
 const char ** get_log_level_strings(void);
 
 bool is_stdout_enabled(void);
+bool is_log_level_enabled(LogLevel level);
 void enable_stdout_logging(int stdoutEnabled);
 
+/* serialize logging from several threads, without
+    a dedicated logging thread */
+void enable_log_locking(int lockingEnabled);
+
 void set_log_thread(Thread *thread);
 void set_log_thread_callback(NotifyThreadFunc func);
 pthread_mutex_t * get_log_mutex(void);
@@ -3,43 +3,61 @@
 #ifndef POLL_MANAGER_H
 #define POLL_MANAGER_H
 
-#include "../../libs/src/hash_table.h"
+#include "../../libs/src/priv_fd_table.h"
 
 #include <stdbool.h>
+#include <sys/epoll.h>
 
 #define RESERVED_FDS 128
 #define DEF_FDS 512 + RESERVED_FDS
-#define MAX_FDS 1024 + RESERVED_FDS
+#define MAX_FDS 16384 + RESERVED_FDS
 
-typedef struct {
-    int fd;
-    int fdIdx;
-} FdIdxPair;
+/* requests edge triggered notifications. ignored
+    by the poll() backend */
+#define EDGE_TRIGGERED EPOLLET
+
+typedef enum {
+    POLL_BACKEND,
+    EPOLL_BACKEND,
+    UNKNOWN_POLL_BACKEND,
+    POLL_BACKEND_TYPE_COUNT
+} PollBackendType;
 
 typedef struct {
     struct pollfd *pfds;
-    HashTable *fdsIdxMap;
+    struct pollfd *readyPfds;
+    struct epoll_event *epollEvents;
+    FdTable *fdTable;
+    PollBackendType backendType;
+    int epollFd;
     int events;
     int count;
+    int readyCount;
     int capacity;
 } PollManager;
 
-PollManager * create_poll_manager(int capacity, int events);
+PollManager * create_poll_manager(int capacity, int events, PollBackendType backendType);
 void delete_poll_manager(PollManager *pollManager);
 
-FdIdxPair * create_pfd_idx_pair(int fd, int fdIdx);
-void delete_pfd_idx_pair(void *fdIdxPair);
+void set_poll_fd(PollManager *pollManager, int fd);
+void unset_poll_fd(PollManager *pollManager, int fd);
 
-bool are_pfd_idx_equal(void *fdIdxPair1, void *fdIdxPair2);
+void set_poll_fd_events(PollManager *pollManager, int fd, int events);
+int get_poll_fd_events(PollManager *pollManager, int fd);
 
-void add_fd_idx_to_hash_table(HashTable *hashTable, int fd, int fdIdx);
-void remove_fd_idx_from_hash_table(HashTable *hashTable, int fd);
-int find_fd_idx_in_hash_table(HashTable *hashTable, int fd);
+int wait_for_poll_events(PollManager *pollManager, int timeout);
 
-void set_poll_fd(PollManager *pollManager, int fd);
-void unset_poll_fd(PollManager *pollManager, int fd);
+int get_ready_fd(PollManager *pollManager, int readyIdx);
+int get_ready_revents(PollManager *pollManager, int readyIdx);
+
+bool is_ready_input_event(PollManager *pollManager, int readyIdx);
+bool is_ready_output_event(PollManager *pollManager, int readyIdx);
+bool is_ready_error_event(PollManager *pollManager, int readyIdx);
 
 struct pollfd * get_poll_pfds(PollManager *pollManager);
+
+int get_poll_fd_count(PollManager *pollManager);
+int get_poll_max_count(PollManager *pollManager);
 int get_poll_capacity(PollManager *pollManager);
 
 int get_poll_fd(PollManager *pollManager, int fd);
@@ -48,9 +66,15 @@ int get_poll_revents(PollManager *pollManager, int fd);
 bool is_fd_input_event(PollManager *pollManager, int fd);
 bool is_fd_error_event(PollManager *pollManager, int fd);
 
+FdTable * get_poll_fd_table(PollManager *pollManager);
+
+PollBackendType get_poll_backend_type(PollManager *pollManager);
+const char ** get_poll_backend_type_strings(void);
+
 #ifdef TEST
 
-int find_poll_fd_idx(PollManager *pollManager, int fd);
+int wait_for_poll(PollManager *pollManager, int timeout);
+int wait_for_epoll(PollManager *pollManager, int timeout);
 
 #endif
 
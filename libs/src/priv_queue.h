@@ -23,6 +23,7 @@ bool is_queue_empty(Queue *queue);
 bool is_queue_full(Queue *queue);
 
 void enqueue(Queue *queue, void *item);
+void resize_queue(Queue *queue, int capacity);
 void * dequeue(Queue *queue);
 
 void * get_previous_item(Queue *queue);
@@ -32,5 +33,6 @@ void * get_current_item(Queue *queue);
 void * get_item_at_idx(Queue *queue, int idx);
 
 int get_queue_capacity(Queue *queue);
+int get_queue_count(Queue *queue);
 
 #endif
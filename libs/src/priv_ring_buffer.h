@@ -0,0 +1,48 @@
+/* --INTERNAL HEADER--
+   used for testing */
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stdbool.h>
+
+#define RING_HEADER_SIZE 2
+#define MAX_RING_RECORD_LEN 0xFFFE
+#define WRAP_RECORD 0xFFFF
+
+typedef struct {
+    unsigned char *data;
+    int size;
+    int maxSize;
+    int head;
+    int tail;
+    int used;
+    int count;
+    bool overwrite;
+    int droppedCount;
+    int highWaterMark;
+} RingBuffer;
+
+RingBuffer * create_ring_buffer(int size, int maxSize);
+void delete_ring_buffer(RingBuffer *ringBuffer);
+
+int write_ring_record(RingBuffer *ringBuffer, const void *record, int length);
+void * read_ring_record(RingBuffer *ringBuffer, int *length);
+
+bool is_ring_buffer_empty(RingBuffer *ringBuffer);
+int get_ring_record_count(RingBuffer *ringBuffer);
+int get_ring_buffer_size(RingBuffer *ringBuffer);
+int get_ring_buffer_used(RingBuffer *ringBuffer);
+
+void set_ring_buffer_overwrite(RingBuffer *ringBuffer, bool overwrite);
+int get_ring_dropped_count(RingBuffer *ringBuffer);
+int get_ring_high_water_mark(RingBuffer *ringBuffer);
+
+#ifdef TEST
+
+int reserve_ring_space(RingBuffer *ringBuffer, int recordSize);
+void resize_ring_buffer(RingBuffer *ringBuffer, int size);
+void skip_ring_padding(RingBuffer *ringBuffer);
+
+#endif
+
+#endif
@@ -0,0 +1,23 @@
+/* --INTERNAL HEADER--
+   used for testing */
+#ifndef SHARED_BUFFER_H
+#define SHARED_BUFFER_H
+
+#include <stdatomic.h>
+
+typedef struct {
+    atomic_int refCount;
+    int len;
+    char data[];
+} SharedBuffer;
+
+SharedBuffer * create_shared_buffer(const char *data, int len, const char *suffix);
+
+void retain_shared_buffer(SharedBuffer *buffer);
+void release_shared_buffer(SharedBuffer *buffer);
+
+const char * get_shared_buffer_data(SharedBuffer *buffer);
+int get_shared_buffer_len(SharedBuffer *buffer);
+int get_shared_buffer_ref_count(SharedBuffer *buffer);
+
+#endif
@@ -0,0 +1,50 @@
+/* --INTERNAL HEADER--
+   used for testing */
+#ifndef SLAB_H
+#define SLAB_H
+
+#include "priv_linked_list.h"
+
+#define SLAB_SIZE 65536
+#define SLAB_ALIGNMENT 16
+
+typedef struct SlabAllocator SlabAllocator;
+
+typedef struct {
+    SlabAllocator *slabAllocator;
+    ListLink link;
+    void *freeObjects;
+    int carvedCount;
+    int usedCount;
+} Slab;
+
+struct SlabAllocator {
+    IntrusiveList partialSlabs;
+    IntrusiveList fullSlabs;
+    Slab *emptySlab;
+    int objectSize;
+    int capacity;
+    int slabCount;
+    int objectCount;
+    int highWaterMark;
+};
+
+SlabAllocator * create_slab_allocator(int objectSize);
+void delete_slab_allocator(SlabAllocator *slabAllocator);
+
+void * allocate_from_slab(SlabAllocator *slabAllocator);
+void release_to_slab(void *object);
+
+int get_slab_capacity(SlabAllocator *slabAllocator);
+int get_slab_count(SlabAllocator *slabAllocator);
+int get_slab_object_count(SlabAllocator *slabAllocator);
+int get_slab_high_water_mark(SlabAllocator *slabAllocator);
+
+#ifdef TEST
+
+Slab * create_slab(SlabAllocator *slabAllocator);
+Slab * get_object_slab(void *object);
+
+#endif
+
+#endif
@@ -58,6 +58,7 @@ int get_thread_id_by_range_idx(ThreadPool *threadPool, int rangeIdx);
 int get_thread_idx_by_range_idx(ThreadPool *threadPool, int rangeIdx);
 
 int get_thread_pipe_fd(ThreadData *threadData, int pipeIdx);
+StreamPipe * get_thread_pipe(ThreadData *threadData);
 
 void notify_single_thread(void *thread, const char *message);
 void notify_thread_pool(void *threadPool, const char *message);
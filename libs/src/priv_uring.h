@@ -0,0 +1,88 @@
+/* --INTERNAL HEADER--
+   used for testing */
+#ifndef URING_H
+#define URING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <linux/io_uring.h>
+
+#define DEF_URING_ENTRIES 256
+
+typedef struct {
+    int ringFd;
+    unsigned *sqHead;
+    unsigned *sqTail;
+    unsigned *sqMask;
+    unsigned *sqArray;
+    unsigned sqEntries;
+    struct io_uring_sqe *sqes;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned *cqMask;
+    struct io_uring_cqe *cqes;
+    void *sqRing;
+    size_t sqRingSize;
+    void *cqRing;
+    size_t cqRingSize;
+    size_t sqesSize;
+    int pendingCount;
+    struct io_uring_buf_ring *bufRing;
+    size_t bufRingSize;
+    char *buffers;
+    int bufCount;
+    int bufSize;
+    int groupId;
+} IoUring;
+
+/* a copy of a completion queue entry */
+typedef struct {
+    uint64_t userData;
+    int result;
+    unsigned flags;
+} UringCompletion;
+
+/* io_uring is accessed through raw system calls,
+    so no external library is required. submission
+    and completion rings are shared with the kernel */
+IoUring * create_io_uring(int entries);
+void delete_io_uring(IoUring *ioUring);
+
+/* register a ring of provided buffers. the kernel
+    selects one of these buffers when receiving data
+    with a multishot recv operation, so that buffers
+    need not be allocated for every connection */
+void register_uring_buffers(IoUring *ioUring, int groupId, int count, int size);
+
+char * get_uring_buffer(IoUring *ioUring, int bufferId);
+int get_uring_buffer_size(IoUring *ioUring);
+
+/* return buffer to the kernel after its data was
+    processed */
+void recycle_uring_buffer(IoUring *ioUring, int bufferId);
+
+void prep_uring_accept(IoUring *ioUring, int fd, uint64_t userData);
+void prep_uring_recv(IoUring *ioUring, int fd, uint64_t userData);
+void prep_uring_send(IoUring *ioUring, int fd, const void *buffer, int len, uint64_t userData);
+void prep_uring_poll(IoUring *ioUring, int fd, int events, uint64_t userData);
+void prep_uring_cancel_fd(IoUring *ioUring, int fd, uint64_t userData);
+
+/* submit prepared operations and wait for at least
+    waitCount completions */
+int submit_uring(IoUring *ioUring, int waitCount);
+
+bool get_uring_completion(IoUring *ioUring, UringCompletion *completion);
+
+/* multishot operation remains active if the
+    completion has the "more" flag set */
+bool has_uring_more(UringCompletion *completion);
+int get_uring_buffer_id(UringCompletion *completion);
+
+#ifdef TEST
+
+struct io_uring_sqe * get_uring_sqe(IoUring *ioUring);
+
+#endif
+
+#endif
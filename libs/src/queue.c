@@ -112,6 +112,36 @@ void enqueue(Queue *queue, void *item) {
     queue->currentIdx = queue->rear;
 }
 
+/* grow the queue to the new capacity. items are 
+    moved to the start of the buffer, so that the 
+    queue doesn't wrap around */
+void resize_queue(Queue *queue, int capacity) {
+
+    if (queue == NULL || capacity < queue->count) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    void *items = (void*) malloc(capacity * queue->itemSize);
+    if (items == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    for (int i = 0; i < queue->count; i++) {
+
+        int idx = (queue->front + i) % queue->capacity;
+
+        memcpy((unsigned char *) items + i * queue->itemSize, (unsigned char *) queue->items + idx * queue->itemSize, queue->itemSize);
+    }
+
+    free(queue->items);
+
+    queue->items = items;
+    queue->front = 0;
+    queue->rear = queue->count % capacity;
+    queue->currentIdx = queue->rear;
+    queue->capacity = capacity;
+}
+
 void * dequeue(Queue *queue) {
 
     if (queue == NULL) {
@@ -198,3 +228,11 @@ int get_queue_capacity(Queue *queue) {
     }
     return queue->capacity;
 }
+
+int get_queue_count(Queue *queue) {
+
+    if (queue == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+    return queue->count;
+}
@@ -5,7 +5,9 @@
 #include <stdbool.h>
 
 /* a fixed-size generic queue data structure, 
-    implemented as a circular buffer */
+    implemented as a circular buffer. enqueue 
+    overwrites the oldest item if the queue is 
+    full, unless the queue is grown first */
 typedef struct Queue Queue;
 
 Queue * create_queue(int capacity, int itemSize);
@@ -15,6 +17,7 @@ bool is_queue_empty(Queue *queue);
 bool is_queue_full(Queue *queue);
 
 void enqueue(Queue *queue, void *item);
+void resize_queue(Queue *queue, int capacity);
 void * dequeue(Queue *queue);
 
 /* below functions access the queue items without 
@@ -28,5 +31,6 @@ void * get_current_item(Queue *queue);
 void * get_item_at_idx(Queue *queue, int idx);
 
 int get_queue_capacity(Queue *queue);
+int get_queue_count(Queue *queue);
 
 #endif
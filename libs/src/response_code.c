@@ -18,6 +18,7 @@ struct ResponseCode {
     response messages based on the IRC standard */
 static const ResponseCode RESPONSE_CODES[] = {
     {RPL_WELCOME, "001", "Welcome to the IRC Network"},
+    {RPL_TRYAGAIN, "263", "Please wait a while and try again."},
     {RPL_WHOISUSER, "311", ""},
     {RPL_NOTOPIC, "331", "No topic is set"},
     {RPL_TOPIC, "332", ""},
@@ -4,6 +4,7 @@
 /* represents IRC response codes */
 typedef enum {
     RPL_WELCOME,
+    RPL_TRYAGAIN,
     RPL_WHOISUSER,
     RPL_NOTOPIC,
     RPL_TOPIC,
@@ -0,0 +1,340 @@
+#ifdef TEST
+#include "priv_ring_buffer.h"
+#else
+#include "ring_buffer.h"
+#endif
+
+#include "common.h"
+#include "error_control.h"
+#include "logger.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef TEST
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+#ifndef TEST
+
+#define WRAP_RECORD 0xFFFF
+
+/* records are read at the head and written at the 
+    tail. a record which doesn't fit at the end of 
+    the buffer is written at the start. the end is 
+    then marked as padding and counted as used until 
+    the reader skips it */
+struct RingBuffer {
+    unsigned char *data;
+    int size;
+    int maxSize;
+    int head;
+    int tail;
+    int used;
+    int count;
+    bool overwrite;
+    int droppedCount;
+    int highWaterMark;
+};
+
+#endif
+
+STATIC int reserve_ring_space(RingBuffer *ringBuffer, int recordSize);
+STATIC void resize_ring_buffer(RingBuffer *ringBuffer, int size);
+STATIC void skip_ring_padding(RingBuffer *ringBuffer);
+
+static inline int read_record_header(const unsigned char *data) {
+
+    uint16_t length;
+    memcpy(&length, data, RING_HEADER_SIZE);
+
+    return length;
+}
+
+static inline void write_record_header(unsigned char *data, int length) {
+
+    uint16_t header = length;
+    memcpy(data, &header, RING_HEADER_SIZE);
+}
+
+RingBuffer * create_ring_buffer(int size, int maxSize) {
+
+    if (size <= 0 || maxSize < size) {
+        LOG(NO_ERRCODE, "Invalid size");
+        return NULL;
+    }
+
+    RingBuffer *ringBuffer = (RingBuffer*) malloc(sizeof(RingBuffer));
+    if (ringBuffer == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    ringBuffer->data = (unsigned char*) malloc(size);
+    if (ringBuffer->data == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    ringBuffer->size = size;
+    ringBuffer->maxSize = maxSize;
+    ringBuffer->head = 0;
+    ringBuffer->tail = 0;
+    ringBuffer->used = 0;
+    ringBuffer->count = 0;
+    ringBuffer->overwrite = 1;
+    ringBuffer->droppedCount = 0;
+    ringBuffer->highWaterMark = 0;
+
+    return ringBuffer;
+}
+
+void delete_ring_buffer(RingBuffer *ringBuffer) {
+
+    if (ringBuffer != NULL) {
+        free(ringBuffer->data);
+    }
+    free(ringBuffer);
+}
+
+/* only the record is copied. the buffer grows when 
+    it's full and once it has reached its maximum 
+    size, the oldest records make room for the new 
+    one, unless the buffer doesn't overwrite them */
+int write_ring_record(RingBuffer *ringBuffer, const void *record, int length) {
+
+    if (ringBuffer == NULL || record == NULL || length < 0) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int recordSize = RING_HEADER_SIZE + length;
+
+    if (length > MAX_RING_RECORD_LEN || recordSize > ringBuffer->maxSize) {
+
+        ringBuffer->droppedCount++;
+        return 0;
+    }
+
+    int offset;
+
+    while ((offset = reserve_ring_space(ringBuffer, recordSize)) == UNASSIGNED) {
+
+        if (ringBuffer->size < ringBuffer->maxSize) {
+
+            int size = ringBuffer->size * 2;
+            resize_ring_buffer(ringBuffer, size < ringBuffer->maxSize ? size : ringBuffer->maxSize);
+        }
+        else if (ringBuffer->overwrite) {
+
+            read_ring_record(ringBuffer, NULL);
+            ringBuffer->droppedCount++;
+        }
+        else {
+
+            ringBuffer->droppedCount++;
+            return 0;
+        }
+    }
+
+    write_record_header(ringBuffer->data + offset, length);
+    memcpy(ringBuffer->data + offset + RING_HEADER_SIZE, record, length);
+
+    ringBuffer->tail = (offset + recordSize) % ringBuffer->size;
+    ringBuffer->used += recordSize;
+    ringBuffer->count++;
+
+    if (ringBuffer->used > ringBuffer->highWaterMark) {
+        ringBuffer->highWaterMark = ringBuffer->used;
+    }
+
+    return 1;
+}
+
+void * read_ring_record(RingBuffer *ringBuffer, int *length) {
+
+    if (ringBuffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    if (!ringBuffer->count) {
+        return NULL;
+    }
+
+    skip_ring_padding(ringBuffer);
+
+    int recordLength = read_record_header(ringBuffer->data + ringBuffer->head);
+    int recordSize = RING_HEADER_SIZE + recordLength;
+
+    void *record = ringBuffer->data + ringBuffer->head + RING_HEADER_SIZE;
+
+    ringBuffer->head = (ringBuffer->head + recordSize) % ringBuffer->size;
+    ringBuffer->used -= recordSize;
+    ringBuffer->count--;
+
+    if (length != NULL) {
+        *length = recordLength;
+    }
+
+    return record;
+}
+
+/* returns the offset of a contiguous space for the 
+    record or UNASSIGNED if there's none. if the 
+    record only fits at the start of the buffer, the 
+    end of the buffer becomes padding */
+STATIC int reserve_ring_space(RingBuffer *ringBuffer, int recordSize) {
+
+    if (ringBuffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    if (!ringBuffer->count) {
+
+        ringBuffer->head = 0;
+        ringBuffer->tail = 0;
+        ringBuffer->used = 0;
+
+        return recordSize <= ringBuffer->size ? 0 : UNASSIGNED;
+    }
+
+    int head = ringBuffer->head;
+    int tail = ringBuffer->tail;
+    int offset = UNASSIGNED;
+
+    if (tail > head) {
+
+        if (recordSize <= ringBuffer->size - tail) {
+            offset = tail;
+        }
+        else if (recordSize <= head) {
+
+            if (ringBuffer->size - tail >= RING_HEADER_SIZE) {
+                write_record_header(ringBuffer->data + tail, WRAP_RECORD);
+            }
+            ringBuffer->used += ringBuffer->size - tail;
+            offset = 0;
+        }
+    }
+    else if (tail < head && recordSize <= head - tail) {
+        offset = tail;
+    }
+
+    return offset;
+}
+
+/* the records are moved to the start of the new 
+    buffer, so that they don't wrap around */
+STATIC void resize_ring_buffer(RingBuffer *ringBuffer, int size) {
+
+    if (ringBuffer == NULL || size < ringBuffer->used) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    unsigned char *data = (unsigned char*) malloc(size);
+    if (data == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    int offset = 0;
+
+    for (int i = 0; i < ringBuffer->count; i++) {
+
+        skip_ring_padding(ringBuffer);
+
+        int recordSize = RING_HEADER_SIZE + read_record_header(ringBuffer->data + ringBuffer->head);
+
+        memcpy(data + offset, ringBuffer->data + ringBuffer->head, recordSize);
+        offset += recordSize;
+
+        ringBuffer->head = (ringBuffer->head + recordSize) % ringBuffer->size;
+    }
+
+    free(ringBuffer->data);
+
+    ringBuffer->data = data;
+    ringBuffer->size = size;
+    ringBuffer->head = 0;
+    ringBuffer->tail = offset % size;
+    ringBuffer->used = offset;
+}
+
+/* the end of the buffer is skipped if it's too 
+    short for a header or marked as padding */
+STATIC void skip_ring_padding(RingBuffer *ringBuffer) {
+
+    if (ringBuffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int head = ringBuffer->head;
+
+    if (ringBuffer->size - head < RING_HEADER_SIZE || read_record_header(ringBuffer->data + head) == WRAP_RECORD) {
+
+        ringBuffer->used -= ringBuffer->size - head;
+        ringBuffer->head = 0;
+    }
+}
+
+bool is_ring_buffer_empty(RingBuffer *ringBuffer) {
+
+    if (ringBuffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return ringBuffer->count == 0;
+}
+
+int get_ring_record_count(RingBuffer *ringBuffer) {
+
+    if (ringBuffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return ringBuffer->count;
+}
+
+int get_ring_buffer_size(RingBuffer *ringBuffer) {
+
+    if (ringBuffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return ringBuffer->size;
+}
+
+int get_ring_buffer_used(RingBuffer *ringBuffer) {
+
+    if (ringBuffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return ringBuffer->used;
+}
+
+void set_ring_buffer_overwrite(RingBuffer *ringBuffer, bool overwrite) {
+
+    if (ringBuffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    ringBuffer->overwrite = overwrite;
+}
+
+int get_ring_dropped_count(RingBuffer *ringBuffer) {
+
+    if (ringBuffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return ringBuffer->droppedCount;
+}
+
+int get_ring_high_water_mark(RingBuffer *ringBuffer) {
+
+    if (ringBuffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return ringBuffer->highWaterMark;
+}
@@ -0,0 +1,44 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stdbool.h>
+
+#define RING_HEADER_SIZE 2
+#define MAX_RING_RECORD_LEN 0xFFFE
+
+/* a byte oriented circular buffer which stores 
+    variable length records. each record is prefixed 
+    with its length and isn't split at the end of the 
+    buffer, so it's read in place. the buffer starts 
+    small and grows up to its maximum size. if it's 
+    still full, the oldest records are dropped or 
+    the new record is refused, depending on the 
+    overwrite flag */
+typedef struct RingBuffer RingBuffer;
+
+RingBuffer * create_ring_buffer(int size, int maxSize);
+void delete_ring_buffer(RingBuffer *ringBuffer);
+
+/* returns 0 if the record is larger than the 
+    buffer's maximum size or the buffer is full and 
+    doesn't overwrite its records */
+int write_ring_record(RingBuffer *ringBuffer, const void *record, int length);
+
+/* the record is valid until the next write. 
+    length may be NULL */
+void * read_ring_record(RingBuffer *ringBuffer, int *length);
+
+bool is_ring_buffer_empty(RingBuffer *ringBuffer);
+int get_ring_record_count(RingBuffer *ringBuffer);
+int get_ring_buffer_size(RingBuffer *ringBuffer);
+int get_ring_buffer_used(RingBuffer *ringBuffer);
+
+/* the oldest records are overwritten by default */
+void set_ring_buffer_overwrite(RingBuffer *ringBuffer, bool overwrite);
+/* number of records which were overwritten or 
+    refused */
+int get_ring_dropped_count(RingBuffer *ringBuffer);
+/* the largest number of bytes used */
+int get_ring_high_water_mark(RingBuffer *ringBuffer);
+
+#endif
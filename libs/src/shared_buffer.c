@@ -0,0 +1,93 @@
+#ifdef TEST
+#include "priv_shared_buffer.h"
+#else
+#include "shared_buffer.h"
+#endif
+
+#include "error_control.h"
+#include "logger.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#ifndef TEST
+
+/* the data is stored in the same allocation as 
+    the header and is null terminated. references 
+    may be released by different threads */
+struct SharedBuffer {
+    atomic_int refCount;
+    int len;
+    char data[];
+};
+
+#endif
+
+SharedBuffer * create_shared_buffer(const char *data, int len, const char *suffix) {
+
+    if (data == NULL || len < 0) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int suffixLen = suffix != NULL ? strlen(suffix) : 0;
+
+    SharedBuffer *buffer = (SharedBuffer*) malloc(sizeof(SharedBuffer) + len + suffixLen + 1);
+    if (buffer == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    memcpy(buffer->data, data, len);
+    memcpy(buffer->data + len, suffix != NULL ? suffix : "", suffixLen);
+
+    buffer->len = len + suffixLen;
+    buffer->data[buffer->len] = '\0';
+
+    atomic_init(&buffer->refCount, 1);
+
+    return buffer;
+}
+
+void retain_shared_buffer(SharedBuffer *buffer) {
+
+    if (buffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    atomic_fetch_add_explicit(&buffer->refCount, 1, memory_order_relaxed);
+}
+
+void release_shared_buffer(SharedBuffer *buffer) {
+
+    if (buffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    if (atomic_fetch_sub_explicit(&buffer->refCount, 1, memory_order_acq_rel) == 1) {
+        free(buffer);
+    }
+}
+
+const char * get_shared_buffer_data(SharedBuffer *buffer) {
+
+    if (buffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+    return buffer->data;
+}
+
+int get_shared_buffer_len(SharedBuffer *buffer) {
+
+    if (buffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+    return buffer->len;
+}
+
+int get_shared_buffer_ref_count(SharedBuffer *buffer) {
+
+    if (buffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+    return atomic_load_explicit(&buffer->refCount, memory_order_relaxed);
+}
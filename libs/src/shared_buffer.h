@@ -0,0 +1,25 @@
+#ifndef SHARED_BUFFER_H
+#define SHARED_BUFFER_H
+
+/* an immutable, reference counted byte buffer. 
+    a message which is sent to many recipients is 
+    stored once and each recipient holds a 
+    reference to it until the message is sent */
+typedef struct SharedBuffer SharedBuffer;
+
+/* create a buffer with a copy of the data, followed
+    by an optional suffix. the buffer is created 
+    with a single reference */
+SharedBuffer * create_shared_buffer(const char *data, int len, const char *suffix);
+
+void retain_shared_buffer(SharedBuffer *buffer);
+
+/* the buffer is deleted when the last reference 
+    is released */
+void release_shared_buffer(SharedBuffer *buffer);
+
+const char * get_shared_buffer_data(SharedBuffer *buffer);
+int get_shared_buffer_len(SharedBuffer *buffer);
+int get_shared_buffer_ref_count(SharedBuffer *buffer);
+
+#endif
@@ -0,0 +1,254 @@
+#define _POSIX_C_SOURCE 200809L
+
+#ifdef TEST
+#include "priv_slab.h"
+#else
+#include "slab.h"
+#include "linked_list.h"
+#endif
+
+#include "error_control.h"
+#include "logger.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#ifdef TEST
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+#ifndef TEST
+
+#define SLAB_SIZE 65536
+#define SLAB_ALIGNMENT 16
+
+/* a slab starts at an address aligned to its size
+    and its objects follow the header. objects are
+    taken from the free objects first and then
+    carved from the unused end of the slab */
+typedef struct {
+    SlabAllocator *slabAllocator;
+    ListLink link;
+    void *freeObjects;
+    int carvedCount;
+    int usedCount;
+} Slab;
+
+/* slabs with free objects are on the partial list.
+    objects are taken from the slabs which are in
+    use before the empty slab */
+struct SlabAllocator {
+    IntrusiveList partialSlabs;
+    IntrusiveList fullSlabs;
+    Slab *emptySlab;
+    int objectSize;
+    int capacity;
+    int slabCount;
+    int objectCount;
+    int highWaterMark;
+};
+
+#endif
+
+#define ALIGN_SIZE(size) (((size) + SLAB_ALIGNMENT - 1) & ~(SLAB_ALIGNMENT - 1))
+#define SLAB_HEADER_SIZE ALIGN_SIZE((int) sizeof(Slab))
+
+STATIC Slab * create_slab(SlabAllocator *slabAllocator);
+STATIC Slab * get_object_slab(void *object);
+
+SlabAllocator * create_slab_allocator(int objectSize) {
+
+    if (objectSize <= 0 || ALIGN_SIZE(objectSize) > SLAB_SIZE - SLAB_HEADER_SIZE) {
+        LOG(NO_ERRCODE, "Invalid object size");
+        return NULL;
+    }
+
+    SlabAllocator *slabAllocator = (SlabAllocator*) malloc(sizeof(SlabAllocator));
+    if (slabAllocator == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    init_intrusive_list(&slabAllocator->partialSlabs);
+    init_intrusive_list(&slabAllocator->fullSlabs);
+    slabAllocator->emptySlab = NULL;
+
+    /* a free object holds the pointer to the next
+        free object */
+    objectSize = objectSize < (int) sizeof(void*) ? (int) sizeof(void*) : objectSize;
+
+    slabAllocator->objectSize = ALIGN_SIZE(objectSize);
+    slabAllocator->capacity = (SLAB_SIZE - SLAB_HEADER_SIZE) / slabAllocator->objectSize;
+    slabAllocator->slabCount = 0;
+    slabAllocator->objectCount = 0;
+    slabAllocator->highWaterMark = 0;
+
+    return slabAllocator;
+}
+
+void delete_slab_allocator(SlabAllocator *slabAllocator) {
+
+    if (slabAllocator != NULL) {
+
+        Slab *slab = NULL;
+
+        while ((slab = pop_link(&slabAllocator->partialSlabs)) != NULL) {
+            free(slab);
+        }
+        while ((slab = pop_link(&slabAllocator->fullSlabs)) != NULL) {
+            free(slab);
+        }
+    }
+    free(slabAllocator);
+}
+
+STATIC Slab * create_slab(SlabAllocator *slabAllocator) {
+
+    if (slabAllocator == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    void *memory = NULL;
+
+    if (posix_memalign(&memory, SLAB_SIZE, SLAB_SIZE) != 0) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    Slab *slab = (Slab*) memory;
+
+    slab->slabAllocator = slabAllocator;
+    init_list_link(&slab->link, slab);
+    slab->freeObjects = NULL;
+    slab->carvedCount = 0;
+    slab->usedCount = 0;
+
+    slabAllocator->slabCount++;
+
+    return slab;
+}
+
+STATIC Slab * get_object_slab(void *object) {
+
+    return (Slab*) ((uintptr_t) object & ~((uintptr_t) SLAB_SIZE - 1));
+}
+
+void * allocate_from_slab(SlabAllocator *slabAllocator) {
+
+    if (slabAllocator == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    ListLink *link = slabAllocator->partialSlabs.head;
+
+    /* the empty slab is used only if it's the last
+        partial slab */
+    if (link != NULL && link->data == slabAllocator->emptySlab && link->next != NULL) {
+        link = link->next;
+    }
+    Slab *slab = link != NULL ? link->data : NULL;
+
+    if (slab == NULL) {
+
+        slab = create_slab(slabAllocator);
+        append_link(&slabAllocator->partialSlabs, &slab->link);
+    }
+    if (slab == slabAllocator->emptySlab) {
+        slabAllocator->emptySlab = NULL;
+    }
+
+    void *object = slab->freeObjects;
+
+    if (object != NULL) {
+        slab->freeObjects = *(void**) object;
+    }
+    else {
+        object = (unsigned char*) slab + SLAB_HEADER_SIZE + slab->carvedCount * slabAllocator->objectSize;
+        slab->carvedCount++;
+    }
+
+    if (++slab->usedCount == slabAllocator->capacity) {
+
+        remove_link(&slabAllocator->partialSlabs, &slab->link);
+        append_link(&slabAllocator->fullSlabs, &slab->link);
+    }
+
+    if (++slabAllocator->objectCount > slabAllocator->highWaterMark) {
+        slabAllocator->highWaterMark = slabAllocator->objectCount;
+    }
+
+    return object;
+}
+
+void release_to_slab(void *object) {
+
+    if (object == NULL) {
+        return;
+    }
+
+    Slab *slab = get_object_slab(object);
+    SlabAllocator *slabAllocator = slab->slabAllocator;
+
+    *(void**) object = slab->freeObjects;
+    slab->freeObjects = object;
+
+    if (slab->usedCount-- == slabAllocator->capacity) {
+
+        remove_link(&slabAllocator->fullSlabs, &slab->link);
+        append_link(&slabAllocator->partialSlabs, &slab->link);
+    }
+    slabAllocator->objectCount--;
+
+    if (!slab->usedCount) {
+
+        remove_link(&slabAllocator->partialSlabs, &slab->link);
+
+        /* the empty slab is reused before a new slab
+            is created */
+        if (slabAllocator->emptySlab == NULL) {
+
+            append_link(&slabAllocator->partialSlabs, &slab->link);
+            slabAllocator->emptySlab = slab;
+        }
+        else {
+            free(slab);
+            slabAllocator->slabCount--;
+        }
+    }
+}
+
+int get_slab_capacity(SlabAllocator *slabAllocator) {
+
+    if (slabAllocator == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return slabAllocator->capacity;
+}
+
+int get_slab_count(SlabAllocator *slabAllocator) {
+
+    if (slabAllocator == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return slabAllocator->slabCount;
+}
+
+int get_slab_object_count(SlabAllocator *slabAllocator) {
+
+    if (slabAllocator == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return slabAllocator->objectCount;
+}
+
+int get_slab_high_water_mark(SlabAllocator *slabAllocator) {
+
+    if (slabAllocator == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return slabAllocator->highWaterMark;
+}
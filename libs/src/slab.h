@@ -0,0 +1,26 @@
+#ifndef SLAB_H
+#define SLAB_H
+
+/* a pool of objects of the same size. objects are
+    carved from large aligned slabs, so the slab of
+    an object is found from its address and the
+    object is released without its allocator. one
+    empty slab is kept for reuse, the others are
+    freed */
+typedef struct SlabAllocator SlabAllocator;
+
+SlabAllocator * create_slab_allocator(int objectSize);
+void delete_slab_allocator(SlabAllocator *slabAllocator);
+
+void * allocate_from_slab(SlabAllocator *slabAllocator);
+void release_to_slab(void *object);
+
+/* number of objects which fit in a slab */
+int get_slab_capacity(SlabAllocator *slabAllocator);
+int get_slab_count(SlabAllocator *slabAllocator);
+/* number of allocated objects */
+int get_slab_object_count(SlabAllocator *slabAllocator);
+/* the largest number of allocated objects */
+int get_slab_high_water_mark(SlabAllocator *slabAllocator);
+
+#endif
@@ -367,6 +367,15 @@ int get_thread_pipe_fd(ThreadData *threadData, int pipeIdx) {
     return pipeFd;
 }
 
+StreamPipe * get_thread_pipe(ThreadData *threadData) {
+
+    if (threadData == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return threadData->streamPipe;
+}
+
 void notify_single_thread(void *thread, const char *message) {
 
     if (thread != NULL && message != NULL) {
@@ -1,6 +1,8 @@
 #ifndef THREADS_H
 #define THREADS_H
 
+#include "io_utils.h"
+
 #define READ_PIPE 0
 #define WRITE_PIPE 1
 #define PIPE_FD_COUNT 2
@@ -54,6 +56,7 @@ int get_thread_id_by_range_idx(ThreadPool *threadPool, int rangeIdx);
 int get_thread_idx_by_range_idx(ThreadPool *threadPool, int rangeIdx);
 
 int get_thread_pipe_fd(ThreadData *threadData, int pipeIdx);
+StreamPipe * get_thread_pipe(ThreadData *threadData);
 
 /* send a message to thread or thread pool */
 void notify_single_thread(void *thread, const char *message);
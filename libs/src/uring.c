@@ -0,0 +1,396 @@
+#ifdef TEST
+#include "priv_uring.h"
+#else
+#include "uring.h"
+#endif
+
+#include "common.h"
+#include "error_control.h"
+#include "logger.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/socket.h>
+#include <linux/io_uring.h>
+
+#ifdef TEST
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+#ifndef TEST
+
+struct IoUring {
+    int ringFd;
+    unsigned *sqHead;
+    unsigned *sqTail;
+    unsigned *sqMask;
+    unsigned *sqArray;
+    unsigned sqEntries;
+    struct io_uring_sqe *sqes;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned *cqMask;
+    struct io_uring_cqe *cqes;
+    void *sqRing;
+    size_t sqRingSize;
+    void *cqRing;
+    size_t cqRingSize;
+    size_t sqesSize;
+    int pendingCount;
+    struct io_uring_buf_ring *bufRing;
+    size_t bufRingSize;
+    char *buffers;
+    int bufCount;
+    int bufSize;
+    int groupId;
+};
+
+#endif
+
+STATIC struct io_uring_sqe * get_uring_sqe(IoUring *ioUring);
+
+IoUring * create_io_uring(int entries) {
+
+    IoUring *ioUring = (IoUring*) malloc(sizeof(IoUring));
+    if (ioUring == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    if (entries <= 0) {
+        entries = DEF_URING_ENTRIES;
+    }
+
+    /* multishot operations may post many completions
+        for a single submission, so the completion ring
+        is larger than the submission ring */
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = entries * 4;
+
+    ioUring->ringFd = syscall(__NR_io_uring_setup, entries, &params);
+    if (ioUring->ringFd < 0) {
+        FAILED(NO_ERRCODE, "Error creating io_uring instance");
+    }
+
+    ioUring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ioUring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+    /* since kernel 5.4 both rings are mapped with
+        a single mmap() call */
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+
+        if (ioUring->cqRingSize > ioUring->sqRingSize) {
+            ioUring->sqRingSize = ioUring->cqRingSize;
+        }
+        ioUring->cqRingSize = ioUring->sqRingSize;
+    }
+
+    ioUring->sqRing = mmap(NULL, ioUring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ioUring->ringFd, IORING_OFF_SQ_RING);
+    if (ioUring->sqRing == MAP_FAILED) {
+        FAILED(NO_ERRCODE, "Error mapping io_uring submission ring");
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ioUring->cqRing = ioUring->sqRing;
+    }
+    else {
+        ioUring->cqRing = mmap(NULL, ioUring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ioUring->ringFd, IORING_OFF_CQ_RING);
+        if (ioUring->cqRing == MAP_FAILED) {
+            FAILED(NO_ERRCODE, "Error mapping io_uring completion ring");
+        }
+    }
+
+    ioUring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    ioUring->sqes = mmap(NULL, ioUring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ioUring->ringFd, IORING_OFF_SQES);
+    if (ioUring->sqes == MAP_FAILED) {
+        FAILED(NO_ERRCODE, "Error mapping io_uring submission entries");
+    }
+
+    char *sqRing = ioUring->sqRing;
+    char *cqRing = ioUring->cqRing;
+
+    ioUring->sqHead = (unsigned*) (sqRing + params.sq_off.head);
+    ioUring->sqTail = (unsigned*) (sqRing + params.sq_off.tail);
+    ioUring->sqMask = (unsigned*) (sqRing + params.sq_off.ring_mask);
+    ioUring->sqArray = (unsigned*) (sqRing + params.sq_off.array);
+    ioUring->sqEntries = params.sq_entries;
+
+    ioUring->cqHead = (unsigned*) (cqRing + params.cq_off.head);
+    ioUring->cqTail = (unsigned*) (cqRing + params.cq_off.tail);
+    ioUring->cqMask = (unsigned*) (cqRing + params.cq_off.ring_mask);
+    ioUring->cqes = (struct io_uring_cqe*) (cqRing + params.cq_off.cqes);
+
+    ioUring->pendingCount = 0;
+    ioUring->bufRing = NULL;
+    ioUring->bufRingSize = 0;
+    ioUring->buffers = NULL;
+    ioUring->bufCount = 0;
+    ioUring->bufSize = 0;
+    ioUring->groupId = UNASSIGNED;
+
+    return ioUring;
+}
+
+void delete_io_uring(IoUring *ioUring) {
+
+    if (ioUring != NULL) {
+
+        if (ioUring->bufRing != NULL) {
+            munmap(ioUring->bufRing, ioUring->bufRingSize);
+        }
+        free(ioUring->buffers);
+
+        munmap(ioUring->sqes, ioUring->sqesSize);
+        if (ioUring->cqRing != ioUring->sqRing) {
+            munmap(ioUring->cqRing, ioUring->cqRingSize);
+        }
+        munmap(ioUring->sqRing, ioUring->sqRingSize);
+        close(ioUring->ringFd);
+    }
+    free(ioUring);
+}
+
+void register_uring_buffers(IoUring *ioUring, int groupId, int count, int size) {
+
+    /* the number of ring entries must be a power of 2 */
+    if (ioUring == NULL || ioUring->bufRing != NULL || count <= 0 || count > 32768 || (count & (count - 1)) || size <= 0) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    ioUring->bufRingSize = count * sizeof(struct io_uring_buf);
+    ioUring->bufRing = mmap(NULL, ioUring->bufRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ioUring->bufRing == MAP_FAILED) {
+        FAILED(NO_ERRCODE, "Error mapping io_uring buffer ring");
+    }
+
+    ioUring->buffers = (char*) malloc(count * size);
+    if (ioUring->buffers == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    struct io_uring_buf_reg bufReg;
+    memset(&bufReg, 0, sizeof(bufReg));
+    bufReg.ring_addr = (uint64_t) (uintptr_t) ioUring->bufRing;
+    bufReg.ring_entries = count;
+    bufReg.bgid = groupId;
+
+    if (syscall(__NR_io_uring_register, ioUring->ringFd, IORING_REGISTER_PBUF_RING, &bufReg, 1) < 0) {
+        FAILED(NO_ERRCODE, "Error registering io_uring buffer ring");
+    }
+
+    ioUring->bufCount = count;
+    ioUring->bufSize = size;
+    ioUring->groupId = groupId;
+
+    for (int i = 0; i < count; i++) {
+        recycle_uring_buffer(ioUring, i);
+    }
+}
+
+char * get_uring_buffer(IoUring *ioUring, int bufferId) {
+
+    if (ioUring == NULL || bufferId < 0 || bufferId >= ioUring->bufCount) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return ioUring->buffers + bufferId * ioUring->bufSize;
+}
+
+int get_uring_buffer_size(IoUring *ioUring) {
+
+    if (ioUring == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return ioUring->bufSize;
+}
+
+void recycle_uring_buffer(IoUring *ioUring, int bufferId) {
+
+    if (ioUring == NULL || bufferId < 0 || bufferId >= ioUring->bufCount) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    /* the tail is only written by the application,
+        but the kernel must see the buffer before it
+        sees the updated tail */
+    unsigned short tail = ioUring->bufRing->tail;
+    struct io_uring_buf *buf = &ioUring->bufRing->bufs[tail & (ioUring->bufCount - 1)];
+
+    buf->addr = (uint64_t) (uintptr_t) get_uring_buffer(ioUring, bufferId);
+    buf->len = ioUring->bufSize;
+    buf->bid = bufferId;
+
+    __atomic_store_n(&ioUring->bufRing->tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+STATIC struct io_uring_sqe * get_uring_sqe(IoUring *ioUring) {
+
+    if (ioUring == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    unsigned tail = *ioUring->sqTail;
+
+    /* if the submission ring is full, pending entries
+        are submitted to make room for a new one */
+    if (tail - __atomic_load_n(ioUring->sqHead, __ATOMIC_ACQUIRE) == ioUring->sqEntries) {
+
+        submit_uring(ioUring, 0);
+
+        if (tail - __atomic_load_n(ioUring->sqHead, __ATOMIC_ACQUIRE) == ioUring->sqEntries) {
+            FAILED(NO_ERRCODE, "io_uring submission ring is full");
+        }
+    }
+
+    unsigned idx = tail & *ioUring->sqMask;
+    struct io_uring_sqe *sqe = &ioUring->sqes[idx];
+
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    ioUring->sqArray[idx] = idx;
+
+    __atomic_store_n(ioUring->sqTail, tail + 1, __ATOMIC_RELEASE);
+    ioUring->pendingCount++;
+
+    return sqe;
+}
+
+void prep_uring_accept(IoUring *ioUring, int fd, uint64_t userData) {
+
+    struct io_uring_sqe *sqe = get_uring_sqe(ioUring);
+
+    /* multishot accept posts a completion for every
+        accepted connection */
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = userData;
+}
+
+void prep_uring_recv(IoUring *ioUring, int fd, uint64_t userData) {
+
+    if (ioUring == NULL || ioUring->bufRing == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    struct io_uring_sqe *sqe = get_uring_sqe(ioUring);
+
+    /* multishot recv posts a completion whenever data
+        arrives, each time picking a buffer from the
+        registered buffer ring */
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = ioUring->groupId;
+    sqe->user_data = userData;
+}
+
+void prep_uring_send(IoUring *ioUring, int fd, const void *buffer, int len, uint64_t userData) {
+
+    if (buffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    struct io_uring_sqe *sqe = get_uring_sqe(ioUring);
+
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t) (uintptr_t) buffer;
+    sqe->len = len;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = userData;
+}
+
+void prep_uring_poll(IoUring *ioUring, int fd, int events, uint64_t userData) {
+
+    struct io_uring_sqe *sqe = get_uring_sqe(ioUring);
+
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->poll32_events = events;
+    sqe->user_data = userData;
+}
+
+void prep_uring_cancel_fd(IoUring *ioUring, int fd, uint64_t userData) {
+
+    struct io_uring_sqe *sqe = get_uring_sqe(ioUring);
+
+    /* cancel all pending operations on the fd */
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = fd;
+    sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+    sqe->user_data = userData;
+}
+
+int submit_uring(IoUring *ioUring, int waitCount) {
+
+    if (ioUring == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    unsigned flags = waitCount > 0 ? IORING_ENTER_GETEVENTS : 0;
+
+    int submitted = syscall(__NR_io_uring_enter, ioUring->ringFd, ioUring->pendingCount, waitCount, flags, NULL, 0);
+
+    if (submitted > 0) {
+        ioUring->pendingCount -= submitted;
+    }
+
+    return submitted;
+}
+
+bool get_uring_completion(IoUring *ioUring, UringCompletion *completion) {
+
+    if (ioUring == NULL || completion == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    unsigned head = *ioUring->cqHead;
+
+    if (head == __atomic_load_n(ioUring->cqTail, __ATOMIC_ACQUIRE)) {
+        return 0;
+    }
+
+    struct io_uring_cqe *cqe = &ioUring->cqes[head & *ioUring->cqMask];
+
+    completion->userData = cqe->user_data;
+    completion->result = cqe->res;
+    completion->flags = cqe->flags;
+
+    __atomic_store_n(ioUring->cqHead, head + 1, __ATOMIC_RELEASE);
+
+    return 1;
+}
+
+bool has_uring_more(UringCompletion *completion) {
+
+    if (completion == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return completion->flags & IORING_CQE_F_MORE;
+}
+
+int get_uring_buffer_id(UringCompletion *completion) {
+
+    if (completion == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int bufferId = UNASSIGNED;
+
+    if (completion->flags & IORING_CQE_F_BUFFER) {
+        bufferId = completion->flags >> IORING_CQE_BUFFER_SHIFT;
+    }
+
+    return bufferId;
+}
@@ -0,0 +1,54 @@
+#ifndef URING_H
+#define URING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DEF_URING_ENTRIES 256
+
+typedef struct IoUring IoUring;
+
+/* a copy of a completion queue entry */
+typedef struct {
+    uint64_t userData;
+    int result;
+    unsigned flags;
+} UringCompletion;
+
+/* io_uring is accessed through raw system calls,
+    so no external library is required. submission
+    and completion rings are shared with the kernel */
+IoUring * create_io_uring(int entries);
+void delete_io_uring(IoUring *ioUring);
+
+/* register a ring of provided buffers. the kernel
+    selects one of these buffers when receiving data
+    with a multishot recv operation, so that buffers
+    need not be allocated for every connection */
+void register_uring_buffers(IoUring *ioUring, int groupId, int count, int size);
+
+char * get_uring_buffer(IoUring *ioUring, int bufferId);
+int get_uring_buffer_size(IoUring *ioUring);
+
+/* return buffer to the kernel after its data was
+    processed */
+void recycle_uring_buffer(IoUring *ioUring, int bufferId);
+
+void prep_uring_accept(IoUring *ioUring, int fd, uint64_t userData);
+void prep_uring_recv(IoUring *ioUring, int fd, uint64_t userData);
+void prep_uring_send(IoUring *ioUring, int fd, const void *buffer, int len, uint64_t userData);
+void prep_uring_poll(IoUring *ioUring, int fd, int events, uint64_t userData);
+void prep_uring_cancel_fd(IoUring *ioUring, int fd, uint64_t userData);
+
+/* submit prepared operations and wait for at least
+    waitCount completions */
+int submit_uring(IoUring *ioUring, int waitCount);
+
+bool get_uring_completion(IoUring *ioUring, UringCompletion *completion);
+
+/* multishot operation remains active if the
+    completion has the "more" flag set */
+bool has_uring_more(UringCompletion *completion);
+int get_uring_buffer_id(UringCompletion *completion);
+
+#endif
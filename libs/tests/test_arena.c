@@ -0,0 +1,111 @@
+#include "../src/priv_arena.h"
+
+#include <check.h>
+#include <string.h>
+
+#define BLOCK_SIZE 64
+
+START_TEST(test_create_arena) {
+
+    Arena *arena = create_arena(BLOCK_SIZE);
+
+    ck_assert_ptr_ne(arena, NULL);
+    ck_assert_ptr_ne(arena->head, NULL);
+    ck_assert_ptr_eq(arena->current, arena->head);
+    ck_assert_int_eq(arena->head->size, BLOCK_SIZE);
+    ck_assert_int_eq(get_arena_used(arena), 0);
+
+    delete_arena(arena);
+}
+END_TEST
+
+START_TEST(test_allocate_from_arena) {
+
+    Arena *arena = create_arena(BLOCK_SIZE);
+
+    char *string1 = copy_to_arena(arena, "message1", strlen("message1"));
+    char *string2 = copy_to_arena(arena, "message2 and more", strlen("message2"));
+
+    ck_assert_str_eq(string1, "message1");
+    ck_assert_str_eq(string2, "message2");
+    ck_assert_int_eq(get_arena_used(arena), 32);
+
+    /* full block is followed by a new block and the 
+        earlier allocations stay in place */
+    char *string3 = allocate_from_arena(arena, BLOCK_SIZE);
+
+    ck_assert_ptr_ne(arena->head->next, NULL);
+    ck_assert_ptr_eq(arena->current, arena->head->next);
+    ck_assert_str_eq(string1, "message1");
+
+    /* allocations larger than the block size get a 
+        dedicated block */
+    allocate_from_arena(arena, BLOCK_SIZE * 2);
+
+    ck_assert_int_eq(arena->current->size, BLOCK_SIZE * 2);
+
+    /* blocks are reused after reset */
+    reset_arena(arena);
+
+    ck_assert_int_eq(get_arena_used(arena), 0);
+    ck_assert_ptr_eq(copy_to_arena(arena, "message4", strlen("message4")), string1);
+    ck_assert_ptr_eq(allocate_from_arena(arena, BLOCK_SIZE), string3);
+
+    delete_arena(arena);
+}
+END_TEST
+
+START_TEST(test_trim_arena_allocation) {
+
+    Arena *arena = create_arena(BLOCK_SIZE);
+
+    char *string1 = allocate_from_arena(arena, BLOCK_SIZE / 2);
+    strcpy(string1, "message1");
+
+    /* the unused space is taken by the next allocation */
+    trim_arena_allocation(arena, string1, strlen(string1) + 1);
+    ck_assert_int_eq(get_arena_used(arena), 16);
+
+    char *string2 = copy_to_arena(arena, "message2", strlen("message2"));
+
+    ck_assert_ptr_eq(string2, string1 + 16);
+    ck_assert_str_eq(string1, "message1");
+
+    delete_arena(arena);
+}
+END_TEST
+
+Suite* arena_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("Arena");
+    tc_core = tcase_create("Core");
+
+    // Add the test case to the test suite
+    tcase_add_test(tc_core, test_create_arena);
+    tcase_add_test(tc_core, test_allocate_from_arena);
+    tcase_add_test(tc_core, test_trim_arena_allocation);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+#ifdef TEST
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = arena_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
+
+#endif
@@ -2,10 +2,11 @@
 
 #include <check.h>
 #include <stdio.h>
+#include <string.h>
 
 static void print_message(Event *event) {
 
-    printf("%s\n", (char*)event->dataItem.itemChar);
+    printf("%s\n", event->message);
 }
 
 START_TEST(test_create_event_manager) {
@@ -23,13 +24,13 @@ END_TEST
 
 START_TEST(test_create_event) {
 
-    Event *event = create_event(UI_EVENT, UI_KEY, (DataItem) {.itemChar = "c"}, CHAR_TYPE);
+    Event *event = create_event(NETWORK_EVENT, NE_ADD_POLL_FD, 5);
 
     ck_assert_ptr_ne(event, NULL);
-    ck_assert_int_eq(event->eventType, UI_EVENT);
-    ck_assert_int_eq(event->subEventType, UI_KEY);
-    ck_assert_str_eq(event->dataItem.itemChar, "c");
-    ck_assert_int_eq(event->dataType, CHAR_TYPE);
+    ck_assert_int_eq(event->eventType, NETWORK_EVENT);
+    ck_assert_int_eq(event->subEventType, NE_ADD_POLL_FD);
+    ck_assert_int_eq(get_event_fd(event), 5);
+    ck_assert_ptr_eq(get_event_message(event), NULL);
 
     delete_event(event);
 
@@ -46,14 +47,85 @@ START_TEST(test_register_dispatch_event) {
     dispatch_base_event(manager, &(Event){
         .eventType = NETWORK_EVENT, 
         .subEventType = NE_CLIENT_MSG, 
-        .dataItem = (DataItem){.itemChar = "/privmsg john :hello!"}, 
-        .dataType = CHAR_TYPE
+        .message = "/privmsg john :hello!"
     });
 
     delete_event_manager(manager);
 }
 END_TEST
 
+START_TEST(test_event_queue_growth) {
+
+    EventManager *manager = create_event_manager(2);
+
+    for (int i = 0; i < 5; i++) {
+        push_event_to_queue(manager, &(Event){.eventType = NETWORK_EVENT, .subEventType = i});
+    }
+
+    /* events aren't overwritten when the initial 
+        capacity is exceeded */
+    ck_assert_int_eq(get_queue_capacity(manager->eventQueue), 8);
+    ck_assert_int_eq(get_event_queue_high_water_mark(manager), 5);
+    ck_assert_int_eq(get_dropped_events(manager), 0);
+
+    for (int i = 0; i < 5; i++) {
+
+        Event *event = pop_event_from_queue(manager);
+
+        ck_assert_ptr_eq(event, &manager->poppedEvent);
+        ck_assert_int_eq(event->subEventType, i);
+    }
+    ck_assert_ptr_eq(pop_event_from_queue(manager), NULL);
+
+    delete_event_manager(manager);
+}
+END_TEST
+
+START_TEST(test_event_queue_overflow) {
+
+    EventManager *manager = create_event_manager(2);
+    manager->maxCapacity = 4;
+
+    for (int i = 0; i < 6; i++) {
+        push_event_to_queue(manager, &(Event){.eventType = NETWORK_EVENT, .subEventType = i});
+    }
+
+    /* new events are dropped at the limit */
+    ck_assert_int_eq(get_queue_capacity(manager->eventQueue), 4);
+    ck_assert_int_eq(get_event_queue_high_water_mark(manager), 4);
+    ck_assert_int_eq(get_dropped_events(manager), 2);
+    ck_assert_int_eq(pop_event_from_queue(manager)->subEventType, 0);
+
+    delete_event_manager(manager);
+}
+END_TEST
+
+START_TEST(test_push_message_event) {
+
+    EventManager *manager = create_event_manager(0);
+
+    char message[] = "PRIVMSG john :hello!";
+
+    push_message_event_to_queue(manager, &(Event){.eventType = NETWORK_EVENT, .subEventType = NE_CLIENT_MSG, .fd = 5}, message, strlen("PRIVMSG john"));
+
+    /* the message is copied into the arena */
+    message[0] = '\0';
+
+    Event *event = pop_event_from_queue(manager);
+
+    ck_assert_int_eq(get_event_fd(event), 5);
+    ck_assert_int_eq(event->len, strlen("PRIVMSG john"));
+    ck_assert_str_eq(get_event_message(event), "PRIVMSG john");
+    ck_assert_int_gt(get_arena_used(manager->messageArena), 0);
+
+    /* the arena is reset once the queue is drained */
+    ck_assert_ptr_eq(pop_event_from_queue(manager), NULL);
+    ck_assert_int_eq(get_arena_used(manager->messageArena), 0);
+
+    delete_event_manager(manager);
+}
+END_TEST
+
 Suite* event_suite(void) {
     Suite *s;
     TCase *tc_core;
@@ -65,6 +137,9 @@ Suite* event_suite(void) {
     tcase_add_test(tc_core, test_create_event_manager);
     tcase_add_test(tc_core, test_create_event);
     tcase_add_test(tc_core, test_register_dispatch_event);
+    tcase_add_test(tc_core, test_event_queue_growth);
+    tcase_add_test(tc_core, test_event_queue_overflow);
+    tcase_add_test(tc_core, test_push_message_event);
 
     suite_add_tcase(s, tc_core);
 
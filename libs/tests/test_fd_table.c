@@ -0,0 +1,105 @@
+#include "../src/priv_fd_table.h"
+#include "../src/common.h"
+
+#include <check.h>
+
+#define FD_TABLE_CAPACITY 4
+#define TABLE_FD 3
+
+START_TEST(test_create_fd_table) {
+
+    FdTable *fdTable = create_fd_table(FD_TABLE_CAPACITY);
+
+    ck_assert_ptr_ne(fdTable, NULL);
+    ck_assert_ptr_ne(fdTable->entries, NULL);
+    ck_assert_int_eq(get_fd_table_capacity(fdTable), FD_TABLE_CAPACITY);
+    ck_assert_int_eq(fdTable->entries[0].pollIdx, UNASSIGNED);
+    ck_assert_int_eq(fdTable->entries[0].clientIdx, UNASSIGNED);
+
+    delete_fd_table(fdTable);
+}
+END_TEST
+
+START_TEST(test_set_fd_idx) {
+
+    FdTable *fdTable = create_fd_table(FD_TABLE_CAPACITY);
+
+    set_fd_poll_idx(fdTable, TABLE_FD, 1);
+    set_fd_client_idx(fdTable, TABLE_FD, 2);
+
+    ck_assert_int_eq(get_fd_poll_idx(fdTable, TABLE_FD), 1);
+    ck_assert_int_eq(get_fd_client_idx(fdTable, TABLE_FD), 2);
+
+    /* indices of an fd are independent */
+    set_fd_poll_idx(fdTable, TABLE_FD, UNASSIGNED);
+
+    ck_assert_int_eq(get_fd_poll_idx(fdTable, TABLE_FD), UNASSIGNED);
+    ck_assert_int_eq(get_fd_client_idx(fdTable, TABLE_FD), 2);
+
+    /* unknown fd's aren't found */
+    ck_assert_int_eq(get_fd_poll_idx(fdTable, TABLE_FD + 1), UNASSIGNED);
+    ck_assert_int_eq(get_fd_client_idx(fdTable, FD_TABLE_CAPACITY * 10), UNASSIGNED);
+    ck_assert_int_eq(get_fd_client_idx(fdTable, UNASSIGNED), UNASSIGNED);
+
+    delete_fd_table(fdTable);
+}
+END_TEST
+
+START_TEST(test_grow_fd_table) {
+
+    FdTable *fdTable = create_fd_table(FD_TABLE_CAPACITY);
+
+    set_fd_client_idx(fdTable, TABLE_FD, 0);
+
+    /* the table doubles or grows to fit the fd */
+    set_fd_client_idx(fdTable, FD_TABLE_CAPACITY, 1);
+
+    ck_assert_int_eq(get_fd_table_capacity(fdTable), FD_TABLE_CAPACITY * 2);
+
+    set_fd_poll_idx(fdTable, FD_TABLE_CAPACITY * 10, 2);
+
+    ck_assert_int_eq(get_fd_table_capacity(fdTable), FD_TABLE_CAPACITY * 10 + 1);
+    ck_assert_int_eq(get_fd_client_idx(fdTable, TABLE_FD), 0);
+    ck_assert_int_eq(get_fd_client_idx(fdTable, FD_TABLE_CAPACITY), 1);
+    ck_assert_int_eq(get_fd_poll_idx(fdTable, FD_TABLE_CAPACITY * 10), 2);
+    ck_assert_int_eq(get_fd_poll_idx(fdTable, FD_TABLE_CAPACITY * 10 - 1), UNASSIGNED);
+
+    delete_fd_table(fdTable);
+}
+END_TEST
+
+Suite* fd_table_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("Fd table");
+    tc_core = tcase_create("Core");
+
+    // Add the test case to the test suite
+    tcase_add_test(tc_core, test_create_fd_table);
+    tcase_add_test(tc_core, test_set_fd_idx);
+    tcase_add_test(tc_core, test_grow_fd_table);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+#ifdef TEST
+
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = fd_table_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
+
+#endif
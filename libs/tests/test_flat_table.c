@@ -0,0 +1,241 @@
+#include "../src/priv_flat_table.h"
+#include "../src/common.h"
+
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_ITEMS 5
+#define KEY_COUNT 200
+#define KEY_LEN 16
+
+static int values[] = {1, 2, 3, 4};
+
+static int deletedCount = 0;
+
+static void delete_value_stub(void *value) {
+
+    deletedCount++;
+}
+
+/* every key has the same hash, so they're all in
+    the same probe sequence */
+static unsigned long constant_hash(void *key) {
+
+    return 0;
+}
+
+START_TEST(test_create_flat_table) {
+
+    FlatTable *flatTable = create_flat_table(MAX_ITEMS, djb2_hash, are_strings_equal, NULL, NULL);
+
+    ck_assert_ptr_ne(flatTable, NULL);
+    ck_assert_int_eq(get_flat_table_capacity(flatTable), GROUP_SIZE);
+    ck_assert_int_eq(is_flat_table_empty(flatTable), 1);
+    ck_assert_int_eq(flatTable->current.ctrl[0], EMPTY_SLOT);
+    ck_assert_int_eq(flatTable->current.ctrl[GROUP_SIZE], EMPTY_SLOT);
+    ck_assert_int_eq(flatTable->previous.capacity, 0);
+
+    delete_flat_table(flatTable);
+
+    ck_assert_int_eq(calculate_flat_capacity(14), 16);
+    ck_assert_int_eq(calculate_flat_capacity(15), 32);
+    ck_assert_int_eq(calculate_flat_capacity(1024), 2048);
+}
+END_TEST
+
+START_TEST(test_insert_to_flat_table) {
+
+    FlatTable *flatTable = create_flat_table(MAX_ITEMS, djb2_hash, are_strings_equal, NULL, NULL);
+
+    ck_assert_int_eq(insert_to_flat_table(flatTable, "john", &values[0]), 1);
+    ck_assert_int_eq(insert_to_flat_table(flatTable, "mark", &values[1]), 1);
+
+    /* keys are unique */
+    ck_assert_int_eq(insert_to_flat_table(flatTable, "john", &values[2]), 0);
+    ck_assert_int_eq(get_flat_table_count(flatTable), 2);
+
+    ck_assert_int_eq(*(int*) find_in_flat_table(flatTable, "john"), 1);
+    ck_assert_int_eq(*(int*) find_in_flat_table(flatTable, "mark"), 2);
+    ck_assert_ptr_null(find_in_flat_table(flatTable, "jane"));
+
+    delete_flat_table(flatTable);
+}
+END_TEST
+
+START_TEST(test_remove_from_flat_table) {
+
+    deletedCount = 0;
+
+    FlatTable *flatTable = create_flat_table(MAX_ITEMS, constant_hash, are_strings_equal, NULL, delete_value_stub);
+
+    insert_to_flat_table(flatTable, "john", &values[0]);
+    insert_to_flat_table(flatTable, "mark", &values[1]);
+    insert_to_flat_table(flatTable, "jane", &values[2]);
+
+    ck_assert_int_eq(remove_from_flat_table(flatTable, "mark"), 1);
+    ck_assert_int_eq(remove_from_flat_table(flatTable, "mark"), 0);
+    ck_assert_int_eq(deletedCount, 1);
+    ck_assert_int_eq(get_flat_table_count(flatTable), 2);
+
+    /* no probe passes the removed slot, since its 
+        group has empty slots */
+    ck_assert_int_eq(flatTable->current.deletedCount, 0);
+    ck_assert_int_eq(*(int*) find_in_flat_table(flatTable, "jane"), 3);
+
+    insert_to_flat_table(flatTable, "mark", &values[3]);
+    ck_assert_int_eq(*(int*) find_in_flat_table(flatTable, "mark"), 4);
+
+    delete_flat_table(flatTable);
+
+    ck_assert_int_eq(deletedCount, 4);
+}
+END_TEST
+
+START_TEST(test_release_from_flat_table) {
+
+    deletedCount = 0;
+
+    FlatTable *flatTable = create_flat_table(MAX_ITEMS, pointer_hash, are_pointers_equal, NULL, delete_value_stub);
+
+    insert_to_flat_table(flatTable, &values[0], &values[1]);
+
+    ck_assert_ptr_eq(release_from_flat_table(flatTable, &values[0]), &values[1]);
+    ck_assert_ptr_null(release_from_flat_table(flatTable, &values[0]));
+    ck_assert_int_eq(is_flat_table_empty(flatTable), 1);
+    ck_assert_int_eq(deletedCount, 0);
+
+    /* the released value can be added under a new key */
+    insert_to_flat_table(flatTable, &values[2], &values[1]);
+    ck_assert_ptr_eq(find_in_flat_table(flatTable, &values[2]), &values[1]);
+
+    delete_flat_table(flatTable);
+}
+END_TEST
+
+START_TEST(test_flat_table_collisions) {
+
+    FlatTable *flatTable = create_flat_table(KEY_COUNT, constant_hash, are_strings_equal, NULL, NULL);
+
+    char keys[KEY_COUNT][KEY_LEN];
+
+    for (int i = 0; i < KEY_COUNT; i++) {
+
+        snprintf(keys[i], KEY_LEN, "key%d", i);
+        ck_assert_int_eq(insert_to_flat_table(flatTable, keys[i], keys[i]), 1);
+    }
+
+    /* colliding keys are spread over many groups, 
+        so the removed slots don't end the probe */
+    for (int i = 0; i < KEY_COUNT; i += 2) {
+        ck_assert_int_eq(remove_from_flat_table(flatTable, keys[i]), 1);
+    }
+    ck_assert_int_gt(flatTable->current.deletedCount, 0);
+
+    for (int i = 0; i < KEY_COUNT; i++) {
+
+        if (i % 2) {
+            ck_assert_ptr_eq(find_in_flat_table(flatTable, keys[i]), keys[i]);
+        }
+        else {
+            ck_assert_ptr_null(find_in_flat_table(flatTable, keys[i]));
+        }
+    }
+
+    delete_flat_table(flatTable);
+}
+END_TEST
+
+START_TEST(test_flat_table_resize) {
+
+    FlatTable *flatTable = create_flat_table(0, djb2_hash, are_strings_equal, NULL, NULL);
+
+    char keys[KEY_COUNT][KEY_LEN];
+    bool resizing = 0;
+
+    for (int i = 0; i < KEY_COUNT; i++) {
+
+        snprintf(keys[i], KEY_LEN, "key%d", i);
+        ck_assert_int_eq(insert_to_flat_table(flatTable, keys[i], keys[i]), 1);
+
+        resizing |= flatTable->previous.capacity != 0;
+
+        /* items are found while they're being moved */
+        for (int j = 0; j <= i; j++) {
+            ck_assert_ptr_eq(find_in_flat_table(flatTable, keys[j]), keys[j]);
+        }
+    }
+
+    ck_assert_int_eq(resizing, 1);
+    ck_assert_int_eq(get_flat_table_count(flatTable), KEY_COUNT);
+    ck_assert_int_ge(MAX_LOAD(get_flat_table_capacity(flatTable)), KEY_COUNT);
+
+    /* the previous array is released once it's empty */
+    migrate_flat_slots(flatTable, flatTable->previous.capacity);
+    ck_assert_int_eq(flatTable->previous.capacity, 0);
+    ck_assert_ptr_null(flatTable->previous.ctrl);
+
+    delete_flat_table(flatTable);
+}
+END_TEST
+
+START_TEST(test_flat_table_reclaim) {
+
+    FlatTable *flatTable = create_flat_table(0, djb2_hash, are_strings_equal, NULL, NULL);
+
+    char keys[KEY_COUNT][KEY_LEN];
+
+    /* removed slots are reclaimed without growing
+        the table */
+    for (int i = 0; i < KEY_COUNT; i++) {
+
+        snprintf(keys[i], KEY_LEN, "key%d", i);
+        insert_to_flat_table(flatTable, keys[i], keys[i]);
+        remove_from_flat_table(flatTable, keys[i]);
+    }
+
+    ck_assert_int_eq(is_flat_table_empty(flatTable), 1);
+    ck_assert_int_eq(get_flat_table_capacity(flatTable), GROUP_SIZE);
+
+    delete_flat_table(flatTable);
+}
+END_TEST
+
+Suite* flat_table_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("Flat table");
+    tc_core = tcase_create("Core");
+
+    // Add the test case to the test suite
+    tcase_add_test(tc_core, test_create_flat_table);
+    tcase_add_test(tc_core, test_insert_to_flat_table);
+    tcase_add_test(tc_core, test_remove_from_flat_table);
+    tcase_add_test(tc_core, test_release_from_flat_table);
+    tcase_add_test(tc_core, test_flat_table_collisions);
+    tcase_add_test(tc_core, test_flat_table_resize);
+    tcase_add_test(tc_core, test_flat_table_reclaim);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+#ifdef TEST
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = flat_table_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
+
+#endif
@@ -115,6 +115,31 @@ START_TEST(test_djb2_hash) {
 }
 END_TEST
 
+START_TEST(test_siphash_rfc1459) {
+
+    set_hash_seed(0x0706050403020100UL, 0x0f0e0d0c0b0a0908UL);
+
+    /* siphash-1-3 with the key 00 01 .. 0f */
+    ck_assert(siphash_rfc1459("john") == 0xc5bb18c5d0f9de25UL);
+    ck_assert(siphash_rfc1459("abcdefghijklmnop") == 0xa0a4466e7e02c46aUL);
+
+    /* strings are folded before they're hashed */
+    ck_assert(siphash_rfc1459("NICK[]\\~") == 0xa3b30a6275e1b1f1UL);
+    ck_assert(siphash_rfc1459("nick{}|^") == 0xa3b30a6275e1b1f1UL);
+    ck_assert(siphash_rfc1459("John") == siphash_rfc1459("jOHN"));
+
+    ck_assert_int_eq(are_strings_equal_rfc1459("John[1]", "jOHN{1}"), 1);
+    ck_assert_int_eq(are_strings_equal_rfc1459("John", "Johnny"), 0);
+    ck_assert_int_eq(are_strings_equal_rfc1459("John_", "John^"), 0);
+
+    /* the hash depends on the key */
+    unsigned long hash = siphash_rfc1459("john");
+
+    init_hash_seed();
+    ck_assert(siphash_rfc1459("john") != hash);
+}
+END_TEST
+
 START_TEST(test_fnv1a_hash) {
 
     unsigned long hash1 = fnv1a_hash(&(int){5});
@@ -165,6 +190,7 @@ Suite* hash_table_suite(void) {
     tcase_add_test(tc_core, test_remove_item_from_hash_table);
     tcase_add_test(tc_core, test_find_item_in_hash_table);
     tcase_add_test(tc_core, test_djb2_hash);
+    tcase_add_test(tc_core, test_siphash_rfc1459);
     tcase_add_test(tc_core, test_fnv1a_hash);
     tcase_add_test(tc_core, test_calculate_load_factor);
 
@@ -4,21 +4,44 @@
 #include "../../libs/src/response_code.h"
 
 #include <check.h>
-
-static void create_prefix(char *buffer, int size, void *arg) {
-
-    safe_copy(buffer, size, arg);
-}
+#include <string.h>
 
 START_TEST(test_create_irc_message) {
 
     char message[MAX_CHARS + 1] = {'\0'};
 
     const char *code = get_response_code(ERR_NICKNAMEINUSE);
-    create_irc_message(message, MAX_CHARS, &(IRCMessage){{code, "john"}, {get_response_message(code)}, 1, create_prefix, "irc.example.com"});
+    create_irc_message(message, MAX_CHARS, &(IRCMessage){{code, "john"}, {get_response_message(code)}, 1, ":irc.example.com"});
 
     ck_assert_str_eq(message, ":irc.example.com 433 john :Nickname is already in use");
 
+    /* empty tokens are skipped */
+    int len = create_irc_message(message, MAX_CHARS, &(IRCMessage){{"PART", "", "#general"}, {NULL, "bye"}, 1, NULL});
+
+    ck_assert_str_eq(message, "PART #general :bye");
+    ck_assert_int_eq(len, strlen(message));
+
+    /* the message which doesn't fit is discarded */
+    ck_assert_int_eq(create_irc_message(message, 10, &(IRCMessage){{"PRIVMSG", "#general"}, {"Hello"}, 1, ":john!john@irc.client.com"}), 0);
+    ck_assert_str_eq(message, "");
+}
+END_TEST
+
+START_TEST(test_create_irc_line) {
+
+    Arena *arena = create_arena(MAX_CHARS);
+
+    int len = 0;
+    const char *code = get_response_code(ERR_NICKNAMEINUSE);
+    const char *line = create_irc_line(arena, MAX_CHARS, &(IRCMessage){{code, "john"}, {get_response_message(code)}, 1, ":irc.example.com"}, &len);
+
+    ck_assert_str_eq(line, ":irc.example.com 433 john :Nickname is already in use");
+    ck_assert_int_eq(len, strlen(line));
+
+    /* the unused space is returned to the arena */
+    ck_assert_int_lt(get_arena_used(arena), MAX_CHARS);
+
+    delete_arena(arena);
 }
 END_TEST
 
@@ -31,6 +54,7 @@ Suite* irc_message_suite(void) {
 
     // Add the test case to the test suite
     tcase_add_test(tc_core, test_create_irc_message);
+    tcase_add_test(tc_core, test_create_irc_line);
 
     suite_add_tcase(s, tc_core);
 
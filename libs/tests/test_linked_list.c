@@ -168,6 +168,41 @@ START_TEST(test_iterate_list) {
 }
 END_TEST
 
+START_TEST(test_intrusive_list) {
+
+    IntrusiveList list;
+    init_intrusive_list(&list);
+
+    int values[] = {1, 2, 3};
+    ListLink links[ARRAY_SIZE(values)];
+
+    for (int i = 0; i < ARRAY_SIZE(values); i++) {
+
+        init_list_link(&links[i], &values[i]);
+        ck_assert_int_eq(append_link(&list, &links[i]), 1);
+    }
+
+    /* a listed link isn't added twice */
+    ck_assert_int_eq(append_link(&list, &links[0]), 0);
+    ck_assert_int_eq(get_intrusive_list_count(&list), 3);
+
+    ck_assert_int_eq(remove_link(&list, &links[1]), 1);
+    ck_assert_int_eq(remove_link(&list, &links[1]), 0);
+    ck_assert_int_eq(is_link_listed(&links[1]), 0);
+
+    ck_assert_ptr_eq(pop_link(&list), &values[0]);
+    ck_assert_ptr_eq(pop_link(&list), &values[2]);
+    ck_assert_ptr_null(pop_link(&list));
+
+    ck_assert_int_eq(get_intrusive_list_count(&list), 0);
+    ck_assert_ptr_null(list.tail);
+
+    /* a popped link may be listed again */
+    ck_assert_int_eq(append_link(&list, &links[0]), 1);
+    ck_assert_ptr_eq(list.head, &links[0]);
+}
+END_TEST
+
 Suite* linked_list_suite(void) {
     Suite *s;
     TCase *tc_core;
@@ -182,6 +217,7 @@ Suite* linked_list_suite(void) {
     tcase_add_test(tc_core, test_remove_node);
     tcase_add_test(tc_core, test_find_node);
     tcase_add_test(tc_core, test_iterate_list);
+    tcase_add_test(tc_core, test_intrusive_list);
 
     suite_add_tcase(s, tc_core);
 
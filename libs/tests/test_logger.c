@@ -15,6 +15,7 @@ START_TEST(test_create_logger) {
     ck_assert_int_eq(logger->capacity, DEF_LOG_FREQUENCY);
     ck_assert_int_eq(logger->currentCount, 0);
     ck_assert_int_eq(logger->totalCount, 0);
+    ck_assert_int_eq(is_log_level_enabled(DEBUG), 1);
 
     delete_logger(logger);
 }
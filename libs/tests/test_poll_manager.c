@@ -3,13 +3,14 @@
 
 #include <check.h>
 #include <poll.h>
+#include <unistd.h>
 
 #define POLL_FD 3
 #define POLL_FD_CAPACITY 5
 
 START_TEST(test_create_poll_manager) {
 
-    PollManager *pollManager = create_poll_manager(POLL_FD_CAPACITY, POLLIN);
+    PollManager *pollManager = create_poll_manager(POLL_FD_CAPACITY, POLLIN, POLL_BACKEND);
 
     ck_assert_ptr_ne(pollManager, NULL);
     ck_assert_ptr_ne(pollManager->pfds, NULL);
@@ -17,96 +18,182 @@ START_TEST(test_create_poll_manager) {
     ck_assert_int_eq(pollManager->pfds[0].events, POLLIN);
     ck_assert_int_eq(pollManager->count, 0);
     ck_assert_int_eq(pollManager->capacity, POLL_FD_CAPACITY);
+    ck_assert_int_eq(pollManager->backendType, POLL_BACKEND);
+    ck_assert_int_eq(pollManager->epollFd, UNASSIGNED);
+
+    delete_poll_manager(pollManager);
+
+    pollManager = create_poll_manager(POLL_FD_CAPACITY, POLLIN, EPOLL_BACKEND);
+
+    ck_assert_ptr_ne(pollManager, NULL);
+    ck_assert_int_eq(pollManager->backendType, EPOLL_BACKEND);
+    ck_assert_int_ne(pollManager->epollFd, UNASSIGNED);
+    ck_assert_ptr_ne(pollManager->epollEvents, NULL);
 
     delete_poll_manager(pollManager);
 }
 END_TEST
 
-START_TEST(test_create_pfd_idx_pair) {
+START_TEST(test_poll_fd_table) {
+
+    PollManager *pollManager = create_poll_manager(POLL_FD_CAPACITY, POLLIN, POLL_BACKEND);
 
-    FdIdxPair *fdIdxPair = create_pfd_idx_pair(POLL_FD, 0);
+    set_poll_fd(pollManager, POLL_FD);
+    set_poll_fd(pollManager, POLL_FD + 1);
 
-    ck_assert_ptr_ne(fdIdxPair, NULL);
-    ck_assert_int_eq(fdIdxPair->fd, POLL_FD);
-    ck_assert_int_eq(fdIdxPair->fdIdx, 0);
+    ck_assert_ptr_eq(get_poll_fd_table(pollManager), pollManager->fdTable);
+    ck_assert_int_eq(get_fd_poll_idx(pollManager->fdTable, POLL_FD), 0);
+    ck_assert_int_eq(get_fd_poll_idx(pollManager->fdTable, POLL_FD + 1), 1);
 
-    delete_pfd_idx_pair(fdIdxPair);
+    unset_poll_fd(pollManager, POLL_FD);
+
+    ck_assert_int_eq(get_fd_poll_idx(pollManager->fdTable, POLL_FD), UNASSIGNED);
+    ck_assert_int_eq(get_fd_poll_idx(pollManager->fdTable, POLL_FD + 1), 0);
+
+    delete_poll_manager(pollManager);
 }
 END_TEST
 
-START_TEST(test_are_pfd_idx_equal) {
+START_TEST(test_set_unset_poll_fd) {
+
+    PollManager *pollManager = create_poll_manager(POLL_FD_CAPACITY, POLLIN, POLL_BACKEND);
+
+    set_poll_fd(pollManager, POLL_FD);
+
+    int fdIdx = get_fd_poll_idx(pollManager->fdTable, POLL_FD);
+
+    ck_assert_int_eq(pollManager->pfds[fdIdx].fd, POLL_FD);
+    ck_assert_int_eq(pollManager->count, 1);
 
-    FdIdxPair *fdIdxPair1 = create_pfd_idx_pair(POLL_FD, 0);
-    FdIdxPair *fdIdxPair2 = create_pfd_idx_pair(POLL_FD + 1, 0);
+    unset_poll_fd(pollManager, POLL_FD);
 
-    ck_assert_int_ne(are_pfd_idx_equal(fdIdxPair1, fdIdxPair2), 1);
+    ck_assert_int_eq(pollManager->pfds[fdIdx].fd, UNASSIGNED);
+    ck_assert_int_eq(pollManager->count, 0);
+
+    delete_poll_manager(pollManager);
 
-    delete_pfd_idx_pair(fdIdxPair1);
-    delete_pfd_idx_pair(fdIdxPair2);
 }
 END_TEST
 
-START_TEST(test_find_poll_fd_idx) {
+START_TEST(test_get_poll_data) {
 
-    PollManager *pollManager = create_poll_manager(POLL_FD_CAPACITY, POLLIN);
+    PollManager *pollManager = create_poll_manager(POLL_FD_CAPACITY, POLLIN, POLL_BACKEND);
 
-    int fdIdx = find_poll_fd_idx(pollManager, UNASSIGNED);
+    ck_assert_ptr_ne(get_poll_pfds(pollManager), NULL);
 
-    ck_assert_int_eq(fdIdx, 0);
+    set_poll_fd(pollManager, POLL_FD);
+    ck_assert_int_eq(get_poll_fd(pollManager, POLL_FD), POLL_FD);
 
     delete_poll_manager(pollManager);
 }
 END_TEST
 
-START_TEST(test_fd_idx_hash_table) {
+START_TEST(test_wait_for_poll_events) {
 
-    PollManager *pollManager = create_poll_manager(POLL_FD_CAPACITY, POLLIN);
+    PollBackendType backendTypes[] = {POLL_BACKEND, EPOLL_BACKEND};
 
-    add_fd_idx_to_hash_table(pollManager->fdsIdxMap, POLL_FD, 0);
+    for (int i = 0; i < ARRAY_SIZE(backendTypes); i++) {
 
-    int fdIdx = find_fd_idx_in_hash_table(pollManager->fdsIdxMap, POLL_FD);
+        PollManager *pollManager = create_poll_manager(POLL_FD_CAPACITY, POLLIN, backendTypes[i]);
 
-    ck_assert_int_eq(fdIdx, 0);
+        int pipeFds1[2], pipeFds2[2];
 
-    remove_fd_idx_from_hash_table(pollManager->fdsIdxMap, POLL_FD);
+        ck_assert_int_eq(pipe(pipeFds1), 0);
+        ck_assert_int_eq(pipe(pipeFds2), 0);
 
-    fdIdx = find_fd_idx_in_hash_table(pollManager->fdsIdxMap, POLL_FD);
+        set_poll_fd(pollManager, pipeFds1[0]);
+        set_poll_fd(pollManager, pipeFds2[0]);
 
-    ck_assert_int_eq(fdIdx, UNASSIGNED);
+        ck_assert_int_eq(wait_for_poll_events(pollManager, 0), 0);
 
-    delete_poll_manager(pollManager);
+        ck_assert_int_eq(write(pipeFds2[1], "a", 1), 1);
+
+        ck_assert_int_eq(wait_for_poll_events(pollManager, 0), 1);
+        ck_assert_int_eq(get_ready_fd(pollManager, 0), pipeFds2[0]);
+        ck_assert_int_eq(is_ready_input_event(pollManager, 0), 1);
+        ck_assert_int_eq(is_fd_input_event(pollManager, pipeFds2[0]), 1);
+        ck_assert_int_eq(is_fd_input_event(pollManager, pipeFds1[0]), 0);
+        ck_assert_int_eq(get_ready_fd(pollManager, 1), UNASSIGNED);
+
+        unset_poll_fd(pollManager, pipeFds2[0]);
+
+        ck_assert_int_eq(is_ready_input_event(pollManager, 0), 0);
+        ck_assert_int_eq(wait_for_poll_events(pollManager, 0), 0);
+
+        close(pipeFds2[1]);
+        close(pipeFds2[0]);
+
+        /* closing the write end signals hang up */
+        close(pipeFds1[1]);
+
+        ck_assert_int_eq(wait_for_poll_events(pollManager, 0), 1);
+        ck_assert_int_eq(get_ready_fd(pollManager, 0), pipeFds1[0]);
+        ck_assert_int_eq(is_ready_error_event(pollManager, 0), 1);
+
+        close(pipeFds1[0]);
+
+        delete_poll_manager(pollManager);
+    }
 }
 END_TEST
 
-START_TEST(test_set_unset_poll_fd) {
+START_TEST(test_set_poll_fd_events) {
 
-    PollManager *pollManager = create_poll_manager(POLL_FD_CAPACITY, POLLIN);
+    PollBackendType backendTypes[] = {POLL_BACKEND, EPOLL_BACKEND};
 
-    set_poll_fd(pollManager, POLL_FD);
+    for (int i = 0; i < ARRAY_SIZE(backendTypes); i++) {
 
-    int fdIdx = find_fd_idx_in_hash_table(pollManager->fdsIdxMap, POLL_FD);
+        PollManager *pollManager = create_poll_manager(POLL_FD_CAPACITY, POLLIN, backendTypes[i]);
 
-    ck_assert_int_eq(pollManager->pfds[fdIdx].fd, POLL_FD);
-    ck_assert_int_eq(pollManager->count, 1);
+        int pipeFds[2];
+        ck_assert_int_eq(pipe(pipeFds), 0);
 
-    unset_poll_fd(pollManager, POLL_FD);
+        set_poll_fd(pollManager, pipeFds[1]);
 
-    ck_assert_int_eq(pollManager->pfds[fdIdx].fd, UNASSIGNED);
-    ck_assert_int_eq(pollManager->count, 0);
+        ck_assert_int_eq(get_poll_fd_events(pollManager, pipeFds[1]), POLLIN);
+        ck_assert_int_eq(wait_for_poll_events(pollManager, 0), 0);
 
-    delete_poll_manager(pollManager);
+        set_poll_fd_events(pollManager, pipeFds[1], POLLIN | POLLOUT);
 
+        ck_assert_int_eq(get_poll_fd_events(pollManager, pipeFds[1]), POLLIN | POLLOUT);
+        ck_assert_int_eq(wait_for_poll_events(pollManager, 0), 1);
+        ck_assert_int_eq(is_ready_output_event(pollManager, 0), 1);
+        ck_assert_int_eq(is_ready_input_event(pollManager, 0), 0);
+
+        unset_poll_fd(pollManager, pipeFds[1]);
+
+        ck_assert_int_eq(get_poll_fd_events(pollManager, pipeFds[1]), 0);
+
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+
+        delete_poll_manager(pollManager);
+    }
 }
 END_TEST
 
-START_TEST(test_get_poll_data) {
-
-    PollManager *pollManager = create_poll_manager(POLL_FD_CAPACITY, POLLIN);
+START_TEST(test_get_poll_max_count) {
 
-    ck_assert_ptr_ne(get_poll_pfds(pollManager), NULL);
+    PollManager *pollManager = create_poll_manager(POLL_FD_CAPACITY, POLLIN, POLL_BACKEND);
 
     set_poll_fd(pollManager, POLL_FD);
-    ck_assert_int_eq(get_poll_fd(pollManager, POLL_FD), POLL_FD);
+    set_poll_fd(pollManager, POLL_FD + 1);
+
+    ck_assert_int_eq(get_poll_max_count(pollManager), 2);
+
+    /* the last fd is moved to the removed fd's 
+        entry */
+    unset_poll_fd(pollManager, POLL_FD);
+
+    ck_assert_int_eq(get_poll_max_count(pollManager), 1);
+    ck_assert_int_eq(get_poll_fd_count(pollManager), 1);
+    ck_assert_int_eq(pollManager->pfds[0].fd, POLL_FD + 1);
+    ck_assert_int_eq(pollManager->pfds[1].fd, UNASSIGNED);
+    ck_assert_int_eq(get_fd_poll_idx(pollManager->fdTable, POLL_FD + 1), 0);
+
+    unset_poll_fd(pollManager, POLL_FD + 1);
+
+    ck_assert_int_eq(get_poll_max_count(pollManager), 0);
 
     delete_poll_manager(pollManager);
 }
@@ -121,12 +208,12 @@ Suite* poll_manager_suite(void) {
 
     // Add the test case to the test suite
     tcase_add_test(tc_core, test_create_poll_manager);
-    tcase_add_test(tc_core, test_create_pfd_idx_pair);
-    tcase_add_test(tc_core, test_are_pfd_idx_equal);
-    tcase_add_test(tc_core, test_find_poll_fd_idx);
-    tcase_add_test(tc_core, test_fd_idx_hash_table);
+    tcase_add_test(tc_core, test_poll_fd_table);
     tcase_add_test(tc_core, test_set_unset_poll_fd);
     tcase_add_test(tc_core, test_get_poll_data);
+    tcase_add_test(tc_core, test_wait_for_poll_events);
+    tcase_add_test(tc_core, test_set_poll_fd_events);
+    tcase_add_test(tc_core, test_get_poll_max_count);
 
     suite_add_tcase(s, tc_core);
 
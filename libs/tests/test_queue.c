@@ -146,6 +146,36 @@ START_TEST(test_get_item) {
 END_TEST
 
 
+START_TEST(test_resize_queue) {
+
+    Queue *queue = create_queue(QUEUE_CAPACITY, sizeof(Message));
+
+    enqueue(queue, &(Message){"message1", "", MSG_STANDARD, NORMAL_PRIORTY});
+    enqueue(queue, &(Message){"message2", "", MSG_STANDARD, NORMAL_PRIORTY});
+    enqueue(queue, &(Message){"message3", "", MSG_STANDARD, NORMAL_PRIORTY});
+    dequeue(queue);
+    enqueue(queue, &(Message){"message4", "", MSG_STANDARD, NORMAL_PRIORTY});
+
+    /* items of a wrapped queue are kept in order */
+    resize_queue(queue, QUEUE_CAPACITY * 2);
+
+    ck_assert_int_eq(queue->front, 0);
+    ck_assert_int_eq(queue->rear, 3);
+    ck_assert_int_eq(queue->count, 3);
+    ck_assert_int_eq(queue->capacity, QUEUE_CAPACITY * 2);
+
+    enqueue(queue, &(Message){"message5", "", MSG_STANDARD, NORMAL_PRIORTY});
+
+    ck_assert_str_eq(((Message*) dequeue(queue))->content, "message2");
+    ck_assert_str_eq(((Message*) dequeue(queue))->content, "message3");
+    ck_assert_str_eq(((Message*) dequeue(queue))->content, "message4");
+    ck_assert_str_eq(((Message*) dequeue(queue))->content, "message5");
+    ck_assert_int_eq(get_queue_count(queue), 0);
+
+    delete_queue(queue);
+}
+END_TEST
+
 Suite* queue_suite(void) {
     Suite *s;
     TCase *tc_core;
@@ -160,6 +190,7 @@ Suite* queue_suite(void) {
     tcase_add_test(tc_core, test_enqueue);
     tcase_add_test(tc_core, test_dequeue);
     tcase_add_test(tc_core, test_get_item);
+    tcase_add_test(tc_core, test_resize_queue);
 
     suite_add_tcase(s, tc_core);
 
@@ -0,0 +1,209 @@
+#include "../src/priv_ring_buffer.h"
+#include "../src/common.h"
+
+#include <check.h>
+#include <stdio.h>
+#include <string.h>
+
+#define BUFFER_SIZE 16
+#define MAX_BUFFER_SIZE 64
+#define RECORD_LEN 24
+
+static void write_string(RingBuffer *ringBuffer, const char *string) {
+
+    ck_assert_int_eq(write_ring_record(ringBuffer, string, strlen(string) + 1), 1);
+}
+
+START_TEST(test_create_ring_buffer) {
+
+    RingBuffer *ringBuffer = create_ring_buffer(BUFFER_SIZE, MAX_BUFFER_SIZE);
+
+    ck_assert_ptr_ne(ringBuffer, NULL);
+    ck_assert_int_eq(ringBuffer->size, BUFFER_SIZE);
+    ck_assert_int_eq(ringBuffer->maxSize, MAX_BUFFER_SIZE);
+    ck_assert_int_eq(ringBuffer->used, 0);
+    ck_assert_int_eq(is_ring_buffer_empty(ringBuffer), 1);
+
+    delete_ring_buffer(ringBuffer);
+
+    ck_assert_ptr_null(create_ring_buffer(BUFFER_SIZE, BUFFER_SIZE - 1));
+}
+END_TEST
+
+START_TEST(test_write_read_ring_record) {
+
+    RingBuffer *ringBuffer = create_ring_buffer(BUFFER_SIZE, MAX_BUFFER_SIZE);
+
+    write_string(ringBuffer, "john");
+    write_string(ringBuffer, "mark");
+
+    /* only the record and its header are stored */
+    ck_assert_int_eq(get_ring_buffer_used(ringBuffer), 2 * (RING_HEADER_SIZE + 5));
+    ck_assert_int_eq(get_ring_record_count(ringBuffer), 2);
+
+    int length = 0;
+
+    ck_assert_str_eq(read_ring_record(ringBuffer, &length), "john");
+    ck_assert_int_eq(length, 5);
+    ck_assert_str_eq(read_ring_record(ringBuffer, NULL), "mark");
+    ck_assert_ptr_null(read_ring_record(ringBuffer, NULL));
+
+    ck_assert_int_eq(get_ring_buffer_used(ringBuffer), 0);
+
+    delete_ring_buffer(ringBuffer);
+}
+END_TEST
+
+START_TEST(test_ring_record_wrap) {
+
+    RingBuffer *ringBuffer = create_ring_buffer(BUFFER_SIZE, BUFFER_SIZE);
+
+    write_string(ringBuffer, "abcde");
+    write_string(ringBuffer, "fghij");
+    ck_assert_str_eq(read_ring_record(ringBuffer, NULL), "abcde");
+
+    /* the record doesn't fit at the end, so it's 
+        written at the start */
+    write_string(ringBuffer, "klm");
+    ck_assert_int_eq(ringBuffer->tail, RING_HEADER_SIZE + 4);
+    ck_assert_int_eq(get_ring_buffer_used(ringBuffer), BUFFER_SIZE - 8 + RING_HEADER_SIZE + 4);
+
+    ck_assert_str_eq(read_ring_record(ringBuffer, NULL), "fghij");
+    ck_assert_str_eq(read_ring_record(ringBuffer, NULL), "klm");
+    ck_assert_int_eq(get_ring_buffer_used(ringBuffer), 0);
+
+    delete_ring_buffer(ringBuffer);
+}
+END_TEST
+
+START_TEST(test_ring_buffer_grow) {
+
+    RingBuffer *ringBuffer = create_ring_buffer(BUFFER_SIZE, MAX_BUFFER_SIZE);
+
+    write_string(ringBuffer, "abcde");
+    write_string(ringBuffer, "fghij");
+    read_ring_record(ringBuffer, NULL);
+    write_string(ringBuffer, "klm");
+
+    /* wrapped records are kept in order */
+    write_string(ringBuffer, "nopqrstu");
+    ck_assert_int_eq(get_ring_buffer_size(ringBuffer), 2 * BUFFER_SIZE);
+    ck_assert_int_eq(ringBuffer->head, 0);
+
+    ck_assert_str_eq(read_ring_record(ringBuffer, NULL), "fghij");
+    ck_assert_str_eq(read_ring_record(ringBuffer, NULL), "klm");
+    ck_assert_str_eq(read_ring_record(ringBuffer, NULL), "nopqrstu");
+
+    delete_ring_buffer(ringBuffer);
+}
+END_TEST
+
+START_TEST(test_ring_buffer_overwrite) {
+
+    RingBuffer *ringBuffer = create_ring_buffer(BUFFER_SIZE, MAX_BUFFER_SIZE);
+
+    char record[RECORD_LEN] = {'\0'};
+
+    /* the oldest records are dropped once the 
+        buffer can't grow */
+    for (int i = 0; i < 20; i++) {
+
+        snprintf(record, sizeof(record), "record%d", i);
+        write_string(ringBuffer, record);
+    }
+
+    ck_assert_int_eq(get_ring_buffer_size(ringBuffer), MAX_BUFFER_SIZE);
+    ck_assert_int_le(get_ring_buffer_used(ringBuffer), MAX_BUFFER_SIZE);
+
+    int count = get_ring_record_count(ringBuffer);
+    ck_assert_int_eq(get_ring_dropped_count(ringBuffer), 20 - count);
+
+    for (int i = 20 - count; i < 20; i++) {
+
+        snprintf(record, sizeof(record), "record%d", i);
+        ck_assert_str_eq(read_ring_record(ringBuffer, NULL), record);
+    }
+
+    ck_assert_int_eq(is_ring_buffer_empty(ringBuffer), 1);
+
+    /* a record larger than the buffer isn't written */
+    char largeRecord[MAX_BUFFER_SIZE] = {'\0'};
+    ck_assert_int_eq(write_ring_record(ringBuffer, largeRecord, sizeof(largeRecord)), 0);
+    ck_assert_int_eq(get_ring_dropped_count(ringBuffer), 20 - count + 1);
+
+    delete_ring_buffer(ringBuffer);
+}
+END_TEST
+
+START_TEST(test_ring_buffer_refuse) {
+
+    RingBuffer *ringBuffer = create_ring_buffer(BUFFER_SIZE, MAX_BUFFER_SIZE);
+    set_ring_buffer_overwrite(ringBuffer, 0);
+
+    char record[RECORD_LEN] = {'\0'};
+    int written = 0;
+
+    /* new records are refused once the buffer 
+        can't grow */
+    for (int i = 0; i < 20; i++) {
+
+        snprintf(record, sizeof(record), "record%d", i);
+        written += write_ring_record(ringBuffer, record, strlen(record) + 1);
+    }
+
+    ck_assert_int_eq(get_ring_record_count(ringBuffer), written);
+    ck_assert_int_eq(get_ring_dropped_count(ringBuffer), 20 - written);
+    ck_assert_int_eq(get_ring_high_water_mark(ringBuffer), get_ring_buffer_used(ringBuffer));
+
+    for (int i = 0; i < written; i++) {
+
+        snprintf(record, sizeof(record), "record%d", i);
+        ck_assert_str_eq(read_ring_record(ringBuffer, NULL), record);
+    }
+
+    /* the high-water mark is kept after the 
+        records are read */
+    ck_assert_int_eq(get_ring_buffer_used(ringBuffer), 0);
+    ck_assert_int_gt(get_ring_high_water_mark(ringBuffer), MAX_BUFFER_SIZE / 2);
+
+    delete_ring_buffer(ringBuffer);
+}
+END_TEST
+
+Suite* ring_buffer_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("Ring buffer");
+    tc_core = tcase_create("Core");
+
+    // Add the test case to the test suite
+    tcase_add_test(tc_core, test_create_ring_buffer);
+    tcase_add_test(tc_core, test_write_read_ring_record);
+    tcase_add_test(tc_core, test_ring_record_wrap);
+    tcase_add_test(tc_core, test_ring_buffer_grow);
+    tcase_add_test(tc_core, test_ring_buffer_overwrite);
+    tcase_add_test(tc_core, test_ring_buffer_refuse);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+#ifdef TEST
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = ring_buffer_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
+
+#endif
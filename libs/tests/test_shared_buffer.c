@@ -0,0 +1,74 @@
+#include "../src/priv_shared_buffer.h"
+
+#include <check.h>
+#include <string.h>
+
+START_TEST(test_create_shared_buffer) {
+
+    SharedBuffer *buffer = create_shared_buffer("message", strlen("message"), "\r\n");
+
+    ck_assert_ptr_ne(buffer, NULL);
+    ck_assert_int_eq(get_shared_buffer_ref_count(buffer), 1);
+    ck_assert_int_eq(get_shared_buffer_len(buffer), strlen("message\r\n"));
+    ck_assert_str_eq(get_shared_buffer_data(buffer), "message\r\n");
+
+    release_shared_buffer(buffer);
+
+    buffer = create_shared_buffer("message", strlen("mess"), NULL);
+
+    ck_assert_int_eq(get_shared_buffer_len(buffer), strlen("mess"));
+    ck_assert_str_eq(get_shared_buffer_data(buffer), "mess");
+
+    release_shared_buffer(buffer);
+}
+END_TEST
+
+START_TEST(test_shared_buffer_refs) {
+
+    SharedBuffer *buffer = create_shared_buffer("message", strlen("message"), NULL);
+
+    retain_shared_buffer(buffer);
+    retain_shared_buffer(buffer);
+    ck_assert_int_eq(get_shared_buffer_ref_count(buffer), 3);
+
+    release_shared_buffer(buffer);
+    release_shared_buffer(buffer);
+    ck_assert_int_eq(get_shared_buffer_ref_count(buffer), 1);
+
+    release_shared_buffer(buffer);
+}
+END_TEST
+
+Suite* shared_buffer_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("Shared buffer");
+    tc_core = tcase_create("Core");
+
+    // Add the test case to the test suite
+    tcase_add_test(tc_core, test_create_shared_buffer);
+    tcase_add_test(tc_core, test_shared_buffer_refs);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+#ifdef TEST
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = shared_buffer_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,128 @@
+#include "../src/priv_slab.h"
+
+#include <check.h>
+#include <stdint.h>
+
+#define OBJECT_SIZE 100
+#define LARGE_OBJECT_SIZE 20000
+
+START_TEST(test_create_slab_allocator) {
+
+    SlabAllocator *slabAllocator = create_slab_allocator(OBJECT_SIZE);
+
+    ck_assert_ptr_ne(slabAllocator, NULL);
+    ck_assert_int_eq(slabAllocator->objectSize % SLAB_ALIGNMENT, 0);
+    ck_assert_int_ge(slabAllocator->objectSize, OBJECT_SIZE);
+    ck_assert_int_gt(get_slab_capacity(slabAllocator), 0);
+    ck_assert_int_eq(get_slab_count(slabAllocator), 0);
+
+    delete_slab_allocator(slabAllocator);
+
+    /* an object must fit in a slab */
+    ck_assert_ptr_null(create_slab_allocator(SLAB_SIZE));
+}
+END_TEST
+
+START_TEST(test_allocate_from_slab) {
+
+    SlabAllocator *slabAllocator = create_slab_allocator(OBJECT_SIZE);
+
+    void *object1 = allocate_from_slab(slabAllocator);
+    void *object2 = allocate_from_slab(slabAllocator);
+
+    ck_assert_ptr_ne(object1, object2);
+    ck_assert_int_eq((uintptr_t) object1 % SLAB_ALIGNMENT, 0);
+    ck_assert_ptr_eq(get_object_slab(object1), get_object_slab(object2));
+    ck_assert_ptr_eq(get_object_slab(object1)->slabAllocator, slabAllocator);
+    ck_assert_int_eq(get_slab_object_count(slabAllocator), 2);
+
+    /* the released object is reused first */
+    release_to_slab(object1);
+    ck_assert_ptr_eq(allocate_from_slab(slabAllocator), object1);
+
+    release_to_slab(object1);
+    release_to_slab(object2);
+
+    ck_assert_int_eq(get_slab_object_count(slabAllocator), 0);
+    ck_assert_int_eq(get_slab_high_water_mark(slabAllocator), 2);
+
+    delete_slab_allocator(slabAllocator);
+}
+END_TEST
+
+START_TEST(test_slab_growth) {
+
+    SlabAllocator *slabAllocator = create_slab_allocator(LARGE_OBJECT_SIZE);
+
+    int capacity = get_slab_capacity(slabAllocator);
+    void *objects[capacity + 1];
+
+    for (int i = 0; i <= capacity; i++) {
+        objects[i] = allocate_from_slab(slabAllocator);
+    }
+
+    /* the objects which don't fit get a new slab */
+    ck_assert_int_eq(get_slab_count(slabAllocator), 2);
+    ck_assert_int_eq(get_intrusive_list_count(&slabAllocator->fullSlabs), 1);
+    ck_assert_ptr_ne(get_object_slab(objects[0]), get_object_slab(objects[capacity]));
+
+    /* a full slab takes objects again once one of
+        its objects is released */
+    release_to_slab(objects[0]);
+    ck_assert_int_eq(get_intrusive_list_count(&slabAllocator->fullSlabs), 0);
+
+    /* only one empty slab is kept */
+    for (int i = 1; i <= capacity; i++) {
+        release_to_slab(objects[i]);
+    }
+
+    ck_assert_int_eq(get_slab_count(slabAllocator), 1);
+    ck_assert_ptr_ne(slabAllocator->emptySlab, NULL);
+    ck_assert_int_eq(get_slab_object_count(slabAllocator), 0);
+    ck_assert_int_eq(get_slab_high_water_mark(slabAllocator), capacity + 1);
+
+    /* the empty slab is reused */
+    void *object = allocate_from_slab(slabAllocator);
+
+    ck_assert_int_eq(get_slab_count(slabAllocator), 1);
+    ck_assert_ptr_null(slabAllocator->emptySlab);
+
+    release_to_slab(object);
+    delete_slab_allocator(slabAllocator);
+}
+END_TEST
+
+Suite* slab_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("Slab");
+    tc_core = tcase_create("Core");
+
+    // Add the test case to the test suite
+    tcase_add_test(tc_core, test_create_slab_allocator);
+    tcase_add_test(tc_core, test_allocate_from_slab);
+    tcase_add_test(tc_core, test_slab_growth);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+#ifdef TEST
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = slab_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,161 @@
+#include "../src/priv_uring.h"
+#include "../src/common.h"
+
+#include <check.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#define URING_ENTRIES 8
+#define BUFFER_COUNT 4
+#define BUFFER_SIZE 16
+#define USER_DATA 42
+
+START_TEST(test_create_io_uring) {
+
+    IoUring *ioUring = create_io_uring(URING_ENTRIES);
+
+    ck_assert_ptr_ne(ioUring, NULL);
+    ck_assert_int_ge(ioUring->ringFd, 0);
+    ck_assert_int_eq(ioUring->sqEntries, URING_ENTRIES);
+    ck_assert_int_eq(ioUring->pendingCount, 0);
+    ck_assert_ptr_eq(ioUring->bufRing, NULL);
+
+    delete_io_uring(ioUring);
+}
+END_TEST
+
+START_TEST(test_register_uring_buffers) {
+
+    IoUring *ioUring = create_io_uring(URING_ENTRIES);
+
+    register_uring_buffers(ioUring, 0, BUFFER_COUNT, BUFFER_SIZE);
+
+    ck_assert_ptr_ne(ioUring->bufRing, NULL);
+    ck_assert_int_eq(ioUring->bufRing->tail, BUFFER_COUNT);
+    ck_assert_int_eq(get_uring_buffer_size(ioUring), BUFFER_SIZE);
+    ck_assert_ptr_eq(get_uring_buffer(ioUring, 1), ioUring->buffers + BUFFER_SIZE);
+
+    delete_io_uring(ioUring);
+}
+END_TEST
+
+START_TEST(test_uring_poll) {
+
+    IoUring *ioUring = create_io_uring(URING_ENTRIES);
+
+    int pipeFds[2];
+    ck_assert_int_eq(pipe(pipeFds), 0);
+
+    prep_uring_poll(ioUring, pipeFds[0], POLLIN, USER_DATA);
+    ck_assert_int_eq(ioUring->pendingCount, 1);
+
+    ck_assert_int_eq(write(pipeFds[1], "a", 1), 1);
+    ck_assert_int_eq(submit_uring(ioUring, 1), 1);
+
+    UringCompletion completion;
+
+    ck_assert_int_eq(get_uring_completion(ioUring, &completion), 1);
+    ck_assert_int_eq(completion.userData, USER_DATA);
+    ck_assert_int_eq(completion.result & POLLIN, POLLIN);
+    ck_assert_int_eq(has_uring_more(&completion), 1);
+    ck_assert_int_eq(get_uring_completion(ioUring, &completion), 0);
+
+    close(pipeFds[0]);
+    close(pipeFds[1]);
+
+    delete_io_uring(ioUring);
+}
+END_TEST
+
+START_TEST(test_uring_send_recv) {
+
+    IoUring *ioUring = create_io_uring(URING_ENTRIES);
+    register_uring_buffers(ioUring, 0, BUFFER_COUNT, BUFFER_SIZE);
+
+    int sockFds[2];
+    ck_assert_int_eq(socketpair(AF_UNIX, SOCK_STREAM, 0, sockFds), 0);
+
+    prep_uring_recv(ioUring, sockFds[1], USER_DATA);
+    prep_uring_send(ioUring, sockFds[0], "message", strlen("message"), USER_DATA + 1);
+
+    ck_assert_int_eq(submit_uring(ioUring, 2), 2);
+
+    UringCompletion completion;
+    int received = 0, sent = 0;
+
+    while (get_uring_completion(ioUring, &completion)) {
+
+        if (completion.userData == USER_DATA) {
+
+            int bufferId = get_uring_buffer_id(&completion);
+
+            ck_assert_int_ne(bufferId, UNASSIGNED);
+            ck_assert_int_eq(completion.result, strlen("message"));
+            ck_assert_int_eq(memcmp(get_uring_buffer(ioUring, bufferId), "message", completion.result), 0);
+            ck_assert_int_eq(has_uring_more(&completion), 1);
+
+            recycle_uring_buffer(ioUring, bufferId);
+            received = 1;
+        }
+        else if (completion.userData == USER_DATA + 1) {
+
+            ck_assert_int_eq(completion.result, strlen("message"));
+            sent = 1;
+        }
+    }
+
+    ck_assert_int_eq(received, 1);
+    ck_assert_int_eq(sent, 1);
+
+    /* closing the peer ends multishot recv */
+    close(sockFds[0]);
+    ck_assert_int_ge(submit_uring(ioUring, 1), 0);
+
+    ck_assert_int_eq(get_uring_completion(ioUring, &completion), 1);
+    ck_assert_int_eq(completion.userData, USER_DATA);
+    ck_assert_int_eq(completion.result, 0);
+    ck_assert_int_eq(has_uring_more(&completion), 0);
+
+    close(sockFds[1]);
+
+    delete_io_uring(ioUring);
+}
+END_TEST
+
+Suite* uring_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("IO uring");
+    tc_core = tcase_create("Core");
+
+    // Add the test case to the test suite
+    tcase_add_test(tc_core, test_create_io_uring);
+    tcase_add_test(tc_core, test_register_uring_buffers);
+    tcase_add_test(tc_core, test_uring_poll);
+    tcase_add_test(tc_core, test_uring_send_recv);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+#ifdef TEST
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = uring_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,245 @@
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#define DEF_CLIENTS 40
+#define DEF_ROUNDS 500
+#define DEF_CHANNELS 10
+#define DEF_PORT 50100
+#define STALL_TIMEOUT 5000
+#define BUFFER_SIZE 4096
+#define MAX_LINE 512
+
+/* churn benchmark for the server. in every round
+    all clients connect, register, join a channel,
+    leave it and quit. clients share the channels, so
+    that channels are both created and joined. the
+    server allocates and frees a user, its channel
+    list and possibly a channel in every cycle. the
+    clients of a round connect at once, so their
+    number should stay below the server's listen
+    backlog. the result is the number of completed
+    cycles per second */
+
+typedef enum {
+    CONNECTING,
+    REGISTERED,
+    QUITTING,
+    CLOSED
+} ChurnState;
+
+typedef struct {
+    int fd;
+    ChurnState state;
+    char buffer[BUFFER_SIZE];
+    int len;
+} BenchClient;
+
+static double get_time(void) {
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void write_all(int fd, const char *data, int len) {
+
+    while (len > 0) {
+
+        ssize_t written = write(fd, data, len);
+
+        if (written < 0) {
+
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("write");
+            exit(EXIT_FAILURE);
+        }
+        data += written;
+        len -= written;
+    }
+}
+
+static int connect_client(const char *address, int port) {
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+    struct sockaddr_in servaddr = {.sin_family = AF_INET, .sin_port = htons(port)};
+    inet_pton(AF_INET, address, &servaddr.sin_addr);
+
+    if (fd < 0 || connect(fd, (struct sockaddr*) &servaddr, sizeof(servaddr)) < 0) {
+        perror("connect");
+        exit(EXIT_FAILURE);
+    }
+
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &(int){1}, sizeof(int));
+
+    return fd;
+}
+
+/* read available data and look for the welcome
+    message. the client is closed when the server
+    closes the connection after QUIT */
+static void read_client(BenchClient *client) {
+
+    ssize_t bytesRead = read(client->fd, client->buffer + client->len, BUFFER_SIZE - client->len - 1);
+
+    if (bytesRead < 0 && errno == EINTR) {
+        return;
+    }
+    if (bytesRead <= 0) {
+
+        if (client->state != QUITTING) {
+            fprintf(stderr, "Connection closed by the server\n");
+            exit(EXIT_FAILURE);
+        }
+        close(client->fd);
+        client->state = CLOSED;
+        return;
+    }
+
+    client->len += bytesRead;
+    client->buffer[client->len] = '\0';
+
+    char *line = client->buffer;
+    char *end = NULL;
+
+    while ((end = strstr(line, "\r\n")) != NULL) {
+
+        *end = '\0';
+
+        if (client->state == CONNECTING && strstr(line, " 001 ") != NULL) {
+            client->state = REGISTERED;
+        }
+        line = end + 2;
+    }
+
+    client->len -= line - client->buffer;
+    memmove(client->buffer, line, client->len);
+}
+
+/* wait for data on the clients which aren't closed
+    and read it. returns the number of ready clients */
+static int poll_clients(BenchClient *clients, struct pollfd *pfds, int count) {
+
+    for (int i = 0; i < count; i++) {
+        pfds[i].fd = clients[i].state != CLOSED ? clients[i].fd : -1;
+    }
+
+    int fdsReady = poll(pfds, count, STALL_TIMEOUT);
+
+    for (int i = 0; i < count && fdsReady > 0; i++) {
+
+        if (pfds[i].fd >= 0 && pfds[i].revents & (POLLIN | POLLERR | POLLHUP)) {
+            read_client(&clients[i]);
+        }
+    }
+    return fdsReady;
+}
+
+int main(int argc, char **argv) {
+
+    int clientCount = DEF_CLIENTS;
+    int rounds = DEF_ROUNDS;
+    int channelCount = DEF_CHANNELS;
+    int port = DEF_PORT;
+    const char *address = "127.0.0.1";
+
+    int opt;
+
+    while ((opt = getopt(argc, argv, "a:c:n:p:r:")) != -1) {
+
+        switch (opt) {
+            case 'a': address = optarg; break;
+            case 'c': channelCount = atoi(optarg); break;
+            case 'n': clientCount = atoi(optarg); break;
+            case 'p': port = atoi(optarg); break;
+            case 'r': rounds = atoi(optarg); break;
+            default:
+                printf("Usage: %s [-a <address>] [-c <channels>] [-n <clients>] [-p <port>] [-r <rounds>]\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (clientCount <= 0 || rounds <= 0 || channelCount <= 0) {
+        fprintf(stderr, "Invalid arguments\n");
+        exit(EXIT_FAILURE);
+    }
+
+    BenchClient *clients = (BenchClient*) calloc(clientCount, sizeof(BenchClient));
+    struct pollfd *pfds = (struct pollfd*) calloc(clientCount, sizeof(struct pollfd));
+
+    if (clients == NULL || pfds == NULL) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+
+    char message[MAX_LINE];
+    long cycles = 0;
+
+    double startTime = get_time();
+
+    for (int round = 0; round < rounds; round++) {
+
+        for (int i = 0; i < clientCount; i++) {
+
+            clients[i] = (BenchClient) {.fd = connect_client(address, port), .state = CONNECTING};
+            pfds[i] = (struct pollfd) {.fd = clients[i].fd, .events = POLLIN};
+
+            int len = snprintf(message, sizeof(message), "NICK c%d\r\nUSER bench 0 * :bench\r\n", i);
+            write_all(clients[i].fd, message, len);
+        }
+
+        int closedCount = 0;
+
+        /* registered clients join and leave their
+            channel and quit */
+        while (closedCount < clientCount) {
+
+            if (!poll_clients(clients, pfds, clientCount)) {
+                fprintf(stderr, "Completed %d of %d clients in round %d\n", closedCount, clientCount, round);
+                exit(EXIT_FAILURE);
+            }
+
+            closedCount = 0;
+
+            for (int i = 0; i < clientCount; i++) {
+
+                BenchClient *client = &clients[i];
+
+                if (client->state == REGISTERED) {
+
+                    int len = snprintf(message, sizeof(message), "JOIN #churn%d\r\nPART #churn%d\r\nQUIT\r\n", i % channelCount, i % channelCount);
+                    write_all(client->fd, message, len);
+
+                    client->state = QUITTING;
+                }
+                closedCount += client->state == CLOSED;
+            }
+        }
+
+        cycles += clientCount;
+    }
+
+    double elapsed = get_time() - startTime;
+
+    printf("clients: %d, rounds: %d, channels: %d, time: %.3f s, churn: %.0f cycles/s\n", clientCount, rounds, channelCount, elapsed, cycles / elapsed);
+
+    free(pfds);
+    free(clients);
+
+    return EXIT_SUCCESS;
+}
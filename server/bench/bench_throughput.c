@@ -0,0 +1,257 @@
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#define DEF_CLIENTS 100
+#define DEF_MESSAGES 1000
+#define DEF_WINDOW 16
+#define DEF_PORT 50100
+#define STALL_TIMEOUT 5000
+#define BUFFER_SIZE 65536
+#define MAX_LINE 512
+
+/* throughput benchmark for the server. clients are
+    connected in pairs and send private messages to
+    their partners. the number of messages in flight
+    is limited for every client, so that the
+    measurement isn't distorted by overflowing
+    queues. the result is the number of delivered
+    messages per second */
+
+typedef struct {
+    int fd;
+    int sent;
+    int received;
+    bool registered;
+    char buffer[BUFFER_SIZE];
+    int len;
+} BenchClient;
+
+static double get_time(void) {
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void write_all(int fd, const char *data, int len) {
+
+    while (len > 0) {
+
+        ssize_t written = write(fd, data, len);
+
+        if (written < 0) {
+
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("write");
+            exit(EXIT_FAILURE);
+        }
+        data += written;
+        len -= written;
+    }
+}
+
+static int connect_client(const char *address, int port) {
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+    struct sockaddr_in servaddr = {.sin_family = AF_INET, .sin_port = htons(port)};
+    inet_pton(AF_INET, address, &servaddr.sin_addr);
+
+    if (fd < 0 || connect(fd, (struct sockaddr*) &servaddr, sizeof(servaddr)) < 0) {
+        perror("connect");
+        exit(EXIT_FAILURE);
+    }
+
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &(int){1}, sizeof(int));
+
+    return fd;
+}
+
+/* read available data and count the received lines.
+    returns -1 if the server closed the connection */
+static int read_client(BenchClient *client) {
+
+    ssize_t bytesRead = read(client->fd, client->buffer + client->len, BUFFER_SIZE - client->len - 1);
+
+    if (bytesRead <= 0) {
+        return bytesRead < 0 && errno == EINTR ? 0 : -1;
+    }
+
+    client->len += bytesRead;
+    client->buffer[client->len] = '\0';
+
+    char *line = client->buffer;
+    char *end = NULL;
+
+    while ((end = strstr(line, "\r\n")) != NULL) {
+
+        *end = '\0';
+
+        if (strstr(line, " PRIVMSG ") != NULL) {
+            client->received++;
+        }
+        else if (strstr(line, " 001 ") != NULL) {
+            client->registered = 1;
+        }
+        line = end + 2;
+    }
+
+    client->len -= line - client->buffer;
+    memmove(client->buffer, line, client->len);
+
+    return bytesRead;
+}
+
+/* wait for data on all clients and read it. returns
+    the number of ready clients */
+static int poll_clients(BenchClient *clients, struct pollfd *pfds, int count) {
+
+    int fdsReady = poll(pfds, count, STALL_TIMEOUT);
+
+    for (int i = 0; i < count && fdsReady > 0; i++) {
+
+        if (pfds[i].revents & (POLLIN | POLLERR | POLLHUP)) {
+
+            if (read_client(&clients[i]) < 0) {
+                fprintf(stderr, "Connection closed by the server (client %d)\n", i);
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+    return fdsReady;
+}
+
+int main(int argc, char **argv) {
+
+    int clientCount = DEF_CLIENTS;
+    int messageCount = DEF_MESSAGES;
+    int window = DEF_WINDOW;
+    int port = DEF_PORT;
+    const char *address = "127.0.0.1";
+
+    int opt;
+
+    while ((opt = getopt(argc, argv, "a:m:n:p:w:")) != -1) {
+
+        switch (opt) {
+            case 'a': address = optarg; break;
+            case 'm': messageCount = atoi(optarg); break;
+            case 'n': clientCount = atoi(optarg); break;
+            case 'p': port = atoi(optarg); break;
+            case 'w': window = atoi(optarg); break;
+            default:
+                printf("Usage: %s [-a <address>] [-m <messages per client>] [-n <clients>] [-p <port>] [-w <messages in flight>]\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    /* clients are paired */
+    clientCount += clientCount % 2;
+
+    if (clientCount <= 0 || messageCount <= 0 || window <= 0) {
+        fprintf(stderr, "Invalid arguments\n");
+        exit(EXIT_FAILURE);
+    }
+
+    BenchClient *clients = (BenchClient*) calloc(clientCount, sizeof(BenchClient));
+    struct pollfd *pfds = (struct pollfd*) calloc(clientCount, sizeof(struct pollfd));
+
+    if (clients == NULL || pfds == NULL) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+
+    char message[MAX_LINE];
+
+    for (int i = 0; i < clientCount; i++) {
+
+        clients[i].fd = connect_client(address, port);
+        pfds[i] = (struct pollfd) {.fd = clients[i].fd, .events = POLLIN};
+
+        int len = snprintf(message, sizeof(message), "NICK b%d\r\nUSER bench 0 * :bench\r\n", i);
+        write_all(clients[i].fd, message, len);
+    }
+
+    /* messages are sent only between registered
+        clients */
+    int registeredCount = 0;
+
+    while (registeredCount < clientCount) {
+
+        if (!poll_clients(clients, pfds, clientCount)) {
+            fprintf(stderr, "Registered %d of %d clients\n", registeredCount, clientCount);
+            exit(EXIT_FAILURE);
+        }
+
+        registeredCount = 0;
+
+        for (int i = 0; i < clientCount; i++) {
+            registeredCount += clients[i].registered;
+        }
+    }
+
+    long totalMessages = (long) clientCount * messageCount;
+    long delivered = 0;
+
+    double startTime = get_time();
+
+    while (delivered < totalMessages) {
+
+        for (int i = 0; i < clientCount; i++) {
+
+            BenchClient *client = &clients[i];
+            int partner = i ^ 1;
+
+            char out[BUFFER_SIZE];
+            int outLen = 0;
+
+            while (client->sent < messageCount && client->sent - clients[partner].received < window && outLen < BUFFER_SIZE - MAX_LINE) {
+
+                outLen += snprintf(out + outLen, MAX_LINE, "PRIVMSG b%d :message %d\r\n", partner, client->sent);
+                client->sent++;
+            }
+
+            if (outLen) {
+                write_all(client->fd, out, outLen);
+            }
+        }
+
+        if (!poll_clients(clients, pfds, clientCount)) {
+            break;
+        }
+
+        delivered = 0;
+
+        for (int i = 0; i < clientCount; i++) {
+            delivered += clients[i].received;
+        }
+    }
+
+    double elapsed = get_time() - startTime;
+
+    printf("clients: %d, messages: %ld/%ld, time: %.3f s, throughput: %.0f msg/s\n", clientCount, delivered, totalMessages, elapsed, delivered / elapsed);
+
+    for (int i = 0; i < clientCount; i++) {
+        close(clients[i].fd);
+    }
+
+    free(pfds);
+    free(clients);
+
+    return delivered == totalMessages ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,32 @@
+#!/bin/bash
+
+# compare the throughput of the single threaded,
+# sharded and multithreaded server. run from the
+# server directory after "make" and "make bench"
+
+threads=${1:-$(nproc)}
+clients=${2:-100}
+messages=${3:-1000}
+
+server_bin="./bin/server"
+bench_bin="./bench/bin/bench_throughput"
+port=50100
+
+run_bench() {
+    local mode=$1
+    shift
+
+    $server_bin "$@" > /dev/null 2>&1 &
+    local server_pid=$!
+    sleep 1
+
+    echo -n "$mode: "
+    $bench_bin -n $clients -m $messages -p $port
+
+    kill $server_pid
+    wait $server_pid 2> /dev/null
+}
+
+run_bench "standard"
+run_bench "sharded ($threads)" -c $threads
+run_bench "multithreaded ($threads)" -t -c $threads
@@ -10,7 +10,10 @@
 #include "config.h"
 #include "../../libs/src/common.h"
 #include "../../libs/src/settings.h"
+#include "../../libs/src/enum_utils.h"
+#include "../../libs/src/irc_message.h"
 #include "../../libs/src/error_control.h"
+#include "../../libs/src/slab.h"
 #include "../../libs/src/logger.h"
 
 #include <stdlib.h>
@@ -24,6 +27,8 @@
 #endif
 
 #define MAX_CHANNEL_NAME 50
+#define MSG_QUEUE_SIZE 4
+#define QUEUE_RECORD_SIZE (RING_HEADER_SIZE + (int) sizeof(IRCLine))
 
 #ifndef TEST
 
@@ -31,9 +36,10 @@ struct Channel {
     char name[MAX_CHANNEL_NAME + 1];
     char topic[MAX_CHARS + 1];
     ChannelType channelType;
-    Queue *outQueue;
-    pthread_rwlock_t channelLock;
-    Channel *next;
+    RingBuffer *outQueue;
+    QueuePolicy queuePolicy;
+    /* links the channel into the ready list */
+    ListLink readyLink;
 };
 
 #endif
@@ -46,21 +52,29 @@ static const char *CHANNEL_TYPE_STRINGS[] = {
 
 ASSERT_ARRAY_SIZE(CHANNEL_TYPE_STRINGS, CHANNEL_TYPE_COUNT)
 
+/* channels are created and deleted while holding 
+    the session lock, so the slab isn't locked */
+static SlabAllocator *channelSlab = NULL;
+
 Channel * create_channel(const char *name, const char *topic, ChannelType channelType, int capacity) {
 
-    Channel *channel = (Channel*) malloc(sizeof(Channel));
-    if (channel == NULL) {
-        FAILED(ALLOC_ERROR, NULL);
+    if (channelSlab == NULL) {
+        channelSlab = create_slab_allocator(sizeof(Channel));
     }
 
+    Channel *channel = (Channel*) allocate_from_slab(channelSlab);
+
     if (is_valid_channel_name(name)) {
         safe_copy(channel->name, sizeof(channel->name), name);
     }
     safe_copy(channel->topic, ARRAY_SIZE(channel->topic), topic);
     channel->channelType = channelType;
-    channel->outQueue = create_queue(capacity, MAX_CHARS + 1);
-    pthread_rwlock_init(&channel->channelLock, NULL);
-    channel->next = NULL;
+    /* the queue holds references to as many messages 
+        in the message arena as the channel has users */
+    int queueSize = capacity < MSG_QUEUE_SIZE ? capacity : MSG_QUEUE_SIZE;
+    channel->outQueue = create_ring_buffer(queueSize * QUEUE_RECORD_SIZE, capacity * QUEUE_RECORD_SIZE);
+    channel->queuePolicy = QP_DROP_OLDEST;
+    init_list_link(&channel->readyLink, channel);
 
     return channel;
 }
@@ -68,45 +82,47 @@ Channel * create_channel(const char *name, const char *topic, ChannelType channe
 void delete_channel(void *channel) {
 
     if (channel != NULL) {
-        delete_queue(((Channel*)channel)->outQueue);
-        pthread_rwlock_destroy(&((Channel*)channel)->channelLock);
+
+        RingBuffer *queue = ((Channel*)channel)->outQueue;
+
+        /* the counters are logged, so that the queue 
+            capacity can be tuned */
+        if (get_ring_dropped_count(queue)) {
+            LOG(WARNING, "Channel <%s> queue dropped %d message(s), high-water mark: %d message(s)", ((Channel*)channel)->name, get_ring_dropped_count(queue), get_ring_high_water_mark(queue) / QUEUE_RECORD_SIZE);
+        }
+        else {
+            LOG(DEBUG, "Channel <%s> queue high-water mark: %d message(s)", ((Channel*)channel)->name, get_ring_high_water_mark(queue) / QUEUE_RECORD_SIZE);
+        }
+        delete_ring_buffer(queue);
     }
 
-    free(channel);
+    release_to_slab(channel);
 }
 
-void enqueue_to_channel_queue(void *channel, void *content) {
+int enqueue_to_channel_queue(Channel *channel, const char *message, int len) {
 
-    if (channel == NULL || content == NULL) {
+    if (channel == NULL || message == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&((Channel *)channel)->channelLock);
-    }
-    enqueue(((Channel *)channel)->outQueue, content);
+    IRCLine line = {message, len};
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&((Channel *)channel)->channelLock);
-    }
+    return write_ring_record(channel->outQueue, &line, sizeof(IRCLine));
 }
 
-void * dequeue_from_channel_queue(Channel *channel) {
+const char * dequeue_from_channel_queue(Channel *channel, int *len) {
 
     if (channel == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&((Channel *)channel)->channelLock);
-    }
-    void *message = dequeue(((Channel *)channel)->outQueue);
+    IRCLine *line = read_ring_record(channel->outQueue, NULL);
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&((Channel *)channel)->channelLock);
+    if (line != NULL && len != NULL) {
+        *len = line->len;
     }
 
-    return message; 
+    return line != NULL ? line->data : NULL; 
 }
 
 bool are_channels_equal(void *channel1, void *channel2) {
@@ -162,20 +178,46 @@ ChannelType get_channel_type(Channel *channel) {
     return channel->channelType;
 }
 
-Queue * get_channel_queue(Channel *channel) {
+RingBuffer * get_channel_queue(Channel *channel) {
+
+    if (channel == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    RingBuffer *queue = channel->outQueue;
+
+    return queue;
+}
+
+QueuePolicy get_channel_queue_policy(Channel *channel) {
 
     if (channel == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&((Channel *)channel)->channelLock);
+    return channel->queuePolicy;
+}
+
+void set_channel_queue_policy(Channel *channel, QueuePolicy queuePolicy) {
+
+    if (channel == NULL || !is_valid_enum_type(queuePolicy, UNKNOWN_QUEUE_POLICY) || queuePolicy == QP_DISCONNECT) {
+        FAILED(ARG_ERROR, NULL);
     }
-    Queue *queue = channel->outQueue;
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&((Channel *)channel)->channelLock);
+    channel->queuePolicy = queuePolicy;
+    set_ring_buffer_overwrite(channel->outQueue, queuePolicy == QP_DROP_OLDEST);
+}
+
+ListLink * get_channel_ready_link(Channel *channel) {
+
+    if (channel == NULL) {
+        FAILED(ARG_ERROR, NULL);
     }
 
-    return queue;
+    return &channel->readyLink;
+}
+
+SlabAllocator * get_channel_slab(void) {
+
+    return channelSlab;
 }
@@ -1,7 +1,10 @@
 #ifndef CHANNEL_H
 #define CHANNEL_H
 
-#include "../../libs/src/queue.h"
+#include "config.h"
+#include "../../libs/src/ring_buffer.h"
+#include "../../libs/src/linked_list.h"
+#include "../../libs/src/slab.h"
 #include "../../libs/src/string_utils.h"
 
 #include <stdbool.h>
@@ -21,8 +24,11 @@ typedef struct Channel Channel;
 Channel * create_channel(const char *name, const char *topic, ChannelType channelType, int capacity);
 void delete_channel(void *channel);
 
-void enqueue_to_channel_queue(void *channel, void *content);
-void * dequeue_from_channel_queue(Channel *channel);
+/* the queue references the message, which should 
+    remain valid until it's dequeued. returns 0 if 
+    the message was refused */
+int enqueue_to_channel_queue(Channel *channel, const char *message, int len);
+const char * dequeue_from_channel_queue(Channel *channel, int *len);
 
 bool are_channels_equal(void *channel1, void *channel2);
 
@@ -31,6 +37,14 @@ bool is_valid_channel_name(const char *string);
 const char *get_channel_name(Channel *channel);
 const char *get_channel_topic(Channel *channel);
 ChannelType get_channel_type(Channel *channel);
-Queue * get_channel_queue(Channel *channel);
+RingBuffer * get_channel_queue(Channel *channel);
+QueuePolicy get_channel_queue_policy(Channel *channel);
+/* a channel has no single consumer, so the 
+    disconnect policy isn't valid */
+void set_channel_queue_policy(Channel *channel, QueuePolicy queuePolicy);
+ListLink * get_channel_ready_link(Channel *channel);
+
+/* channels are allocated from a shared slab */
+SlabAllocator * get_channel_slab(void);
 
 #endif
\ No newline at end of file
@@ -20,15 +20,25 @@
 #define STATIC static
 #endif
 
+#define DEF_OUTPUT_CAPACITY 16
+
 #ifndef TEST
 
 struct Client {
     int fd;
     char nickname[MAX_NICKNAME_LEN + 1];
+    User *user;
     char clientIdentifier[MAX_CHARS + 1];
     HostIdentifierType identifierType;
     int port;
     char inBuffer[MAX_CHARS + 1];
+    SharedBuffer **outBuffers;
+    struct iovec *outVecs;
+    int outFront;
+    int outCount;
+    int outCapacity;
+    int outLen;
+    bool writePending;
     SessionStateType stateType;
 };
 
@@ -43,10 +53,18 @@ Client * create_client(void) {
 
     client->fd = UNASSIGNED;
     memset(client->nickname, '\0', sizeof(client->nickname));
+    client->user = NULL;
     memset(client->clientIdentifier, '\0', ARRAY_SIZE(client->clientIdentifier));
     client->identifierType = UNKNOWN_HOST_IDENTIFIER;
     client->port = UNASSIGNED;
     memset(client->inBuffer, '\0', sizeof(client->inBuffer));
+    client->outBuffers = NULL;
+    client->outVecs = NULL;
+    client->outFront = 0;
+    client->outCount = 0;
+    client->outCapacity = 0;
+    client->outLen = 0;
+    client->writePending = 0;
     client->stateType = DISCONNECTED;
 
     return client;
@@ -58,6 +76,10 @@ void delete_client(Client *client) {
         FAILED(ARG_ERROR, NULL);
     }
     
+    reset_client_output(client);
+
+    free(client->outBuffers);
+    free(client->outVecs);
     free(client);
 }
 
@@ -94,6 +116,22 @@ void set_client_nickname(Client *client, const char *nickname) {
     safe_copy(client->nickname, ARRAY_SIZE(client->nickname), nickname);
 }
 
+User * get_client_user(Client *client) {
+
+    if (client == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+    return client->user;
+}
+
+void set_client_user(Client *client, User *user) {
+
+    if (client == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+    client->user = user;
+}
+
 const char * get_client_identifier(Client *client) {
 
     if (client == NULL) {
@@ -162,6 +200,140 @@ void set_client_inbuffer(Client *client, const char *content) {
     safe_copy(client->inBuffer, ARRAY_SIZE(client->inBuffer), content);
 }
 
+void add_client_output(Client *client, SharedBuffer *buffer) {
+
+    if (client == NULL || buffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    if (client->outFront + client->outCount == client->outCapacity) {
+
+        /* reuse the space of sent messages before 
+            growing the arrays */
+        if (client->outFront > 0) {
+
+            memmove(client->outBuffers, client->outBuffers + client->outFront, client->outCount * sizeof(SharedBuffer*));
+            memmove(client->outVecs, client->outVecs + client->outFront, client->outCount * sizeof(struct iovec));
+            client->outFront = 0;
+        }
+        else {
+
+            int capacity = client->outCapacity ? client->outCapacity * 2 : DEF_OUTPUT_CAPACITY;
+
+            SharedBuffer **outBuffers = (SharedBuffer**) realloc(client->outBuffers, capacity * sizeof(SharedBuffer*));
+            struct iovec *outVecs = (struct iovec*) realloc(client->outVecs, capacity * sizeof(struct iovec));
+            if (outBuffers == NULL || outVecs == NULL) {
+                FAILED(ALLOC_ERROR, NULL);
+            }
+
+            client->outBuffers = outBuffers;
+            client->outVecs = outVecs;
+            client->outCapacity = capacity;
+        }
+    }
+
+    int idx = client->outFront + client->outCount;
+
+    retain_shared_buffer(buffer);
+
+    client->outBuffers[idx] = buffer;
+    client->outVecs[idx] = (struct iovec) {(void*) get_shared_buffer_data(buffer), get_shared_buffer_len(buffer)};
+    client->outCount++;
+    client->outLen += get_shared_buffer_len(buffer);
+}
+
+void consume_client_output(Client *client, int len) {
+
+    if (client == NULL || len < 0) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    while (len > 0 && client->outCount) {
+
+        struct iovec *vec = &client->outVecs[client->outFront];
+
+        /* partially sent message is kept, but its
+            vector skips the sent part */
+        if (len < (int) vec->iov_len) {
+
+            vec->iov_base = (char*) vec->iov_base + len;
+            vec->iov_len -= len;
+            client->outLen -= len;
+            break;
+        }
+
+        len -= vec->iov_len;
+        client->outLen -= vec->iov_len;
+
+        release_shared_buffer(client->outBuffers[client->outFront]);
+
+        client->outFront++;
+        client->outCount--;
+    }
+
+    if (!client->outCount) {
+        client->outFront = 0;
+    }
+}
+
+void reset_client_output(Client *client) {
+
+    if (client == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    for (int i = client->outFront; i < client->outFront + client->outCount; i++) {
+        release_shared_buffer(client->outBuffers[i]);
+    }
+
+    client->outFront = 0;
+    client->outCount = 0;
+    client->outLen = 0;
+}
+
+struct iovec * get_client_output(Client *client, int *count) {
+
+    if (client == NULL || count == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    *count = client->outCount;
+
+    return client->outCount ? &client->outVecs[client->outFront] : NULL;
+}
+
+int get_client_output_count(Client *client) {
+
+    if (client == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+    return client->outCount;
+}
+
+int get_client_output_len(Client *client) {
+
+    if (client == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+    return client->outLen;
+}
+
+bool is_client_write_pending(Client *client) {
+
+    if (client == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+    return client->writePending;
+}
+
+void set_client_write_pending(Client *client, bool writePending) {
+
+    if (client == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+    client->writePending = writePending;
+}
+
 SessionStateType get_client_state_type(Client *client) {
     
     if (client == NULL) {
@@ -1,10 +1,13 @@
 #ifndef CLIENT_H
 #define CLIENT_H
 
+#include "user.h"
 #include "../../libs/src/session_state.h"
 #include "../../libs/src/network_utils.h"
+#include "../../libs/src/shared_buffer.h"
 
 #include <stdbool.h>
+#include <sys/uio.h>
 
 typedef struct Client Client;
 
@@ -17,6 +20,12 @@ void set_client_fd(Client *client, int fd);
 const char * get_client_nickname(Client *client);
 void set_client_nickname(Client *client, const char *nickname);
 
+/* the user of a registered client, so that the 
+    user is found without a lookup by nickname. the 
+    user is owned by the session */
+User * get_client_user(Client *client);
+void set_client_user(Client *client, User *user);
+
 const char * get_client_identifier(Client *client);
 void set_client_identifier(Client *client, const char *clientIdentifier);
 
@@ -29,6 +38,21 @@ void set_client_port(Client *client, int port);
 char * get_client_inbuffer(Client *client);
 void set_client_inbuffer(Client *client, const char *content);
 
+/* output holds references to messages which were
+    not yet sent to the client. the unsent part of 
+    each message is described by an iovec, so that 
+    the output can be sent with a single writev() */
+void add_client_output(Client *client, SharedBuffer *buffer);
+void consume_client_output(Client *client, int len);
+void reset_client_output(Client *client);
+
+struct iovec * get_client_output(Client *client, int *count);
+int get_client_output_count(Client *client);
+int get_client_output_len(Client *client);
+
+bool is_client_write_pending(Client *client);
+void set_client_write_pending(Client *client, bool writePending);
+
 SessionStateType get_client_state_type(Client *client);
 void set_client_state_type(Client *client, SessionStateType stateType);
 
@@ -9,12 +9,12 @@
 #include "channel.h"
 #include "session.h"
 #include "tcp_server.h"
+#include "config.h"
 #include "../../libs/src/common.h"
 #include "../../libs/src/session_state.h"
 #include "../../libs/src/settings.h"
 #include "../../libs/src/irc_message.h"
 #include "../../libs/src/linked_list.h"
-#include "../../libs/src/network_utils.h"
 #include "../../libs/src/enum_utils.h"
 #include "../../libs/src/logger.h"
 #include "../../libs/src/error_control.h"
@@ -41,6 +41,8 @@ STATIC void cmd_quit(EventManager *eventManager, TCPServer *tcpServer, Client *c
 STATIC void cmd_unknown(EventManager *eventManager, TCPServer *tcpServer, Client *client, CommandTokens *cmdTokens);
 
 STATIC void handle_nickname_change(TCPServer *tcpServer, Client *client, CommandTokens *cmdTokens);
+STATIC bool is_nickname_in_use(TCPServer *tcpServer, Client *client, const char *nickname);
+STATIC bool is_nickname_reserved(TCPServer *tcpServer, Client *client, const char *nickname);
 STATIC void handle_user_registration(TCPServer *tcpServer, Client *client, CommandTokens *cmdTokens);
 
 STATIC void handle_join_existing_channel(TCPServer *tcpServer, Client *client, CommandTokens *cmdTokens);
@@ -51,6 +53,7 @@ STATIC void handle_leave_channel(TCPServer *tcpServer, Client *client, CommandTo
 
 STATIC void send_privmsg_to_channel(TCPServer *tcpServer, Client *client, CommandTokens *cmdTokens);
 STATIC void send_privmsg_to_user(TCPServer *tcpServer, Client *client, CommandTokens *cmdTokens);
+STATIC void send_try_again_message(TCPServer *tcpServer, Client *client, CommandTokens *cmdTokens);
 
 static const CommandFunc COMMAND_FUNCTIONS[] = {
     NULL,
@@ -103,7 +106,7 @@ STATIC void cmd_nick(EventManager *eventManager, TCPServer *tcpServer, Client *c
 
         // :server 451 * :You have not registered
         const char *code = get_response_code(ERR_NOTREGISTERED);         
-        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, "*"}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, "*"}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
         return;
     }
 
@@ -112,7 +115,7 @@ STATIC void cmd_nick(EventManager *eventManager, TCPServer *tcpServer, Client *c
         // :server 431 * :No nickname given
         const char *code = get_response_code(ERR_NONICKNAMEGIVEN);
 
-        add_irc_message_to_queue(tcpServer, client, &(IRCMessage) {{code, "*"}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+        add_irc_message_to_queue(tcpServer, client, &(IRCMessage) {{code, "*"}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
     }
     else {
 
@@ -122,14 +125,14 @@ STATIC void cmd_nick(EventManager *eventManager, TCPServer *tcpServer, Client *c
 
             // :server 432 <nickname> :Erroneous nickname
             const char *code = get_response_code(ERR_ERRONEUSNICKNAME);
-            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
             LOG(DEBUG, "Nickname <%s> invalid", nickname);
         }
-        else if (find_user_in_hash_table(get_session(tcpServer), nickname) != NULL) {
+        else if (is_nickname_in_use(tcpServer, client, nickname) || is_nickname_reserved(tcpServer, client, nickname)) {
 
             // :server 433 <nickname> :Nickname is already in use
             const char *code = get_response_code(ERR_NICKNAMEINUSE);
-            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
             LOG(DEBUG, "Nickname <%s> in use", nickname);
         }
         else {
@@ -139,35 +142,45 @@ STATIC void cmd_nick(EventManager *eventManager, TCPServer *tcpServer, Client *c
             if (get_client_state_type(client) >= REGISTERED) {  
                 handle_nickname_change(tcpServer, client, cmdTokens);
             }
-            set_client_nickname(client, nickname);
+            set_server_client_nickname(tcpServer, client, nickname);
         }
     }
 }
 
 STATIC void handle_nickname_change(TCPServer *tcpServer, Client *client, CommandTokens *cmdTokens) {
 
-    User *user = find_user_in_hash_table(get_session(tcpServer), get_client_nickname(client));
-    User *userCopy = copy_user(user);
-    set_user_nickname(userCopy, get_command_argument(cmdTokens, 0));
+    User *user = get_client_user(client);
 
-    UserChannels *userChannels = find_user_channels(get_session(tcpServer), user);
+    // <:old nickname!username@hostname> NICK <new nickname>
+    int fwdMessageLen = 0;
+    const char *fwdMessage = create_irc_line(get_message_arena(tcpServer), MAX_CHARS, &(IRCMessage){{get_command(cmdTokens)}, {get_command_argument(cmdTokens, 0)}, 0, get_user_prefix(user)}, &fwdMessageLen);
 
-    if (userChannels != NULL) {
+    /* users sharing several channels with the 
+        user get a single message */
+    enqueue_to_channel_peers(get_session(tcpServer), user, fwdMessage, fwdMessageLen, 1);
 
-        // <:old nickname!username@hostname> NICK <new nickname>
-        char fwdMessage[MAX_CHARS + CRLF_LEN + 1] = {'\0'};
+    /* the user is renamed in place, so its queue 
+        and memberships are kept */
+    rename_user_in_hash_table(get_session(tcpServer), user, get_command_argument(cmdTokens, 0));
+    LOG(DEBUG, "Nickname changed from <%s> to <%s>", get_client_nickname(client), get_command_argument(cmdTokens, 0));
+}
 
-        create_irc_message(fwdMessage, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens)}, {get_command_argument(cmdTokens, 0)}, 0, create_user_info, user});
+/* a user may change the case of its own nickname */
+STATIC bool is_nickname_in_use(TCPServer *tcpServer, Client *client, const char *nickname) {
 
-        iterate_list(get_channels_from_user_channels(userChannels), enqueue_to_channel_queue, fwdMessage);
-        iterate_list(get_channels_from_user_channels(userChannels), add_channel_to_ready_list, get_ready_list(get_session(tcpServer)));
+    User *user = find_user_in_hash_table(get_session(tcpServer), nickname);
 
-        change_user_in_user_channels(userChannels, userCopy);
-        iterate_list(get_channel_users_ll(get_session(tcpServer)), change_user_in_channel_users, userCopy);
+    return user != NULL && user != get_client_user(client);
+}
 
-        change_user_in_hash_table(get_session(tcpServer), user, userCopy);
-        LOG(DEBUG, "Nickname changed from <%s> to <%s>", get_client_nickname(client), get_command_argument(cmdTokens, 0));
-    }
+/* a nickname is reserved by another client of any 
+    event loop, even before its registration is 
+    complete */
+STATIC bool is_nickname_reserved(TCPServer *tcpServer, Client *client, const char *nickname) {
+
+    Client *holder = find_client(tcpServer, nickname);
+
+    return holder != NULL && holder != client;
 }
 
 STATIC void cmd_user(EventManager *eventManager, TCPServer *tcpServer, Client *client, CommandTokens *cmdTokens) {
@@ -178,13 +191,13 @@ STATIC void cmd_user(EventManager *eventManager, TCPServer *tcpServer, Client *c
 
             // :server 451 * :You have not registered
             const char *code = get_response_code(ERR_NOTREGISTERED);         
-            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, "*"}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, "*"}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
         }
         else {
 
             // :server 462 <nickname> :Already registered
             const char *code = get_response_code(ERR_ALREADYREGISTRED);
-            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, get_client_nickname(client)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, get_client_nickname(client)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
             LOG(DEBUG, "User <%s> already registered", get_client_nickname(client));
         }
     }
@@ -193,7 +206,7 @@ STATIC void cmd_user(EventManager *eventManager, TCPServer *tcpServer, Client *c
 
             // :server 461 <nickname> <cmd> :Not enough parameters
             const char *code = get_response_code(ERR_NEEDMOREPARAMS);
-            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, get_client_nickname(client), get_command(cmdTokens)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, get_client_nickname(client), get_command(cmdTokens)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
         }
         else {
             handle_user_registration(tcpServer, client, cmdTokens);           
@@ -204,13 +217,11 @@ STATIC void cmd_user(EventManager *eventManager, TCPServer *tcpServer, Client *c
 STATIC void handle_user_registration(TCPServer *tcpServer, Client *client, CommandTokens *cmdTokens) {
 
     const char *nickname = get_client_nickname(client);
-    const char *clientIdentifier = get_client_identifier(client);
-    char hostname[MAX_CHARS + 1] = {'\0'};
 
-    if (get_client_identifier_type(client) == IP_ADDRESS) {
-        ip_to_hostname(hostname, ARRAY_SIZE(hostname), get_client_identifier(client));
-        clientIdentifier = hostname;
-    }
+    /* the identifier is the hostname if the lookup 
+        was completed, otherwise the IP address, 
+        which is replaced when the lookup completes */
+    const char *clientIdentifier = get_client_identifier(client);
 
     const char *realname = NULL;
 
@@ -222,13 +233,29 @@ STATIC void handle_user_registration(TCPServer *tcpServer, Client *client, Comma
     }
 
     User *user = create_user(get_client_fd(client), nickname, get_command_argument(cmdTokens, 0), clientIdentifier, realname);
+    set_user_queue_policy(user, get_int_option_value(OT_USER_QUEUE_POLICY));
 
-    register_user(get_session(tcpServer), user);
+    /* nicknames are reserved in the session, which 
+        is shared by all event loops, so the nickname 
+        should be free. a user whose nickname is taken 
+        isn't registered */
+    if (!register_user(get_session(tcpServer), user)) {
+
+        delete_user(user);
+
+        // :server 433 <nickname> :Nickname is already in use
+        const char *code = get_response_code(ERR_NICKNAMEINUSE);
+        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
+        LOG(DEBUG, "Nickname <%s> in use", nickname);
+        return;
+    }
+
+    set_client_user(client, user);
     set_client_state_type(client, REGISTERED);
 
     // :server 001 <nickname> :Welcome to the IRC Network
     const char *code = get_response_code(RPL_WELCOME);
-    add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+    add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
     LOG(DEBUG, "User <%s> registered", nickname);
 }
 
@@ -238,7 +265,7 @@ STATIC void cmd_join(EventManager *eventManager, TCPServer *tcpServer, Client *c
         
         // :server 451 * :You have not registered
         const char *code = get_response_code(ERR_NOTREGISTERED);         
-        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, "*"}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, "*"}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
         return;
     }
 
@@ -246,7 +273,7 @@ STATIC void cmd_join(EventManager *eventManager, TCPServer *tcpServer, Client *c
 
         // :server 461 <nickname> <cmd> :Not enough parameters
         const char *code = get_response_code(ERR_NEEDMOREPARAMS);
-        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, get_client_nickname(client), get_command(cmdTokens)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, get_client_nickname(client), get_command(cmdTokens)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
     }
     else {
         Channel *channel = find_channel_in_hash_table(get_session(tcpServer), get_command_argument(cmdTokens, 0));
@@ -264,17 +291,17 @@ STATIC void handle_join_existing_channel(TCPServer *tcpServer, Client *client, C
 
     const char *nickname = get_client_nickname(client);
 
-    User *user = find_user_in_hash_table(get_session(tcpServer), nickname);
+    User *user = get_client_user(client);
     Channel *channel = find_channel_in_hash_table(get_session(tcpServer), get_command_argument(cmdTokens, 0));
     ChannelUsers *channelUsers = find_channel_users(get_session(tcpServer), channel);
 
-    if (find_user_in_channel_users(channelUsers, user) == NULL) {
+    if (!is_channel_member(get_session(tcpServer), channel, user)) {
 
         if (is_channel_full(channelUsers)) {
 
             // :server 471 <nickname> <channel> :Cannot join channel
             const char *code = get_response_code(ERR_CHANNELISFULL);
-            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
             LOG(DEBUG, "Channel <%s> is full", get_command_argument(cmdTokens, 0));
 
         }
@@ -295,17 +322,18 @@ STATIC void handle_join_new_channel(TCPServer *tcpServer, Client *client, Comman
 
     const char *nickname = get_client_nickname(client);
 
-    User *user = find_user_in_hash_table(get_session(tcpServer), nickname);
+    User *user = get_client_user(client);
 
     if (strlen(get_command_argument(cmdTokens, 0)) > MAX_CHANNEL_LEN || !is_valid_channel_name(get_command_argument(cmdTokens, 0))) {
 
         // :server 479 <nickname> <channel> :Illegal channel name
         const char *code = get_response_code(ERR_BADCHANNAME);
-        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
     }
     else {
 
         Channel *channel = create_channel(get_command_argument(cmdTokens, 0), NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
+        set_channel_queue_policy(channel, get_int_option_value(OT_CHANNEL_QUEUE_POLICY));
         register_new_channel_join(get_session(tcpServer), channel, user);
 
         send_channel_join_messages(tcpServer, client, cmdTokens);
@@ -320,14 +348,14 @@ STATIC void handle_join_new_channel(TCPServer *tcpServer, Client *client, Comman
 STATIC void send_channel_join_messages(TCPServer *tcpServer, Client *client, CommandTokens *cmdTokens) {
 
     const char *nickname = get_client_nickname(client);
-    User *user = find_user_in_hash_table(get_session(tcpServer), nickname);
+    User *user = get_client_user(client);
     Channel *channel = find_channel_in_hash_table(get_session(tcpServer), get_command_argument(cmdTokens, 0));
     ChannelUsers *channelUsers = find_channel_users(get_session(tcpServer), channel);
     
     // <:nickname!username@hostname> JOIN <channel>
-    char fwdMessage[MAX_CHARS + CRLF_LEN + 1] = {'\0'};
-    create_irc_message(fwdMessage, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens)}, {get_command_argument(cmdTokens, 0)}, 0, create_user_info, user});
-    enqueue_to_channel_queue(channel, fwdMessage);
+    int fwdMessageLen = 0;
+    const char *fwdMessage = create_irc_line(get_message_arena(tcpServer), MAX_CHARS, &(IRCMessage){{get_command(cmdTokens)}, {get_command_argument(cmdTokens, 0)}, 0, get_user_prefix(user)}, &fwdMessageLen);
+    enqueue_to_channel_queue(channel, fwdMessage, fwdMessageLen);
     add_channel_to_ready_list(channel, get_ready_list(get_session(tcpServer)));
 
     add_topic_message_to_queue(tcpServer, client, channel, cmdTokens);
@@ -336,15 +364,15 @@ STATIC void send_channel_join_messages(TCPServer *tcpServer, Client *client, Com
         char nicknameList[MAX_CHARS + 1];
     } data = {{'\0'}};
 
-    iterate_list(get_users_from_channel_users(channelUsers), add_nickname_to_list, &data);
+    iterate_channel_users(channelUsers, add_nickname_to_list, &data);
 
     // :server 353 <nickname> <channel> :<nicknames list>
     const char *code = get_response_code(RPL_NAMREPLY);
-    add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {data.nicknameList}, 1, create_server_info, tcpServer});
+    add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {data.nicknameList}, 1, get_server_prefix(tcpServer)});
 
     // :server 366 <nickname> <channel> :<End of NAMES list>
     code = get_response_code(RPL_ENDOFNAMES);
-    add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+    add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
 }
 
 STATIC void add_topic_message_to_queue(TCPServer *tcpServer, Client *client, Channel *channel, CommandTokens *cmdTokens) {
@@ -355,12 +383,12 @@ STATIC void add_topic_message_to_queue(TCPServer *tcpServer, Client *client, Cha
 
         // :server 331 <nickname> <channel> :No topic is set
         const char *code = get_response_code(RPL_NOTOPIC);
-        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
     }
     else {
         // :server 332 <nickname> <channel> :<topic>
         const char *code = get_response_code(RPL_TOPIC);
-        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_channel_topic(channel)}, 1, create_server_info, tcpServer});
+        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_channel_topic(channel)}, 1, get_server_prefix(tcpServer)});
     }
 }
 
@@ -372,12 +400,12 @@ STATIC void cmd_part(EventManager *eventManager, TCPServer *tcpServer, Client *c
 
             // :server 451 * :You have not registered
             const char *code = get_response_code(ERR_NOTREGISTERED);         
-            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, "*"}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, "*"}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
         }
         else {
             // :server 442 <nickname> <channel> :You're not on that channel
             const char *code = get_response_code(ERR_NOTONCHANNEL);       
-            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, get_client_nickname(client), get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, get_client_nickname(client), get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
         }
         return;
     }
@@ -387,7 +415,7 @@ STATIC void cmd_part(EventManager *eventManager, TCPServer *tcpServer, Client *c
     if (!get_command_argument_count(cmdTokens)) {
         // :server 461 <nickname> <cmd> :Not enough parameters
         const char *code = get_response_code(ERR_NEEDMOREPARAMS);
-        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command(cmdTokens)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command(cmdTokens)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
     }
     else {
         handle_leave_channel(tcpServer, client, cmdTokens);
@@ -398,44 +426,46 @@ STATIC void handle_leave_channel(TCPServer *tcpServer, Client *client, CommandTo
 
     const char *nickname = get_client_nickname(client);
 
-    User *user = find_user_in_hash_table(get_session(tcpServer), nickname);
+    User *user = get_client_user(client);
     Channel *channel = find_channel_in_hash_table(get_session(tcpServer), get_command_argument(cmdTokens, 0));
 
     if (channel == NULL) {
 
         // :server 403 <nickname> <channel> :No such channel
         const char *code = get_response_code(ERR_NOSUCHCHANNEL);
-        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
     }
     else {
 
         ChannelUsers *channelUsers = find_channel_users(get_session(tcpServer), channel);
 
-        if (find_user_in_channel_users(channelUsers, user) == NULL) {
+        if (!is_channel_member(get_session(tcpServer), channel, user)) {
 
             // :server 442 <nickname> <channel> :You're not on that channel
             const char *code = get_response_code(ERR_NOTONCHANNEL);
-            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
         }
         else {
 
-            char fwdMessage[MAX_CHARS + CRLF_LEN + 1] = {'\0'};
-
-            create_irc_message(fwdMessage, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens), get_command_argument(cmdTokens, 0)}, {get_command_argument(cmdTokens, 1)}, 0, create_user_info, user});
+            int fwdMessageLen = 0;
+            const char *fwdMessage = create_irc_line(get_message_arena(tcpServer), MAX_CHARS, &(IRCMessage){{get_command(cmdTokens), get_command_argument(cmdTokens, 0)}, {get_command_argument(cmdTokens, 1)}, 0, get_user_prefix(user)}, &fwdMessageLen);
 
             register_channel_leave(get_session(tcpServer), channel, user);
 
-            if (get_channel_type(channel) == TEMPORARY && !get_channel_users_count(channelUsers)) {
+            /* channel users are freed with the channel */
+            int usersCount = get_channel_users_count(channelUsers);
+
+            if (get_channel_type(channel) == TEMPORARY && !usersCount) {
 
                 remove_channel_data(get_session(tcpServer), channel);
-                add_message_to_queue(tcpServer, client, fwdMessage);
+                add_message_to_queue(tcpServer, client, fwdMessage, fwdMessageLen);
             }
             else {
-                enqueue_to_channel_queue(channel, fwdMessage);
+                enqueue_to_channel_queue(channel, fwdMessage, fwdMessageLen);
                 add_channel_to_ready_list(channel, get_ready_list(get_session(tcpServer)));
             }        
             
-            if (get_client_state_type(client) == IN_CHANNEL && !get_channel_users_count(channelUsers)) {
+            if (get_client_state_type(client) == IN_CHANNEL && !usersCount) {
                 set_client_state_type(client, REGISTERED);
             }
             LOG(DEBUG, "User \"%s\" left channel <%s>", nickname, get_command_argument(cmdTokens, 0));
@@ -448,7 +478,7 @@ STATIC void cmd_privmsg(EventManager *eventManager, TCPServer *tcpServer, Client
     if (!is_allowed_state_command(get_server_session_states(), get_client_state_type(client), PRIVMSG)) {
         // :server 451 * :You have not registered
         const char *code = get_response_code(ERR_NOTREGISTERED);         
-        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, "*"}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, "*"}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
         return;
     }
 
@@ -458,7 +488,7 @@ STATIC void cmd_privmsg(EventManager *eventManager, TCPServer *tcpServer, Client
 
         // :server 461 <nickname> <cmd> :Not enough parameters
         const char *code = get_response_code(ERR_NEEDMOREPARAMS);
-        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command(cmdTokens)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command(cmdTokens)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
     }
     else {
         if (is_valid_channel_name(get_command_argument(cmdTokens, 0))) {
@@ -474,32 +504,32 @@ STATIC void send_privmsg_to_channel(TCPServer *tcpServer, Client *client, Comman
 
     const char *nickname = get_client_nickname(client);
 
-    User *user = find_user_in_hash_table(get_session(tcpServer), nickname);
+    User *user = get_client_user(client);
     Channel *channel = find_channel_in_hash_table(get_session(tcpServer), get_command_argument(cmdTokens, 0));
 
     if (channel == NULL) {
 
         // :server 403 <nickname> <channel> :No such channel
         const char *code = get_response_code(ERR_NOSUCHCHANNEL);
-        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
     }
     else {
 
-        ChannelUsers *channelUsers = find_channel_users(get_session(tcpServer), channel);
-
-        if (find_user_in_channel_users(channelUsers, user) == NULL) {
+        if (!is_channel_member(get_session(tcpServer), channel, user)) {
 
             // :server 442 <nickname> <channel> :You're not on that channel
             const char *code = get_response_code(ERR_NOTONCHANNEL);
-            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
         }
         else {
 
             // <:nickname!username@hostname> PRIVMSG <channel> <:message>        
-            char fwdMessage[MAX_CHARS + CRLF_LEN + 1] = {'\0'};
+            int fwdMessageLen = 0;
+            const char *fwdMessage = create_irc_line(get_message_arena(tcpServer), MAX_CHARS, &(IRCMessage){{get_command(cmdTokens), get_command_argument(cmdTokens, 0)}, {get_command_argument(cmdTokens, 1)}, 0, get_user_prefix(user)}, &fwdMessageLen);
 
-            create_irc_message(fwdMessage, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens), get_command_argument(cmdTokens, 0)}, {get_command_argument(cmdTokens, 1)}, 0, create_user_info, user});
-            enqueue_to_channel_queue(channel, fwdMessage);
+            if (!enqueue_to_channel_queue(channel, fwdMessage, fwdMessageLen) && get_channel_queue_policy(channel) == QP_BLOCK) {
+                send_try_again_message(tcpServer, client, cmdTokens);
+            }
             add_channel_to_ready_list(channel, get_ready_list(get_session(tcpServer)));
 
             LOG(DEBUG, "Sent message to channel <%s>", get_command_argument(cmdTokens, 0));
@@ -511,34 +541,46 @@ STATIC void send_privmsg_to_user(TCPServer *tcpServer, Client *client, CommandTo
 
     const char *nickname = get_client_nickname(client);
 
-    User *user = find_user_in_hash_table(get_session(tcpServer), nickname);
+    User *user = get_client_user(client);
     User *recipient = find_user_in_hash_table(get_session(tcpServer), get_command_argument(cmdTokens, 0));
 
     if (recipient == NULL) {
 
         // :server 401 <client nickname> <nickname> :No such nick
         const char *code = get_response_code(ERR_NOSUCHNICK);
-        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
     }
     else {
         // <:nickname!username@hostname> PRIVMSG <nickname> <:message>       
-        char fwdMessage[MAX_CHARS + CRLF_LEN + 1] = {'\0'};
+        int fwdMessageLen = 0;
+        const char *fwdMessage = create_irc_line(get_message_arena(tcpServer), MAX_CHARS, &(IRCMessage){{get_command(cmdTokens), get_command_argument(cmdTokens, 0)}, {get_command_argument(cmdTokens, 1)}, 0, get_user_prefix(user)}, &fwdMessageLen);
 
-        create_irc_message(fwdMessage, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens), get_command_argument(cmdTokens, 0)}, {get_command_argument(cmdTokens, 1)}, 0, create_user_info, user});
-        enqueue_to_user_queue(recipient, fwdMessage);
-        add_user_to_ready_list(user, get_ready_list(get_session(tcpServer)));
+        if (!enqueue_to_user_queue(recipient, fwdMessage, fwdMessageLen) && get_user_queue_policy(recipient) == QP_BLOCK) {
+            send_try_again_message(tcpServer, client, cmdTokens);
+        }
+        add_user_to_ready_list(recipient, get_ready_list(get_session(tcpServer)));
 
         LOG(DEBUG, "Sent message to user <%s>", get_command_argument(cmdTokens, 0));
     }
 }
 
+/* the recipient's queue is full and refused the 
+    message, so the sender is asked to send it 
+    again later */
+STATIC void send_try_again_message(TCPServer *tcpServer, Client *client, CommandTokens *cmdTokens) {
+
+    // :server 263 <nickname> <command> :Please wait a while and try again.
+    const char *code = get_response_code(RPL_TRYAGAIN);
+    add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, get_client_nickname(client), get_command(cmdTokens)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
+}
+
 
 STATIC void cmd_whois(EventManager *eventManager, TCPServer *tcpServer, Client *client, CommandTokens *cmdTokens) {
 
     if (!is_allowed_state_command(get_server_session_states(), get_client_state_type(client), WHOIS)) {
         // :server 451 * :You have not registered
         const char *code = get_response_code(ERR_NOTREGISTERED);         
-        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, "*"}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, "*"}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
         return;
     }
 
@@ -548,7 +590,7 @@ STATIC void cmd_whois(EventManager *eventManager, TCPServer *tcpServer, Client *
 
         // :server 461 <nickname> <cmd> :Not enough parameters
         const char *code = get_response_code(ERR_NEEDMOREPARAMS);
-        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command(cmdTokens)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command(cmdTokens)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
     }
     else {
 
@@ -558,13 +600,13 @@ STATIC void cmd_whois(EventManager *eventManager, TCPServer *tcpServer, Client *
 
             // :server 401 <client nickname> <nickname> :No such nick
             const char *code = get_response_code(ERR_NOSUCHNICK);
-            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
         }
         else {
 
             // :server 311 <client nickname> <nickname> <username> <hostname> <realname>
             const char *code = get_response_code(RPL_WHOISUSER);
-            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0), get_user_username(whoisUser), get_user_hostname(whoisUser)}, {get_user_realname(whoisUser)}, 1, create_server_info, tcpServer});
+            add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, nickname, get_command_argument(cmdTokens, 0), get_user_username(whoisUser), get_user_hostname(whoisUser)}, {get_user_realname(whoisUser)}, 1, get_server_prefix(tcpServer)});
 
             LOG(DEBUG, "Performed WHOIS for user <%s>", get_command_argument(cmdTokens, 0));
         }
@@ -576,25 +618,29 @@ STATIC void cmd_quit(EventManager *eventManager, TCPServer *tcpServer, Client *c
     if (!is_allowed_state_command(get_server_session_states(), get_client_state_type(client), QUIT)) {
         // :server 451 * :You have not registered
         const char *code = get_response_code(ERR_NOTREGISTERED);         
-        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, "*"}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+        add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, "*"}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
         return;
     }
 
-    User *user = find_user_in_hash_table(get_session(tcpServer), get_client_nickname(client));
+    User *user = get_client_user(client);
 
-    // <:nickname!username@hostname> QUIT <:message>
-    char fwdMessage[MAX_CHARS + CRLF_LEN + 1] = {'\0'};
+    LOG(INFO, "User quit (fd: %d)", get_client_fd(client));
 
-    create_irc_message(fwdMessage, MAX_CHARS, &(IRCMessage){{get_command(cmdTokens)}, {get_command_argument(cmdTokens, 0)}, 0, create_user_info, user});
+    /* a client which quits before its registration 
+        is complete has no user */
+    if (user != NULL) {
 
-    LOG(INFO, "User quit (fd: %d)", get_client_fd(client));
+        // <:nickname!username@hostname> QUIT <:message>
+        int fwdMessageLen = 0;
+        const char *fwdMessage = create_irc_line(get_message_arena(tcpServer), MAX_CHARS, &(IRCMessage){{get_command(cmdTokens)}, {get_command_argument(cmdTokens, 0)}, 0, get_user_prefix(user)}, &fwdMessageLen);
 
-    leave_all_channels(get_session(tcpServer), user, fwdMessage);
+        leave_all_channels(get_session(tcpServer), user, fwdMessage, fwdMessageLen);
 
-    ReadyList *readyList = get_ready_list(get_session(tcpServer));
-    remove_user_from_ready_list(get_ready_users(readyList), user);
+        remove_user_from_ready_list(get_ready_list(get_session(tcpServer)), user);
+
+        unregister_user(get_session(tcpServer), user);
+    }
 
-    unregister_user(get_session(tcpServer), user);
     remove_client(tcpServer, eventManager, get_client_fd(client));
 }
 
@@ -602,7 +648,7 @@ STATIC void cmd_unknown(EventManager *eventManager, TCPServer *tcpServer, Client
 
     // :server 421 <command> :Unknown command
     const char *code = get_response_code(ERR_UNKNOWNCOMMAND);
-    add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, get_command(cmdTokens)}, {get_response_message(code)}, 1, create_server_info, tcpServer});
+    add_irc_message_to_queue(tcpServer, client, &(IRCMessage){{code, get_command(cmdTokens)}, {get_response_message(code)}, 1, get_server_prefix(tcpServer)});
 
     LOG(DEBUG, "Unknown command <%s>", get_command(cmdTokens));
 }
@@ -1,8 +1,10 @@
 #include "config.h"
 
+#include "../../libs/src/common.h"
 #include "../../libs/src/data_type.h"
 #include "../../libs/src/enum_utils.h"
 #include "../../libs/src/network_utils.h"
+#include "../../libs/src/poll_manager.h"
 #include "../../libs/src/signal_handler.h"
 #include "../../libs/src/error_control.h"
 #include "../../libs/src/logger.h"
@@ -13,6 +15,17 @@
 #include <signal.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <assert.h>
+
+static const char *QUEUE_POLICY_STRINGS[] = {
+    "dropoldest",
+    "dropnewest",
+    "block",
+    "disconnect",
+    "unknown"
+};
+
+ASSERT_ARRAY_SIZE(QUEUE_POLICY_STRINGS, QUEUE_POLICY_COUNT)
 
 typedef struct {
     ServerOptionType optionType;
@@ -21,13 +34,20 @@ typedef struct {
 } ServerOptions;
 
 static const ServerOptions serverOptions[] = {
+    {OT_POLL_BACKEND, {.itemInt = EPOLL_BACKEND}, INT_TYPE},
     {OT_DAEMON, {.itemInt = 0}, INT_TYPE},
     {OT_ECHO, {.itemInt = 0}, INT_TYPE},
     {OT_MAX_FDS, {.itemInt = 1024}, CHAR_TYPE},
     {OT_SERVER_LOG_LEVEL, {.itemInt = DEBUG}, INT_TYPE},
     {OT_SERVER_NAME, {.itemChar = "irc.server.com"}, CHAR_TYPE},
     {OT_PORT, {.itemInt = 50100}, INT_TYPE},
+    {OT_USER_QUEUE_POLICY, {.itemInt = QP_DROP_OLDEST}, INT_TYPE},
+    {OT_CHANNEL_QUEUE_POLICY, {.itemInt = QP_DROP_OLDEST}, INT_TYPE},
+    {OT_SENDQ_LIMIT, {.itemInt = 65536}, INT_TYPE},
+    /* 0 if the number of threads isn't given */
+    {OT_SHARDS, {.itemInt = 0}, INT_TYPE},
     {OT_THREADS, {.itemInt = 0}, INT_TYPE},
+    {OT_IO_URING, {.itemInt = 0}, INT_TYPE},
     {OT_WAIT_TIME, {.itemInt = 60}, INT_TYPE}
 };
 
@@ -77,9 +97,20 @@ void get_command_line_args(int argc, char **argv) {
 
     int opt;
 
-    while ((opt = getopt(argc, argv, "deflnptw")) != -1) {
+    while ((opt = getopt(argc, argv, "bc:deflnpq:Q:s:tuw")) != -1) {
 
         switch (opt) {
+            case 'b': {
+                set_option_value(OT_POLL_BACKEND, &(int){POLL_BACKEND});
+                break;
+            }
+            case 'c': {
+                int shards = str_to_uint(optarg);
+                if (shards > 0) {
+                    set_option_value(OT_SHARDS, &shards);
+                }
+                break;
+            }
             case 'd': {
                 set_option_value(OT_DAEMON, &(int){1});
                 break;
@@ -115,8 +146,39 @@ void get_command_line_args(int argc, char **argv) {
                 }
                 break;
             }
+            case 'q': {
+
+                QueuePolicy queuePolicy = string_to_enum_type(QUEUE_POLICY_STRINGS, QUEUE_POLICY_COUNT, optarg);
+
+                if (is_valid_enum_type(queuePolicy, UNKNOWN_QUEUE_POLICY)) {
+                    set_option_value(OT_USER_QUEUE_POLICY, &queuePolicy);
+                }
+                break;
+            }
+            case 'Q': {
+
+                QueuePolicy queuePolicy = string_to_enum_type(QUEUE_POLICY_STRINGS, QUEUE_POLICY_COUNT, optarg);
+
+                /* a channel has no single consumer to 
+                    disconnect */
+                if (is_valid_enum_type(queuePolicy, UNKNOWN_QUEUE_POLICY) && queuePolicy != QP_DISCONNECT) {
+                    set_option_value(OT_CHANNEL_QUEUE_POLICY, &queuePolicy);
+                }
+                break;
+            }
+            case 's': {
+                int sendqLimit = str_to_uint(optarg);
+                if (sendqLimit > 0) {
+                    set_option_value(OT_SENDQ_LIMIT, &sendqLimit);
+                }
+                break;
+            }
             case 't': {
-                set_option_value(OT_THREADS, &(int){str_to_uint(argv[7])});
+                set_option_value(OT_THREADS, &(int){1});
+                break;
+            }
+            case 'u': {
+                set_option_value(OT_IO_URING, &(int){1});
                 break;
             }
             case 'w': {
@@ -127,15 +189,21 @@ void get_command_line_args(int argc, char **argv) {
                 break;
             }
             default:
-                printf("Usage: %s [-d <daemon>] [-e <echo>] [-f <max fds>] [-l <loglevel>]  [-n <servername>] [-p <port>][-t <threads>] [-w <waittime>]\n", argv[0]);
+                printf("Usage: %s [-b <poll backend>] [-c <event loops>] [-d <daemon>] [-e <echo>] [-f <max fds>] [-l <loglevel>]  [-n <servername>] [-p <port>] [-q <user queue policy>] [-Q <channel queue policy>] [-s <sendq limit>] [-t] [-u <io_uring>] [-w <waittime>]\n", argv[0]);
                 printf("\tOptions:\n");
+                printf("\t  -b : Use poll() instead of epoll\n");
+                printf("\t  -c : Set the number of event loop (or reader) threads\n");
                 printf("\t  -d : Run as a daemon\n");
                 printf("\t  -e : Enable echo mode\n");
                 printf("\t  -f : Set max file descriptors\n");
                 printf("\t  -l : Set the logging level\n");
                 printf("\t  -n : Specify the server name\n");
                 printf("\t  -p : Specify the port number\n");
-                printf("\t  -t : Use multithreading\n");
+                printf("\t  -q : Set the full user queue policy (dropoldest, dropnewest, block, disconnect)\n");
+                printf("\t  -Q : Set the full channel queue policy (dropoldest, dropnewest, block)\n");
+                printf("\t  -s : Set the client's send queue limit in bytes\n");
+                printf("\t  -t : Use a pool of reader threads\n");
+                printf("\t  -u : Use io_uring event loop\n");
                 printf("\t  -w : Set wait time\n");
                 exit(EXIT_FAILURE);
         }
@@ -144,12 +212,18 @@ void get_command_line_args(int argc, char **argv) {
 
 void initialize_server_settings(void) {
 
+    register_option(INT_TYPE, OT_POLL_BACKEND, "pollbackend", &(int){serverOptions[OT_POLL_BACKEND].dataItem.itemInt});
     register_option(INT_TYPE, OT_DAEMON, "daemon", &(int){serverOptions[OT_DAEMON].dataItem.itemInt});
     register_option(INT_TYPE, OT_ECHO, "echo", &(int){serverOptions[OT_ECHO].dataItem.itemInt});
     register_option(INT_TYPE, OT_MAX_FDS, "maxfds", &(int){serverOptions[OT_MAX_FDS].dataItem.itemInt});
     register_option(INT_TYPE, OT_SERVER_LOG_LEVEL, "loglevel", &(int){serverOptions[OT_SERVER_LOG_LEVEL].dataItem.itemInt});
     register_option(CHAR_TYPE, OT_SERVER_NAME, "servername", (char*)serverOptions[OT_SERVER_NAME].dataItem.itemChar);
     register_option(INT_TYPE, OT_PORT, "port",  &(int){serverOptions[OT_PORT].dataItem.itemInt});
+    register_option(INT_TYPE, OT_USER_QUEUE_POLICY, "userqueuepolicy", &(int){serverOptions[OT_USER_QUEUE_POLICY].dataItem.itemInt});
+    register_option(INT_TYPE, OT_CHANNEL_QUEUE_POLICY, "channelqueuepolicy", &(int){serverOptions[OT_CHANNEL_QUEUE_POLICY].dataItem.itemInt});
+    register_option(INT_TYPE, OT_SENDQ_LIMIT, "sendqlimit", &(int){serverOptions[OT_SENDQ_LIMIT].dataItem.itemInt});
+    register_option(INT_TYPE, OT_SHARDS, "shards", &(int){serverOptions[OT_SHARDS].dataItem.itemInt});
     register_option(INT_TYPE, OT_THREADS, "threads", &(int){serverOptions[OT_THREADS].dataItem.itemInt});
+    register_option(INT_TYPE, OT_IO_URING, "iouring", &(int){serverOptions[OT_IO_URING].dataItem.itemInt});
     register_option(INT_TYPE, OT_WAIT_TIME, "waittime", &(int){serverOptions[OT_WAIT_TIME].dataItem.itemInt});
 }
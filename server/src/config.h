@@ -5,17 +5,37 @@
 
 /* server settings */
 typedef enum {
+    OT_POLL_BACKEND,
     OT_DAEMON,
     OT_ECHO,
     OT_MAX_FDS,
     OT_SERVER_LOG_LEVEL,
     OT_SERVER_NAME,
     OT_PORT,
+    OT_USER_QUEUE_POLICY,
+    OT_CHANNEL_QUEUE_POLICY,
+    OT_SENDQ_LIMIT,
+    OT_SHARDS,
     OT_THREADS,
+    OT_IO_URING,
     OT_WAIT_TIME,
     SERVER_OT_COUNT
 } ServerOptionType;
 
+/* handling of a message for a full user or 
+    channel queue. a single threaded server can't 
+    block the producer, so the message is refused 
+    and the sender is asked to try again. only a 
+    user queue disconnects its consumer */
+typedef enum {
+    QP_DROP_OLDEST,
+    QP_DROP_NEWEST,
+    QP_BLOCK,
+    QP_DISCONNECT,
+    UNKNOWN_QUEUE_POLICY,
+    QUEUE_POLICY_COUNT
+} QueuePolicy;
+
 /* run server as daemon process */
 void daemonize(void);
 
@@ -1,5 +1,6 @@
 
 #ifdef TEST
+#include "priv_dispatcher.h"
 #else
 #include "dispatcher.h"
 #endif
@@ -20,6 +21,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <poll.h>
 
 #ifdef TEST
 #define STATIC
@@ -36,18 +38,60 @@ typedef struct {
     CommandTokens *cmdTokens;
 } EventContext;
 
-static EventContext eventContext = {NULL};
+/* each event loop thread has its own context */
+static _Thread_local EventContext eventContext = {NULL};
 
+STATIC void create_client_msg_events(EventManager *eventManager, TCPServer *tcpServer, int fd);
+STATIC void write_socket_output(EventManager *eventManager, TCPServer *tcpServer, int fd);
 STATIC void detect_pipe_event_type(const char *message, Event *event);
 STATIC void execute_command(TCPServer *tcpServer, Client *client, CommandTokens *cmdTokens);
 
+void process_poll_events(EventManager *eventManager, PollManager *pollManager, StreamPipe *streamPipe, TCPServer *tcpServer, int fdsReady) {
+
+    if (eventManager == NULL || pollManager == NULL || streamPipe == NULL || tcpServer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    /* only fd's with pending events are visited */
+    for (int i = 0; i < fdsReady; i++) {
+
+        int fd = get_ready_fd(pollManager, i);
+
+        if (fd == get_pipe_fd(streamPipe, READ_PIPE)) {
+
+            if (is_ready_input_event(pollManager, i)) {
+                process_pipe_data(eventManager, streamPipe);
+            }
+        }
+        else if (fd == get_server_listen_fd(tcpServer)) {
+
+            if (is_ready_input_event(pollManager, i)) {
+                process_connection_request(eventManager, tcpServer);
+            }
+        }
+        else {
+
+            if (is_ready_output_event(pollManager, i)) {
+                process_socket_output(eventManager, tcpServer, fd);
+            }
+
+            if (is_ready_input_event(pollManager, i)) {
+                process_socket_data(eventManager, tcpServer, fd);
+            }
+            else if (is_ready_error_event(pollManager, i)) {
+                trigger_event_client_disconnect(eventManager, fd);
+            }
+        }
+    }
+}
+
 void process_connection_request(EventManager *eventManager, TCPServer *tcpServer) {
     
     if (eventManager == NULL || tcpServer == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    Event event = {.eventType = NETWORK_EVENT, .subEventType = NE_CLIENT_CONNECT, .dataItem = (DataItem) {0}, .dataType = UNKNOWN_DATA_TYPE};
+    Event event = {.eventType = NETWORK_EVENT, .subEventType = NE_CLIENT_CONNECT};
 
     push_event_to_queue(eventManager, &event);
 }
@@ -65,7 +109,7 @@ void process_pipe_data(EventManager *eventManager, StreamPipe *streamPipe) {
 
     while (extract_message(message, ARRAY_SIZE(message), pipeBuffer, CRLF)) {
 
-        Event event = {.eventType = UNKNOWN_EVENT_TYPE, .subEventType = UNASSIGNED, .dataItem = (DataItem) {0}, .dataType = UNKNOWN_DATA_TYPE};
+        Event event = {.eventType = UNKNOWN_EVENT_TYPE, .subEventType = UNASSIGNED};
 
         detect_pipe_event_type(message, &event);
 
@@ -85,31 +129,69 @@ void process_socket_data(EventManager *eventManager, TCPServer *tcpServer, int f
         FAILED(ARG_ERROR, NULL);
     }
 
-    int readStatus = server_read(tcpServer, eventManager, fd);
+    char readBuffer[MAX_CHARS + 1] = {'\0'};
 
-    if (readStatus == 1) {
+    ssize_t bytesRead = server_recv(tcpServer, eventManager, fd, readBuffer, ARRAY_SIZE(readBuffer));
 
-        int fdIdx = find_fd_idx_in_hash_table(get_server_fds_idx_map(tcpServer), fd);
-        Client *client = get_client(tcpServer, fdIdx);
+    if (bytesRead > 0) {
+        process_received_data(eventManager, tcpServer, fd, readBuffer, bytesRead);
+    }
+}
 
-        char message[MAX_CHARS + 1] = {'\0'};
+void process_received_data(EventManager *eventManager, TCPServer *tcpServer, int fd, const char *data, int len) {
 
-        while (extract_message(message, ARRAY_SIZE(message), get_client_inbuffer(client), CRLF)) {
+    if (eventManager == NULL || tcpServer == NULL || data == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
 
-            char fmtMessage[MAX_CHARS + 1] = {'\0'};
-            char fdStr[MAX_DIGITS] = {'\0'};
+    /* received data may exceed the size of the client's
+        input buffer, so it is buffered in parts, and 
+        complete messages are extracted after each part */
+    while (len > 0) {
 
-            uint_to_str(fdStr, ARRAY_SIZE(fdStr), fd);
-            const char *tokens[] = {fdStr, "|", message};
+        int bytesBuffered = buffer_client_data(tcpServer, fd, data, len);
 
-            concat_tokens(fmtMessage, ARRAY_SIZE(fmtMessage), tokens, ARRAY_SIZE(tokens), "");
+        if (bytesBuffered <= 0) {
+            break;
+        }
 
-            Event event = {.eventType = NETWORK_EVENT, .subEventType = NE_CLIENT_MSG, .dataItem = (DataItem) {.itemChar = ""}, .dataType = CHAR_TYPE};
-            safe_copy(event.dataItem.itemChar, ARRAY_SIZE(event.dataItem.itemChar), fmtMessage);
+        create_client_msg_events(eventManager, tcpServer, fd);
 
-            push_event_to_queue(eventManager, &event);
+        data += bytesBuffered;
+        len -= bytesBuffered;
+    }
+}
+
+STATIC void create_client_msg_events(EventManager *eventManager, TCPServer *tcpServer, int fd) {
+
+    if (eventManager == NULL || tcpServer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int fdIdx = get_client_fd_idx(tcpServer, fd);
+
+    if (fdIdx == UNASSIGNED) {
+        return;
+    }
+
+    char *inBuffer = get_client_inbuffer(get_client(tcpServer, fdIdx));
+    char *message = inBuffer;
+    char *delimiter = NULL;
+
+    /* complete messages are copied from the client's 
+        buffer to the event arena, the incomplete 
+        remainder is kept in the buffer */
+    while ((delimiter = find_delimiter(message, CRLF)) != NULL) {
+
+        if (delimiter > message) {
+
+            Event event = {.eventType = NETWORK_EVENT, .subEventType = NE_CLIENT_MSG, .fd = fd};
+            push_message_event_to_queue(eventManager, &event, message, delimiter - message);
         }
+        message = delimiter + CRLF_LEN;
     }
+
+    memmove(inBuffer, message, strlen(message) + 1);
 }
 
 void dispatch_events(EventManager *eventManager) {
@@ -146,22 +228,27 @@ void handle_ne_client_disconnect_event(Event *event) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    int fdIdx = find_fd_idx_in_hash_table(get_server_fds_idx_map(eventContext.tcpServer), event->dataItem.itemInt);
+    int fdIdx = get_client_fd_idx(eventContext.tcpServer, event->fd);
+
+    /* a client may be reported as disconnected more
+        than once (e.g. by a failed read and write) */
+    if (fdIdx == UNASSIGNED) {
+        return;
+    }
+
     Client *client = get_client(eventContext.tcpServer, fdIdx);
     Session *session = get_session(eventContext.tcpServer);
-    User *user = find_user_in_hash_table(session, get_client_nickname(client));
+    User *user = get_client_user(client);
 
     if (user != NULL) {
 
         // <:nickname!username@hostname> QUIT <:message>
-        char fwdMessage[MAX_CHARS + CRLF_LEN + 1] = {'\0'};
-
-        create_irc_message(fwdMessage, MAX_CHARS, &(IRCMessage){{"QUIT"}, {NULL}, 0, create_user_info, user});
+        int fwdMessageLen = 0;
+        const char *fwdMessage = create_irc_line(get_message_arena(eventContext.tcpServer), MAX_CHARS, &(IRCMessage){{"QUIT"}, {NULL}, 0, get_user_prefix(user)}, &fwdMessageLen);
 
-        leave_all_channels(get_session(eventContext.tcpServer), user, fwdMessage);
+        leave_all_channels(get_session(eventContext.tcpServer), user, fwdMessage, fwdMessageLen);
 
-        ReadyList *readyList = get_ready_list(session);
-        remove_user_from_ready_list(get_ready_users(readyList), user);
+        remove_user_from_ready_list(get_ready_list(session), user);
 
         unregister_user(session, user);
     }
@@ -175,8 +262,8 @@ void handle_ne_remove_poll_fd_event(Event *event) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    unset_poll_fd(eventContext.pollManager, event->dataItem.itemInt);
-    close(event->dataItem.itemInt);
+    unset_poll_fd(eventContext.pollManager, event->fd);
+    close(event->fd);
 }
 
 void handle_ne_add_poll_fd_event(Event *event) {
@@ -185,7 +272,7 @@ void handle_ne_add_poll_fd_event(Event *event) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    set_poll_fd(eventContext.pollManager, event->dataItem.itemInt);
+    set_poll_fd(eventContext.pollManager, event->fd);
 }
 
 void handle_ne_client_msg_event(Event *event) {
@@ -194,22 +281,37 @@ void handle_ne_client_msg_event(Event *event) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (count_delimiters(event->dataItem.itemChar, "|") == 1) {
+    int fdIdx = get_client_fd_idx(eventContext.tcpServer, event->fd);
 
-        const char *tokens[MSG_TOKENS] = {NULL};
-        tokenize_string(event->dataItem.itemChar, tokens, ARRAY_SIZE(tokens), "|");
+    /* the client may have been removed earlier in 
+        the same iteration */
+    if (fdIdx == UNASSIGNED) {
+        return;
+    }
 
-        int fdIdx = find_fd_idx_in_hash_table(get_server_fds_idx_map(eventContext.tcpServer), str_to_uint(tokens[0]));
-        Client *client = get_client(eventContext.tcpServer, fdIdx);
+    Client *client = get_client(eventContext.tcpServer, fdIdx);
 
-        if (get_int_option_value(OT_ECHO)) {
-            add_message_to_queue(eventContext.tcpServer, client, tokens[1]);
-        }
-        else {
-            parse_message(tokens[1], eventContext.cmdTokens);
-            execute_command(eventContext.tcpServer, client, eventContext.cmdTokens);
-        }
+    /* the event's message is released with the event 
+        queue, so the queued copy is made in the 
+        message arena */
+    if (get_int_option_value(OT_ECHO)) {
+
+        const char *message = copy_to_arena(get_message_arena(eventContext.tcpServer), event->message, event->len);
+        add_message_to_queue(eventContext.tcpServer, client, message, event->len);
     }
+    else {
+        parse_message(event->message, eventContext.cmdTokens);
+        execute_command(eventContext.tcpServer, client, eventContext.cmdTokens);
+    }
+}
+
+void handle_ne_hostname_resolved_event(Event *event) {
+
+    if (event == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    update_client_hostnames(eventContext.tcpServer);
 }
 
 void handle_se_exit_event(Event *event) {
@@ -230,6 +332,10 @@ STATIC void detect_pipe_event_type(const char *message, Event *event) {
         event->eventType = SYSTEM_EVENT;
         event->subEventType = SE_EXIT;
     }
+    else if (strcmp(message, "resolved") == 0) {
+        event->eventType = NETWORK_EVENT;
+        event->subEventType = NE_HOSTNAME_RESOLVED;
+    }
 }
 
 STATIC void execute_command(TCPServer *tcpServer, Client *client, CommandTokens *cmdTokens) {
@@ -269,23 +375,80 @@ void send_socket_messages(EventManager *eventManager, TCPServer *tcpServer) {
             const char *tokens[MSG_TOKENS] = {NULL};
             tokenize_string(message, tokens, ARRAY_SIZE(tokens), "|");
 
-            server_write(tcpServer, eventManager, str_to_uint(tokens[0]), tokens[1]);
+            server_write(tcpServer, eventManager, str_to_uint(tokens[0]), tokens[1], strlen(tokens[1]));
         }
     }
 
     struct {
         TCPServer *tcpServer;
         EventManager *eventManager;
-        const char *message;
+        SharedBuffer *buffer;
     } data = {tcpServer, eventManager, NULL};
 
     /* send messages from users' and channels' queues ( 
         users and channels have dedicated queues) */
-    iterate_list(get_ready_channels(get_ready_list(session)), send_channel_queue_messages, &data);
-    iterate_list(get_ready_users(get_ready_list(session)), send_user_queue_messages, &data);
+    ReadyList *readyList = get_ready_list(session);
+    Channel *channel = NULL;
+    User *user = NULL;
+
+    while ((channel = pop_ready_channel(readyList)) != NULL) {
+        send_channel_queue_messages(channel, &data);
+    }
+    while ((user = pop_ready_user(readyList)) != NULL) {
+        send_user_queue_messages(user, &data);
+    }
+
+    /* the queues are drained, so the formatted 
+        messages are no longer referenced */
+    reset_arena(get_message_arena(tcpServer));
+}
+
+void process_socket_output(EventManager *eventManager, TCPServer *tcpServer, int fd) {
+
+    if (eventManager == NULL || tcpServer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
 
-    reset_linked_list(get_ready_users(get_ready_list(session)));
-    reset_linked_list(get_ready_channels(get_ready_list(session)));
+    write_socket_output(eventManager, tcpServer, fd);
+}
+
+void flush_socket_messages(EventManager *eventManager, TCPServer *tcpServer) {
+
+    if (eventManager == NULL || tcpServer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    Client *client = NULL;
+
+    /* write output of clients with buffered messages */
+    while ((client = pop_pending_write(tcpServer)) != NULL) {
+
+        int fd = get_client_fd(client);
+
+        /* clients waiting for POLLOUT are written to 
+            when the socket becomes writable */
+        if (fd != UNASSIGNED && !(get_poll_fd_events(eventContext.pollManager, fd) & POLLOUT)) {
+            write_socket_output(eventManager, tcpServer, fd);
+        }
+    }
+}
+
+STATIC void write_socket_output(EventManager *eventManager, TCPServer *tcpServer, int fd) {
+
+    if (eventManager == NULL || tcpServer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int pendingBytes = server_flush(tcpServer, eventManager, fd);
+
+    /* if the socket's send buffer is full, the rest of
+        the output is sent when the socket is writable */
+    if (pendingBytes > 0) {
+        set_poll_fd_events(eventContext.pollManager, fd, POLLIN | POLLOUT);
+    }
+    else if (pendingBytes == 0) {
+        set_poll_fd_events(eventContext.pollManager, fd, POLLIN);
+    }
 }
 
 void set_event_context(EventManager *eventManager, PollManager *pollManager, TCPServer *tcpServer, CommandTokens *cmdTokens) {
@@ -311,5 +474,6 @@ void register_event_handlers(EventManager *eventManager) {
     register_network_event_handler(eventManager, NE_CLIENT_MSG, handle_ne_client_msg_event);
     register_network_event_handler(eventManager, NE_ADD_POLL_FD, handle_ne_add_poll_fd_event);
     register_network_event_handler(eventManager, NE_REMOVE_POLL_FD, handle_ne_remove_poll_fd_event);
+    register_network_event_handler(eventManager, NE_HOSTNAME_RESOLVED, handle_ne_hostname_resolved_event);
     register_system_event_handler(eventManager, SE_EXIT, handle_se_exit_event);
 }
\ No newline at end of file
@@ -7,10 +7,16 @@
 #include "../../libs/src/command.h"
 #include "../../libs/src/io_utils.h"
 
+/* process the events reported by the poll manager */
+void process_poll_events(EventManager *eventManager, PollManager *pollManager, StreamPipe *streamPipe, TCPServer *tcpServer, int fdsReady);
 void process_connection_request(EventManager *eventManager, TCPServer *tcpServer);
 void process_pipe_data(EventManager *eventManager, StreamPipe *streamPipe);
 void process_socket_data(EventManager *eventManager, TCPServer *tcpServer, int fd);
 
+/* process data which was already received from
+    the socket */
+void process_received_data(EventManager *eventManager, TCPServer *tcpServer, int fd, const char *data, int len);
+
 void dispatch_events(EventManager *eventManager);
 
 void handle_ne_client_connect_event(Event *event);
@@ -18,10 +24,15 @@ void handle_ne_client_disconnect_event(Event *event);
 void handle_ne_add_poll_fd_event(Event *event);
 void handle_ne_remove_poll_fd_event(Event *event);
 void handle_ne_client_msg_event(Event *event);
+void handle_ne_hostname_resolved_event(Event *event);
 void handle_se_exit_event(Event *event);
 
 void send_socket_messages(EventManager *eventManager, TCPServer *tcpServer);
 
+/* write buffered output to sockets */
+void process_socket_output(EventManager *eventManager, TCPServer *tcpServer, int fd);
+void flush_socket_messages(EventManager *eventManager, TCPServer *tcpServer);
+
 void set_event_context(EventManager *eventManager, PollManager *pollManager, TCPServer *tcpServer, CommandTokens *cmdTokens);
 
 void register_event_handlers(EventManager *eventManager);
@@ -0,0 +1,289 @@
+#ifdef TEST
+#include "priv_event_loop.h"
+#else
+#include "event_loop.h"
+#endif
+
+#include "dispatcher.h"
+
+#include "../../libs/src/error_control.h"
+#include "../../libs/src/logger.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#ifdef TEST
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+#define DEF_MAILBOX_CAPACITY 64
+#define WAKEUP_MESSAGE "wakeup\r\n"
+
+#ifndef TEST
+
+/* a new connection (without a buffer) or a message
+    for a client of the event loop, sent by another
+    thread */
+typedef struct {
+    int fd;
+    SharedBuffer *buffer;
+} Mail;
+
+/* the mailbox is accessed only while holding the
+    session lock */
+struct EventLoop {
+    int id;
+    EventManager *eventManager;
+    PollManager *pollManager;
+    StreamPipe *streamPipe;
+    TCPServer *tcpServer;
+    CommandTokens *cmdTokens;
+    Mail *mailbox;
+    int mailCount;
+    int mailCapacity;
+};
+
+#endif
+
+static pthread_mutex_t sessionLock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_bool stopping = 0;
+
+static _Thread_local EventLoop *currentLoop = NULL;
+static _Thread_local bool sessionLocked = 0;
+static _Thread_local bool deliveringMail = 0;
+
+STATIC void deliver_mail(EventLoop *eventLoop);
+
+EventLoop * create_event_loop(int id, EventManager *eventManager, PollManager *pollManager, StreamPipe *streamPipe, TCPServer *tcpServer, CommandTokens *cmdTokens) {
+
+    if (eventManager == NULL || pollManager == NULL || streamPipe == NULL || tcpServer == NULL || cmdTokens == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    EventLoop *eventLoop = (EventLoop*) calloc(1, sizeof(EventLoop));
+    if (eventLoop == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    eventLoop->id = id;
+    eventLoop->eventManager = eventManager;
+    eventLoop->pollManager = pollManager;
+    eventLoop->streamPipe = streamPipe;
+    eventLoop->tcpServer = tcpServer;
+    eventLoop->cmdTokens = cmdTokens;
+
+    return eventLoop;
+}
+
+void delete_event_loop(EventLoop *eventLoop) {
+
+    if (eventLoop == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < eventLoop->mailCount; i++) {
+
+        if (eventLoop->mailbox[i].buffer != NULL) {
+            release_shared_buffer(eventLoop->mailbox[i].buffer);
+        }
+        else {
+            close(eventLoop->mailbox[i].fd);
+        }
+    }
+
+    free(eventLoop->mailbox);
+    free(eventLoop);
+}
+
+void init_event_loops(void) {
+
+    atomic_store(&stopping, 0);
+    enable_log_locking(1);
+}
+
+void run_event_loop(EventLoop *eventLoop) {
+
+    if (eventLoop == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    currentLoop = eventLoop;
+
+    set_event_context(eventLoop->eventManager, eventLoop->pollManager, eventLoop->tcpServer, eventLoop->cmdTokens);
+
+    /* reading and writing of sockets runs in parallel,
+        while the events, which access the session, are
+        dispatched by one loop at a time */
+    while (!atomic_load(&stopping)) {
+
+        int timeout = is_event_queue_empty(eventLoop->eventManager) ? -1 : 0;
+
+        int fdsReady = wait_for_poll_events(eventLoop->pollManager, timeout);
+
+        if (fdsReady < 0) {
+
+            if (errno == EINTR) {
+                continue;
+            }
+            else {
+                FAILED(NO_ERRCODE, "Error polling descriptors");
+            }
+        }
+
+        process_poll_events(eventLoop->eventManager, eventLoop->pollManager, eventLoop->streamPipe, eventLoop->tcpServer, fdsReady);
+
+        lock_session();
+
+        if (atomic_load(&stopping)) {
+            unlock_session();
+            break;
+        }
+
+        /* mail is delivered before the events are
+            dispatched, so that it can't reach a new
+            client which reused the fd of a disconnected
+            client */
+        deliver_mail(eventLoop);
+
+        dispatch_events(eventLoop->eventManager);
+        send_socket_messages(eventLoop->eventManager, eventLoop->tcpServer);
+
+        unlock_session();
+
+        flush_socket_messages(eventLoop->eventManager, eventLoop->tcpServer);
+    }
+}
+
+void stop_event_loops(void) {
+
+    atomic_store(&stopping, 1);
+
+    /* the server is usually stopped by an event
+        handler, while it holds the session lock */
+    if (sessionLocked) {
+        unlock_session();
+    }
+}
+
+bool are_event_loops_stopping(void) {
+
+    return atomic_load(&stopping);
+}
+
+void lock_session(void) {
+
+    pthread_mutex_lock(&sessionLock);
+    sessionLocked = 1;
+}
+
+void unlock_session(void) {
+
+    sessionLocked = 0;
+    pthread_mutex_unlock(&sessionLock);
+}
+
+bool forward_to_event_loop(EventLoop *eventLoop, int fd, SharedBuffer *buffer) {
+
+    if (buffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    /* mail for a client which has already left isn't
+        forwarded to a new client with the same fd */
+    if (eventLoop == NULL || eventLoop == currentLoop || deliveringMail) {
+        return 0;
+    }
+
+    post_mail(eventLoop, fd, buffer);
+
+    return 1;
+}
+
+void post_mail(EventLoop *eventLoop, int fd, SharedBuffer *buffer) {
+
+    if (eventLoop == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    if (eventLoop->mailCount == eventLoop->mailCapacity) {
+
+        int capacity = eventLoop->mailCapacity ? eventLoop->mailCapacity * 2 : DEF_MAILBOX_CAPACITY;
+
+        Mail *mailbox = (Mail*) realloc(eventLoop->mailbox, capacity * sizeof(Mail));
+        if (mailbox == NULL) {
+            FAILED(ALLOC_ERROR, NULL);
+        }
+
+        eventLoop->mailbox = mailbox;
+        eventLoop->mailCapacity = capacity;
+    }
+
+    if (buffer != NULL) {
+        retain_shared_buffer(buffer);
+    }
+    eventLoop->mailbox[eventLoop->mailCount++] = (Mail) {fd, buffer};
+
+    /* the loop is woken only once, until it empties
+        its mailbox */
+    if (eventLoop->mailCount == 1) {
+        wake_event_loop(eventLoop);
+    }
+}
+
+void wake_event_loop(EventLoop *eventLoop) {
+
+    if (eventLoop == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    /* the message isn't recognized as an event, it only
+        interrupts the wait for poll events */
+    if (write(get_pipe_fd(eventLoop->streamPipe, WRITE_PIPE), WAKEUP_MESSAGE, strlen(WAKEUP_MESSAGE)) < 0 && errno != EAGAIN) {
+        LOG(ERROR, "Error waking event loop %d", eventLoop->id);
+    }
+}
+
+EventLoop * get_current_event_loop(void) {
+
+    return currentLoop;
+}
+
+int get_event_loop_id(EventLoop *eventLoop) {
+
+    if (eventLoop == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return eventLoop->id;
+}
+
+STATIC void deliver_mail(EventLoop *eventLoop) {
+
+    if (eventLoop == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    deliveringMail = 1;
+
+    for (int i = 0; i < eventLoop->mailCount; i++) {
+
+        Mail *mail = &eventLoop->mailbox[i];
+
+        if (mail->buffer == NULL) {
+            register_connection(eventLoop->tcpServer, eventLoop->eventManager, mail->fd);
+        }
+        else {
+            server_write_buffer(eventLoop->tcpServer, eventLoop->eventManager, mail->fd, mail->buffer);
+            release_shared_buffer(mail->buffer);
+        }
+    }
+
+    deliveringMail = 0;
+    eventLoop->mailCount = 0;
+}
@@ -0,0 +1,65 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include "tcp_server.h"
+#include "../../libs/src/event.h"
+#include "../../libs/src/io_utils.h"
+#include "../../libs/src/poll_manager.h"
+#include "../../libs/src/command.h"
+
+/* an event loop which runs on its own thread and
+    shares the session with the loops on other
+    threads. the loops read and write their sockets
+    in parallel, while the events, which access the
+    session, are dispatched by one loop at a time.
+    other threads pass messages and new connections
+    to the loop through its mailbox. the loop doesn't
+    own the given resources */
+typedef struct EventLoop EventLoop;
+
+EventLoop * create_event_loop(int id, EventManager *eventManager, PollManager *pollManager, StreamPipe *streamPipe, TCPServer *tcpServer, CommandTokens *cmdTokens);
+
+/* undelivered messages are released and undelivered
+    connections are closed */
+void delete_event_loop(EventLoop *eventLoop);
+
+/* clear the stop flag of the event loops, before they
+    are run */
+void init_event_loops(void);
+
+/* run the event loop on the calling thread, until
+    the loops are stopped */
+void run_event_loop(EventLoop *eventLoop);
+
+/* stop all event loops. the session lock is released
+    if the calling thread holds it. the loops notice
+    the stop flag when they are woken */
+void stop_event_loops(void);
+bool are_event_loops_stopping(void);
+
+void lock_session(void);
+void unlock_session(void);
+
+/* forward a message to a client of the event loop.
+    returns 0 if the loop is the calling thread's
+    loop or if the calling loop is delivering its
+    mail, since a client which has received the mail's
+    fd after its recipient left isn't the recipient.
+    must be called while holding the session lock */
+bool forward_to_event_loop(EventLoop *eventLoop, int fd, SharedBuffer *buffer);
+
+/* post a message or a new connection (without a
+    buffer) to the event loop's mailbox. must be
+    called while holding the session lock */
+void post_mail(EventLoop *eventLoop, int fd, SharedBuffer *buffer);
+
+/* interrupt the event loop's wait for poll events */
+void wake_event_loop(EventLoop *eventLoop);
+
+/* returns the event loop of the calling thread or
+    NULL if the thread doesn't run a loop */
+EventLoop * get_current_event_loop(void);
+
+int get_event_loop_id(EventLoop *eventLoop);
+
+#endif
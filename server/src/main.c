@@ -1,11 +1,17 @@
 #include "config.h"
 #include "tcp_server.h"
 #include "dispatcher.h"
+#include "uring_core.h"
+#include "shard.h"
+#include "mt_core.h"
 #include "../../libs/src/event.h"
 #include "../../libs/src/settings.h"
 #include "../../libs/src/io_utils.h"
 #include "../../libs/src/poll_manager.h"
+#include "../../libs/src/uring.h"
 #include "../../libs/src/command.h"
+#include "../../libs/src/hash_table.h"
+#include "../../libs/src/slab.h"
 #include "../../libs/src/signal_handler.h"
 #include "../../libs/src/error_control.h"
 #include "../../libs/src/logger.h"
@@ -23,6 +29,8 @@ typedef struct {
     StreamPipe *streamPipe;
     TCPServer *tcpServer;
     PollManager *pollManager;
+    IoUring *ioUring;
+    Resolver *resolver;
     CommandTokens *cmdTokens;
 } AppContext;
 
@@ -32,12 +40,17 @@ static AppContext appContext = {NULL};
 
 static void run_standard_server(void);
 static void cleanup(void);
+static void log_slab_usage(const char *name, SlabAllocator *slabAllocator);
 
 int main(int argc, char **argv)
 {
     /* register cleanup function */
     atexit(cleanup);
 
+    /* nicknames and channels are hashed with a random 
+        key, before any table is created */
+    init_hash_seed();
+
     /* register event handlers */
     appContext.eventManager = create_event_manager(0);
     register_event_handlers(appContext.eventManager);
@@ -65,6 +78,19 @@ int main(int argc, char **argv)
     if (get_int_option_value(OT_THREADS)) {
         LOG(INFO, "Multithreading enabled");
     }
+    if (get_int_option_value(OT_IO_URING)) {
+        LOG(INFO, "io_uring event loop enabled");
+    }
+    if (get_int_option_value(OT_IO_URING) && get_int_option_value(OT_THREADS)) {
+
+        LOG(WARNING, "Multithreading is not supported with io_uring");
+        set_option_value(OT_THREADS, &(int){0});
+    }
+    if (get_int_option_value(OT_SHARDS) > 1 && get_int_option_value(OT_IO_URING)) {
+
+        LOG(WARNING, "Multiple event loops are not supported in this mode");
+        set_option_value(OT_SHARDS, &(int){1});
+    }
 
     /*  a pipe is used to handle registered signals 
         with poll(). signals interrupt poll() and
@@ -76,14 +102,25 @@ int main(int argc, char **argv)
     set_server_pipe_fd(get_pipe_fd(appContext.streamPipe, WRITE_PIPE));
 
     /* poll manager tracks input activity on socket and 
-        pipe fd's */
-    appContext.pollManager = create_poll_manager(get_int_option_value(OT_MAX_FDS), POLLIN);
+        pipe fd's. epoll is used by default, so that the
+        cost of each iteration depends on the number of
+        ready fd's rather than on the number of connections */
+    appContext.pollManager = create_poll_manager(get_int_option_value(OT_MAX_FDS), POLLIN, get_int_option_value(OT_POLL_BACKEND));
+    LOG(INFO, "Using %s backend", get_poll_backend_type_strings()[get_poll_backend_type(appContext.pollManager)]);
 
     /* tcpServer provides networking functionality for 
         the app */
     appContext.tcpServer = create_server(get_int_option_value(OT_MAX_FDS));
+    set_server_fd_table(appContext.tcpServer, get_poll_fd_table(appContext.pollManager));
     int listenFd = init_server(appContext.tcpServer, NULL, get_int_option_value(OT_PORT));
 
+    /* hostnames of clients are looked up by worker 
+        threads, which report completed lookups 
+        through the pipe */
+    enable_log_locking(1);
+    appContext.resolver = create_resolver(DEF_RESOLVER_THREADS, DEF_RESOLVER_CACHE_CAPACITY, DEF_RESOLVER_CACHE_TTL, NULL);
+    set_server_resolver(appContext.tcpServer, appContext.resolver, get_pipe_fd(appContext.streamPipe, WRITE_PIPE));
+
     /* set fd for pipe and listening socket */
     set_poll_fd(appContext.pollManager, get_pipe_fd(appContext.streamPipe, READ_PIPE));
     set_poll_fd(appContext.pollManager, listenFd);
@@ -98,7 +135,22 @@ int main(int argc, char **argv)
 
     set_event_context(appContext.eventManager, appContext.pollManager, appContext.tcpServer, appContext.cmdTokens);
 
-    if (!get_int_option_value(OT_THREADS)) {
+    if (get_int_option_value(OT_IO_URING)) {
+
+        appContext.ioUring = create_io_uring(DEF_URING_ENTRIES);
+        run_uring_server(appContext.ioUring, appContext.eventManager, appContext.streamPipe, appContext.tcpServer);
+    }
+    else if (get_int_option_value(OT_THREADS)) {
+
+        /* without -c, a reader is started for every CPU */
+        int threadCount = get_int_option_value(OT_SHARDS) > 0 ? get_int_option_value(OT_SHARDS) : sysconf(_SC_NPROCESSORS_ONLN);
+
+        run_concurrent_server(appContext.eventManager, appContext.pollManager, appContext.streamPipe, appContext.tcpServer, threadCount);
+    }
+    else if (get_int_option_value(OT_SHARDS) > 1) {
+        run_sharded_server(appContext.eventManager, appContext.pollManager, appContext.streamPipe, appContext.tcpServer, appContext.cmdTokens, get_int_option_value(OT_SHARDS));
+    }
+    else {
         run_standard_server();  
     }
     return 0;
@@ -114,20 +166,25 @@ static void run_standard_server(void) {
         2. read data from pipe and socket fd,
         3. create input events and add them to event queue,
         4.  process events from the event queue and dispatch them to event handlers,
-        5.  send IRC responses to clients */
+        5.  send IRC responses to clients (responses which can't be sent
+            immediately are sent when the socket becomes writable) */
 
     while (1) {
 
-        /*  server uses I/O multiplexing with poll() to monitor pipe and
-            socket fd's for input events (readiness to read data). 
-            pipe is used for handling signals with poll(). sockets are
-            used for accepting connection requests from clients and 
-            exchanging data with clients */
-        int fdsReady = poll(get_poll_pfds(appContext.pollManager), get_poll_fd_count(appContext.pollManager), -1);
+        /* if handlers generated new events (e.g. a client
+            exceeded its send queue), don't block */
+        int timeout = is_event_queue_empty(appContext.eventManager) ? -1 : 0;
+
+        /*  server uses I/O multiplexing with epoll (or poll()) to 
+            monitor pipe and socket fd's for input events (readiness 
+            to read data). pipe is used for handling signals. sockets 
+            are used for accepting connection requests from clients 
+            and exchanging data with clients */
+        int fdsReady = wait_for_poll_events(appContext.pollManager, timeout);
 
         if (fdsReady < 0) {
 
-            /* restart poll() if it was interrupted by a signal */
+            /* restart wait if it was interrupted by a signal */
             if (errno == EINTR) {
                 continue;
             }
@@ -136,35 +193,18 @@ static void run_standard_server(void) {
             }
         }
 
-        if (fdsReady && is_fd_input_event(appContext.pollManager, get_pipe_fd(appContext.streamPipe, READ_PIPE))) {
-            process_pipe_data(appContext.eventManager, appContext.streamPipe);
-            fdsReady--;
-        }
-
-        if (fdsReady && is_fd_input_event(appContext.pollManager, get_server_listen_fd(appContext.tcpServer))) {
-            process_connection_request(appContext.eventManager, appContext.tcpServer);
-            fdsReady--;
-        }
-
-        int connectedFd = get_server_listen_fd(appContext.tcpServer) + 1;
-
-        while (fdsReady && connectedFd < get_server_capacity(appContext.tcpServer)) {
-
-            if (is_fd_input_event(appContext.pollManager, connectedFd)) {
-
-                process_socket_data(appContext.eventManager, appContext.tcpServer, connectedFd);
-                fdsReady--;
-            }
-            else if (is_fd_error_event(appContext.pollManager, connectedFd)) {
-
-                trigger_event_client_disconnect(appContext.eventManager, connectedFd);
-                fdsReady--;
-            }
-            connectedFd++;
-        }
+        process_poll_events(appContext.eventManager, appContext.pollManager, appContext.streamPipe, appContext.tcpServer, fdsReady);
 
         dispatch_events(appContext.eventManager);
         send_socket_messages(appContext.eventManager, appContext.tcpServer);
+        flush_socket_messages(appContext.eventManager, appContext.tcpServer);
+    }
+}
+
+static void log_slab_usage(const char *name, SlabAllocator *slabAllocator) {
+
+    if (slabAllocator != NULL) {
+        LOG(INFO, "%s slab high-water mark: %d, in use: %d, slabs: %d (%d objects each)", name, get_slab_high_water_mark(slabAllocator), get_slab_object_count(slabAllocator), get_slab_count(slabAllocator), get_slab_capacity(slabAllocator));
     }
 }
 
@@ -172,10 +212,19 @@ static void run_standard_server(void) {
 static void cleanup(void) {
 
     if (!get_int_option_value(OT_DAEMON)) {
+        LOG(INFO, "Event queue high-water mark: %d, dropped events: %d", get_event_queue_high_water_mark(appContext.eventManager), get_dropped_events(appContext.eventManager));
+        log_slab_usage("User", get_user_slab());
+        log_slab_usage("Channel", get_channel_slab());
         LOG(INFO, "Terminated");
     }
 
+    /* resolver threads write to the pipes of the 
+        event loops, so they are stopped first */
+    delete_resolver(appContext.resolver);
+    stop_shards();
+    stop_concurrent_server();
     delete_command_tokens(appContext.cmdTokens);
+    delete_io_uring(appContext.ioUring);
     delete_poll_manager(appContext.pollManager);
     delete_server(appContext.tcpServer);
     delete_pipe(appContext.streamPipe);
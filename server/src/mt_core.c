@@ -1,17 +1,28 @@
 #define _XOPEN_SOURCE 700
 
 #ifdef TEST
+#include "priv_mt_core.h"
 #else
 #include "mt_core.h"
 #endif
 
-#include "tcp_server.h"
+#include "event_loop.h"
+#include "config.h"
+#include "dispatcher.h"
 
+#include "../../libs/src/common.h"
+#include "../../libs/src/settings.h"
+#include "../../libs/src/command.h"
 #include "../../libs/src/error_control.h"
 #include "../../libs/src/logger.h"
 
-#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <poll.h>
 
 #ifdef TEST
 #define STATIC
@@ -19,83 +30,70 @@
 #define STATIC static
 #endif
 
-static void * reader_thread(void *arg);
-static void * writer_thread(void *arg);
-static void handle_client_connection(TCPServer *tcpServer, int threadId);
-static void set_blocked_signals(void);
-
-static pthread_mutex_t writeMutex = PTHREAD_MUTEX_INITIALIZER;
-
-
-/* multithreaded server uses several threads:
-    1. main thread - handles initialization,
-        executes commands, sends messages and 
-        handles signals,
-    2. reader threads - read  parse client
-        messages and execute commands
-        from a subset of all sockets
-    3. writer thread - sends messages and writes
-        log file */
-static void run_concurrent_server(AppContext *appContext) {
-
-    ThreadPool *threadPool = create_thread_pool(get_fds_capacity(get_tcp_server_context())/ DEF_WORKLOAD, get_fds_capacity(get_tcp_server_context()));
-    Thread *thread = create_thread();
-
-    set_thread_pool_context(threadPool);
-    set_thread_context(thread);
+#ifndef TEST
+
+typedef struct {
+    ThreadData *threadData;
+    EventManager *eventManager;
+    PollManager *pollManager;
+    TCPServer *tcpServer;
+    CommandTokens *cmdTokens;
+    EventLoop *eventLoop;
+    int clientCount;
+} Reader;
+
+/* slots and client counts are accessed only while
+    holding the session lock */
+typedef struct {
+    ThreadPool *threadPool;
+    Reader *readers;
+    int readerCount;
+    TCPServer *tcpServer;
+    int *fdSlots;
+    int fdCount;
+    int *slotFds;
+    int slotCount;
+    bool running;
+} MtContext;
 
-    run_multiple_threads(get_thread_pool_context(), reader_thread);
-    run_single_thread(get_thread_context(), writer_thread);
+#endif
 
-    /* enable thread notifications */
-    set_thread_pool(get_thread_pool_context());
-    set_thread_pool_callback(notify_thread_pool);
+static MtContext mtContext = {0};
 
-    set_thread(get_thread_context());
-    set_thread_callback(notify_single_thread);
+STATIC void create_readers(TCPServer *tcpServer, int readerCount, int capacity);
+STATIC void delete_readers(void);
 
-    set_log_thread(get_thread_context());
-    set_log_thread_callback(notify_single_thread);
- 
-    join_single_thread(get_thread_context(), NULL);
-    join_multiple_threads(get_thread_pool_context(), NULL);
+STATIC void * run_reader_thread(void *arg);
 
-    delete_thread(get_thread_context());
-    delete_thread_pool(get_thread_pool_context());
-    
-}
+STATIC int assign_client_slot(int fd);
+STATIC void release_client_slot(int fd);
+STATIC int find_fd_reader(int fd);
 
-/* reader threads are responsible for reading incoming data
-    from the clients, parsing messages and executing commands.
-    the workload is divided between the threads, so that each
-    thread works on the subset of clients */
-static void * reader_thread(void *arg) {
+STATIC bool forward_to_reader(int fd, SharedBuffer *buffer);
 
-    set_blocked_signals();
+STATIC void handle_mt_client_connect_event(Event *event);
+STATIC void handle_mt_remove_fd_event(Event *event);
 
-    ThreadData *threadData = (ThreadData*)arg;
-    
-    /* the startIdx and endIdx define the range of 
-        sockets on which the thread will operate */
-    int startIdx = get_start_idx(threadData);
-    int endIdx = get_end_idx(threadData);
+void run_concurrent_server(EventManager *eventManager, PollManager *pollManager, StreamPipe *streamPipe, TCPServer *tcpServer, int threadCount) {
 
-    /* pipes are used for inter-thread communication */
-    const int FIRST_THREAD = get_thread_id(threadData) == 0 ? 1 : 0;
-    const int PIPE_IDX = FIRST_THREAD ? LISTEN_FD_IDX + 1: startIdx;
+    if (eventManager == NULL || pollManager == NULL || streamPipe == NULL || tcpServer == NULL || threadCount <= 0) {
+        FAILED(ARG_ERROR, NULL);
+    }
 
-    TCPServer *tcpServer = get_tcp_server_context();
+    create_readers(tcpServer, threadCount, get_server_capacity(tcpServer));
 
-    /* add pipe to the set of fd's monitored by poll() */
-    assign_fd(get_tcp_server_context(), PIPE_IDX, get_thread_pipe_fd(threadData, READ_PIPE));
+    /* the calling thread only accepts connections and
+        hands them over to the readers */
+    register_network_event_handler(eventManager, NE_CLIENT_CONNECT, handle_mt_client_connect_event);
 
-    CommandTokens *cmdTokens = create_command_tokens(1);
+    run_multiple_threads(mtContext.threadPool, run_reader_thread);
+    mtContext.running = 1;
 
-    int terminated = 0;
+    LOG(INFO, "Started %d reader threads", mtContext.readerCount);
 
-    while (!terminated) {
+    while (!are_event_loops_stopping()) {
 
-        int fdsReady = poll(&get_fds(tcpServer)[startIdx], endIdx - startIdx, -1);
+        int fdsReady = wait_for_poll_events(pollManager, -1);
 
         if (fdsReady < 0) {
 
@@ -103,142 +101,265 @@ static void * reader_thread(void *arg) {
                 continue;
             }
             else {
-                FAILED(NO_ERRCODE, "Error polling descriptors");  
+                FAILED(NO_ERRCODE, "Error polling descriptors");
             }
         }
 
-        while (fdsReady && startIdx < endIdx) {
-
-            if (is_fd_ready(tcpServer, startIdx)) {
-
-                /* first reader thread is responsible for 
-                    handling connection requests */
-                if (startIdx == LISTEN_FD_IDX) {
-
-                    handle_client_connection();
-                }  
-
-                /* reader thread may receive sginal related 
-                    message or a message from another thread.
-                    pipes are used as a form of inter-thread 
-                    communication */
-                else if (startIdx == PIPE_IDX) {
-
-                    struct {
-                        int *terminated;
-                        int *message;
-                        int *log;
-                    } data = {&terminated};
-
-                    read_pipe_messages(&data);
-                }       
-                else {
-                    read_socket_messages(tcpServer, cmdTokens, startIdx);
-
-                    pthread_mutex_lock(&writeMutex);
-                        
-                    if (!messagePending) {
-
-                        ThreadData *td = get_thread_data(get_thread_context());
-                        write_message(get_thread_pipe_fd(td, WRITE_PIPE), "message");
-                        messagePending = 1;
-                    }
-                    pthread_mutex_unlock(&writeMutex);
-                }
-                fdsReady--;
-            }
-            startIdx++;
+        process_poll_events(eventManager, pollManager, streamPipe, tcpServer, fdsReady);
+
+        lock_session();
+        dispatch_events(eventManager);
+        unlock_session();
+    }
+}
+
+void stop_concurrent_server(void) {
+
+    if (mtContext.readers == NULL) {
+        return;
+    }
+
+    stop_event_loops();
+
+    for (int i = 0; i < mtContext.readerCount; i++) {
+        wake_event_loop(mtContext.readers[i].eventLoop);
+    }
+
+    /* the server was terminated by an error on one of
+        the readers, which can't join itself */
+    if (get_current_event_loop() != NULL) {
+        return;
+    }
+
+    if (mtContext.running) {
+        join_multiple_threads(mtContext.threadPool, NULL);
+        mtContext.running = 0;
+    }
+
+    delete_readers();
+}
+
+STATIC void create_readers(TCPServer *tcpServer, int readerCount, int capacity) {
+
+    if (tcpServer == NULL || readerCount <= 0 || capacity <= 0) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    if (readerCount > capacity) {
+        readerCount = capacity;
+    }
+
+    /* every thread in the pool owns a range of client
+        slots */
+    mtContext.threadPool = create_thread_pool(readerCount, capacity);
+    mtContext.readerCount = get_thread_count(mtContext.threadPool);
+    mtContext.tcpServer = tcpServer;
+
+    mtContext.readers = (Reader*) calloc(mtContext.readerCount, sizeof(Reader));
+    mtContext.fdCount = sysconf(_SC_OPEN_MAX);
+    mtContext.fdSlots = (int*) malloc(mtContext.fdCount * sizeof(int));
+    mtContext.slotCount = capacity;
+    mtContext.slotFds = (int*) malloc(mtContext.slotCount * sizeof(int));
+
+    if (mtContext.readers == NULL || mtContext.fdSlots == NULL || mtContext.slotFds == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    for (int i = 0; i < mtContext.fdCount; i++) {
+        mtContext.fdSlots[i] = UNASSIGNED;
+    }
+    for (int i = 0; i < mtContext.slotCount; i++) {
+        mtContext.slotFds[i] = UNASSIGNED;
+    }
+
+    init_event_loops();
+    mtContext.running = 0;
+
+    for (int i = 0; i < mtContext.readerCount; i++) {
+
+        Reader *reader = &mtContext.readers[i];
+
+        reader->threadData = get_thread_data_from_pool(mtContext.threadPool, i);
+
+        reader->eventManager = create_event_manager(0);
+        register_event_handlers(reader->eventManager);
+        register_network_event_handler(reader->eventManager, NE_REMOVE_POLL_FD, handle_mt_remove_fd_event);
+
+        reader->pollManager = create_poll_manager(get_int_option_value(OT_MAX_FDS), POLLIN, get_int_option_value(OT_POLL_BACKEND));
+        set_poll_fd(reader->pollManager, get_thread_pipe_fd(reader->threadData, READ_PIPE));
+
+        int slots = get_end_idx(reader->threadData) - get_start_idx(reader->threadData);
+
+        reader->tcpServer = create_server(slots);
+        set_server_session(reader->tcpServer, get_session(tcpServer));
+        set_server_fd_table(reader->tcpServer, get_poll_fd_table(reader->pollManager));
+
+        if (get_server_resolver(tcpServer) != NULL) {
+            set_server_resolver(reader->tcpServer, get_server_resolver(tcpServer), get_thread_pipe_fd(reader->threadData, WRITE_PIPE));
         }
+        set_server_forward_func(reader->tcpServer, forward_to_reader);
+
+        reader->cmdTokens = create_command_tokens(1);
+
+        reader->eventLoop = create_event_loop(i, reader->eventManager, reader->pollManager, get_thread_pipe(reader->threadData), reader->tcpServer, reader->cmdTokens);
     }
+}
+
+STATIC void delete_readers(void) {
 
-    delete_command_tokens(get_cmd_tokens_context());
+    for (int i = 0; i < mtContext.readerCount; i++) {
+
+        Reader *reader = &mtContext.readers[i];
+
+        delete_event_loop(reader->eventLoop);
+        delete_command_tokens(reader->cmdTokens);
+        delete_poll_manager(reader->pollManager);
+        delete_server(reader->tcpServer);
+        delete_event_manager(reader->eventManager);
+    }
+
+    delete_thread_pool(mtContext.threadPool);
+
+    free(mtContext.readers);
+    free(mtContext.fdSlots);
+    free(mtContext.slotFds);
+
+    mtContext.threadPool = NULL;
+    mtContext.readers = NULL;
+    mtContext.fdSlots = NULL;
+    mtContext.slotFds = NULL;
+    mtContext.readerCount = 0;
+}
+
+STATIC void * run_reader_thread(void *arg) {
+
+    /* signals are handled by the main thread */
+    sigset_t blockedSignals;
+    sigfillset(&blockedSignals);
+    pthread_sigmask(SIG_BLOCK, &blockedSignals, NULL);
+
+    ThreadData *threadData = (ThreadData*) arg;
+
+    run_event_loop(mtContext.readers[get_thread_id(threadData)].eventLoop);
 
     return NULL;
 }
 
+/* the client is assigned to the reader with the
+    fewest clients. returns the reader's index or
+    UNASSIGNED if all slots are taken */
+STATIC int assign_client_slot(int fd) {
 
+    if (fd < 0 || fd >= mtContext.fdCount) {
+        FAILED(ARG_ERROR, NULL);
+    }
 
-/* writer thread handles sending messages to
-    clients and logging to a file */
-static void * writer_thread(void *arg) {
+    int readerIdx = UNASSIGNED;
 
-    set_blocked_signals();
+    for (int i = 0; i < mtContext.readerCount; i++) {
 
-    ThreadData *threadData = (ThreadData*)arg;
+        ThreadData *threadData = mtContext.readers[i].threadData;
+        int slots = get_end_idx(threadData) - get_start_idx(threadData);
 
-    struct pollfd pfd = {.events = POLL_IN, .fd = get_thread_pipe_fd(threadData, READ_PIPE)};
+        if (mtContext.readers[i].clientCount < slots && (readerIdx == UNASSIGNED || mtContext.readers[i].clientCount < mtContext.readers[readerIdx].clientCount)) {
+            readerIdx = i;
+        }
+    }
 
-    int terminated = 0;
+    if (readerIdx != UNASSIGNED) {
 
-    while (!terminated) {
+        ThreadData *threadData = mtContext.readers[readerIdx].threadData;
 
-        int fdsReady = poll(&pfd, 1, -1);
-        
-        if (fdsReady < 0) {
+        for (int i = get_start_idx(threadData); i < get_end_idx(threadData); i++) {
 
-            if (errno == EINTR) {
-                continue;
-            }
-            else {
-                FAILED(NO_ERRCODE, "Error polling descriptors");  
+            if (mtContext.slotFds[i] == UNASSIGNED) {
+
+                mtContext.slotFds[i] = fd;
+                mtContext.fdSlots[fd] = i;
+                mtContext.readers[readerIdx].clientCount++;
+                break;
             }
         }
-        else {
+    }
 
-            int message = 0, log = 0;
+    return readerIdx;
+}
 
-            struct {
-                int *terminated;
-                int *message;
-                int *log;
-            } data = {&terminated, &message, &log};
+STATIC void release_client_slot(int fd) {
 
-            read_pipe_messages(&data);
+    if (fd < 0 || fd >= mtContext.fdCount || mtContext.fdSlots[fd] == UNASSIGNED) {
+        return;
+    }
 
-            if (message) {
+    int slot = mtContext.fdSlots[fd];
+    int readerIdx = get_thread_idx_by_range_idx(mtContext.threadPool, slot);
 
-                /* send messages to clients */
-                pthread_mutex_lock(&writeMutex);
-                send_socket_messages(get_tcp_server_context());       
-                messagePending = 0;
-                pthread_mutex_unlock(&writeMutex);
-            }
-            else if (log) {
+    mtContext.slotFds[slot] = UNASSIGNED;
+    mtContext.fdSlots[fd] = UNASSIGNED;
+    mtContext.readers[readerIdx].clientCount--;
+}
 
-                write_log_to_file();
-                set_log_pending(0);
-            }
-        }
+STATIC int find_fd_reader(int fd) {
+
+    if (fd < 0 || fd >= mtContext.fdCount || mtContext.fdSlots[fd] == UNASSIGNED) {
+        return UNASSIGNED;
     }
-    return NULL;
+
+    return get_thread_idx_by_range_idx(mtContext.threadPool, mtContext.fdSlots[fd]);
 }
 
-static void set_blocked_signals(void) {
+STATIC bool forward_to_reader(int fd, SharedBuffer *buffer) {
+
+    if (buffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
 
-    /* thread blocks delivery of below signals 
-    because these are handled by the main 
-    thread */
-    sigset_t set;
-    sigemptyset(&set);
-    sigaddset(&set, SIGINT);
-    sigaddset(&set, SIGTERM);
-    pthread_sigmask(SIG_BLOCK, &set, NULL);
+    int readerIdx = find_fd_reader(fd);
+
+    if (readerIdx == UNASSIGNED) {
+        return 0;
+    }
+
+    return forward_to_event_loop(mtContext.readers[readerIdx].eventLoop, fd, buffer);
 }
 
-static void handle_client_connection(TCPServer *tcpServer, int threadId) {
+STATIC void handle_mt_client_connect_event(Event *event) {
 
-    int connectFd = accept_connection(tcpServer);
-    int fdIndex = find_fd_index(tcpServer, -1);
-    register_connection(tcpServer, fdIndex, connectFd);
+    if (event == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
 
-    ThreadPool *threadPool = get_thread_pool_context();
+    int fd = accept_connection(mtContext.tcpServer);
+    int readerIdx = assign_client_slot(fd);
 
-    int id = get_thread_id_by_range_idx(threadPool, fdIndex);
+    if (readerIdx == UNASSIGNED) {
 
-    /* notify thread of new client connection */
-    if (id != threadId) {
+        LOG(WARNING, "Connection refused, the server is full (fd: %d)", fd);
+        close(fd);
+    }
+    else {
+        post_mail(mtContext.readers[readerIdx].eventLoop, fd, NULL);
+    }
+}
+
+STATIC void handle_mt_remove_fd_event(Event *event) {
 
-        ThreadData *threadData = get_thread_data_from_pool(threadPool, threadId);
-        write_message(get_thread_pipe_fd(threadData, WRITE_PIPE), "client");
+    if (event == NULL) {
+        FAILED(ARG_ERROR, NULL);
     }
-}
\ No newline at end of file
+
+    /* the slot is released before the fd is closed,
+        so that it's free when the fd is reused */
+    release_client_slot(event->fd);
+
+    handle_ne_remove_poll_fd_event(event);
+}
+
+#ifdef TEST
+
+MtContext * get_mt_context(void) {
+
+    return &mtContext;
+}
+
+#endif
@@ -1,8 +1,23 @@
 #ifndef MT_CORE_H
 #define MT_CORE_H
 
+#include "tcp_server.h"
+#include "../../libs/src/event.h"
+#include "../../libs/src/io_utils.h"
+#include "../../libs/src/poll_manager.h"
 #include "../../libs/src/threads.h"
 
-void run_concurrent_server(AppContext *appContext);
+/* run the server with a pool of reader threads. the
+    calling thread handles signals and accepts new
+    connections with the given resources. every
+    reader thread owns a range of client slots and
+    reads, parses and writes data of the clients
+    assigned to these slots. the session is shared
+    and is only accessed while holding the session
+    lock */
+void run_concurrent_server(EventManager *eventManager, PollManager *pollManager, StreamPipe *streamPipe, TCPServer *tcpServer, int threadCount);
 
-#endif
\ No newline at end of file
+/* stop and delete the reader threads */
+void stop_concurrent_server(void);
+
+#endif
@@ -5,7 +5,10 @@
 #ifndef CHANNEL_H
 #define CHANNEL_H
 
-#include "../../libs/src/priv_queue.h"
+#include "config.h"
+#include "../../libs/src/priv_ring_buffer.h"
+#include "../../libs/src/priv_linked_list.h"
+#include "../../libs/src/priv_slab.h"
 #include "../../libs/src/common.h"
 
 #include <stdbool.h>
@@ -25,16 +28,16 @@ typedef struct Channel {
     char name[MAX_CHANNEL_LEN + 1];
     char topic[MAX_CHARS + 1];
     ChannelType channelType;
-    Queue *outQueue;
-    pthread_rwlock_t channelLock;
-    struct Channel *next;  
+    RingBuffer *outQueue;
+    QueuePolicy queuePolicy;
+    ListLink readyLink;
 } Channel;
 
 Channel * create_channel(const char *name, const char *topic, ChannelType channelType, int capacity);
 void delete_channel(void *channel);
 
-void enqueue_to_channel_queue(void *channel, void *content);
-void * dequeue_from_channel_queue(Channel *channel);
+int enqueue_to_channel_queue(Channel *channel, const char *message, int len);
+const char * dequeue_from_channel_queue(Channel *channel, int *len);
 
 bool are_channels_equal(void *channel1, void *channel2);
 bool is_valid_channel_name(const char *string);
@@ -42,6 +45,10 @@ bool is_valid_channel_name(const char *string);
 const char *get_channel_name(Channel *channel);
 const char *get_channel_topic(Channel *channel);
 ChannelType get_channel_type(Channel *channel);
-Queue * get_channel_queue(Channel *channel);
+RingBuffer * get_channel_queue(Channel *channel);
+QueuePolicy get_channel_queue_policy(Channel *channel);
+void set_channel_queue_policy(Channel *channel, QueuePolicy queuePolicy);
+ListLink * get_channel_ready_link(Channel *channel);
+SlabAllocator * get_channel_slab(void);
 
 #endif
\ No newline at end of file
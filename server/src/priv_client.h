@@ -2,18 +2,29 @@
 #define CLIENT_H
 
 #include "../../libs/src/common.h"
+#include "priv_user.h"
 #include "../../libs/src/session_state.h"
 #include "../../libs/src/network_utils.h"
+#include "../../libs/src/shared_buffer.h"
 
 #include <stdbool.h>
+#include <sys/uio.h>
 
 typedef struct {
     int fd;
     char nickname[MAX_NICKNAME_LEN + 1];
+    User *user;
     char clientIdentifier[MAX_CHARS + 1];
     HostIdentifierType identifierType;
     int port;
     char inBuffer[MAX_CHARS + 1];
+    SharedBuffer **outBuffers;
+    struct iovec *outVecs;
+    int outFront;
+    int outCount;
+    int outCapacity;
+    int outLen;
+    bool writePending;
     SessionStateType stateType;
 } Client;
 
@@ -26,6 +37,9 @@ void set_client_fd(Client *client, int fd);
 const char * get_client_nickname(Client *client);
 void set_client_nickname(Client *client, const char *nickname);
 
+User * get_client_user(Client *client);
+void set_client_user(Client *client, User *user);
+
 const char * get_client_identifier(Client *client);
 void set_client_identifier(Client *client, const char *clientIdentifier);
 
@@ -38,6 +52,21 @@ void set_client_port(Client *client, int port);
 char * get_client_inbuffer(Client *client);
 void set_client_inbuffer(Client *client, const char *content);
 
+/* output holds references to messages which were
+    not yet sent to the client. the unsent part of 
+    each message is described by an iovec, so that 
+    the output can be sent with a single writev() */
+void add_client_output(Client *client, SharedBuffer *buffer);
+void consume_client_output(Client *client, int len);
+void reset_client_output(Client *client);
+
+struct iovec * get_client_output(Client *client, int *count);
+int get_client_output_count(Client *client);
+int get_client_output_len(Client *client);
+
+bool is_client_write_pending(Client *client);
+void set_client_write_pending(Client *client, bool writePending);
+
 SessionStateType get_client_state_type(Client *client);
 void set_client_state_type(Client *client, SessionStateType stateType);
 
@@ -7,9 +7,12 @@
 #include "../../libs/src/priv_command.h"
 #include "../../libs/src/priv_io_utils.h"
 
+/* process the events reported by the poll manager */
+void process_poll_events(EventManager *eventManager, PollManager *pollManager, StreamPipe *streamPipe, TCPServer *tcpServer, int fdsReady);
 void process_connection_request(EventManager *eventManager, TCPServer *tcpServer);
 void process_pipe_data(EventManager *eventManager, StreamPipe *streamPipe);
 void process_socket_data(EventManager *eventManager, TCPServer *tcpServer, int fd);
+void process_received_data(EventManager *eventManager, TCPServer *tcpServer, int fd, const char *data, int len);
 
 void dispatch_events(EventManager *eventManager);
 
@@ -18,16 +21,24 @@ void handle_ne_client_disconnect_event(Event *event);
 void handle_ne_add_poll_fd_event(Event *event);
 void handle_ne_remove_poll_fd_event(Event *event);
 void handle_ne_client_msg_event(Event *event);
+void handle_ne_hostname_resolved_event(Event *event);
 void handle_se_exit_event(Event *event);
 
+void send_socket_messages(EventManager *eventManager, TCPServer *tcpServer);
+
+void process_socket_output(EventManager *eventManager, TCPServer *tcpServer, int fd);
+void flush_socket_messages(EventManager *eventManager, TCPServer *tcpServer);
+
 void set_event_context(EventManager *eventManager, PollManager *pollManager, TCPServer *tcpServer, CommandTokens *cmdTokens);
 
 void register_event_handlers(EventManager *eventManager);
 
 #ifdef TEST
 
+void create_client_msg_events(EventManager *eventManager, TCPServer *tcpServer, int fd);
 void detect_pipe_event_type(const char *message, Event *event);
 void execute_command(TCPServer *tcpServer, Client *client, CommandTokens *cmdTokens);
+void write_socket_output(EventManager *eventManager, TCPServer *tcpServer, int fd);
 
 #endif
 
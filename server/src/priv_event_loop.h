@@ -0,0 +1,54 @@
+/* --INTERNAL HEADER--
+   used for testing */
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include "priv_tcp_server.h"
+#include "../../libs/src/priv_event.h"
+#include "../../libs/src/priv_io_utils.h"
+#include "../../libs/src/priv_poll_manager.h"
+#include "../../libs/src/priv_command.h"
+
+typedef struct {
+    int fd;
+    SharedBuffer *buffer;
+} Mail;
+
+typedef struct {
+    int id;
+    EventManager *eventManager;
+    PollManager *pollManager;
+    StreamPipe *streamPipe;
+    TCPServer *tcpServer;
+    CommandTokens *cmdTokens;
+    Mail *mailbox;
+    int mailCount;
+    int mailCapacity;
+} EventLoop;
+
+EventLoop * create_event_loop(int id, EventManager *eventManager, PollManager *pollManager, StreamPipe *streamPipe, TCPServer *tcpServer, CommandTokens *cmdTokens);
+void delete_event_loop(EventLoop *eventLoop);
+
+void init_event_loops(void);
+void run_event_loop(EventLoop *eventLoop);
+
+void stop_event_loops(void);
+bool are_event_loops_stopping(void);
+
+void lock_session(void);
+void unlock_session(void);
+
+bool forward_to_event_loop(EventLoop *eventLoop, int fd, SharedBuffer *buffer);
+void post_mail(EventLoop *eventLoop, int fd, SharedBuffer *buffer);
+void wake_event_loop(EventLoop *eventLoop);
+
+EventLoop * get_current_event_loop(void);
+int get_event_loop_id(EventLoop *eventLoop);
+
+#ifdef TEST
+
+void deliver_mail(EventLoop *eventLoop);
+
+#endif
+
+#endif
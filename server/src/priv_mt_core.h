@@ -0,0 +1,59 @@
+/* --INTERNAL HEADER--
+   used for testing */
+#ifndef MT_CORE_H
+#define MT_CORE_H
+
+#include "priv_tcp_server.h"
+#include "priv_event_loop.h"
+#include "../../libs/src/priv_event.h"
+#include "../../libs/src/priv_io_utils.h"
+#include "../../libs/src/priv_poll_manager.h"
+#include "../../libs/src/priv_command.h"
+#include "../../libs/src/priv_threads.h"
+
+typedef struct {
+    ThreadData *threadData;
+    EventManager *eventManager;
+    PollManager *pollManager;
+    TCPServer *tcpServer;
+    CommandTokens *cmdTokens;
+    EventLoop *eventLoop;
+    int clientCount;
+} Reader;
+
+typedef struct {
+    ThreadPool *threadPool;
+    Reader *readers;
+    int readerCount;
+    TCPServer *tcpServer;
+    int *fdSlots;
+    int fdCount;
+    int *slotFds;
+    int slotCount;
+    bool running;
+} MtContext;
+
+void run_concurrent_server(EventManager *eventManager, PollManager *pollManager, StreamPipe *streamPipe, TCPServer *tcpServer, int threadCount);
+void stop_concurrent_server(void);
+
+#ifdef TEST
+
+MtContext * get_mt_context(void);
+
+void create_readers(TCPServer *tcpServer, int readerCount, int capacity);
+void delete_readers(void);
+
+void * run_reader_thread(void *arg);
+
+int assign_client_slot(int fd);
+void release_client_slot(int fd);
+int find_fd_reader(int fd);
+
+bool forward_to_reader(int fd, SharedBuffer *buffer);
+
+void handle_mt_client_connect_event(Event *event);
+void handle_mt_remove_fd_event(Event *event);
+
+#endif
+
+#endif
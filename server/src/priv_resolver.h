@@ -0,0 +1,92 @@
+/* --INTERNAL HEADER--
+   used for testing */
+#ifndef RESOLVER_H
+#define RESOLVER_H
+
+#include "../../libs/src/common.h"
+#include "../../libs/src/priv_queue.h"
+#include "../../libs/src/priv_flat_table.h"
+
+#include <stdbool.h>
+#include <time.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+
+#define DEF_RESOLVER_THREADS 2
+#define DEF_RESOLVER_CACHE_CAPACITY 1024
+#define DEF_RESOLVER_CACHE_TTL 3600
+
+typedef struct {
+    int fd;
+    char ipAddress[INET_ADDRSTRLEN + 1];
+    char hostname[MAX_CHARS + 1];
+    bool resolved;
+} HostLookup;
+
+typedef bool (*ResolveFunc)(char *buffer, int size, const char *ipAddress);
+
+typedef struct CacheEntry {
+    char ipAddress[INET_ADDRSTRLEN + 1];
+    char hostname[MAX_CHARS + 1];
+    bool resolved;
+    time_t expiry;
+    struct CacheEntry *previous;
+    struct CacheEntry *next;
+} CacheEntry;
+
+typedef struct {
+    pthread_mutex_t mutex;
+    HostLookup *lookups;
+    int count;
+    int capacity;
+    int wakeupFd;
+} LookupQueue;
+
+typedef struct {
+    HostLookup lookup;
+    LookupQueue *lookupQueue;
+} LookupRequest;
+
+typedef struct {
+    pthread_t *threads;
+    int threadCount;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    Queue *requests;
+    FlatTable *cache;
+    CacheEntry *lruHead;
+    CacheEntry *lruTail;
+    int cacheCount;
+    int cacheCapacity;
+    int cacheTtl;
+    ResolveFunc resolveFunc;
+    int lookupCount;
+    bool stopping;
+} Resolver;
+
+Resolver * create_resolver(int threadCount, int cacheCapacity, int cacheTtl, ResolveFunc resolveFunc);
+void delete_resolver(Resolver *resolver);
+
+LookupQueue * create_lookup_queue(int wakeupFd);
+void delete_lookup_queue(LookupQueue *lookupQueue);
+
+bool resolve_hostname(Resolver *resolver, LookupQueue *lookupQueue, int fd, const char *ipAddress, char *buffer, int size);
+
+int get_completed_lookups(LookupQueue *lookupQueue, HostLookup *lookups, int count);
+
+int get_resolver_lookup_count(Resolver *resolver);
+
+#ifdef TEST
+
+void * run_resolver_thread(void *arg);
+
+CacheEntry * find_cache_entry(Resolver *resolver, const char *ipAddress);
+void add_cache_entry(Resolver *resolver, HostLookup *lookup);
+void remove_cache_entry(Resolver *resolver, CacheEntry *entry);
+void move_cache_entry_to_front(Resolver *resolver, CacheEntry *entry);
+
+void complete_lookup(LookupQueue *lookupQueue, HostLookup *lookup);
+
+#endif
+
+#endif
@@ -7,7 +7,7 @@
 
 #include "priv_user.h"
 #include "priv_channel.h"
-#include "../../libs/src/priv_hash_table.h"
+#include "../../libs/src/priv_flat_table.h"
 #include "../../libs/src/priv_linked_list.h"
 
 #include <stdbool.h>
@@ -15,44 +15,58 @@
 
 #define MAX_USERS 1024
 #define MAX_CHANNELS 100
+#define DEF_MEMBERS_SIZE 8
 
 typedef void (*IteratorFunc)(void *data, void *arg);
 
 typedef struct {
-    LinkedList *readyUsers;
-    LinkedList *readyChannels;
+    IntrusiveList readyUsers;
+    IntrusiveList readyChannels;
 } ReadyList;
 
+typedef struct UserChannels UserChannels;
+typedef struct ChannelUsers ChannelUsers;
+
+typedef struct {
+    ChannelUsers *channelUsers;
+    int memberIdx;
+} ChannelEntry;
+
 typedef struct {
     User *user;
-    LinkedList *channels;
+    UserChannels *userChannels;
+    int channelIdx;
+} MemberEntry;
+
+struct UserChannels {
+    User *user;
+    ChannelEntry channels[MAX_CHANNELS_PER_USER];
     int capacity;
     int count;
-} UserChannels;
+};
 
-typedef struct {
+struct ChannelUsers {
     Channel *channel;
-    LinkedList *users;
+    MemberEntry *members;
+    int size;
     int capacity;
     int count;
-} ChannelUsers;
+};
 
 typedef struct {
     ReadyList *readyList;
-    HashTable *users;
-    HashTable *channels;
-    LinkedList *userChannelsLL;
-    LinkedList *channelUsersLL;
-    pthread_rwlock_t usersLock;
-    pthread_rwlock_t channelsLock;
-    pthread_rwlock_t usersCountLock;
-    pthread_rwlock_t channelsCountLock;
+    FlatTable *users;
+    FlatTable *channels;
+    FlatTable *userChannels;
+    FlatTable *channelUsers;
+    FlatTable *nicknames;
+    unsigned long peerEpoch;
 } Session;
 
 Session * create_session(void);
 void delete_session(Session *session);
 
-void add_user_to_hash_table(Session *session, User *user);
+int add_user_to_hash_table(Session *session, User *user);
 void add_channel_to_hash_table(Session *session, Channel *channel);
 
 void remove_user_from_hash_table(Session *session, User *user);
@@ -60,7 +74,11 @@ void remove_channel_from_hash_table(Session *session, Channel *channel);
 
 User * find_user_in_hash_table(Session *session, const char *nickname);
 Channel * find_channel_in_hash_table(Session *session, const char *name);
-void change_user_in_hash_table(Session *session, User *oldUser, User *newUser);
+void rename_user_in_hash_table(Session *session, User *user, const char *nickname);
+
+int reserve_nickname(Session *session, const char *nickname, void *holder);
+void release_nickname(Session *session, const char *nickname, void *holder);
+void * find_nickname_holder(Session *session, const char *nickname);
 
 ReadyList * create_ready_list(void);
 void delete_ready_list(ReadyList *readyList);
@@ -68,8 +86,11 @@ void delete_ready_list(ReadyList *readyList);
 void add_user_to_ready_list(void *user, void *readyList);
 void add_channel_to_ready_list(void *channel, void *readyList);
 
-void remove_user_from_ready_list(LinkedList *readyUsers, User *user);
-void remove_channel_from_ready_list(LinkedList *readyChannels, Channel *channel);
+void remove_user_from_ready_list(ReadyList *readyList, User *user);
+void remove_channel_from_ready_list(ReadyList *readyList, Channel *channel);
+
+User * pop_ready_user(ReadyList *readyList);
+Channel * pop_ready_channel(ReadyList *readyList);
 
 UserChannels * create_user_channels(User *user);
 ChannelUsers * create_channel_users(Channel *channel);
@@ -83,47 +104,43 @@ int remove_channel_users(Session *session, ChannelUsers *channelUsers);
 UserChannels * find_user_channels(Session *session, User *user);
 ChannelUsers * find_channel_users(Session *session, Channel *channel);
 
-int add_channel_to_user_channels(UserChannels *userChannels, Channel *channel);
-int add_user_to_channel_users(ChannelUsers *channelUsers, User *user);
+int add_channel_member(UserChannels *userChannels, ChannelUsers *channelUsers);
+int remove_channel_member(UserChannels *userChannels, ChannelUsers *channelUsers);
 
 Channel * find_channel_in_user_channels(UserChannels *userChannels, Channel *channel);
-User * find_user_in_channel_users(ChannelUsers *channelUsers, User *user);
+bool is_channel_member(Session *session, Channel *channel, User *user);
 
-void remove_channel_in_user_channels(UserChannels *userChannels, Channel *channel);
-void remove_user_in_channel_users(ChannelUsers *channelUsers, User *user);
+void iterate_user_channels(UserChannels *userChannels, IteratorFunc iteratorFunc, void *arg);
+void iterate_channel_users(ChannelUsers *channelUsers, IteratorFunc iteratorFunc, void *arg);
 
-void change_user_in_user_channels(UserChannels *userChannels, User *user);
-void change_user_in_channel_users(void *channelUsers, void *user);
+void iterate_channel_peers(Session *session, User *user, IteratorFunc iteratorFunc, void *arg);
+void enqueue_to_channel_peers(Session *session, User *user, const char *message, int len, bool includeUser);
 
-void register_user(Session *session, User *user);
+int register_user(Session *session, User *user);
 void unregister_user(Session *session, User *user);
 
 void register_new_channel_join(Session *session, Channel *channel, User *user);
 void register_existing_channel_join(Session *session, Channel *channel, User *user);
 
 void register_channel_leave(Session *session, Channel *channel, User *user);
-void leave_all_channels(Session *session, User *user, const char *message);
+void leave_all_channels(Session *session, User *user, const char *message, int len);
 void remove_channel_data(Session *session, Channel *channel);
 
 bool is_channel_full(ChannelUsers *channelUsers);
 
-bool are_user_channels_equal(void *userChannels1, void *userChannels2);
-bool are_channel_users_equal(void *channelUsers1, void *channelUsers2);
-
 ReadyList * get_ready_list(Session *session);
-LinkedList * get_ready_users(ReadyList *readyList);
-LinkedList * get_ready_channels(ReadyList *readyList);
-
-LinkedList * get_channels_from_user_channels(UserChannels *userChannels);
-LinkedList * get_users_from_channel_users(ChannelUsers *channelUsers);
+int get_ready_users_count(ReadyList *readyList);
+int get_ready_channels_count(ReadyList *readyList);
 
-LinkedList * get_channel_users_ll(Session *session);
 int get_channel_users_count(ChannelUsers *channelUsers);
 
 #ifdef TEST
 
 void delete_user_channels(void *userChannels);
 void delete_channel_users(void *channelUsers);
+void remove_member_entry(ChannelUsers *channelUsers, int memberIdx);
+void remove_channel_entry(UserChannels *userChannels, int channelIdx);
+void enqueue_to_channel_peer(void *user, void *arg);
 
 #endif
 
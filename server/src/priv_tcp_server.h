@@ -6,28 +6,42 @@
 
 #include "priv_client.h"
 #include "priv_session.h"
+#include "priv_resolver.h"
 #include "../../libs/src/priv_event.h"
 #include "../../libs/src/priv_queue.h"
-#include "../../libs/src/priv_hash_table.h"
+#include "../../libs/src/priv_fd_table.h"
 #include "../../libs/src/threads.h"
 #include "../../libs/src/irc_message.h"
+#include "../../libs/src/shared_buffer.h"
 #include "../../libs/src/time_utils.h"
 
 #include <stdbool.h>
 #include <arpa/inet.h>
 #include <pthread.h>
 
+/* forward a message to a client which is handled
+    by another event loop */
+typedef bool (*ForwardMessageFunc)(int fd, SharedBuffer *buffer);
+
 typedef struct {
     int listenFd;
     Client **clients;
     Session *session;
     Queue *outQueue;
-    HashTable *fdsIdxMap;
+    Arena *messageArena;
+    char serverPrefix[MAX_PREFIX + 1];
+    FdTable *fdTable;
+    Client **pendingWrites;
+    int pendingCount;
+    int *freeSlots;
+    int freeCount;
+    ForwardMessageFunc forwardFunc;
+    Resolver *resolver;
+    LookupQueue *lookupQueue;
+    bool sharedSession;
+    bool sharedFdTable;
     int count;
     int capacity;
-    pthread_rwlock_t fdLock;
-    pthread_rwlock_t queueLock;
-    pthread_rwlock_t countLock;
 } TCPServer;
 
 TCPServer * create_server(int capacity);
@@ -43,16 +57,34 @@ int accept_connection(TCPServer *tcpServer);
 void register_connection(TCPServer *tcpServer, EventManager *eventManager, int fd);
 void remove_client(TCPServer *tcpServer, EventManager *eventManager, int fd);
 Client * find_client(TCPServer *tcpServer, const char *nickname);
+void set_server_client_nickname(TCPServer *tcpServer, Client *client, const char *nickname);
 
 int get_server_capacity(TCPServer *tcpServer);
 Client * get_client(TCPServer *tcpServer, int fdIdx);
 Session * get_session(TCPServer *tcpServer);
+
+/* servers of several event loops may share the 
+    session. the shared session isn't deleted with 
+    the server */
+void set_server_session(TCPServer *tcpServer, Session *session);
+
+/* messages to clients which aren't found in the 
+    server are passed to the forward function */
+void set_server_forward_func(TCPServer *tcpServer, ForwardMessageFunc forwardFunc);
+
+void set_server_resolver(TCPServer *tcpServer, Resolver *resolver, int wakeupFd);
+Resolver * get_server_resolver(TCPServer *tcpServer);
+void update_client_hostnames(TCPServer *tcpServer);
+
+void set_server_fd_table(TCPServer *tcpServer, FdTable *fdTable);
+int get_client_fd_idx(TCPServer *tcpServer, int fd);
+
 Queue * get_server_out_queue(TCPServer *tcpServer);
-HashTable * get_server_fds_idx_map(TCPServer *tcpServer);
+Arena * get_message_arena(TCPServer *tcpServer);
 
-void create_server_info(char *buffer, int size, void *arg);
+const char * get_server_prefix(TCPServer *tcpServer);
 
-void add_message_to_queue(TCPServer *tcpServer, Client *client, const char *content);
+void add_message_to_queue(TCPServer *tcpServer, Client *client, const char *content, int len);
 void enqueue_to_server_queue(TCPServer *tcpServer, void *message);
 void * dequeue_from_server_queue(TCPServer *tcpServer);
 void add_irc_message_to_queue(TCPServer *tcpServer, Client *client, IRCMessage *tokens);
@@ -62,8 +94,23 @@ void send_message_to_user(void *user, void *arg);
 void send_user_queue_messages(void *user, void *arg);
 void send_channel_queue_messages(void *channel, void *arg);
 
+ssize_t server_recv(TCPServer *tcpServer, EventManager *eventManager, int fd, char *buffer, int size);
 int server_read(TCPServer *tcpServer, EventManager *eventManager, int fd);
-int server_write(TCPServer *tcpServer, EventManager *eventManager, int fd, const char *message);
+int server_write(TCPServer *tcpServer, EventManager *eventManager, int fd, const char *message, int len);
+int server_write_buffer(TCPServer *tcpServer, EventManager *eventManager, int fd, SharedBuffer *buffer);
+
+/* write the client's buffered output. returns the
+    number of bytes which are still pending or -1
+    on error */
+int server_flush(TCPServer *tcpServer, EventManager *eventManager, int fd);
+
+/* store received data in the client's input buffer.
+    returns the number of bytes stored */
+int buffer_client_data(TCPServer *tcpServer, int fd, const char *data, int len);
+
+/* clients with buffered output */
+void add_pending_write(TCPServer *tcpServer, Client *client);
+Client * pop_pending_write(TCPServer *tcpServer);
 
 void trigger_event_client_disconnect(EventManager *eventManager, int fd);
 
@@ -72,9 +119,11 @@ void set_server_listen_fd(TCPServer *tcpServer, int listenFd);
 
 #ifdef TEST
 
-int find_client_fd_idx(TCPServer *tcpServer, int fd);
+int allocate_client_slot(TCPServer *tcpServer);
+void free_client_slot(TCPServer *tcpServer, int fdIdx);
 void set_client_data(TCPServer *tcpServer, int fdIdx, int fd, const char *clientIdentifier, HostIdentifierType identifierType, int port);
 void unset_client_data(TCPServer *tcpServer, int fdIdx);
+SharedBuffer * create_message_buffer(const char *message, int len);
 
 #endif
 
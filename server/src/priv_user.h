@@ -6,7 +6,11 @@
 #define USER_H
 
 #include "../../libs/src/common.h"
-#include "../../libs/src/priv_queue.h"
+#include "config.h"
+#include "../../libs/src/priv_ring_buffer.h"
+#include "../../libs/src/priv_linked_list.h"
+#include "../../libs/src/priv_slab.h"
+#include "../../libs/src/irc_message.h"
 
 #include <stdbool.h>
 #include <pthread.h>
@@ -19,30 +23,40 @@ typedef struct User {
     char username[MAX_CHARS + 1];
     char hostname[MAX_CHARS + 1];
     char realname[MAX_CHARS + 1];
-    Queue *outQueue;
-    pthread_rwlock_t userLock;
+    char prefix[MAX_PREFIX + 1];
+    bool prefixValid;
+    RingBuffer *outQueue;
+    QueuePolicy queuePolicy;
+    bool queueOverflowed;
+    ListLink readyLink;
+    unsigned long peerEpoch;
 } User;
 
 User * create_user(int fd, const char *nickname, const char *username, const char *hostname, const char *realname);
 void delete_user(void *value);
 
-User * copy_user(User *user);
-
-void enqueue_to_user_queue(User *user, void *message);
-void * dequeue_from_user_queue(User *user);
+int enqueue_to_user_queue(User *user, const char *message, int len);
+const char * dequeue_from_user_queue(User *user, int *len);
 
 bool are_users_equal(void *user1, void *user2);
 bool is_valid_user_name(const char *string);
 
 void add_nickname_to_list(void *user, void *namesList);
-void create_user_info(char *buffer, int size, void *arg);
+const char * get_user_prefix(User *user);
 
 int get_user_fd(User *user);
 const char * get_user_nickname(User *user);
 void set_user_nickname(User *user, const char *nickname);
 const char * get_user_username(User *user);
 const char * get_user_hostname(User *user);
+void set_user_hostname(User *user, const char *hostname);
 const char * get_user_realname(User *user);
-Queue * get_user_queue(User *user);
+RingBuffer * get_user_queue(User *user);
+QueuePolicy get_user_queue_policy(User *user);
+void set_user_queue_policy(User *user, QueuePolicy queuePolicy);
+bool is_user_queue_overflowed(User *user);
+bool stamp_user_epoch(User *user, unsigned long epoch);
+ListLink * get_user_ready_link(User *user);
+SlabAllocator * get_user_slab(void);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,474 @@
+#ifdef TEST
+#include "priv_resolver.h"
+#else
+#include "resolver.h"
+#include "../../libs/src/queue.h"
+#include "../../libs/src/flat_table.h"
+#endif
+
+#include "../../libs/src/network_utils.h"
+#include "../../libs/src/string_utils.h"
+#include "../../libs/src/error_control.h"
+#include "../../libs/src/logger.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <signal.h>
+
+#ifdef TEST
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+#define DEF_QUEUE_CAPACITY 64
+#define RESOLVED_MESSAGE "resolved\r\n"
+
+#ifndef TEST
+
+/* cache entries are kept in a hash table for
+    lookup and in a list ordered by use, with the
+    most recently used entry at the head. failed
+    lookups are cached as well */
+typedef struct CacheEntry {
+    char ipAddress[INET_ADDRSTRLEN + 1];
+    char hostname[MAX_CHARS + 1];
+    bool resolved;
+    time_t expiry;
+    struct CacheEntry *previous;
+    struct CacheEntry *next;
+} CacheEntry;
+
+struct LookupQueue {
+    pthread_mutex_t mutex;
+    HostLookup *lookups;
+    int count;
+    int capacity;
+    int wakeupFd;
+};
+
+typedef struct {
+    HostLookup lookup;
+    LookupQueue *lookupQueue;
+} LookupRequest;
+
+/* requests and the cache are shared by the event
+    loops and the worker threads and are protected
+    by the mutex */
+struct Resolver {
+    pthread_t *threads;
+    int threadCount;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    Queue *requests;
+    FlatTable *cache;
+    CacheEntry *lruHead;
+    CacheEntry *lruTail;
+    int cacheCount;
+    int cacheCapacity;
+    int cacheTtl;
+    ResolveFunc resolveFunc;
+    int lookupCount;
+    bool stopping;
+};
+
+#endif
+
+STATIC void * run_resolver_thread(void *arg);
+
+STATIC CacheEntry * find_cache_entry(Resolver *resolver, const char *ipAddress);
+STATIC void add_cache_entry(Resolver *resolver, HostLookup *lookup);
+STATIC void remove_cache_entry(Resolver *resolver, CacheEntry *entry);
+STATIC void move_cache_entry_to_front(Resolver *resolver, CacheEntry *entry);
+
+STATIC void complete_lookup(LookupQueue *lookupQueue, HostLookup *lookup);
+
+Resolver * create_resolver(int threadCount, int cacheCapacity, int cacheTtl, ResolveFunc resolveFunc) {
+
+    if (threadCount <= 0 || cacheCapacity <= 0 || cacheTtl < 0) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    Resolver *resolver = (Resolver*) malloc(sizeof(Resolver));
+    if (resolver == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    resolver->threads = (pthread_t*) malloc(threadCount * sizeof(pthread_t));
+    if (resolver->threads == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    resolver->threadCount = threadCount;
+    resolver->requests = create_queue(DEF_QUEUE_CAPACITY, sizeof(LookupRequest));
+    resolver->cache = create_flat_table(cacheCapacity, djb2_hash, are_strings_equal, NULL, NULL);
+    resolver->lruHead = NULL;
+    resolver->lruTail = NULL;
+    resolver->cacheCount = 0;
+    resolver->cacheCapacity = cacheCapacity;
+    resolver->cacheTtl = cacheTtl;
+    resolver->resolveFunc = resolveFunc != NULL ? resolveFunc : ip_to_hostname;
+    resolver->lookupCount = 0;
+    resolver->stopping = 0;
+
+    pthread_mutex_init(&resolver->mutex, NULL);
+    pthread_cond_init(&resolver->cond, NULL);
+
+    /* signals are handled by the event loops */
+    sigset_t signalSet, oldSignalSet;
+    sigfillset(&signalSet);
+    pthread_sigmask(SIG_SETMASK, &signalSet, &oldSignalSet);
+
+    for (int i = 0; i < threadCount; i++) {
+
+        if (pthread_create(&resolver->threads[i], NULL, run_resolver_thread, resolver) != 0) {
+            FAILED(NO_ERRCODE, "Error creating resolver thread");
+        }
+    }
+
+    pthread_sigmask(SIG_SETMASK, &oldSignalSet, NULL);
+
+    return resolver;
+}
+
+void delete_resolver(Resolver *resolver) {
+
+    if (resolver != NULL) {
+
+        /* pending lookups are discarded */
+        pthread_mutex_lock(&resolver->mutex);
+        resolver->stopping = 1;
+        pthread_cond_broadcast(&resolver->cond);
+        pthread_mutex_unlock(&resolver->mutex);
+
+        for (int i = 0; i < resolver->threadCount; i++) {
+            pthread_join(resolver->threads[i], NULL);
+        }
+
+        while (resolver->lruHead != NULL) {
+            remove_cache_entry(resolver, resolver->lruHead);
+        }
+
+        delete_flat_table(resolver->cache);
+        delete_queue(resolver->requests);
+
+        pthread_mutex_destroy(&resolver->mutex);
+        pthread_cond_destroy(&resolver->cond);
+
+        free(resolver->threads);
+    }
+    free(resolver);
+}
+
+LookupQueue * create_lookup_queue(int wakeupFd) {
+
+    LookupQueue *lookupQueue = (LookupQueue*) malloc(sizeof(LookupQueue));
+    if (lookupQueue == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    lookupQueue->lookups = NULL;
+    lookupQueue->count = 0;
+    lookupQueue->capacity = 0;
+    lookupQueue->wakeupFd = wakeupFd;
+
+    pthread_mutex_init(&lookupQueue->mutex, NULL);
+
+    return lookupQueue;
+}
+
+void delete_lookup_queue(LookupQueue *lookupQueue) {
+
+    if (lookupQueue != NULL) {
+
+        pthread_mutex_destroy(&lookupQueue->mutex);
+        free(lookupQueue->lookups);
+    }
+    free(lookupQueue);
+}
+
+bool resolve_hostname(Resolver *resolver, LookupQueue *lookupQueue, int fd, const char *ipAddress, char *buffer, int size) {
+
+    if (resolver == NULL || lookupQueue == NULL || ipAddress == NULL || buffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    bool resolved = 0;
+
+    pthread_mutex_lock(&resolver->mutex);
+
+    CacheEntry *entry = find_cache_entry(resolver, ipAddress);
+
+    if (entry != NULL) {
+
+        move_cache_entry_to_front(resolver, entry);
+
+        if (entry->resolved) {
+            safe_copy(buffer, size, entry->hostname);
+            resolved = 1;
+        }
+    }
+    else {
+        LookupRequest request = {.lookup = {.fd = fd, .resolved = 0}, .lookupQueue = lookupQueue};
+        safe_copy(request.lookup.ipAddress, ARRAY_SIZE(request.lookup.ipAddress), ipAddress);
+
+        /* the queue grows instead of overwriting
+            pending requests */
+        if (is_queue_full(resolver->requests)) {
+            resize_queue(resolver->requests, get_queue_capacity(resolver->requests) * 2);
+        }
+
+        enqueue(resolver->requests, &request);
+        pthread_cond_signal(&resolver->cond);
+    }
+
+    pthread_mutex_unlock(&resolver->mutex);
+
+    return resolved;
+}
+
+int get_completed_lookups(LookupQueue *lookupQueue, HostLookup *lookups, int count) {
+
+    if (lookupQueue == NULL || lookups == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    pthread_mutex_lock(&lookupQueue->mutex);
+
+    int moved = lookupQueue->count < count ? lookupQueue->count : count;
+
+    memcpy(lookups, lookupQueue->lookups, moved * sizeof(HostLookup));
+    memmove(lookupQueue->lookups, lookupQueue->lookups + moved, (lookupQueue->count - moved) * sizeof(HostLookup));
+    lookupQueue->count -= moved;
+
+    pthread_mutex_unlock(&lookupQueue->mutex);
+
+    return moved;
+}
+
+int get_resolver_lookup_count(Resolver *resolver) {
+
+    if (resolver == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    pthread_mutex_lock(&resolver->mutex);
+    int lookupCount = resolver->lookupCount;
+    pthread_mutex_unlock(&resolver->mutex);
+
+    return lookupCount;
+}
+
+STATIC void * run_resolver_thread(void *arg) {
+
+    Resolver *resolver = (Resolver*) arg;
+
+    pthread_mutex_lock(&resolver->mutex);
+
+    while (1) {
+
+        while (is_queue_empty(resolver->requests) && !resolver->stopping) {
+            pthread_cond_wait(&resolver->cond, &resolver->mutex);
+        }
+
+        if (resolver->stopping) {
+            break;
+        }
+
+        LookupRequest request = *(LookupRequest*) dequeue(resolver->requests);
+        HostLookup *lookup = &request.lookup;
+
+        /* the same address may have been resolved by
+            another worker in the meantime */
+        CacheEntry *entry = find_cache_entry(resolver, lookup->ipAddress);
+
+        if (entry != NULL) {
+
+            safe_copy(lookup->hostname, ARRAY_SIZE(lookup->hostname), entry->hostname);
+            lookup->resolved = entry->resolved;
+        }
+        else {
+            /* the lookup may block, so it's performed
+                without holding the lock */
+            pthread_mutex_unlock(&resolver->mutex);
+
+            lookup->resolved = resolver->resolveFunc(lookup->hostname, ARRAY_SIZE(lookup->hostname), lookup->ipAddress);
+
+            pthread_mutex_lock(&resolver->mutex);
+
+            resolver->lookupCount++;
+
+            if (find_cache_entry(resolver, lookup->ipAddress) == NULL) {
+                add_cache_entry(resolver, lookup);
+            }
+        }
+
+        /* failed lookups aren't reported, the client
+            keeps its IP address */
+        if (lookup->resolved) {
+            complete_lookup(request.lookupQueue, lookup);
+        }
+    }
+
+    pthread_mutex_unlock(&resolver->mutex);
+
+    return NULL;
+}
+
+/* returns the entry for the address, or NULL if
+    the address isn't cached. expired entries are
+    removed */
+STATIC CacheEntry * find_cache_entry(Resolver *resolver, const char *ipAddress) {
+
+    if (resolver == NULL || ipAddress == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    CacheEntry *entry = find_in_flat_table(resolver->cache, (void*) ipAddress);
+
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    if (entry->expiry <= time(NULL)) {
+
+        remove_cache_entry(resolver, entry);
+        entry = NULL;
+    }
+
+    return entry;
+}
+
+STATIC void add_cache_entry(Resolver *resolver, HostLookup *lookup) {
+
+    if (resolver == NULL || lookup == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    /* the least recently used entry is evicted */
+    if (resolver->cacheCount == resolver->cacheCapacity) {
+        remove_cache_entry(resolver, resolver->lruTail);
+    }
+
+    CacheEntry *entry = (CacheEntry*) malloc(sizeof(CacheEntry));
+    if (entry == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    safe_copy(entry->ipAddress, ARRAY_SIZE(entry->ipAddress), lookup->ipAddress);
+    safe_copy(entry->hostname, ARRAY_SIZE(entry->hostname), lookup->hostname);
+    entry->resolved = lookup->resolved;
+    entry->expiry = time(NULL) + resolver->cacheTtl;
+    entry->previous = NULL;
+    entry->next = NULL;
+
+    if (!insert_to_flat_table(resolver->cache, entry->ipAddress, entry)) {
+
+        free(entry);
+        return;
+    }
+
+    move_cache_entry_to_front(resolver, entry);
+    resolver->cacheCount++;
+}
+
+STATIC void remove_cache_entry(Resolver *resolver, CacheEntry *entry) {
+
+    if (resolver == NULL || entry == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    if (entry->previous != NULL) {
+        entry->previous->next = entry->next;
+    }
+    else {
+        resolver->lruHead = entry->next;
+    }
+
+    if (entry->next != NULL) {
+        entry->next->previous = entry->previous;
+    }
+    else {
+        resolver->lruTail = entry->previous;
+    }
+
+    remove_from_flat_table(resolver->cache, entry->ipAddress);
+    resolver->cacheCount--;
+
+    free(entry);
+}
+
+/* the entry may be new or already listed */
+STATIC void move_cache_entry_to_front(Resolver *resolver, CacheEntry *entry) {
+
+    if (resolver == NULL || entry == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    if (resolver->lruHead == entry) {
+        return;
+    }
+
+    if (entry->previous != NULL) {
+
+        entry->previous->next = entry->next;
+
+        if (entry->next != NULL) {
+            entry->next->previous = entry->previous;
+        }
+        else {
+            resolver->lruTail = entry->previous;
+        }
+    }
+
+    entry->previous = NULL;
+    entry->next = resolver->lruHead;
+
+    if (resolver->lruHead != NULL) {
+        resolver->lruHead->previous = entry;
+    }
+    resolver->lruHead = entry;
+
+    if (resolver->lruTail == NULL) {
+        resolver->lruTail = entry;
+    }
+}
+
+STATIC void complete_lookup(LookupQueue *lookupQueue, HostLookup *lookup) {
+
+    if (lookupQueue == NULL || lookup == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    pthread_mutex_lock(&lookupQueue->mutex);
+
+    if (lookupQueue->count == lookupQueue->capacity) {
+
+        int capacity = lookupQueue->capacity ? lookupQueue->capacity * 2 : DEF_QUEUE_CAPACITY;
+
+        HostLookup *lookups = (HostLookup*) realloc(lookupQueue->lookups, capacity * sizeof(HostLookup));
+        if (lookups == NULL) {
+            FAILED(ALLOC_ERROR, NULL);
+        }
+
+        lookupQueue->lookups = lookups;
+        lookupQueue->capacity = capacity;
+    }
+
+    lookupQueue->lookups[lookupQueue->count++] = *lookup;
+
+    pthread_mutex_unlock(&lookupQueue->mutex);
+
+    /* the message is detected by the event loop as
+        input on its pipe */
+    if (lookupQueue->wakeupFd >= 0) {
+
+        if (write(lookupQueue->wakeupFd, RESOLVED_MESSAGE, strlen(RESOLVED_MESSAGE)) < 0 && errno != EAGAIN) {
+            LOG(ERROR, "Error waking up event loop");
+        }
+    }
+}
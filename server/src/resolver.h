@@ -0,0 +1,57 @@
+#ifndef RESOLVER_H
+#define RESOLVER_H
+
+#include "../../libs/src/common.h"
+
+#include <stdbool.h>
+#include <arpa/inet.h>
+
+#define DEF_RESOLVER_THREADS 2
+#define DEF_RESOLVER_CACHE_CAPACITY 1024
+#define DEF_RESOLVER_CACHE_TTL 3600
+
+/* resolves IP addresses of clients to hostnames. 
+    lookups are performed by a pool of worker 
+    threads, so that a slow DNS server doesn't block 
+    the event loops. results are cached by IP 
+    address, with the least recently used entry 
+    evicted when the cache is full. entries expire 
+    after the cache TTL (in seconds) */
+typedef struct Resolver Resolver;
+
+/* completed lookups of a single event loop. the 
+    event loop is woken up through the wakeup fd 
+    when a lookup is completed */
+typedef struct LookupQueue LookupQueue;
+
+typedef struct {
+    int fd;
+    char ipAddress[INET_ADDRSTRLEN + 1];
+    char hostname[MAX_CHARS + 1];
+    bool resolved;
+} HostLookup;
+
+/* performs the lookup. the default function uses 
+    reverse DNS lookup */
+typedef bool (*ResolveFunc)(char *buffer, int size, const char *ipAddress);
+
+Resolver * create_resolver(int threadCount, int cacheCapacity, int cacheTtl, ResolveFunc resolveFunc);
+void delete_resolver(Resolver *resolver);
+
+LookupQueue * create_lookup_queue(int wakeupFd);
+void delete_lookup_queue(LookupQueue *lookupQueue);
+
+/* returns true and copies the hostname to the 
+    buffer if it's cached. otherwise, the lookup 
+    is queued, unless it's known to fail, and the 
+    result is later added to the lookup queue */
+bool resolve_hostname(Resolver *resolver, LookupQueue *lookupQueue, int fd, const char *ipAddress, char *buffer, int size);
+
+/* move up to count completed lookups to the array. 
+    returns the number of moved lookups */
+int get_completed_lookups(LookupQueue *lookupQueue, HostLookup *lookups, int count);
+
+/* number of lookups passed to the resolve function */
+int get_resolver_lookup_count(Resolver *resolver);
+
+#endif
@@ -4,12 +4,13 @@
 #include "priv_session.h"
 #else
 #include "session.h"
-#include "../../libs/src/hash_table.h"
+#include "../../libs/src/flat_table.h"
 #endif
 
 #include "config.h"
 #include "../../libs/src/settings.h"
 #include "../../libs/src/error_control.h"
+#include "../../libs/src/slab.h"
 #include "../../libs/src/logger.h"
 
 #include <stdlib.h>
@@ -24,28 +25,48 @@
 
 #define MAX_USERS 1024
 #define MAX_CHANNELS 100
+#define DEF_MEMBERS_SIZE 8
+
+/* a channel of the user. memberIdx is the 
+    user's position in the channel's members */
+typedef struct {
+    ChannelUsers *channelUsers;
+    int memberIdx;
+} ChannelEntry;
+
+/* a user in the channel. channelIdx is the 
+    channel's position in the user's channels */
+typedef struct {
+    User *user;
+    UserChannels *userChannels;
+    int channelIdx;
+} MemberEntry;
 
 /* keeps track of all user's channels */
 struct UserChannels {
     User *user;
-    LinkedList *channels;
+    ChannelEntry channels[MAX_CHANNELS_PER_USER];
     int capacity;
     int count;
 };
 
-/* keeps track of all users in a channel */
+/* keeps track of all users in a channel. 
+    members grow up to the channel's capacity */
 struct ChannelUsers {
     Channel *channel;
-    LinkedList *users;
+    MemberEntry *members;
+    int size;
     int capacity;
     int count;
 };
 
 /* keeps track of users and channnels
-  which have messages to send */ 
+  which have messages to send. users and 
+  channels are linked through their own 
+  ready links */ 
 struct ReadyList {
-    LinkedList *readyUsers;
-    LinkedList *readyChannels;
+    IntrusiveList readyUsers;
+    IntrusiveList readyChannels;
 };
  
 /* keeps track of all users on the server, 
@@ -53,24 +74,27 @@ all channels on the server, all user's
 channels and all users in a channel */
 struct Session {
     ReadyList *readyList;
-    HashTable *users;
-    HashTable *channels;
-    LinkedList *userChannelsLL;
-    LinkedList *channelUsersLL;
-    pthread_rwlock_t usersLock;
-    pthread_rwlock_t channelsLock;
-    pthread_rwlock_t usersCountLock;
-    pthread_rwlock_t channelsCountLock;
+    FlatTable *users;
+    FlatTable *channels;
+    FlatTable *userChannels;
+    FlatTable *channelUsers;
+    /* nicknames reserved by the clients */
+    FlatTable *nicknames;
+    unsigned long peerEpoch;
 };
 
 #endif
 
-static pthread_rwlock_t readyListLock = PTHREAD_RWLOCK_INITIALIZER;
-static pthread_rwlock_t userChannelsLock = PTHREAD_RWLOCK_INITIALIZER;
-static pthread_rwlock_t channelUsersLock = PTHREAD_RWLOCK_INITIALIZER;
+/* memberships are created and deleted while holding
+    the session lock, so the slabs aren't locked */
+static SlabAllocator *userChannelsSlab = NULL;
+static SlabAllocator *channelUsersSlab = NULL;
 
 STATIC void delete_user_channels(void *userChannels);
 STATIC void delete_channel_users(void *channelUsers);
+STATIC void remove_member_entry(ChannelUsers *channelUsers, int memberIdx);
+STATIC void remove_channel_entry(UserChannels *userChannels, int channelIdx);
+STATIC void enqueue_to_channel_peer(void *user, void *arg);
 
 Session * create_session(void) {
 
@@ -79,17 +103,21 @@ Session * create_session(void) {
         FAILED(ALLOC_ERROR, NULL);
     }
     session->readyList = create_ready_list();
+    session->peerEpoch = 0;
 
-    session->users = create_hash_table(MAX_USERS, 0, djb2_hash, are_strings_equal, NULL, delete_user);
-    session->channels = create_hash_table(MAX_CHANNELS, 0, djb2_hash, are_strings_equal, NULL, delete_channel);
+    /* the tables grow past their initial capacity. 
+        nicknames and channel names are case insensitive */
+    session->users = create_flat_table(MAX_USERS, siphash_rfc1459, are_strings_equal_rfc1459, NULL, delete_user);
+    session->channels = create_flat_table(MAX_CHANNELS, siphash_rfc1459, are_strings_equal_rfc1459, NULL, delete_channel);
 
-    session->userChannelsLL = create_linked_list(are_user_channels_equal, delete_user_channels);
-    session->channelUsersLL = create_linked_list(are_channel_users_equal, delete_channel_users);
+    /* memberships are keyed by the user and 
+        channel objects */
+    session->userChannels = create_flat_table(MAX_USERS, pointer_hash, are_pointers_equal, NULL, delete_user_channels);
+    session->channelUsers = create_flat_table(MAX_CHANNELS, pointer_hash, are_pointers_equal, NULL, delete_channel_users);
 
-    pthread_rwlock_init(&session->usersLock, NULL);
-    pthread_rwlock_init(&session->channelsLock, NULL);
-    pthread_rwlock_init(&session->usersCountLock, NULL);
-    pthread_rwlock_init(&session->channelsCountLock, NULL);
+    /* the reserved nicknames are owned by their 
+        holders */
+    session->nicknames = create_flat_table(MAX_USERS, siphash_rfc1459, are_strings_equal_rfc1459, NULL, NULL);
 
     return session; 
 }
@@ -99,15 +127,11 @@ void delete_session(Session *session) {
     if (session != NULL) {
 
         delete_ready_list(session->readyList);
-        delete_hash_table(session->users);
-        delete_hash_table(session->channels);
-        delete_linked_list(session->userChannelsLL);
-        delete_linked_list(session->channelUsersLL);
-
-        pthread_rwlock_destroy(&session->usersLock);
-        pthread_rwlock_destroy(&session->channelsLock);
-        pthread_rwlock_destroy(&session->usersCountLock);
-        pthread_rwlock_destroy(&session->channelsCountLock);
+        delete_flat_table(session->users);
+        delete_flat_table(session->channels);
+        delete_flat_table(session->userChannels);
+        delete_flat_table(session->channelUsers);
+        delete_flat_table(session->nicknames);
 
     }
 
@@ -118,30 +142,14 @@ void delete_session(Session *session) {
 adding them to the <hash table>. they will be
 freed automatically when hash table is deleted
 in delete_session() if DeleteValueFunc is passed
-to create_hash_table() */
-void add_user_to_hash_table(Session *session, User *user) {
+to create_flat_table() */
+int add_user_to_hash_table(Session *session, User *user) {
 
     if (session == NULL || user == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&session->usersLock);
-        pthread_rwlock_wrlock(&session->usersCountLock);
-    }
-
-    if (!is_hash_table_full(session->users) && find_item_in_hash_table(session->users, (char*)get_user_nickname(user)) == NULL) {
-
-        HashItem *item = create_hash_item((char*)get_user_nickname(user), user); 
-        insert_item_to_hash_table(session->users, item);
-
-    }
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&session->usersCountLock);
-        pthread_rwlock_unlock(&session->usersLock);
-    }
-
+    return insert_to_flat_table(session->users, (char*)get_user_nickname(user), user);
 }
 
 void add_channel_to_hash_table(Session *session, Channel *channel) {
@@ -150,20 +158,7 @@ void add_channel_to_hash_table(Session *session, Channel *channel) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&session->channelsLock);
-        pthread_rwlock_wrlock(&session->channelsCountLock);
-    }
-
-    if (!is_hash_table_full(session->channels) && find_item_in_hash_table(session->channels, (char*) get_channel_name(channel)) == NULL) {
-
-        HashItem *item = create_hash_item((char*)get_channel_name(channel), channel); 
-        insert_item_to_hash_table(session->channels, item);
-    }
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&session->channelsCountLock);
-        pthread_rwlock_unlock(&session->channelsLock);
-    }
+    insert_to_flat_table(session->channels, (char*)get_channel_name(channel), channel);
 } 
 
 void remove_user_from_hash_table(Session *session, User *user) {
@@ -172,17 +167,7 @@ void remove_user_from_hash_table(Session *session, User *user) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&session->usersLock);
-        pthread_rwlock_wrlock(&session->usersCountLock);
-    }
-
-    remove_item_from_hash_table(session->users, (char*)get_user_nickname(user));
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&session->usersCountLock);
-        pthread_rwlock_unlock(&session->usersLock);
-    }
+    remove_from_flat_table(session->users, (char*)get_user_nickname(user));
 }
 
 void remove_channel_from_hash_table(Session *session, Channel *channel) {
@@ -191,17 +176,7 @@ void remove_channel_from_hash_table(Session *session, Channel *channel) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&session->channelsLock);
-        pthread_rwlock_wrlock(&session->channelsCountLock);
-    }
-
-    remove_item_from_hash_table(session->channels, (char*)get_channel_name(channel));
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&session->channelsCountLock);
-        pthread_rwlock_unlock(&session->channelsLock);
-    }
+    remove_from_flat_table(session->channels, (char*)get_channel_name(channel));
 }
 
 User * find_user_in_hash_table(Session *session, const char *nickname) {
@@ -210,48 +185,66 @@ User * find_user_in_hash_table(Session *session, const char *nickname) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&session->usersLock);
-    }
+    return find_in_flat_table(session->users, (char*)nickname);
+}
 
-    HashItem *item = find_item_in_hash_table(session->users, (char*)nickname);
-    User *user = get_value(item);
+Channel * find_channel_in_hash_table(Session *session, const char *name) {
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&session->usersLock);
+    if (session == NULL || name == NULL) {
+        FAILED(ARG_ERROR, NULL);
     }
 
-    return user;
+    return find_in_flat_table(session->channels, (char*)name);
 }
 
-Channel * find_channel_in_hash_table(Session *session, const char *name) {
+/* the nickname is the user's key, so the user is 
+    taken out of the table while it's renamed. its 
+    memberships are keyed by the user itself and 
+    don't change. the new nickname must be free, 
+    since a user which isn't in the table can't be 
+    found or unregistered */
+void rename_user_in_hash_table(Session *session, User *user, const char *nickname) {
 
-    if (session == NULL || name == NULL) {
+    if (session == NULL || user == NULL || nickname == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&session->channelsLock);
+    release_from_flat_table(session->users, (char*)get_user_nickname(user));
+    set_user_nickname(user, nickname);
+
+    if (!add_user_to_hash_table(session, user)) {
+        FAILED(NO_ERRCODE, "Nickname is already in use");
     }
+}
 
-    HashItem *item = find_item_in_hash_table(session->channels, (char*)name);
-    Channel *channel = get_value(item);
+int reserve_nickname(Session *session, const char *nickname, void *holder) {
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&session->channelsLock);
+    if (session == NULL || nickname == NULL || holder == NULL) {
+        FAILED(ARG_ERROR, NULL);
     }
 
-    return channel;
+    return insert_to_flat_table(session->nicknames, (char*)nickname, holder);
 }
 
-void change_user_in_hash_table(Session *session, User *oldUser, User *newUser) {
+/* only the holder releases its nickname */
+void release_nickname(Session *session, const char *nickname, void *holder) {
 
-    if (session == NULL || oldUser == NULL || newUser == NULL) {
+    if (session == NULL || nickname == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    remove_user_from_hash_table(session, oldUser);
-    add_user_to_hash_table(session, newUser);
+    if (find_nickname_holder(session, nickname) == holder) {
+        remove_from_flat_table(session->nicknames, (char*)nickname);
+    }
+}
+
+void * find_nickname_holder(Session *session, const char *nickname) {
+
+    if (session == NULL || nickname == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return find_in_flat_table(session->nicknames, (char*)nickname);
 }
 
 ReadyList * create_ready_list(void) {
@@ -261,42 +254,26 @@ ReadyList * create_ready_list(void) {
         FAILED(ALLOC_ERROR, NULL);
     }
 
-    readyList->readyUsers = create_linked_list(are_users_equal, NULL);
-    readyList->readyChannels = create_linked_list(are_channels_equal, NULL);
+    init_intrusive_list(&readyList->readyUsers);
+    init_intrusive_list(&readyList->readyChannels);
 
     return readyList;
 }
 
 void delete_ready_list(ReadyList *readyList) {
 
-    if (readyList != NULL) {
-
-        delete_linked_list(readyList->readyUsers);
-        delete_linked_list(readyList->readyChannels);
-    }
-
     free(readyList);   
 }
 
+/* a user or a channel which is already 
+    in the list isn't added again */
 void add_user_to_ready_list(void *user, void *readyList) {
 
     if (user == NULL || readyList == NULL ) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&readyListLock);
-    }
-
-    if (!find_node(((ReadyList*)readyList)->readyUsers, user)) {
-
-        Node *node = create_node(user);
-        append_node(((ReadyList*)readyList)->readyUsers, node);
-    }
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&readyListLock);
-    }
+    append_link(&((ReadyList*)readyList)->readyUsers, get_user_ready_link(user));
 }
 
 void add_channel_to_ready_list(void *channel, void *readyList) {
@@ -305,53 +282,43 @@ void add_channel_to_ready_list(void *channel, void *readyList) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&readyListLock);
-    }
-
-    if (!find_node(((ReadyList*)readyList)->readyChannels, channel)) {
+    append_link(&((ReadyList*)readyList)->readyChannels, get_channel_ready_link(channel));
+}
 
-        Node *node = create_node(channel);
-        append_node(((ReadyList*)readyList)->readyChannels, node);
+void remove_user_from_ready_list(ReadyList *readyList, User *user) {
+    
+    if (readyList == NULL || user == NULL) {
+        FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&readyListLock);
-    }
+    remove_link(&readyList->readyUsers, get_user_ready_link(user));
 }
 
-void remove_user_from_ready_list(LinkedList *readyUsers, User *user) {
+void remove_channel_from_ready_list(ReadyList *readyList, Channel *channel) {
     
-    if (readyUsers == NULL || user == NULL) {
+    if (readyList == NULL || channel == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&readyListLock);
-    }
-
-    remove_node(readyUsers, user);
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&readyListLock);
-    }
+    remove_link(&readyList->readyChannels, get_channel_ready_link(channel));
 }
 
-void remove_channel_from_ready_list(LinkedList *readyChannels, Channel *channel) {
-    
-    if (readyChannels == NULL || channel == NULL) {
+User * pop_ready_user(ReadyList *readyList) {
+
+    if (readyList == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&readyListLock);
-    }
+    return pop_link(&readyList->readyUsers);
+}
 
-    remove_node(readyChannels, channel);
+Channel * pop_ready_channel(ReadyList *readyList) {
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&readyListLock);
+    if (readyList == NULL) {
+        FAILED(ARG_ERROR, NULL);
     }
+
+    return pop_link(&readyList->readyChannels);
 }
 
 UserChannels * create_user_channels(User *user) {
@@ -360,13 +327,13 @@ UserChannels * create_user_channels(User *user) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    UserChannels *userChannels = (UserChannels*) malloc(sizeof(UserChannels));
-    if (userChannels == NULL) {
-        FAILED(ALLOC_ERROR, NULL);
+    if (userChannelsSlab == NULL) {
+        userChannelsSlab = create_slab_allocator(sizeof(UserChannels));
     }
 
+    UserChannels *userChannels = (UserChannels*) allocate_from_slab(userChannelsSlab);
+
     userChannels->user = user;
-    userChannels->channels = create_linked_list(are_channels_equal, NULL);
     userChannels->capacity = MAX_CHANNELS_PER_USER;
     userChannels->count = 0;
 
@@ -379,14 +346,21 @@ ChannelUsers * create_channel_users(Channel *channel) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    ChannelUsers *channelUsers = (ChannelUsers*) malloc(sizeof(ChannelUsers));
-    if (channelUsers == NULL) {
+    if (channelUsersSlab == NULL) {
+        channelUsersSlab = create_slab_allocator(sizeof(ChannelUsers));
+    }
+
+    ChannelUsers *channelUsers = (ChannelUsers*) allocate_from_slab(channelUsersSlab);
+
+    channelUsers->capacity = MAX_USERS_PER_CHANNEL;
+    channelUsers->size = channelUsers->capacity < DEF_MEMBERS_SIZE ? channelUsers->capacity : DEF_MEMBERS_SIZE;
+
+    channelUsers->members = (MemberEntry*) malloc(channelUsers->size * sizeof(MemberEntry));
+    if (channelUsers->members == NULL) {
         FAILED(ALLOC_ERROR, NULL);
     }
 
     channelUsers->channel = channel;
-    channelUsers->users = create_linked_list(are_users_equal, NULL);
-    channelUsers->capacity = MAX_USERS_PER_CHANNEL;
     channelUsers->count = 0;
 
     return channelUsers;
@@ -394,29 +368,24 @@ ChannelUsers * create_channel_users(Channel *channel) {
 
 STATIC void delete_user_channels(void *userChannels) {
 
-    if (userChannels != NULL) {
-
-        delete_linked_list(((UserChannels*)userChannels)->channels);
-    }
-
-    free(userChannels);
+    release_to_slab(userChannels);
 }
 
 STATIC void delete_channel_users(void *channelUsers) {
 
     if (channelUsers != NULL) {
 
-        delete_linked_list(((ChannelUsers*)channelUsers)->users);
+        free(((ChannelUsers*)channelUsers)->members);
     }
 
-    free(channelUsers);
+    release_to_slab(channelUsers);
 }
 
-/* don't manually free userChannels user or 
-channelUsers after adding them to <linked list>, 
-they will be freed automatically when linked list 
-is deleted in delete_session() if DeleteDataFunc 
-is passed to create_linked_list() */
+/* don't manually free userChannels or 
+channelUsers after adding them to the <hash table>, 
+they will be freed automatically when they're 
+removed or when the table is deleted in 
+delete_session() */
 
 void add_user_channels(Session *session, UserChannels *userChannels) {
 
@@ -424,16 +393,7 @@ void add_user_channels(Session *session, UserChannels *userChannels) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&userChannelsLock);
-    }
-
-    Node *node = create_node(userChannels);
-    append_node(session->userChannelsLL, node);
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&userChannelsLock);
-    }
+    insert_to_flat_table(session->userChannels, userChannels->user, userChannels);
 }
 
 void add_channel_users(Session *session, ChannelUsers *channelUsers) {
@@ -442,16 +402,7 @@ void add_channel_users(Session *session, ChannelUsers *channelUsers) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&channelUsersLock);
-    }
-
-    Node *node = create_node(channelUsers);
-    append_node(session->channelUsersLL, node);
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&channelUsersLock);
-    }
+    insert_to_flat_table(session->channelUsers, channelUsers->channel, channelUsers);
 }
 
 int remove_user_channels(Session *session, UserChannels *userChannels) {
@@ -460,15 +411,7 @@ int remove_user_channels(Session *session, UserChannels *userChannels) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&userChannelsLock);
-    }
-
-    int removed = remove_node(session->userChannelsLL, userChannels);
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&userChannelsLock);
-    }
+    int removed = remove_from_flat_table(session->userChannels, userChannels->user);
 
     return removed;
 }
@@ -479,15 +422,7 @@ int remove_channel_users(Session *session, ChannelUsers *channelUsers) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&channelUsersLock);
-    }
-
-    int removed = remove_node(session->channelUsersLL, channelUsers);
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&channelUsersLock);
-    }
+    int removed = remove_from_flat_table(session->channelUsers, channelUsers->channel);
 
     return removed;
 }
@@ -498,94 +433,108 @@ UserChannels * find_user_channels(Session *session, User *user) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&userChannelsLock);
-    }
-
-    Node *node = find_node(session->userChannelsLL, &(UserChannels){user, NULL, 0, 0});
+    return find_in_flat_table(session->userChannels, user);
+}
 
-    UserChannels *userChannels = get_data(node);
+ChannelUsers * find_channel_users(Session *session, Channel *channel) {
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&userChannelsLock);
+    if (session == NULL || channel == NULL) {
+        FAILED(ARG_ERROR, NULL);
     }
 
-    return userChannels;
+    return find_in_flat_table(session->channelUsers, channel);
 }
 
-ChannelUsers * find_channel_users(Session *session, Channel *channel) {
+/* the user and the channel keep each other's 
+    position, so a member is added and removed 
+    without searching the channel */
+int add_channel_member(UserChannels *userChannels, ChannelUsers *channelUsers) {
 
-    if (session == NULL || channel == NULL) {
+    if (userChannels == NULL || channelUsers == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&channelUsersLock);
+    if (userChannels->count == userChannels->capacity || channelUsers->count == channelUsers->capacity) {
+        return 0;
     }
 
-    Node *node = find_node(session->channelUsersLL, &(ChannelUsers){channel, NULL, 0, 0});
+    if (channelUsers->count == channelUsers->size) {
+
+        int size = channelUsers->size * 2 < channelUsers->capacity ? channelUsers->size * 2 : channelUsers->capacity;
 
-    ChannelUsers *channelUsers = get_data(node);
+        MemberEntry *members = (MemberEntry*) realloc(channelUsers->members, size * sizeof(MemberEntry));
+        if (members == NULL) {
+            FAILED(ALLOC_ERROR, NULL);
+        }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&channelUsersLock);
+        channelUsers->members = members;
+        channelUsers->size = size;
     }
 
-    return channelUsers;
+    userChannels->channels[userChannels->count] = (ChannelEntry){channelUsers, channelUsers->count};
+    channelUsers->members[channelUsers->count] = (MemberEntry){userChannels->user, userChannels, userChannels->count};
+
+    userChannels->count++;
+    channelUsers->count++;
+
+    return 1;
 }
 
-int add_channel_to_user_channels(UserChannels *userChannels, Channel *channel) {
+int remove_channel_member(UserChannels *userChannels, ChannelUsers *channelUsers) {
 
-    if (userChannels == NULL || channel == NULL) {
+    if (userChannels == NULL || channelUsers == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    int added = 0;
+    for (int i = 0; i < userChannels->count; i++) {
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&userChannelsLock);
-    }
+        if (userChannels->channels[i].channelUsers == channelUsers) {
 
-    if (userChannels->count < userChannels->capacity) {
+            remove_member_entry(channelUsers, userChannels->channels[i].memberIdx);
+            remove_channel_entry(userChannels, i);
 
-        Node *node = create_node(channel);
-        append_node(userChannels->channels, node);
-        userChannels->count++;
-        added = 1;
-    }
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&userChannelsLock);
+            return 1;
+        }
     }
 
-    return added;
+    return 0;
 }
 
-int add_user_to_channel_users(ChannelUsers *channelUsers, User *user) {
+/* the last entry is moved to the removed 
+    position and its user is told where it is */
+STATIC void remove_member_entry(ChannelUsers *channelUsers, int memberIdx) {
 
-    if (channelUsers == NULL || user == NULL) {
+    if (channelUsers == NULL || memberIdx < 0 || memberIdx >= channelUsers->count) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    int added = 0;
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&channelUsersLock);
+    /* the last entry isn't moved, so nothing is 
+        fixed up. its back index may already point 
+        at a refilled slot */
+    if (memberIdx == --channelUsers->count) {
+        return;
     }
 
-    if (channelUsers->count < channelUsers->capacity) {
+    MemberEntry *lastMember = &channelUsers->members[channelUsers->count];
+
+    channelUsers->members[memberIdx] = *lastMember;
+    lastMember->userChannels->channels[lastMember->channelIdx].memberIdx = memberIdx;
+}
+
+STATIC void remove_channel_entry(UserChannels *userChannels, int channelIdx) {
 
-        Node *node = create_node(user);
-        append_node(channelUsers->users, node);
-        channelUsers->count++;
-        added = 1;
+    if (userChannels == NULL || channelIdx < 0 || channelIdx >= userChannels->count) {
+        FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&channelUsersLock);
+    if (channelIdx == --userChannels->count) {
+        return;
     }
 
-    return added;
+    ChannelEntry *lastChannel = &userChannels->channels[userChannels->count];
+
+    userChannels->channels[channelIdx] = *lastChannel;
+    lastChannel->channelUsers->members[lastChannel->memberIdx].channelIdx = channelIdx;
 }
 
 Channel * find_channel_in_user_channels(UserChannels *userChannels, Channel *channel) {
@@ -594,125 +543,139 @@ Channel * find_channel_in_user_channels(UserChannels *userChannels, Channel *cha
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&userChannelsLock);
-    }
-
-    Node *node = find_node(userChannels->channels, channel);
-    Channel *foundChannel = get_data(node);
+    for (int i = 0; i < userChannels->count; i++) {
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&userChannelsLock);
+        if (userChannels->channels[i].channelUsers->channel == channel) {
+            return channel;
+        }
     }
 
-    return foundChannel;
+    return NULL;
 }
 
-User * find_user_in_channel_users(ChannelUsers *channelUsers, User *user) {
+/* a user is in a few channels at most, so 
+    they're searched instead of the channel */
+bool is_channel_member(Session *session, Channel *channel, User *user) {
 
-    if (channelUsers == NULL || user == NULL) {
+    if (session == NULL || channel == NULL || user == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&channelUsersLock);
-    }
-
-    Node *node = find_node(channelUsers->users, user);
-    User *foundUser = get_data(node);
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&channelUsersLock);
-    }
+    UserChannels *userChannels = find_user_channels(session, user);
 
-    return foundUser;
+    return userChannels != NULL && find_channel_in_user_channels(userChannels, channel) != NULL;
 }
 
-void remove_channel_in_user_channels(UserChannels *userChannels, Channel *channel) {
+void iterate_user_channels(UserChannels *userChannels, IteratorFunc iteratorFunc, void *arg) {
 
-    if (userChannels == NULL || channel == NULL) {
+    if (userChannels == NULL || iteratorFunc == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&userChannelsLock);
+    for (int i = 0; i < userChannels->count; i++) {
+        iteratorFunc(userChannels->channels[i].channelUsers->channel, arg);
     }
+}
+
+void iterate_channel_users(ChannelUsers *channelUsers, IteratorFunc iteratorFunc, void *arg) {
 
-    remove_node(userChannels->channels, channel);
-    userChannels->count--;
+    if (channelUsers == NULL || iteratorFunc == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&userChannelsLock);
+    for (int i = 0; i < channelUsers->count; i++) {
+        iteratorFunc(channelUsers->members[i].user, arg);
     }
 }
 
-void remove_user_in_channel_users(ChannelUsers *channelUsers, User *user) {
+/* calls the function once for every user sharing 
+    a channel with the user, the user included. every 
+    call stamps a user with a new epoch, so users in 
+    several of the channels are skipped after the 
+    first one */
+void iterate_channel_peers(Session *session, User *user, IteratorFunc iteratorFunc, void *arg) {
 
-    if (channelUsers == NULL || user == NULL) {
+    if (session == NULL || user == NULL || iteratorFunc == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&channelUsersLock);
+    UserChannels *userChannels = find_user_channels(session, user);
+
+    if (userChannels == NULL) {
+        return;
     }
 
-    remove_node(channelUsers->users, user);
-    channelUsers->count--;
+    unsigned long epoch = ++session->peerEpoch;
+
+    for (int i = 0; i < userChannels->count; i++) {
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&channelUsersLock);
+        ChannelUsers *channelUsers = userChannels->channels[i].channelUsers;
+
+        for (int j = 0; j < channelUsers->count; j++) {
+
+            User *peer = channelUsers->members[j].user;
+
+            if (stamp_user_epoch(peer, epoch)) {
+                iteratorFunc(peer, arg);
+            }
+        }
     }
 }
 
-void change_user_in_user_channels(UserChannels *userChannels, User *user) {
+/* each peer gets one copy of the message, no 
+    matter how many channels it shares with the user */
+void enqueue_to_channel_peers(Session *session, User *user, const char *message, int len, bool includeUser) {
 
-    if (userChannels == NULL || user == NULL) {
+    if (session == NULL || user == NULL || message == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&userChannelsLock);
-    }
-
-    userChannels->user = user;
+    struct {
+        Session *session;
+        User *user;
+        const char *message;
+        int len;
+        bool includeUser;
+    } data = {session, user, message, len, includeUser};
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&userChannelsLock);
-    }
+    iterate_channel_peers(session, user, enqueue_to_channel_peer, &data);
 }
 
-void change_user_in_channel_users(void *channelUsers, void *user) {
+STATIC void enqueue_to_channel_peer(void *user, void *arg) {
 
-    if (channelUsers == NULL || user == NULL) {
+    if (user == NULL || arg == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&channelUsersLock);
-    }
+    struct {
+        Session *session;
+        User *user;
+        const char *message;
+        int len;
+        bool includeUser;
+    } *data = arg;
 
-    LinkedList *users = ((ChannelUsers*)channelUsers)->users;
-    Node *node = find_node(users, user);
+    if (user != data->user || data->includeUser) {
 
-    if (node != NULL) {
-        set_data(node, user);
-    }
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&channelUsersLock);
+        enqueue_to_user_queue(user, data->message, data->len);
+        add_user_to_ready_list(user, get_ready_list(data->session));
     }
 }
 
-void register_user(Session *session, User *user) {
+int register_user(Session *session, User *user) {
 
     if (session == NULL || user == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    add_user_to_hash_table(session, user);
+    if (!add_user_to_hash_table(session, user)) {
+        return 0;
+    }
 
     UserChannels *userChannels = create_user_channels(user);
     add_user_channels(session, userChannels);
+
+    return 1;
 }
 
 void unregister_user(Session *session, User *user) {
@@ -737,10 +700,9 @@ void register_new_channel_join(Session *session, Channel *channel, User *user) {
 
     ChannelUsers *channelUsers = create_channel_users(channel);
     add_channel_users(session, channelUsers);
-    add_user_to_channel_users(channelUsers, user);
 
     UserChannels *userChannels = find_user_channels(session, user);
-    add_channel_to_user_channels(userChannels, channel);
+    add_channel_member(userChannels, channelUsers);
 }
 
 void register_existing_channel_join(Session *session, Channel *channel, User *user) {
@@ -750,10 +712,9 @@ void register_existing_channel_join(Session *session, Channel *channel, User *us
     }
 
     ChannelUsers *channelUsers = find_channel_users(session, channel);
-    add_user_to_channel_users(channelUsers, user);
-
     UserChannels *userChannels = find_user_channels(session, user);
-    add_channel_to_user_channels(userChannels, channel);
+
+    add_channel_member(userChannels, channelUsers);
 }
 
 void register_channel_leave(Session *session, Channel *channel, User *user) {
@@ -763,46 +724,38 @@ void register_channel_leave(Session *session, Channel *channel, User *user) {
     }
 
     ChannelUsers *channelUsers = find_channel_users(session, channel);
-    remove_user_in_channel_users(channelUsers, user);
-
     UserChannels *userChannels = find_user_channels(session, user);
-    remove_channel_in_user_channels(userChannels, channel);
+
+    remove_channel_member(userChannels, channelUsers);
 }
 
-void leave_all_channels(Session *session, User *user, const char *message) {
+void leave_all_channels(Session *session, User *user, const char *message, int len) {
 
     UserChannels *userChannels = find_user_channels(session, user);
 
-    if (userChannels != NULL) {
-
-        LinkedList *channels = get_channels_from_user_channels(userChannels);
-        reset_iterator(channels);
+    /* the quit message is sent once to every peer 
+        before the channels are left */
+    enqueue_to_channel_peers(session, user, message, len, 0);
 
-        Node *node = NULL;
+    /* channels are left from the last one, so 
+        the remaining entries don't move */
+    while (userChannels != NULL && userChannels->count) {
 
-        while ((node = iterator_next(channels)) != NULL) {
+        ChannelUsers *channelUsers = userChannels->channels[userChannels->count - 1].channelUsers;
+        Channel *channel = channelUsers->channel;
 
-            Channel *channel = get_data(node);
-            ChannelUsers *channelUsers = find_channel_users(session, channel);
+        register_channel_leave(session, channel, user);
 
-            register_channel_leave(session, channel, user);
-
-             /* remove channels with only client */
-            if (channelUsers != NULL && !get_channel_users_count(channelUsers)) {
-                remove_channel_data(session, channel);
-            }
-            /* send quit message to channel */
-            else {
-                enqueue_to_channel_queue(channel, (char*) message);
-                add_channel_to_ready_list(channel, get_ready_list(session));
-            }
+        /* remove channels with only client */
+        if (!get_channel_users_count(channelUsers)) {
+            remove_channel_data(session, channel);
         }
     }
 }
 
 void remove_channel_data(Session *session, Channel *channel) {
 
-    remove_channel_from_ready_list(get_ready_channels(get_ready_list(session)), channel);
+    remove_channel_from_ready_list(get_ready_list(session), channel);
     remove_channel_users(session, find_channel_users(session, channel));
     remove_channel_from_hash_table(session, channel);
 }
@@ -813,171 +766,38 @@ bool is_channel_full(ChannelUsers *channelUsers) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&channelUsersLock);
-    }
     int count = channelUsers->count; 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&channelUsersLock);
-    }
     return count == channelUsers->capacity;
 }
 
 
-bool are_user_channels_equal(void *userChannels1, void *userChannels2) {
-
-    bool equal = 0;
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&userChannelsLock);
-    }
-
-    if (userChannels1 != NULL && userChannels2 != NULL) {
-
-        equal = are_users_equal(((UserChannels*)userChannels1)->user, ((UserChannels*)userChannels2)->user);
-    }
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&userChannelsLock);
-    }
-
-    return equal;
-}
-
-bool are_channel_users_equal(void *channelUsers1, void *channelUsers2) {
-
-    bool equal = 0;
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&channelUsersLock);
-    }
-
-    if (channelUsers1 != NULL && channelUsers2 != NULL) {
-
-        equal = are_channels_equal(((ChannelUsers*)channelUsers1)->channel, ((ChannelUsers*)channelUsers2)->channel);
-    }
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&channelUsersLock);
-    }
-
-    return equal;
-}
-
 ReadyList * get_ready_list(Session *session) {
 
     if (session == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&readyListLock);
-    }
-
     ReadyList *readyList = session->readyList;
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&readyListLock);
-    }
-
     return readyList;
 }
 
-LinkedList * get_ready_users(ReadyList *readyList) {
+int get_ready_users_count(ReadyList *readyList) {
 
     if (readyList == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&readyListLock);
-    }
-
-    LinkedList *readyUsers = readyList->readyUsers;
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&readyListLock);
-    }
-
-    return readyUsers;
+    return get_intrusive_list_count(&readyList->readyUsers);
 }
 
-LinkedList * get_ready_channels(ReadyList *readyList) {
+int get_ready_channels_count(ReadyList *readyList) {
 
     if (readyList == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&readyListLock);
-    }
-
-    LinkedList *readyChannels = readyList->readyChannels;
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&readyListLock);
-    }
-
-    return readyChannels;
-}
-
-
-LinkedList * get_channels_from_user_channels(UserChannels *userChannels) {
-
-    if (userChannels == NULL) {
-        FAILED(ARG_ERROR, NULL);
-    }
-
-    
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&userChannelsLock);
-    }
-
-    LinkedList *channels = userChannels->channels;
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&userChannelsLock);
-    }
-
-    return channels;
-}
-
-LinkedList * get_users_from_channel_users(ChannelUsers *channelUsers) {
-
-    if (channelUsers == NULL) {
-        FAILED(ARG_ERROR, NULL);
-    }
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&channelUsersLock);
-    }
-
-    LinkedList *users = channelUsers->users;
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&channelUsersLock);
-    }
-
-    return users;
-}
-
-LinkedList * get_channel_users_ll(Session *session) {
-
-    if (session == NULL) {
-        FAILED(ARG_ERROR, NULL);
-    }
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&channelUsersLock);
-    }
-
-    LinkedList *channelUsersLL = session->channelUsersLL;
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&channelUsersLock);
-    }
-
-    return channelUsersLL;
+    return get_intrusive_list_count(&readyList->readyChannels);
 }
 
 int get_channel_users_count(ChannelUsers *channelUsers) {
@@ -986,14 +806,7 @@ int get_channel_users_count(ChannelUsers *channelUsers) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&channelUsersLock);
-    }
-
     int count = channelUsers->count;
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&channelUsersLock);
-    }
     return count;
 }
@@ -19,7 +19,8 @@ typedef void (*IteratorFunc)(void *data, void *arg);
 Session * create_session(void);
 void delete_session(Session *session);
 
-void add_user_to_hash_table(Session *session, User *user);
+/* returns 0 if the nickname is taken */
+int add_user_to_hash_table(Session *session, User *user);
 void add_channel_to_hash_table(Session *session, Channel *channel);
 
 void remove_user_from_hash_table(Session *session, User *user);
@@ -27,7 +28,15 @@ void remove_channel_from_hash_table(Session *session, Channel *channel);
 
 User * find_user_in_hash_table(Session *session, const char *nickname);
 Channel * find_channel_in_hash_table(Session *session, const char *name);
-void change_user_in_hash_table(Session *session, User *oldUser, User *newUser);
+void rename_user_in_hash_table(Session *session, User *user, const char *nickname);
+
+/* clients of all event loops reserve their 
+    nicknames in the session, before their 
+    registration is complete. the key is the 
+    holder's own nickname buffer */
+int reserve_nickname(Session *session, const char *nickname, void *holder);
+void release_nickname(Session *session, const char *nickname, void *holder);
+void * find_nickname_holder(Session *session, const char *nickname);
 
 ReadyList * create_ready_list(void);
 void delete_ready_list(ReadyList *readyList);
@@ -35,8 +44,11 @@ void delete_ready_list(ReadyList *readyList);
 void add_user_to_ready_list(void *user, void *readyList);
 void add_channel_to_ready_list(void *channel, void *readyList);
 
-void remove_user_from_ready_list(LinkedList *readyUsers, User *user);
-void remove_channel_from_ready_list(LinkedList *readyChannels, Channel *channel);
+void remove_user_from_ready_list(ReadyList *readyList, User *user);
+void remove_channel_from_ready_list(ReadyList *readyList, Channel *channel);
+
+User * pop_ready_user(ReadyList *readyList);
+Channel * pop_ready_channel(ReadyList *readyList);
 
 UserChannels * create_user_channels(User *user);
 ChannelUsers * create_channel_users(Channel *channel);
@@ -50,41 +62,35 @@ int remove_channel_users(Session *session, ChannelUsers *channelUsers);
 UserChannels * find_user_channels(Session *session, User *user);
 ChannelUsers * find_channel_users(Session *session, Channel *channel);
 
-int add_channel_to_user_channels(UserChannels *userChannels, Channel *channel);
-int add_user_to_channel_users(ChannelUsers *channelUsers, User *user);
+int add_channel_member(UserChannels *userChannels, ChannelUsers *channelUsers);
+int remove_channel_member(UserChannels *userChannels, ChannelUsers *channelUsers);
 
 Channel * find_channel_in_user_channels(UserChannels *userChannels, Channel *channel);
-User * find_user_in_channel_users(ChannelUsers *channelUsers, User *user);
+bool is_channel_member(Session *session, Channel *channel, User *user);
 
-void remove_channel_in_user_channels(UserChannels *userChannels, Channel *channel);
-void remove_user_in_channel_users(ChannelUsers *channelUsers, User *user);
+void iterate_user_channels(UserChannels *userChannels, IteratorFunc iteratorFunc, void *arg);
+void iterate_channel_users(ChannelUsers *channelUsers, IteratorFunc iteratorFunc, void *arg);
 
-void change_user_in_user_channels(UserChannels *userChannels, User *user);
-void change_user_in_channel_users(void *channelUsers, void *user);
+void iterate_channel_peers(Session *session, User *user, IteratorFunc iteratorFunc, void *arg);
+void enqueue_to_channel_peers(Session *session, User *user, const char *message, int len, bool includeUser);
 
-void register_user(Session *session, User *user);
+/* returns 0 if the user's nickname is taken */
+int register_user(Session *session, User *user);
 void unregister_user(Session *session, User *user);
 
 void register_new_channel_join(Session *session, Channel *channel, User *user);
 void register_existing_channel_join(Session *session, Channel *channel, User *user);
 
 void register_channel_leave(Session *session, Channel *channel, User *user);
-void leave_all_channels(Session *session, User *user, const char *message);
+void leave_all_channels(Session *session, User *user, const char *message, int len);
 void remove_channel_data(Session *session, Channel *channel);
 
 bool is_channel_full(ChannelUsers *channelUsers);
 
-bool are_user_channels_equal(void *userChannels1, void *userChannels2);
-bool are_channel_users_equal(void *channelUsers1, void *channelUsers2);
-
 ReadyList * get_ready_list(Session *session);
-LinkedList * get_ready_users(ReadyList *readyList);
-LinkedList * get_ready_channels(ReadyList *readyList);
-
-LinkedList * get_channels_from_user_channels(UserChannels *userChannels);
-LinkedList * get_users_from_channel_users(ChannelUsers *channelUsers);
+int get_ready_users_count(ReadyList *readyList);
+int get_ready_channels_count(ReadyList *readyList);
 
-LinkedList * get_channel_users_ll(Session *session);
 int get_channel_users_count(ChannelUsers *channelUsers);
 
 #endif
\ No newline at end of file
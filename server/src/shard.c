@@ -0,0 +1,225 @@
+#include "shard.h"
+#include "event_loop.h"
+#include "config.h"
+#include "dispatcher.h"
+
+#include "../../libs/src/common.h"
+#include "../../libs/src/settings.h"
+#include "../../libs/src/error_control.h"
+#include "../../libs/src/logger.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <poll.h>
+
+#ifdef TEST
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+typedef struct {
+    pthread_t thread;
+    EventManager *eventManager;
+    PollManager *pollManager;
+    StreamPipe *streamPipe;
+    TCPServer *tcpServer;
+    CommandTokens *cmdTokens;
+    EventLoop *eventLoop;
+} Shard;
+
+/* the fd's owners are accessed only while holding
+    the session lock */
+typedef struct {
+    Shard *shards;
+    int shardCount;
+    int *fdShards;
+    int fdCount;
+} ShardContext;
+
+static ShardContext shardContext = {0};
+
+STATIC void * run_shard_thread(void *arg);
+
+STATIC bool forward_message(int fd, SharedBuffer *buffer);
+
+STATIC void handle_shard_add_fd_event(Event *event);
+STATIC void handle_shard_remove_fd_event(Event *event);
+
+void run_sharded_server(EventManager *eventManager, PollManager *pollManager, StreamPipe *streamPipe, TCPServer *tcpServer, CommandTokens *cmdTokens, int shardCount) {
+
+    if (eventManager == NULL || pollManager == NULL || streamPipe == NULL || tcpServer == NULL || cmdTokens == NULL || shardCount <= 0) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    shardContext.shards = (Shard*) calloc(shardCount, sizeof(Shard));
+    shardContext.fdCount = sysconf(_SC_OPEN_MAX);
+    shardContext.fdShards = (int*) malloc(shardContext.fdCount * sizeof(int));
+    if (shardContext.shards == NULL || shardContext.fdShards == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+
+    for (int i = 0; i < shardContext.fdCount; i++) {
+        shardContext.fdShards[i] = UNASSIGNED;
+    }
+
+    shardContext.shardCount = shardCount;
+
+    init_event_loops();
+
+    for (int i = 0; i < shardCount; i++) {
+
+        Shard *shard = &shardContext.shards[i];
+
+        /* the first shard uses the resources of the main
+            thread, including the pipe for signals */
+        if (i == 0) {
+            shard->eventManager = eventManager;
+            shard->pollManager = pollManager;
+            shard->streamPipe = streamPipe;
+            shard->tcpServer = tcpServer;
+            shard->cmdTokens = cmdTokens;
+        }
+        else {
+            shard->eventManager = create_event_manager(0);
+            register_event_handlers(shard->eventManager);
+
+            shard->pollManager = create_poll_manager(get_int_option_value(OT_MAX_FDS), POLLIN, get_int_option_value(OT_POLL_BACKEND));
+            shard->streamPipe = create_pipe();
+
+            shard->tcpServer = create_server(get_int_option_value(OT_MAX_FDS));
+            set_server_session(shard->tcpServer, get_session(tcpServer));
+            set_server_fd_table(shard->tcpServer, get_poll_fd_table(shard->pollManager));
+
+            if (get_server_resolver(tcpServer) != NULL) {
+                set_server_resolver(shard->tcpServer, get_server_resolver(tcpServer), get_pipe_fd(shard->streamPipe, WRITE_PIPE));
+            }
+            init_server(shard->tcpServer, NULL, get_int_option_value(OT_PORT));
+
+            set_poll_fd(shard->pollManager, get_pipe_fd(shard->streamPipe, READ_PIPE));
+            set_poll_fd(shard->pollManager, get_server_listen_fd(shard->tcpServer));
+
+            shard->cmdTokens = create_command_tokens(1);
+        }
+
+        shard->eventLoop = create_event_loop(i, shard->eventManager, shard->pollManager, shard->streamPipe, shard->tcpServer, shard->cmdTokens);
+
+        /* the shard which owns the fd is recorded when
+            the fd is added to or removed from the shard */
+        register_network_event_handler(shard->eventManager, NE_ADD_POLL_FD, handle_shard_add_fd_event);
+        register_network_event_handler(shard->eventManager, NE_REMOVE_POLL_FD, handle_shard_remove_fd_event);
+
+        set_server_forward_func(shard->tcpServer, forward_message);
+    }
+
+    for (int i = 1; i < shardCount; i++) {
+
+        if (pthread_create(&shardContext.shards[i].thread, NULL, run_shard_thread, &shardContext.shards[i]) != 0) {
+            FAILED(NO_ERRCODE, "Error creating thread");
+        }
+    }
+
+    LOG(INFO, "Started %d event loops", shardCount);
+
+    run_event_loop(shardContext.shards[0].eventLoop);
+}
+
+void stop_shards(void) {
+
+    if (shardContext.shards == NULL) {
+        return;
+    }
+
+    stop_event_loops();
+
+    for (int i = 1; i < shardContext.shardCount; i++) {
+        wake_event_loop(shardContext.shards[i].eventLoop);
+    }
+
+    for (int i = 1; i < shardContext.shardCount; i++) {
+
+        Shard *shard = &shardContext.shards[i];
+
+        /* the server may be terminated by an error on 
+            one of the shard threads */
+        if (shard->eventLoop == get_current_event_loop()) {
+            continue;
+        }
+
+        pthread_join(shard->thread, NULL);
+
+        delete_command_tokens(shard->cmdTokens);
+        delete_poll_manager(shard->pollManager);
+        delete_server(shard->tcpServer);
+        delete_pipe(shard->streamPipe);
+        delete_event_manager(shard->eventManager);
+    }
+
+    for (int i = 0; i < shardContext.shardCount; i++) {
+        delete_event_loop(shardContext.shards[i].eventLoop);
+    }
+
+    free(shardContext.shards);
+    free(shardContext.fdShards);
+
+    shardContext.shards = NULL;
+    shardContext.fdShards = NULL;
+}
+
+STATIC void * run_shard_thread(void *arg) {
+
+    /* signals are handled by the main thread */
+    sigset_t blockedSignals;
+    sigfillset(&blockedSignals);
+    pthread_sigmask(SIG_BLOCK, &blockedSignals, NULL);
+
+    run_event_loop(((Shard*) arg)->eventLoop);
+
+    return NULL;
+}
+
+STATIC bool forward_message(int fd, SharedBuffer *buffer) {
+
+    if (buffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    if (fd < 0 || fd >= shardContext.fdCount || shardContext.fdShards[fd] == UNASSIGNED) {
+        return 0;
+    }
+
+    return forward_to_event_loop(shardContext.shards[shardContext.fdShards[fd]].eventLoop, fd, buffer);
+}
+
+STATIC void handle_shard_add_fd_event(Event *event) {
+
+    if (event == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int fd = event->fd;
+
+    if (fd >= 0 && fd < shardContext.fdCount) {
+        shardContext.fdShards[fd] = get_event_loop_id(get_current_event_loop());
+    }
+
+    handle_ne_add_poll_fd_event(event);
+}
+
+STATIC void handle_shard_remove_fd_event(Event *event) {
+
+    if (event == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int fd = event->fd;
+
+    if (fd >= 0 && fd < shardContext.fdCount) {
+        shardContext.fdShards[fd] = UNASSIGNED;
+    }
+
+    handle_ne_remove_poll_fd_event(event);
+}
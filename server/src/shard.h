@@ -0,0 +1,24 @@
+#ifndef SHARD_H
+#define SHARD_H
+
+#include "tcp_server.h"
+#include "../../libs/src/event.h"
+#include "../../libs/src/io_utils.h"
+#include "../../libs/src/poll_manager.h"
+#include "../../libs/src/command.h"
+
+/* run the server on several event loops (shards), 
+    each on its own thread. the first shard runs on 
+    the calling thread with the given resources, 
+    while the others create their own. each shard 
+    accepts connections on its own SO_REUSEPORT 
+    listening socket and handles I/O of its clients.
+    the session is shared and is only accessed while
+    holding the session lock */
+void run_sharded_server(EventManager *eventManager, PollManager *pollManager, StreamPipe *streamPipe, TCPServer *tcpServer, CommandTokens *cmdTokens, int shardCount);
+
+/* stop and delete the shards running on other 
+    threads */
+void stop_shards(void);
+
+#endif
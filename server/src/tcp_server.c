@@ -1,11 +1,11 @@
 #define _XOPEN_SOURCE 700
+#define _DEFAULT_SOURCE
 
 #ifdef TEST
 #include "priv_tcp_server.h"
 #include "../../libs/src/mock.h"
 #else
 #include "tcp_server.h"
-#include "../../libs/src/hash_table.h"
 #endif
 
 #include "config.h"
@@ -22,6 +22,9 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/uio.h>
 #include <errno.h>
 
 #ifdef TEST
@@ -32,6 +35,8 @@
 
 #define LISTEN_QUEUE_LEN 50
 #define MSG_QUEUE_LEN 50
+#define LOOKUP_BATCH_SIZE 16
+#define MESSAGE_ARENA_BLOCK_SIZE 16384
 
 #ifndef TEST
 
@@ -40,19 +45,29 @@ struct TCPServer {
     Client **clients;
     Session *session;
     Queue *outQueue;
-    HashTable *fdsIdxMap;
+    Arena *messageArena;
+    char serverPrefix[MAX_PREFIX + 1];
+    FdTable *fdTable;
+    Client **pendingWrites;
+    int pendingCount;
+    int *freeSlots;
+    int freeCount;
+    ForwardMessageFunc forwardFunc;
+    Resolver *resolver;
+    LookupQueue *lookupQueue;
+    bool sharedSession;
+    bool sharedFdTable;
     int count;
     int capacity;
-    pthread_rwlock_t fdLock;
-    pthread_rwlock_t queueLock;
-    pthread_rwlock_t countLock;
 };
 
 #endif
 
-STATIC int find_client_fd_idx(TCPServer *tcpServer, int fd);
+STATIC int allocate_client_slot(TCPServer *tcpServer);
+STATIC void free_client_slot(TCPServer *tcpServer, int fdIdx);
 STATIC void set_client_data(TCPServer *tcpServer, int fdIdx, int fd, const char *clientIdentifier, HostIdentifierType identifierType, int port);
 STATIC void unset_client_data(TCPServer *tcpServer, int fdIdx);
+STATIC SharedBuffer * create_message_buffer(const char *message, int len);
 
 TCPServer * create_server(int capacity) {
 
@@ -81,14 +96,46 @@ TCPServer * create_server(int capacity) {
 
     tcpServer->session = create_session();
     tcpServer->outQueue = create_queue(MSG_QUEUE_LEN, MAX_CHARS + 1);
-    tcpServer->fdsIdxMap = create_hash_table(capacity, 0, fnv1a_hash, are_ints_equal, NULL, delete_pfd_idx_pair);
+    tcpServer->messageArena = create_arena(MESSAGE_ARENA_BLOCK_SIZE);
+
+    /* replies start with the server's name, which 
+        doesn't change while the server is running */
+    const char *serverName = get_char_option_value(OT_SERVER_NAME);
+    tcpServer->serverPrefix[0] = '\0';
+
+    if (serverName != NULL && serverName[0] != '\0') {
+        prepend_char(tcpServer->serverPrefix, MAX_PREFIX, serverName, ':');
+    }
+
+    tcpServer->fdTable = create_fd_table(capacity);
+
+    tcpServer->pendingWrites = (Client**) malloc(capacity * sizeof(Client*));
+    if (tcpServer->pendingWrites == NULL) {
+        FAILED(ALLOC_ERROR, NULL);  
+    }
+    tcpServer->pendingCount = 0;
+
+    /* free client slots are kept on a stack, with 
+        the lowest slot on top */
+    tcpServer->freeSlots = (int*) malloc(capacity * sizeof(int));
+    if (tcpServer->freeSlots == NULL) {
+        FAILED(ALLOC_ERROR, NULL);  
+    }
+
+    for (int i = 0; i < capacity; i++) {
+        tcpServer->freeSlots[i] = capacity - i - 1;
+    }
+    tcpServer->freeCount = capacity;
+
+    tcpServer->forwardFunc = NULL;
+    tcpServer->resolver = NULL;
+    tcpServer->lookupQueue = NULL;
+    tcpServer->sharedSession = 0;
+    tcpServer->sharedFdTable = 0;
+
     tcpServer->count = 0;
     tcpServer->capacity = capacity;
 
-    pthread_rwlock_init(&tcpServer->fdLock, NULL);
-    pthread_rwlock_init(&tcpServer->queueLock, NULL);
-    pthread_rwlock_init(&tcpServer->countLock, NULL);
-
     return tcpServer;
 }
 
@@ -101,13 +148,17 @@ void delete_server(TCPServer *tcpServer) {
         }
 
         free(tcpServer->clients);
-        delete_session(tcpServer->session);
+        if (!tcpServer->sharedSession) {
+            delete_session(tcpServer->session);
+        }
         delete_queue(tcpServer->outQueue);
-        delete_hash_table(tcpServer->fdsIdxMap);
-
-        pthread_rwlock_destroy(&tcpServer->countLock);
-        pthread_rwlock_destroy(&tcpServer->queueLock);
-        pthread_rwlock_destroy(&tcpServer->fdLock);
+        delete_arena(tcpServer->messageArena);
+        if (!tcpServer->sharedFdTable) {
+            delete_fd_table(tcpServer->fdTable);
+        }
+        free(tcpServer->pendingWrites);
+        free(tcpServer->freeSlots);
+        delete_lookup_queue(tcpServer->lookupQueue);
     }
     free(tcpServer);
 }
@@ -134,6 +185,13 @@ int init_server(TCPServer *tcpServer, const char *address, int port) {
         FAILED(NO_ERRCODE, "Error setting socket option");
     }
 
+    /* with several event loops, each loop has its own 
+        listening socket bound to the same port and the 
+        kernel distributes connections between them */
+    if (get_int_option_value(OT_SHARDS) > 1 && setsockopt(listenFd, SOL_SOCKET, SO_REUSEPORT, &enableSockOpt, sizeof(int)) < 0) {
+        FAILED(NO_ERRCODE, "Error setting socket option");
+    }
+
     /* initialize socket address structure */
     struct sockaddr_in servaddr;
     
@@ -163,18 +221,7 @@ bool is_server_empty(TCPServer *tcpServer) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    int count;
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&tcpServer->countLock);
-    }
-    count = tcpServer->count;
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&tcpServer->countLock);
-    }
-
-    return count == 0;
+    return tcpServer->count == 0;
 }
 
 bool is_server_full(TCPServer *tcpServer) {
@@ -183,35 +230,27 @@ bool is_server_full(TCPServer *tcpServer) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    int count;
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&tcpServer->countLock);
-    }
-    count = tcpServer->count;
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&tcpServer->countLock);
-    }
-    return count == tcpServer->capacity;
+    return tcpServer->count == tcpServer->capacity;
 }
 
-STATIC int find_client_fd_idx(TCPServer *tcpServer, int fd) {
+/* returns a free client slot or UNASSIGNED if the 
+    server is full */
+STATIC int allocate_client_slot(TCPServer *tcpServer) {
 
     if (tcpServer == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    int index = UNASSIGNED;
+    return tcpServer->freeCount ? tcpServer->freeSlots[--tcpServer->freeCount] : UNASSIGNED;
+}
 
-    for (int i = 0; i < tcpServer->capacity; i++) {
+STATIC void free_client_slot(TCPServer *tcpServer, int fdIdx) {
 
-        if (get_client_fd(tcpServer->clients[i]) == fd) {
-            index = i;
-            break;
-        }
+    if (tcpServer == NULL || fdIdx < 0 || fdIdx >= tcpServer->capacity) {
+        FAILED(ARG_ERROR, NULL);
     }
-    return index;
+
+    tcpServer->freeSlots[tcpServer->freeCount++] = fdIdx;
 }
 
 void add_client(TCPServer *tcpServer, EventManager *eventManager) {
@@ -250,28 +289,46 @@ void register_connection(TCPServer *tcpServer, EventManager *eventManager, int f
         FAILED(ARG_ERROR, NULL);
     }
 
-    int fdIdx = find_client_fd_idx(tcpServer, UNASSIGNED);
-    add_fd_idx_to_hash_table(tcpServer->fdsIdxMap, fd, fdIdx);
+    int fdIdx = allocate_client_slot(tcpServer);
+
+    if (fdIdx == UNASSIGNED) {
+
+        LOG(ERROR, "No free client slots (fd: %d)", fd);
+        close(fd);
+        return;
+    }
+    set_fd_client_idx(tcpServer->fdTable, fd, fdIdx);
 
     char ipv4Address[INET_ADDRSTRLEN + 1] = {'\0'};
     int port;
 
     get_peer_address(ipv4Address, INET_ADDRSTRLEN, &port, fd);
 
-    char servername[MAX_CHARS + 1] = {'\0'};
+    char hostname[MAX_CHARS + 1] = {'\0'};
     const char *clientIdentifier = ipv4Address;
     HostIdentifierType identifierType = IP_ADDRESS;
 
-    if (ip_to_hostname(servername, ARRAY_SIZE(servername), ipv4Address)) {
-        clientIdentifier = servername;
+    /* the client is registered with its IP address, 
+        unless the hostname is cached. the address is 
+        replaced when the lookup is completed */
+    if (tcpServer->resolver != NULL && resolve_hostname(tcpServer->resolver, tcpServer->lookupQueue, fd, ipv4Address, hostname, ARRAY_SIZE(hostname))) {
+        clientIdentifier = hostname;
         identifierType = HOSTNAME;
     }
 
     set_client_data(tcpServer, fdIdx, fd, clientIdentifier, identifierType, port);
 
+    /* writes to a client socket must not block the 
+        server. io_uring completes operations when the 
+        socket is ready, but it would fail them with 
+        EAGAIN on a non-blocking socket */
+    if (!get_int_option_value(OT_IO_URING) && !set_fd_nonblocking(fd)) {
+        LOG(ERROR, "Error setting non-blocking mode (fd: %d)", fd);
+    }
+
     if (eventManager != NULL) {
 
-        Event event = {.eventType = NETWORK_EVENT, .subEventType = NE_ADD_POLL_FD, .dataItem = (DataItem) {.itemInt = fd}, .dataType = INT_TYPE};
+        Event event = {.eventType = NETWORK_EVENT, .subEventType = NE_ADD_POLL_FD, .fd = fd};
 
         push_event_to_queue(eventManager, &event);   
     }
@@ -304,10 +361,14 @@ STATIC void unset_client_data(TCPServer *tcpServer, int fdIdx) {
         FAILED(ARG_ERROR, NULL);
     }
 
+    set_server_client_nickname(tcpServer, tcpServer->clients[fdIdx], "");
+    set_client_user(tcpServer->clients[fdIdx], NULL);
     set_client_fd(tcpServer->clients[fdIdx], UNASSIGNED);
     set_client_identifier(tcpServer->clients[fdIdx], "");
     set_client_identifier_type(tcpServer->clients[fdIdx], UNKNOWN_HOST_IDENTIFIER);
     set_client_port(tcpServer->clients[fdIdx], UNASSIGNED);
+    set_client_inbuffer(tcpServer->clients[fdIdx], "");
+    reset_client_output(tcpServer->clients[fdIdx]);
 
 }
 
@@ -317,15 +378,18 @@ void remove_client(TCPServer *tcpServer, EventManager *eventManager, int fd) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (!is_server_empty(tcpServer)) {
+    int fdIdx = get_fd_client_idx(tcpServer->fdTable, fd);
 
-        int fdIdx = find_fd_idx_in_hash_table(tcpServer->fdsIdxMap, fd);
-        remove_fd_idx_from_hash_table(tcpServer->fdsIdxMap, fd);
+    /* the slot of an unknown fd mustn't be freed */
+    if (fdIdx != UNASSIGNED) {
+
+        set_fd_client_idx(tcpServer->fdTable, fd, UNASSIGNED);
 
         unset_client_data(tcpServer, fdIdx);
+        free_client_slot(tcpServer, fdIdx);
 
         if (eventManager != NULL) {
-            Event event = {.eventType = NETWORK_EVENT, .subEventType = NE_REMOVE_POLL_FD, .dataItem = (DataItem) {.itemInt = fd}, .dataType = INT_TYPE};
+            Event event = {.eventType = NETWORK_EVENT, .subEventType = NE_REMOVE_POLL_FD, .fd = fd};
 
             push_event_to_queue(eventManager, &event);
         }        
@@ -347,25 +411,29 @@ Client * find_client(TCPServer *tcpServer, const char *nickname) {
     Client *client = NULL;
 
     if (nickname != NULL) {
+        client = find_nickname_holder(tcpServer->session, nickname);
+    }
+    return client;
+}
 
-        if (get_int_option_value(OT_THREADS)) {
-            pthread_rwlock_rdlock(&tcpServer->fdLock);
-        }
-        for (int i = 0; i < tcpServer->capacity; i++) {
+void set_server_client_nickname(TCPServer *tcpServer, Client *client, const char *nickname) {
 
-            if (get_client_fd(tcpServer->clients[i]) != UNASSIGNED) {
+    if (tcpServer == NULL || client == NULL || nickname == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
 
-                if (strcmp(get_client_nickname(tcpServer->clients[i]), nickname) == 0) {
-                    client = tcpServer->clients[i];
-                    break;
-                }
-            }
-        }
-        if (get_int_option_value(OT_THREADS)) {
-            pthread_rwlock_unlock(&tcpServer->fdLock);
-        }
+    /* the reservation is keyed by the client's 
+        nickname, so it's released before the nickname 
+        changes */
+    if (*get_client_nickname(client)) {
+        release_nickname(tcpServer->session, get_client_nickname(client), client);
+    }
+
+    set_client_nickname(client, nickname);
+
+    if (*nickname) {
+        reserve_nickname(tcpServer->session, get_client_nickname(client), client);
     }
-    return client;
 }
 
 int get_server_capacity(TCPServer *tcpServer) {
@@ -392,6 +460,93 @@ Session * get_session(TCPServer *tcpServer) {
     return tcpServer->session;
 }
 
+void set_server_session(TCPServer *tcpServer, Session *session) {
+
+    if (tcpServer == NULL || session == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    if (!tcpServer->sharedSession) {
+        delete_session(tcpServer->session);
+    }
+
+    tcpServer->session = session;
+    tcpServer->sharedSession = 1;
+}
+
+void set_server_forward_func(TCPServer *tcpServer, ForwardMessageFunc forwardFunc) {
+
+    if (tcpServer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+    tcpServer->forwardFunc = forwardFunc;
+}
+
+void set_server_resolver(TCPServer *tcpServer, Resolver *resolver, int wakeupFd) {
+
+    if (tcpServer == NULL || resolver == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    delete_lookup_queue(tcpServer->lookupQueue);
+
+    tcpServer->resolver = resolver;
+    tcpServer->lookupQueue = create_lookup_queue(wakeupFd);
+}
+
+Resolver * get_server_resolver(TCPServer *tcpServer) {
+
+    if (tcpServer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+    return tcpServer->resolver;
+}
+
+void update_client_hostnames(TCPServer *tcpServer) {
+
+    if (tcpServer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    if (tcpServer->lookupQueue == NULL) {
+        return;
+    }
+
+    HostLookup lookups[LOOKUP_BATCH_SIZE];
+    int count = 0;
+
+    while ((count = get_completed_lookups(tcpServer->lookupQueue, lookups, ARRAY_SIZE(lookups))) > 0) {
+
+        for (int i = 0; i < count; i++) {
+
+            int fdIdx = get_fd_client_idx(tcpServer->fdTable, lookups[i].fd);
+
+            if (fdIdx == UNASSIGNED) {
+                continue;
+            }
+
+            Client *client = tcpServer->clients[fdIdx];
+
+            /* the fd may have been reused by a client 
+                from a different address */
+            if (get_client_identifier_type(client) != IP_ADDRESS || strcmp(get_client_identifier(client), lookups[i].ipAddress) != 0) {
+                continue;
+            }
+
+            set_client_identifier(client, lookups[i].hostname);
+            set_client_identifier_type(client, HOSTNAME);
+
+            User *user = get_client_user(client);
+
+            if (user != NULL) {
+                set_user_hostname(user, lookups[i].hostname);
+            }
+
+            LOG(DEBUG, "Resolved %s to %s (fd: %d)", lookups[i].ipAddress, lookups[i].hostname, lookups[i].fd);
+        }
+    }
+}
+
 Queue * get_server_out_queue(TCPServer *tcpServer) {
 
     if (tcpServer == NULL) {
@@ -400,28 +555,45 @@ Queue * get_server_out_queue(TCPServer *tcpServer) {
     return tcpServer->outQueue;
 }
 
-HashTable * get_server_fds_idx_map(TCPServer *tcpServer) {
-    
+Arena * get_message_arena(TCPServer *tcpServer) {
+
     if (tcpServer == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
-    return tcpServer->fdsIdxMap;
+    return tcpServer->messageArena;
 }
 
-void create_server_info(char *buffer, int size, void *arg) {
+void set_server_fd_table(TCPServer *tcpServer, FdTable *fdTable) {
 
-    if (buffer == NULL) {
+    if (tcpServer == NULL || fdTable == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    const char *servername = get_char_option_value(OT_SERVER_NAME);
-    
-    if (servername != NULL) {
-        safe_copy(buffer, size, servername);
+    if (!tcpServer->sharedFdTable) {
+        delete_fd_table(tcpServer->fdTable);
+    }
+
+    tcpServer->fdTable = fdTable;
+    tcpServer->sharedFdTable = 1;
+}
+
+int get_client_fd_idx(TCPServer *tcpServer, int fd) {
+
+    if (tcpServer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+    return get_fd_client_idx(tcpServer->fdTable, fd);
+}
+
+const char * get_server_prefix(TCPServer *tcpServer) {
+
+    if (tcpServer == NULL) {
+        FAILED(ARG_ERROR, NULL);
     }
+    return tcpServer->serverPrefix;
 }
 
-void add_message_to_queue(TCPServer *tcpServer, Client *client, const char *content) {
+void add_message_to_queue(TCPServer *tcpServer, Client *client, const char *content, int len) {
 
     if (tcpServer == NULL || client == NULL || content == NULL) {
         FAILED(ARG_ERROR, NULL);
@@ -440,12 +612,11 @@ void add_message_to_queue(TCPServer *tcpServer, Client *client, const char *cont
     }
     else {
 
-        const char *nickname = get_client_nickname(client);
-        User *user = find_user_in_hash_table(get_session(tcpServer), nickname);
+        User *user = get_client_user(client);
 
         if (user != NULL) {
 
-            enqueue_to_user_queue(user, (char*) content);
+            enqueue_to_user_queue(user, content, len);
             add_user_to_ready_list(user, get_ready_list(get_session(tcpServer)));
         }
     }
@@ -457,14 +628,7 @@ void enqueue_to_server_queue(TCPServer *tcpServer, void *message) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&tcpServer->queueLock);
-    }
     enqueue(tcpServer->outQueue, message);
-
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&tcpServer->queueLock);
-    }
 }
 
 void * dequeue_from_server_queue(TCPServer *tcpServer) {
@@ -475,25 +639,17 @@ void * dequeue_from_server_queue(TCPServer *tcpServer) {
 
     void *message = NULL;
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&tcpServer->queueLock);
-    }
-
     message = dequeue(tcpServer->outQueue);
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&tcpServer->queueLock);
-    }
-
     return message;
 }
 
 void add_irc_message_to_queue(TCPServer *tcpServer, Client *client, IRCMessage *tokens) {
 
-    char message[MAX_CHARS - CRLF_LEN + 1] = {'\0'};
+    int len = 0;
+    const char *message = create_irc_line(tcpServer->messageArena, MAX_CHARS - CRLF_LEN, tokens, &len);
 
-    create_irc_message(message, MAX_CHARS - CRLF_LEN, tokens);
-    add_message_to_queue(tcpServer, client, message);
+    add_message_to_queue(tcpServer, client, message, len);
 }
 
 void send_message_to_user(void *user, void *arg) {
@@ -505,10 +661,10 @@ void send_message_to_user(void *user, void *arg) {
     struct {
         TCPServer *tcpServer;
         EventManager *eventManager;
-        const char *message;
+        SharedBuffer *buffer;
     } *data = arg;
 
-    server_write(data->tcpServer, data->eventManager, get_user_fd((User*)user), data->message);
+    server_write_buffer(data->tcpServer, data->eventManager, get_user_fd((User*)user), data->buffer);
 }
 
 void send_user_queue_messages(void *user, void *arg) {
@@ -520,12 +676,29 @@ void send_user_queue_messages(void *user, void *arg) {
     struct {
         TCPServer *tcpServer;
         EventManager *eventManager;
-        const char *message;
+        SharedBuffer *buffer;
     } *data = arg;
 
-    while ((data->message = dequeue_from_user_queue((User*)user)) != NULL) {
+    /* a user which refused a message under the 
+        disconnect policy is disconnected like a 
+        client over its send queue limit. its queued 
+        messages are discarded, since they reference 
+        the message arena */
+    if (is_user_queue_overflowed((User*)user)) {
+
+        while (dequeue_from_user_queue((User*)user, NULL) != NULL);
 
-        server_write(data->tcpServer, data->eventManager, get_user_fd((User*)user), data->message);
+        trigger_event_client_disconnect(data->eventManager, get_user_fd((User*)user));
+        LOG(WARNING, "User queue limit exceeded (fd: %d)", get_user_fd((User*)user));
+        return;
+    }
+
+    const char *message = NULL;
+    int len = 0;
+
+    while ((message = dequeue_from_user_queue((User*)user, &len)) != NULL) {
+
+        server_write(data->tcpServer, data->eventManager, get_user_fd((User*)user), message, len);
     }
 }
 
@@ -538,27 +711,34 @@ void send_channel_queue_messages(void *channel, void *arg) {
     struct {
         TCPServer *tcpServer;
         EventManager *eventManager;
-        const char *message;
+        SharedBuffer *buffer;
     } *data = arg;
 
-    while ((data->message = dequeue_from_channel_queue((Channel*)channel)) != NULL) {
+    const char *message = NULL;
+    int len = 0;
+
+    while ((message = dequeue_from_channel_queue((Channel*)channel, &len)) != NULL) {
 
         Session *session = get_session(data->tcpServer);
 
-        iterate_list(get_users_from_channel_users(find_channel_users(session, channel)), send_message_to_user, data);
+        /* the message is terminated and copied once and
+            all channel members reference the same buffer */
+        data->buffer = create_message_buffer(message, len);
+
+        iterate_channel_users(find_channel_users(session, channel), send_message_to_user, data);
+
+        release_shared_buffer(data->buffer);
+        data->buffer = NULL;
     }
 }
 
-int server_read(TCPServer *tcpServer, EventManager *eventManager, int fd) {
+ssize_t server_recv(TCPServer *tcpServer, EventManager *eventManager, int fd, char *buffer, int size) {
     
-    if (tcpServer == NULL) {
+    if (tcpServer == NULL || buffer == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    char readBuffer[MAX_CHARS + 1] = {'\0'};
-    int readStatus = 0;
-
-    ssize_t bytesRead = read_string(fd, readBuffer, ARRAY_SIZE(readBuffer));
+    ssize_t bytesRead = read_string(fd, buffer, size);
 
     if (bytesRead <= 0) {
 
@@ -566,14 +746,35 @@ int server_read(TCPServer *tcpServer, EventManager *eventManager, int fd) {
 
             trigger_event_client_disconnect(eventManager, fd);
             LOG(INFO, "Client terminated (fd: %d)", fd);
-            readStatus = -1;
+            bytesRead = -1;
         }
-        else if (bytesRead < 0 && errno != EINTR) {
+        else if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+            bytesRead = 0;
+        }
+        else {
             trigger_event_client_disconnect(eventManager, fd);
             LOG(ERROR, "Error reading from socket (fd: %d)", fd); 
         }
     }
-    else {
+
+    return bytesRead;
+}
+
+int server_read(TCPServer *tcpServer, EventManager *eventManager, int fd) {
+    
+    if (tcpServer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    char readBuffer[MAX_CHARS + 1] = {'\0'};
+    int readStatus = 0;
+
+    ssize_t bytesRead = server_recv(tcpServer, eventManager, fd, readBuffer, ARRAY_SIZE(readBuffer));
+
+    if (bytesRead < 0) {
+        readStatus = -1;
+    }
+    else if (bytesRead > 0) {
 
         /* the server may receive a partial message 
             from the client due to the nature of the
@@ -581,24 +782,24 @@ int server_read(TCPServer *tcpServer, EventManager *eventManager, int fd) {
             data is stored in the client's buffer, and
             only after the message is received (indicated
             by CRLF), will it be parsed */
+        buffer_client_data(tcpServer, fd, readBuffer, bytesRead);
 
-        int fdIdx = find_fd_idx_in_hash_table(tcpServer->fdsIdxMap, fd);
+        int fdIdx = get_fd_client_idx(tcpServer->fdTable, fd);
 
         char *inBuffer = get_client_inbuffer(tcpServer->clients[fdIdx]);
         int currentLen = strlen(inBuffer);
-        int totalLen = currentLen + strlen(readBuffer);
-
-        int copyBytes = totalLen >= MAX_CHARS + 1 ? MAX_CHARS - currentLen: strlen(readBuffer);
-        safe_copy(inBuffer + currentLen, copyBytes + 1, readBuffer);
-        currentLen += copyBytes;
 
         /* IRC messages are terminated with CRLF sequence ("\r\n") */
         if (find_delimiter(inBuffer, CRLF) != NULL) {
 
-            char escapedMsg[MAX_CHARS + sizeof(CRLF) + 1] = {'\0'};
-            escape_crlf_sequence(escapedMsg, ARRAY_SIZE(escapedMsg), inBuffer);
-            
-            LOG(DEBUG, "Received message(s) \"%s\" from client (fd: %d)", escapedMsg, fd);
+            /* the message is only escaped if it's logged */
+            if (is_log_level_enabled(DEBUG)) {
+
+                char escapedMsg[MAX_CHARS + sizeof(CRLF) + 1] = {'\0'};
+                escape_crlf_sequence(escapedMsg, ARRAY_SIZE(escapedMsg), inBuffer);
+
+                LOG(DEBUG, "Received message(s) \"%s\" from client (fd: %d)", escapedMsg, fd);
+            }
             readStatus = 1;
         }
 
@@ -610,56 +811,193 @@ int server_read(TCPServer *tcpServer, EventManager *eventManager, int fd) {
     return readStatus;
 }
 
-int server_write(TCPServer *tcpServer, EventManager *eventManager, int fd, const char *message) {
+int buffer_client_data(TCPServer *tcpServer, int fd, const char *data, int len) {
+
+    if (tcpServer == NULL || data == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int fdIdx = get_fd_client_idx(tcpServer->fdTable, fd);
+
+    /* data for unknown fd's is discarded */
+    if (fdIdx == UNASSIGNED) {
+        return len;
+    }
+
+    char *inBuffer = get_client_inbuffer(tcpServer->clients[fdIdx]);
+    int currentLen = strlen(inBuffer);
+
+    /* complete messages are extracted as soon as 
+        they are buffered, so a full buffer holds a 
+        message which is too long and is discarded */
+    if (currentLen == MAX_CHARS) {
+        memset(inBuffer, '\0', MAX_CHARS + 1);
+        currentLen = 0;
+    }
+
+    int copyBytes = len < MAX_CHARS - currentLen ? len : MAX_CHARS - currentLen;
+
+    memcpy(inBuffer + currentLen, data, copyBytes);
+    inBuffer[currentLen + copyBytes] = '\0';
+
+    return copyBytes;
+}
+
+int server_write(TCPServer *tcpServer, EventManager *eventManager, int fd, const char *message, int len) {
 
     if (tcpServer == NULL || message == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    char fmtMessage[MAX_CHARS + 1] = {'\0'};
+    SharedBuffer *buffer = create_message_buffer(message, len);
+
+    int writeStatus = server_write_buffer(tcpServer, eventManager, fd, buffer);
+
+    release_shared_buffer(buffer);
+
+    return writeStatus;
+}
+
+int server_write_buffer(TCPServer *tcpServer, EventManager *eventManager, int fd, SharedBuffer *buffer) {
+
+    if (tcpServer == NULL || buffer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
     int writeStatus = 0;
+    int fdIdx = get_fd_client_idx(tcpServer->fdTable, fd);
+
+    if (fdIdx == UNASSIGNED) {
+
+        if (tcpServer->forwardFunc != NULL) {
+            writeStatus = tcpServer->forwardFunc(fd, buffer);
+        }
+        return writeStatus;
+    }
+
+    /* messages are referenced by the client's output
+        and sent when the socket is writable, so that a 
+        slow client can't block the server. a client 
+        which doesn't read its messages is disconnected 
+        when its output exceeds the send queue limit */
+    Client *client = tcpServer->clients[fdIdx];
+    int sendqLimit = get_int_option_value(OT_SENDQ_LIMIT);
+
+    if (sendqLimit > 0 && get_client_output_len(client) + get_shared_buffer_len(buffer) > sendqLimit) {
+
+        reset_client_output(client);
+
+        trigger_event_client_disconnect(eventManager, fd);
+        LOG(WARNING, "Send queue limit exceeded (fd: %d)", fd);
+    }
+    else {
+
+        add_client_output(client, buffer);
+        add_pending_write(tcpServer, client);
+        writeStatus = 1;
+    }
+
+    return writeStatus;
+}
+
+STATIC SharedBuffer * create_message_buffer(const char *message, int len) {
 
     /* according to the IRC standard, all valid messages
         should be terminated with CRLF */
-    if (!is_terminated(message, CRLF)) {
-        terminate_string(fmtMessage, MAX_CHARS + 1, message, CRLF);
-        message = fmtMessage;
+    bool terminated = len >= CRLF_LEN && memcmp(message + len - CRLF_LEN, CRLF, CRLF_LEN) == 0;
+
+    return create_shared_buffer(message, len, terminated ? NULL : CRLF);
+}
+
+int server_flush(TCPServer *tcpServer, EventManager *eventManager, int fd) {
+
+    if (tcpServer == NULL) {
+        FAILED(ARG_ERROR, NULL);
     }
 
-    ssize_t bytesWritten = write_string(fd, message);
+    int fdIdx = get_fd_client_idx(tcpServer->fdTable, fd);
 
-    if (bytesWritten <= 0) {
+    if (fdIdx == UNASSIGNED) {
+        return -1;
+    }
 
-        if (bytesWritten < 0 && errno == EPIPE) {
+    Client *client = tcpServer->clients[fdIdx];
+    int messageCount = get_client_output_count(client);
+    int count = 0;
+    struct iovec *output = NULL;
 
-            if (!get_int_option_value(OT_THREADS)) {
+    /* all pending messages are sent with a single 
+        system call */
+    while ((output = get_client_output(client, &count)) != NULL) {
 
-                trigger_event_client_disconnect(eventManager, fd);
-                LOG(INFO, "Client terminated (fd: %d)", fd);
-            }
-        }
-        else if (bytesWritten < 0 && errno != EINTR) {
+        ssize_t bytesWritten = writev(fd, output, count < IOV_MAX ? count : IOV_MAX);
 
-            if (!get_int_option_value(OT_THREADS)) {
+        if (bytesWritten > 0) {
+            consume_client_output(client, bytesWritten);
+        }
+        else if (bytesWritten < 0 && errno == EINTR) {
+            continue;
+        }
+        else if (bytesWritten < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        else {
 
-                trigger_event_client_disconnect(eventManager, fd);
+            if (bytesWritten < 0 && errno == EPIPE) {
+                LOG(INFO, "Client terminated (fd: %d)", fd);
+            }
+            else {
                 LOG(ERROR, "Error writing to socket (fd: %d)", fd); 
             }
+
+            reset_client_output(client);
+            trigger_event_client_disconnect(eventManager, fd);
+
+            return -1;
         }
-    } 
-    else {
-        char escapedMsg[MAX_CHARS + sizeof(CRLF) + 1] = {'\0'};
-        escape_crlf_sequence(escapedMsg, ARRAY_SIZE(escapedMsg), message);
+    }
 
-        LOG(DEBUG, "Sent message \"%s\" to client (fd: %d)", escapedMsg, fd);
-        writeStatus = 1;
-    }   
-    return writeStatus;
+    LOG(DEBUG, "Sent %d message(s) to client (fd: %d)", messageCount - get_client_output_count(client), fd);
+
+    return get_client_output_len(client);
+}
+
+void add_pending_write(TCPServer *tcpServer, Client *client) {
+
+    if (tcpServer == NULL || client == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    /* each client is added only once. a client may 
+        be disconnected while on the list, so the 
+        caller should check the fd after removal */
+    if (!is_client_write_pending(client) && tcpServer->pendingCount < tcpServer->capacity) {
+
+        set_client_write_pending(client, 1);
+        tcpServer->pendingWrites[tcpServer->pendingCount++] = client;
+    }
+}
+
+Client * pop_pending_write(TCPServer *tcpServer) {
+
+    if (tcpServer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    Client *client = NULL;
+
+    if (tcpServer->pendingCount) {
+
+        client = tcpServer->pendingWrites[--tcpServer->pendingCount];
+        set_client_write_pending(client, 0);
+    }
+
+    return client;
 }
 
 void trigger_event_client_disconnect(EventManager *eventManager, int fd) {
 
-    Event event = {.eventType = NETWORK_EVENT, .subEventType = NE_CLIENT_DISCONNECT, .dataItem = (DataItem) {.itemInt = fd}, .dataType = INT_TYPE};
+    Event event = {.eventType = NETWORK_EVENT, .subEventType = NE_CLIENT_DISCONNECT, .fd = fd};
 
     push_event_to_queue(eventManager, &event);
 }
@@ -3,11 +3,13 @@
 
 #include "client.h"
 #include "session.h"
+#include "resolver.h"
 #include "../../libs/src/event.h"
 #include "../../libs/src/queue.h"
 #include "../../libs/src/threads.h"
-#include "../../libs/src/hash_table.h"
+#include "../../libs/src/fd_table.h"
 #include "../../libs/src/irc_message.h"
+#include "../../libs/src/shared_buffer.h"
 
 #include <stdbool.h>
 #include <arpa/inet.h>
@@ -15,6 +17,10 @@
 
 typedef struct TCPServer TCPServer;
 
+/* forward a message to a client which is handled
+    by another event loop */
+typedef bool (*ForwardMessageFunc)(int fd, SharedBuffer *buffer);
+
 TCPServer * create_server(int capacity);
 void delete_server(TCPServer *tcpServer);
 
@@ -29,15 +35,58 @@ void register_connection(TCPServer *tcpServer, EventManager *eventManager, int f
 void remove_client(TCPServer *tcpServer, EventManager *eventManager,  int fd);
 Client * find_client(TCPServer *tcpServer, const char *nickname);
 
+/* set the client's nickname and update its 
+    reservation in the session, which is shared by 
+    the servers of all event loops. nicknames are 
+    found regardless of their case */
+void set_server_client_nickname(TCPServer *tcpServer, Client *client, const char *nickname);
+
 int get_server_capacity(TCPServer *tcpServer);
 Client * get_client(TCPServer *tcpServer, int fdIdx);
 Session * get_session(TCPServer *tcpServer);
-HashTable * get_server_fds_idx_map(TCPServer *tcpServer);
+
+/* servers of several event loops may share the 
+    session. the shared session isn't deleted with 
+    the server */
+void set_server_session(TCPServer *tcpServer, Session *session);
+
+/* messages to clients which aren't found in the 
+    server are passed to the forward function */
+void set_server_forward_func(TCPServer *tcpServer, ForwardMessageFunc forwardFunc);
+
+/* hostnames of the server's clients are looked up 
+    by the resolver, which may be shared by several 
+    servers. the wakeup fd is written to when a 
+    lookup is completed */
+void set_server_resolver(TCPServer *tcpServer, Resolver *resolver, int wakeupFd);
+Resolver * get_server_resolver(TCPServer *tcpServer);
+
+/* replace IP addresses of clients with hostnames 
+    from completed lookups */
+void update_client_hostnames(TCPServer *tcpServer);
+
+/* an event loop may share the fd table of its poll 
+    manager with the server. the shared table isn't 
+    deleted with the server */
+void set_server_fd_table(TCPServer *tcpServer, FdTable *fdTable);
+
+/* returns the client slot of the fd or UNASSIGNED */
+int get_client_fd_idx(TCPServer *tcpServer, int fd);
+
 Queue * get_server_out_queue(TCPServer *tcpServer);
 
-void create_server_info(char *buffer, int size, void *arg);
+/* messages are formatted in the server's arena and 
+    the user and channel queues reference them. the 
+    arena is reset once per event loop iteration, 
+    after the queues are drained */
+Arena * get_message_arena(TCPServer *tcpServer);
 
-void add_message_to_queue(TCPServer *tcpServer, Client *client, const char *content);
+/* the server's name with the leading ':' */
+const char * get_server_prefix(TCPServer *tcpServer);
+
+/* the message is referenced by the user's queue, 
+    so it should be in the message arena */
+void add_message_to_queue(TCPServer *tcpServer, Client *client, const char *content, int len);
 void enqueue_to_server_queue(TCPServer *tcpServer, void *message);
 void * dequeue_from_server_queue(TCPServer *tcpServer);
 void add_irc_message_to_queue(TCPServer *tcpServer, Client *client, IRCMessage *tokens);
@@ -47,8 +96,30 @@ void send_message_to_user(void *user, void *arg);
 void send_user_queue_messages(void *user, void *arg);
 void send_channel_queue_messages(void *channel, void *arg);
 
+/* read available data from the socket into the
+    buffer. returns the number of bytes read, 0 if
+    no data is available or -1 if the client was
+    disconnected */
+ssize_t server_recv(TCPServer *tcpServer, EventManager *eventManager, int fd, char *buffer, int size);
 int server_read(TCPServer *tcpServer, EventManager *eventManager, int fd);
-int server_write(TCPServer *tcpServer, EventManager *eventManager, int fd, const char *message);
+int server_write(TCPServer *tcpServer, EventManager *eventManager, int fd, const char *message, int len);
+
+/* add a reference to the terminated message to 
+    the client's output, without copying it */
+int server_write_buffer(TCPServer *tcpServer, EventManager *eventManager, int fd, SharedBuffer *buffer);
+
+/* write the client's buffered output. returns the
+    number of bytes which are still pending or -1
+    on error */
+int server_flush(TCPServer *tcpServer, EventManager *eventManager, int fd);
+
+/* store received data in the client's input buffer.
+    returns the number of bytes stored */
+int buffer_client_data(TCPServer *tcpServer, int fd, const char *data, int len);
+
+/* clients with buffered output */
+void add_pending_write(TCPServer *tcpServer, Client *client);
+Client * pop_pending_write(TCPServer *tcpServer);
 
 void trigger_event_client_disconnect(EventManager *eventManager, int fd);
 
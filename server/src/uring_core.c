@@ -0,0 +1,435 @@
+#include "uring_core.h"
+#include "dispatcher.h"
+
+#include "../../libs/src/common.h"
+#include "../../libs/src/poll_manager.h"
+#include "../../libs/src/error_control.h"
+#include "../../libs/src/logger.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+
+#ifdef TEST
+#define STATIC
+#else
+#define STATIC static
+#endif
+
+#define URING_BUF_GROUP 0
+#define URING_BUF_COUNT 1024
+#define URING_BUF_SIZE 2048
+
+/* operation type, connection generation and fd are
+    encoded in the user data of each submission. the
+    generation changes when the connection is closed,
+    so that the completions of stale operations can
+    be detected after the fd is reused */
+#define OP_SHIFT 56
+#define GENERATION_SHIFT 32
+#define GENERATION_MASK 0xFFFFFF
+#define FD_MASK 0xFFFFFFFF
+
+typedef enum {
+    URING_ACCEPT,
+    URING_RECV,
+    URING_SEND,
+    URING_PIPE,
+    URING_CANCEL,
+    URING_OP_TYPE_COUNT
+} UringOpType;
+
+/* data which is being sent must remain unchanged
+    until the send completes, so it is moved from
+    the client's output buffer to the connection's
+    send buffer */
+typedef struct {
+    char *sendBuffer;
+    int sendLen;
+    int sendOffset;
+    int sendCapacity;
+    bool sendInFlight;
+    unsigned generation;
+} UringConnection;
+
+typedef struct {
+    IoUring *ioUring;
+    EventManager *eventManager;
+    StreamPipe *streamPipe;
+    TCPServer *tcpServer;
+    UringConnection *connections;
+    int connectionCount;
+} UringContext;
+
+static UringContext uringContext = {NULL};
+
+STATIC uint64_t encode_user_data(UringOpType opType, unsigned generation, int fd);
+STATIC UringOpType decode_op_type(uint64_t userData);
+STATIC unsigned decode_generation(uint64_t userData);
+STATIC int decode_fd(uint64_t userData);
+
+STATIC void handle_uring_completion(UringCompletion *completion);
+STATIC void handle_accept_completion(UringCompletion *completion);
+STATIC void handle_recv_completion(UringCompletion *completion);
+STATIC void handle_send_completion(UringCompletion *completion);
+STATIC void handle_pipe_completion(UringCompletion *completion);
+
+STATIC void submit_client_send(int fd);
+STATIC void send_pending_writes(void);
+
+STATIC void handle_uring_add_fd_event(Event *event);
+STATIC void handle_uring_remove_fd_event(Event *event);
+
+static void delete_uring_connections(void);
+
+void run_uring_server(IoUring *ioUring, EventManager *eventManager, StreamPipe *streamPipe, TCPServer *tcpServer) {
+
+    if (ioUring == NULL || eventManager == NULL || streamPipe == NULL || tcpServer == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    uringContext.ioUring = ioUring;
+    uringContext.eventManager = eventManager;
+    uringContext.streamPipe = streamPipe;
+    uringContext.tcpServer = tcpServer;
+
+    /* connections are indexed by fd */
+    uringContext.connectionCount = get_server_capacity(tcpServer) + RESERVED_FDS;
+    uringContext.connections = (UringConnection*) calloc(uringContext.connectionCount, sizeof(UringConnection));
+    if (uringContext.connections == NULL) {
+        FAILED(ALLOC_ERROR, NULL);
+    }
+    atexit(delete_uring_connections);
+
+    /* registered fd's are handled with io_uring
+        operations instead of the poll manager */
+    register_network_event_handler(eventManager, NE_ADD_POLL_FD, handle_uring_add_fd_event);
+    register_network_event_handler(eventManager, NE_REMOVE_POLL_FD, handle_uring_remove_fd_event);
+
+    register_uring_buffers(ioUring, URING_BUF_GROUP, URING_BUF_COUNT, URING_BUF_SIZE);
+
+    int listenFd = get_server_listen_fd(tcpServer);
+    int pipeFd = get_pipe_fd(streamPipe, READ_PIPE);
+
+    prep_uring_accept(ioUring, listenFd, encode_user_data(URING_ACCEPT, 0, listenFd));
+    prep_uring_poll(ioUring, pipeFd, POLLIN, encode_user_data(URING_PIPE, 0, pipeFd));
+
+    while (1) {
+
+        /* submit prepared operations and wait for at
+            least one completion, unless there are new
+            events to dispatch */
+        int waitCount = is_event_queue_empty(eventManager) ? 1 : 0;
+
+        if (submit_uring(ioUring, waitCount) < 0) {
+
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                FAILED(NO_ERRCODE, "Error submitting io_uring operations");
+            }
+        }
+
+        UringCompletion completion;
+
+        while (get_uring_completion(ioUring, &completion)) {
+            handle_uring_completion(&completion);
+        }
+
+        dispatch_events(eventManager);
+        send_socket_messages(eventManager, tcpServer);
+        send_pending_writes();
+    }
+}
+
+STATIC uint64_t encode_user_data(UringOpType opType, unsigned generation, int fd) {
+
+    return ((uint64_t) opType << OP_SHIFT) | ((uint64_t) (generation & GENERATION_MASK) << GENERATION_SHIFT) | ((uint64_t) fd & FD_MASK);
+}
+
+STATIC UringOpType decode_op_type(uint64_t userData) {
+
+    return userData >> OP_SHIFT;
+}
+
+STATIC unsigned decode_generation(uint64_t userData) {
+
+    return (userData >> GENERATION_SHIFT) & GENERATION_MASK;
+}
+
+STATIC int decode_fd(uint64_t userData) {
+
+    return userData & FD_MASK;
+}
+
+STATIC void handle_uring_completion(UringCompletion *completion) {
+
+    if (completion == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    switch (decode_op_type(completion->userData)) {
+        case URING_ACCEPT:
+            handle_accept_completion(completion);
+            break;
+        case URING_RECV:
+            handle_recv_completion(completion);
+            break;
+        case URING_SEND:
+            handle_send_completion(completion);
+            break;
+        case URING_PIPE:
+            handle_pipe_completion(completion);
+            break;
+        default:
+            break;
+    }
+}
+
+STATIC void handle_accept_completion(UringCompletion *completion) {
+
+    if (completion == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int fd = completion->result;
+
+    if (fd >= 0) {
+
+        if (is_server_full(uringContext.tcpServer) || fd >= uringContext.connectionCount) {
+
+            LOG(WARNING, "Connection refused, server is full (fd: %d)", fd);
+            close(fd);
+        }
+        else {
+            register_connection(uringContext.tcpServer, uringContext.eventManager, fd);
+        }
+    }
+    else {
+        LOG(ERROR, "Error accepting connection");
+    }
+
+    /* multishot accept is terminated on error */
+    if (!has_uring_more(completion)) {
+
+        int listenFd = decode_fd(completion->userData);
+        prep_uring_accept(uringContext.ioUring, listenFd, encode_user_data(URING_ACCEPT, 0, listenFd));
+    }
+}
+
+STATIC void handle_recv_completion(UringCompletion *completion) {
+
+    if (completion == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int fd = decode_fd(completion->userData);
+    int bufferId = get_uring_buffer_id(completion);
+    UringConnection *connection = &uringContext.connections[fd];
+    bool isStale = decode_generation(completion->userData) != (connection->generation & GENERATION_MASK);
+
+    if (!isStale) {
+
+        if (completion->result > 0) {
+
+            process_received_data(uringContext.eventManager, uringContext.tcpServer, fd, get_uring_buffer(uringContext.ioUring, bufferId), completion->result);
+
+            /* multishot recv is terminated if the kernel
+                runs out of provided buffers */
+            if (!has_uring_more(completion)) {
+                prep_uring_recv(uringContext.ioUring, fd, completion->userData);
+            }
+        }
+        else if (completion->result == 0 || completion->result == -ECONNRESET) {
+
+            trigger_event_client_disconnect(uringContext.eventManager, fd);
+            LOG(INFO, "Client terminated (fd: %d)", fd);
+        }
+        else if (completion->result == -ENOBUFS) {
+            prep_uring_recv(uringContext.ioUring, fd, completion->userData);
+        }
+        else if (completion->result != -ECANCELED) {
+
+            trigger_event_client_disconnect(uringContext.eventManager, fd);
+            LOG(ERROR, "Error reading from socket (fd: %d)", fd);
+        }
+    }
+
+    if (bufferId != UNASSIGNED) {
+        recycle_uring_buffer(uringContext.ioUring, bufferId);
+    }
+}
+
+STATIC void handle_send_completion(UringCompletion *completion) {
+
+    if (completion == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int fd = decode_fd(completion->userData);
+    UringConnection *connection = &uringContext.connections[fd];
+    bool isStale = decode_generation(completion->userData) != (connection->generation & GENERATION_MASK);
+
+    connection->sendInFlight = 0;
+
+    if (isStale || completion->result < 0) {
+
+        if (!isStale && completion->result != -ECANCELED) {
+
+            trigger_event_client_disconnect(uringContext.eventManager, fd);
+            LOG(ERROR, "Error writing to socket (fd: %d)", fd);
+        }
+        connection->sendLen = 0;
+        connection->sendOffset = 0;
+    }
+    else {
+
+        connection->sendOffset += completion->result;
+
+        /* resubmit the remainder of a partial send */
+        if (connection->sendOffset < connection->sendLen) {
+
+            prep_uring_send(uringContext.ioUring, fd, connection->sendBuffer + connection->sendOffset, connection->sendLen - connection->sendOffset, completion->userData);
+            connection->sendInFlight = 1;
+            return;
+        }
+
+        connection->sendLen = 0;
+        connection->sendOffset = 0;
+    }
+
+    /* the fd may now belong to a new connection,
+        whose messages were held back while the
+        previous send was in flight */
+    submit_client_send(fd);
+}
+
+STATIC void handle_pipe_completion(UringCompletion *completion) {
+
+    if (completion == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    if (completion->result > 0) {
+        process_pipe_data(uringContext.eventManager, uringContext.streamPipe);
+    }
+
+    if (!has_uring_more(completion)) {
+
+        int pipeFd = decode_fd(completion->userData);
+        prep_uring_poll(uringContext.ioUring, pipeFd, POLLIN, encode_user_data(URING_PIPE, 0, pipeFd));
+    }
+}
+
+STATIC void submit_client_send(int fd) {
+
+    if (fd < 0 || fd >= uringContext.connectionCount) {
+        return;
+    }
+
+    UringConnection *connection = &uringContext.connections[fd];
+    int fdIdx = get_client_fd_idx(uringContext.tcpServer, fd);
+
+    if (connection->sendInFlight || fdIdx == UNASSIGNED) {
+        return;
+    }
+
+    Client *client = get_client(uringContext.tcpServer, fdIdx);
+    int len = get_client_output_len(client);
+
+    if (!len) {
+        return;
+    }
+
+    if (len > connection->sendCapacity) {
+
+        char *sendBuffer = (char*) realloc(connection->sendBuffer, len);
+        if (sendBuffer == NULL) {
+            FAILED(ALLOC_ERROR, NULL);
+        }
+
+        connection->sendBuffer = sendBuffer;
+        connection->sendCapacity = len;
+    }
+
+    /* the output is copied, since the referenced 
+        messages may be released when the connection
+        is closed, before the send is completed */
+    int count = 0;
+    int offset = 0;
+    struct iovec *output = get_client_output(client, &count);
+
+    for (int i = 0; i < count; i++) {
+
+        memcpy(connection->sendBuffer + offset, output[i].iov_base, output[i].iov_len);
+        offset += output[i].iov_len;
+    }
+    reset_client_output(client);
+
+    connection->sendLen = len;
+    connection->sendOffset = 0;
+    connection->sendInFlight = 1;
+
+    prep_uring_send(uringContext.ioUring, fd, connection->sendBuffer, len, encode_user_data(URING_SEND, connection->generation, fd));
+}
+
+STATIC void send_pending_writes(void) {
+
+    Client *client = NULL;
+
+    while ((client = pop_pending_write(uringContext.tcpServer)) != NULL) {
+
+        if (get_client_fd(client) != UNASSIGNED) {
+            submit_client_send(get_client_fd(client));
+        }
+    }
+}
+
+STATIC void handle_uring_add_fd_event(Event *event) {
+
+    if (event == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int fd = event->fd;
+
+    if (fd >= 0 && fd < uringContext.connectionCount) {
+
+        UringConnection *connection = &uringContext.connections[fd];
+        prep_uring_recv(uringContext.ioUring, fd, encode_user_data(URING_RECV, connection->generation, fd));
+    }
+}
+
+STATIC void handle_uring_remove_fd_event(Event *event) {
+
+    if (event == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    int fd = event->fd;
+
+    if (fd >= 0 && fd < uringContext.connectionCount) {
+
+        /* pending operations must be canceled before
+            the fd is closed, since they hold a reference
+            to the socket */
+        uringContext.connections[fd].generation++;
+
+        prep_uring_cancel_fd(uringContext.ioUring, fd, encode_user_data(URING_CANCEL, 0, fd));
+        submit_uring(uringContext.ioUring, 0);
+    }
+
+    close(fd);
+}
+
+static void delete_uring_connections(void) {
+
+    if (uringContext.connections != NULL) {
+
+        for (int i = 0; i < uringContext.connectionCount; i++) {
+            free(uringContext.connections[i].sendBuffer);
+        }
+        free(uringContext.connections);
+        uringContext.connections = NULL;
+    }
+}
@@ -0,0 +1,15 @@
+#ifndef URING_CORE_H
+#define URING_CORE_H
+
+#include "tcp_server.h"
+#include "../../libs/src/event.h"
+#include "../../libs/src/io_utils.h"
+#include "../../libs/src/uring.h"
+
+/* run the server's event loop on io_uring. new
+    connections are accepted and data is received
+    with multishot operations, while the messages
+    are sent in a batch at the end of each iteration */
+void run_uring_server(IoUring *ioUring, EventManager *eventManager, StreamPipe *streamPipe, TCPServer *tcpServer);
+
+#endif
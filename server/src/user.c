@@ -10,13 +10,19 @@
 #include "config.h"
 #include "../../libs/src/settings.h"
 #include "../../libs/src/common.h"
+#include "../../libs/src/enum_utils.h"
+#include "../../libs/src/irc_message.h"
 #include "../../libs/src/error_control.h"
+#include "../../libs/src/slab.h"
 #include "../../libs/src/logger.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #define MSG_QUEUE_LEN 20
+#define MSG_QUEUE_SIZE 4
+#define QUEUE_RECORD_SIZE (RING_HEADER_SIZE + (int) sizeof(IRCLine))
 #define MAX_CHANNELS 20
 
 #ifndef TEST
@@ -27,28 +33,50 @@ struct User {
     char username[MAX_CHARS + 1];
     char hostname[MAX_CHARS + 1];
     char realname[MAX_CHARS + 1];
-    Queue *outQueue;
-    pthread_rwlock_t userLock;
+    /* ":nick!user@host" which is built on first use 
+        after the nickname or the hostname changed */
+    char prefix[MAX_PREFIX + 1];
+    bool prefixValid;
+    RingBuffer *outQueue;
+    QueuePolicy queuePolicy;
+    /* a message was refused under the disconnect 
+        policy */
+    bool queueOverflowed;
+    /* links the user into the ready list */
+    ListLink readyLink;
+    /* the last fan-out which reached the user */
+    unsigned long peerEpoch;
 };
 
 #endif
 
+/* users are created and deleted while holding the 
+    session lock, so the slab isn't locked */
+static SlabAllocator *userSlab = NULL;
+
 User * create_user(int fd, const char *nickname, const char *username, const char *hostname, const char *realname) {
 
-    User *user = (User*) malloc(sizeof(User));
-    if (user == NULL) {
-        FAILED(ALLOC_ERROR, NULL);
+    if (userSlab == NULL) {
+        userSlab = create_slab_allocator(sizeof(User));
     }
 
+    User *user = (User*) allocate_from_slab(userSlab);
+
     user->fd = fd;
 
     safe_copy(user->nickname, ARRAY_SIZE(user->nickname), nickname);
     safe_copy(user->username, ARRAY_SIZE(user->username), username);
     safe_copy(user->hostname, ARRAY_SIZE(user->hostname), hostname);
     safe_copy(user->realname, ARRAY_SIZE(user->realname), realname);
+    user->prefixValid = 0;
 
-    user->outQueue = create_queue(MSG_QUEUE_LEN, MAX_CHARS + 1);
-    pthread_rwlock_init(&user->userLock, NULL);
+    /* the queue holds references to MSG_QUEUE_LEN 
+        messages in the message arena */
+    user->outQueue = create_ring_buffer(MSG_QUEUE_SIZE * QUEUE_RECORD_SIZE, MSG_QUEUE_LEN * QUEUE_RECORD_SIZE);
+    user->queuePolicy = QP_DROP_OLDEST;
+    user->queueOverflowed = 0;
+    init_list_link(&user->readyLink, user);
+    user->peerEpoch = 0;
 
     return user;
 }
@@ -56,55 +84,53 @@ User * create_user(int fd, const char *nickname, const char *username, const cha
 void delete_user(void *user) {
 
     if (user != NULL) {
-        delete_queue(((User*)user)->outQueue);
-        pthread_rwlock_destroy(&((User*)user)->userLock);
-    }
 
-    free(user);
-}
-
-User * copy_user(User *user) {
+        RingBuffer *queue = ((User*)user)->outQueue;
 
-    if (user == NULL) {
-        FAILED(ARG_ERROR, NULL);
+        /* the counters are logged, so that the queue 
+            capacity can be tuned */
+        if (get_ring_dropped_count(queue)) {
+            LOG(WARNING, "User \"%s\" queue dropped %d message(s), high-water mark: %d message(s)", ((User*)user)->nickname, get_ring_dropped_count(queue), get_ring_high_water_mark(queue) / QUEUE_RECORD_SIZE);
+        }
+        else {
+            LOG(DEBUG, "User \"%s\" queue high-water mark: %d message(s)", ((User*)user)->nickname, get_ring_high_water_mark(queue) / QUEUE_RECORD_SIZE);
+        }
+        delete_ring_buffer(queue);
     }
 
-    return create_user(user->fd, user->nickname, user->username, user->hostname, user->realname);
+    release_to_slab(user);
 }
 
-void enqueue_to_user_queue(User *user, void *message) {
+int enqueue_to_user_queue(User *user, const char *message, int len) {
 
     if (user == NULL || message == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&user->userLock);
-    }
-    enqueue(user->outQueue, message);
+    IRCLine line = {message, len};
+
+    int queued = write_ring_record(user->outQueue, &line, sizeof(IRCLine));
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&user->userLock);
+    if (!queued && user->queuePolicy == QP_DISCONNECT) {
+        user->queueOverflowed = 1;
     }
+
+    return queued;
 }
 
-void * dequeue_from_user_queue(User *user) {
+const char * dequeue_from_user_queue(User *user, int *len) {
 
     if (user == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_wrlock(&user->userLock);
-    }
+    IRCLine *line = read_ring_record(user->outQueue, NULL);
 
-    void *message = dequeue(((User *)user)->outQueue);
-    
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&user->userLock);
+    if (line != NULL && len != NULL) {
+        *len = line->len;
     }
 
-    return message; 
+    return line != NULL ? line->data : NULL; 
 }
 
 bool are_users_equal(void *user1, void *user2) {
@@ -152,23 +178,24 @@ void add_nickname_to_list(void *user, void *arg) {
     }
 }
 
-void create_user_info(char *buffer, int size, void *arg) {
+const char * get_user_prefix(User *user) {
 
-    if (buffer == NULL || arg == NULL) {
+    if (user == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    User *user = arg;
-
-    const char *tokens[] = {user->nickname, "!", user->username, "@", user->hostname};  
-    int userInfoLength = 0;
+    /* the prefix which doesn't fit is left out */
+    if (!user->prefixValid) {
 
-    iterate_string_list(tokens, ARRAY_SIZE(tokens), add_string_length, &userInfoLength);
+        int len = snprintf(user->prefix, ARRAY_SIZE(user->prefix), ":%s!%s@%s", user->nickname, user->username, user->hostname);
 
-    if (userInfoLength < size) {
-        concat_tokens(buffer, size, tokens, ARRAY_SIZE(tokens), "");
+        if (len < 0 || len >= (int) ARRAY_SIZE(user->prefix)) {
+            user->prefix[0] = '\0';
+        }
+        user->prefixValid = 1;
     }
 
+    return user->prefix;
 }
 
 int get_user_fd(User *user) {
@@ -199,6 +226,7 @@ void set_user_nickname(User *user, const char *nickname) {
     if (is_valid_user_name(nickname)) {
 
         safe_copy(user->nickname, ARRAY_SIZE(user->nickname),nickname);
+        user->prefixValid = 0;
     }
 }
 
@@ -220,6 +248,16 @@ const char * get_user_hostname(User *user) {
     return user->hostname;
 }
 
+void set_user_hostname(User *user, const char *hostname) {
+
+    if (user == NULL || hostname == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    safe_copy(user->hostname, ARRAY_SIZE(user->hostname), hostname);
+    user->prefixValid = 0;
+}
+
 const char * get_user_realname(User *user) {
 
     if (user == NULL) {
@@ -229,20 +267,74 @@ const char * get_user_realname(User *user) {
     return user->realname;
 }
 
-Queue * get_user_queue(User *user) {
+RingBuffer * get_user_queue(User *user) {
 
     if (user == NULL) {
         FAILED(ARG_ERROR, NULL);
     }
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_rdlock(&user->userLock);
+    RingBuffer *queue = user->outQueue;
+
+    return queue;
+}
+
+QueuePolicy get_user_queue_policy(User *user) {
+
+    if (user == NULL) {
+        FAILED(ARG_ERROR, NULL);
     }
-    Queue *queue = user->outQueue;
 
-    if (get_int_option_value(OT_THREADS)) {
-        pthread_rwlock_unlock(&user->userLock);
+    return user->queuePolicy;
+}
+
+/* only the oldest messages are overwritten, the 
+    other policies refuse the new message */
+void set_user_queue_policy(User *user, QueuePolicy queuePolicy) {
+
+    if (user == NULL || !is_valid_enum_type(queuePolicy, UNKNOWN_QUEUE_POLICY)) {
+        FAILED(ARG_ERROR, NULL);
     }
 
-    return queue;
+    user->queuePolicy = queuePolicy;
+    set_ring_buffer_overwrite(user->outQueue, queuePolicy == QP_DROP_OLDEST);
+}
+
+bool is_user_queue_overflowed(User *user) {
+
+    if (user == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return user->queueOverflowed;
+}
+
+/* returns 0 if the user was already stamped 
+    with the epoch */
+bool stamp_user_epoch(User *user, unsigned long epoch) {
+
+    if (user == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    if (user->peerEpoch == epoch) {
+        return 0;
+    }
+
+    user->peerEpoch = epoch;
+
+    return 1;
+}
+
+ListLink * get_user_ready_link(User *user) {
+
+    if (user == NULL) {
+        FAILED(ARG_ERROR, NULL);
+    }
+
+    return &user->readyLink;
+}
+
+SlabAllocator * get_user_slab(void) {
+
+    return userSlab;
 }
\ No newline at end of file
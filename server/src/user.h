@@ -1,7 +1,10 @@
 #ifndef USER_H
 #define USER_H
 
-#include "../../libs/src/queue.h"
+#include "config.h"
+#include "../../libs/src/ring_buffer.h"
+#include "../../libs/src/linked_list.h"
+#include "../../libs/src/slab.h"
 
 #include <stdbool.h>
 #include <pthread.h>
@@ -13,23 +16,37 @@ typedef struct User User;
 User * create_user(int fd, const char *nickname, const char *username, const char *hostname, const char *realname);
 void delete_user(void *user);
 
-User * copy_user(User *user);
-
-void enqueue_to_user_queue(User *user, void *message);
-void * dequeue_from_user_queue(User *user);
+/* the queue references the message, which should 
+    remain valid until it's dequeued. returns 0 if 
+    the message was refused */
+int enqueue_to_user_queue(User *user, const char *message, int len);
+const char * dequeue_from_user_queue(User *user, int *len);
 
 bool are_users_equal(void *user1, void *user2);
 bool is_valid_user_name(const char *string);
 
 void add_nickname_to_list(void *user, void *namesList);
-void create_user_info(char *buffer, int size, void *arg);
+/* ":nick!user@host" is cached until the nickname 
+    or the hostname changes */
+const char * get_user_prefix(User *user);
 
 int get_user_fd(User *user);
 const char * get_user_nickname(User *user);
 void set_user_nickname(User *user, const char *nickname);
 const char * get_user_username(User *user);
 const char * get_user_hostname(User *user);
+void set_user_hostname(User *user, const char *hostname);
 const char * get_user_realname(User *user);
-Queue * get_user_queue(User *user);
+RingBuffer * get_user_queue(User *user);
+QueuePolicy get_user_queue_policy(User *user);
+void set_user_queue_policy(User *user, QueuePolicy queuePolicy);
+/* a user whose queue refused a message under the 
+    disconnect policy should be disconnected */
+bool is_user_queue_overflowed(User *user);
+bool stamp_user_epoch(User *user, unsigned long epoch);
+ListLink * get_user_ready_link(User *user);
+
+/* users are allocated from a shared slab */
+SlabAllocator * get_user_slab(void);
 
 #endif
@@ -1,7 +1,12 @@
 #include "../src/priv_channel.h"
-#include "../../libs/src/priv_queue.h"
+#include "../../libs/src/priv_ring_buffer.h"
+#include "../../libs/src/irc_message.h"
 
 #include <check.h>
+#include <string.h>
+
+#define CHANNEL_CAPACITY 2
+#define MESSAGE_COUNT 5
 
 START_TEST(test_create_channel) {
 
@@ -19,10 +24,10 @@ START_TEST(test_enqueue_dequeue_channel) {
 
     Channel *channel = create_channel("#general", NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
 
-    enqueue_to_channel_queue(channel, "message");
+    enqueue_to_channel_queue(channel, "message", strlen("message"));
     ck_assert_int_eq(channel->outQueue->count, 1);
 
-    const char *content = dequeue_from_channel_queue(channel);
+    const char *content = dequeue_from_channel_queue(channel, NULL);
     ck_assert_int_eq(channel->outQueue->count, 0);
 
     ck_assert_str_eq(content, "message");
@@ -31,6 +36,32 @@ START_TEST(test_enqueue_dequeue_channel) {
 }
 END_TEST
 
+START_TEST(test_channel_queue_policy) {
+
+    Channel *channel = create_channel("#general", NULL, TEMPORARY, CHANNEL_CAPACITY);
+
+    /* the queue references the messages */
+    const char *messages = "ABCDEFGHIJ";
+
+    /* the oldest messages are dropped by default */
+    for (int i = 0; i < MESSAGE_COUNT; i++) {
+        ck_assert_int_eq(enqueue_to_channel_queue(channel, messages + i, 1), 1);
+    }
+
+    ck_assert_int_eq(get_ring_dropped_count(channel->outQueue), MESSAGE_COUNT - CHANNEL_CAPACITY);
+    ck_assert_int_eq(dequeue_from_channel_queue(channel, NULL)[0], 'A' + MESSAGE_COUNT - CHANNEL_CAPACITY);
+
+    set_channel_queue_policy(channel, QP_BLOCK);
+    ck_assert_int_eq(get_channel_queue_policy(channel), QP_BLOCK);
+
+    ck_assert_int_eq(enqueue_to_channel_queue(channel, messages, 1), 1);
+    ck_assert_int_eq(enqueue_to_channel_queue(channel, messages, 1), 0);
+    ck_assert_int_eq(get_ring_high_water_mark(channel->outQueue), CHANNEL_CAPACITY * (RING_HEADER_SIZE + sizeof(IRCLine)));
+
+    delete_channel(channel);
+}
+END_TEST
+
 START_TEST(test_are_channels_equal) {
 
     Channel *channel1 = create_channel("#general", NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
@@ -54,7 +85,7 @@ START_TEST(test_get_channel_data) {
     const char *name = get_channel_name(channel);
     ck_assert_str_eq(name, "#general");
 
-    Queue *queue = get_channel_queue(channel);
+    RingBuffer *queue = get_channel_queue(channel);
     ck_assert_ptr_ne(queue, NULL);
 
     delete_channel(channel);
@@ -71,6 +102,7 @@ Suite* channel_suite(void) {
     // Add the test case to the test suite
     tcase_add_test(tc_core, test_create_channel);
     tcase_add_test(tc_core, test_enqueue_dequeue_channel);
+    tcase_add_test(tc_core, test_channel_queue_policy);
     tcase_add_test(tc_core, test_are_channels_equal);
     tcase_add_test(tc_core, test_get_channel_data);
     
@@ -2,6 +2,7 @@
 #include "../../libs/src/string_utils.h"
 
 #include <check.h>
+#include <string.h>
 
 START_TEST(test_create_client) {
 
@@ -46,6 +47,49 @@ START_TEST(test_get_set_client_data) {
 }
 END_TEST
 
+START_TEST(test_client_output) {
+
+    Client *client = create_client();
+
+    int count = 0;
+    ck_assert_ptr_eq(get_client_output(client, &count), NULL);
+
+    SharedBuffer *buffer1 = create_shared_buffer("message1", strlen("message1"), CRLF);
+    SharedBuffer *buffer2 = create_shared_buffer("message2", strlen("message2"), CRLF);
+
+    add_client_output(client, buffer1);
+    add_client_output(client, buffer2);
+
+    ck_assert_int_eq(get_shared_buffer_ref_count(buffer1), 2);
+
+    struct iovec *output = get_client_output(client, &count);
+
+    ck_assert_int_eq(count, 2);
+    ck_assert_ptr_eq(output[0].iov_base, get_shared_buffer_data(buffer1));
+    ck_assert_int_eq(get_client_output_len(client), strlen("message1\r\nmessage2\r\n"));
+
+    consume_client_output(client, strlen("message1\r\nmess"));
+
+    output = get_client_output(client, &count);
+
+    ck_assert_int_eq(count, 1);
+    ck_assert_int_eq(get_shared_buffer_ref_count(buffer1), 1);
+    ck_assert_int_eq(memcmp(output[0].iov_base, "age2\r\n", output[0].iov_len), 0);
+    ck_assert_int_eq(get_client_output_len(client), strlen("age2\r\n"));
+
+    reset_client_output(client);
+
+    ck_assert_int_eq(get_client_output_count(client), 0);
+    ck_assert_int_eq(get_client_output_len(client), 0);
+    ck_assert_int_eq(get_shared_buffer_ref_count(buffer2), 1);
+
+    release_shared_buffer(buffer1);
+    release_shared_buffer(buffer2);
+
+    delete_client(client);
+}
+END_TEST
+
 Suite* client_suite(void) {
     Suite *s;
     TCase *tc_core;
@@ -56,6 +100,7 @@ Suite* client_suite(void) {
     // Add the test case to the test suite
     tcase_add_test(tc_core, test_create_client);
     tcase_add_test(tc_core, test_get_set_client_data);
+    tcase_add_test(tc_core, test_client_output);
     
     suite_add_tcase(s, tc_core);
 
@@ -13,6 +13,7 @@
 #include "../../libs/src/string_utils.h"
 
 #include <check.h>
+#include <string.h>
 
 #define CLIENT_FD 3
 #define CLIENT_FD_IDX 0
@@ -58,10 +59,35 @@ static void execute_command(Client *client, CommandFunc cmdFunction, const char
     delete_command_tokens(cmdTokens);
 }
 
+/* users are bound to the registered clients with 
+    the same nickname, as on registration */
+static void bind_user_to_clients(User *user) {
+
+    for (int i = 0; i < get_server_capacity(server); i++) {
+
+        Client *client = server->clients[i];
+
+        if (get_client_fd(client) != UNASSIGNED && get_client_state_type(client) >= REGISTERED && strcmp(get_client_nickname(client), get_user_nickname(user)) == 0) {
+            set_client_user(client, user);
+        }
+    }
+}
+
+static void unbind_user_from_clients(User *user) {
+
+    for (int i = 0; i < get_server_capacity(server); i++) {
+
+        if (get_client_user(server->clients[i]) == user) {
+            set_client_user(server->clients[i], NULL);
+        }
+    }
+}
+
 static void initialize_user_session(User **user, UserChannels **userChannels, const char *nickname, const char *username, const char *hostname, const char *realname) {
 
     *user = create_user(0, nickname, username, hostname, realname);
     add_user_to_hash_table(server->session, *user);
+    bind_user_to_clients(*user);
 
     *userChannels = create_user_channels(*user);
     add_user_channels(server->session, *userChannels);
@@ -71,7 +97,8 @@ static void cleanup_user_session(TCPServer *tcpServer, User *user, UserChannels
 
     ReadyList *readyList = get_ready_list(get_session(tcpServer));
 
-    remove_user_from_ready_list(get_ready_users(readyList), user);
+    unbind_user_from_clients(user);
+    remove_user_from_ready_list(readyList, user);
     remove_user_channels(get_session(tcpServer), userChannels);
     remove_user_from_hash_table(get_session(tcpServer), user);
 }
@@ -151,9 +178,11 @@ START_TEST(test_cmd_nick) {
     initialize_user_session(&user, &userChannels, "john", NULL, NULL, NULL);
 
     Channel *channel1 = create_channel("#general", NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
-    add_channel_to_user_channels(userChannels, channel1);
+    ChannelUsers *channelUsers1 = create_channel_users(channel1);
+    add_channel_member(userChannels, channelUsers1);
     Channel *channel2 = create_channel("#linux", NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
-    add_channel_to_user_channels(userChannels, channel2); 
+    ChannelUsers *channelUsers2 = create_channel_users(channel2);
+    add_channel_member(userChannels, channelUsers2);
 
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(NICK), "NICK john");
     message = dequeue_from_server_queue(server);
@@ -163,16 +192,59 @@ START_TEST(test_cmd_nick) {
     ck_assert_str_eq(content, ":irc.server.com 433 john :Nickname is already in use");
     
     set_client_state_type(server->clients[CLIENT_FD_IDX], REGISTERED);
+    bind_user_to_clients(user);
+
+    enqueue_to_user_queue(user, "hello", strlen("hello"));
 
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(NICK), "NICK john707");
-    content = dequeue_from_channel_queue(channel1);
+
+    /* the user is renamed in place and keeps its messages. 
+        it gets one copy of the message for both channels */
+    ck_assert_str_eq(dequeue_from_user_queue(user, NULL), "hello");
+    content = dequeue_from_user_queue(user, NULL);
     ck_assert_str_eq(content, ":john!@ NICK john707");
-    ck_assert_int_eq(get_list_count(get_ready_channels(get_ready_list(server->session))), 2);
+    ck_assert_ptr_null(dequeue_from_user_queue(user, NULL));
+    ck_assert_int_eq(get_ready_users_count(get_ready_list(server->session)), 1);
     
     User *newUser = find_user_in_hash_table(server->session, "john707");
-    ck_assert_int_eq(get_total_items(server->session->users), 1);
-    ck_assert_ptr_ne(user, newUser);
+    ck_assert_int_eq(get_flat_table_count(server->session->users), 1);
+    ck_assert_ptr_eq(user, newUser);
+
+    /* users may change the case of their own nickname */
+    execute_command(server->clients[CLIENT_FD_IDX], get_command_function(NICK), "NICK John707");
+    content = dequeue_from_user_queue(user, NULL);
+    ck_assert_str_eq(content, ":john707!@ NICK John707");
+    ck_assert_ptr_eq(find_user_in_hash_table(server->session, "JOHN707"), get_client_user(server->clients[CLIENT_FD_IDX]));
+
+    /* nicknames are reserved regardless of their case 
+        and before the registration is complete */
+    set_client_data(server, CLIENT_FD_IDX + 1, CLIENT_FD + 1, CLIENT_IDENTIFIER, HOSTNAME, 50102);
+    set_client_state_type(server->clients[CLIENT_FD_IDX + 1], CONNECTED);
+    set_client_data(server, CLIENT_FD_IDX + 2, CLIENT_FD + 2, CLIENT_IDENTIFIER, HOSTNAME, 50103);
+    set_client_state_type(server->clients[CLIENT_FD_IDX + 2], CONNECTED);
+
+    execute_command(server->clients[CLIENT_FD_IDX + 1], get_command_function(NICK), "NICK JOHN707");
+    message = dequeue_from_server_queue(server);
+
+    decode_message(buffer, ARRAY_SIZE(buffer), &fd, &content, message);
+    ck_assert_int_eq(fd, CLIENT_FD + 1);
+    ck_assert_str_eq(content, ":irc.server.com 433 JOHN707 :Nickname is already in use");
+
+    execute_command(server->clients[CLIENT_FD_IDX + 1], get_command_function(NICK), "NICK mark");
+    ck_assert_ptr_eq(find_client(server, "mark"), server->clients[CLIENT_FD_IDX + 1]);
 
+    execute_command(server->clients[CLIENT_FD_IDX + 2], get_command_function(NICK), "NICK Mark");
+    message = dequeue_from_server_queue(server);
+
+    decode_message(buffer, ARRAY_SIZE(buffer), &fd, &content, message);
+    ck_assert_int_eq(fd, CLIENT_FD + 2);
+    ck_assert_str_eq(content, ":irc.server.com 433 Mark :Nickname is already in use");
+
+    unset_client_data(server, CLIENT_FD_IDX + 2);
+    unset_client_data(server, CLIENT_FD_IDX + 1);
+
+    delete_channel_users(channelUsers1);
+    delete_channel_users(channelUsers2);
     delete_channel(channel1);
     delete_channel(channel2);
 
@@ -204,7 +276,7 @@ START_TEST(test_cmd_user) {
     initialize_user_session(&user, &userChannels, "john", NULL, NULL, NULL);
 
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(USER), "USER john 127.0.0.1 * :john jones");
-    content = dequeue_from_user_queue(user);
+    content = dequeue_from_user_queue(user, NULL);
     ck_assert_str_eq(content, ":irc.server.com 462 john :Already registered");
     
     set_client_state_type(server->clients[CLIENT_FD_IDX], START_REGISTRATION);
@@ -217,11 +289,28 @@ START_TEST(test_cmd_user) {
     
     cleanup_user_session(server, user, userChannels);
 
+    /* a user which holds the nickname isn't replaced */
+    User *otherUser = create_user(CLIENT_FD + 1, "JOHN", NULL, NULL, NULL);
+    register_user(server->session, otherUser);
+
+    execute_command(server->clients[CLIENT_FD_IDX], get_command_function(USER), "USER john 127.0.0.1 * :john jones");
+    message = dequeue_from_server_queue(server);
+    decode_message(buffer, ARRAY_SIZE(buffer), &fd, &content, message);
+    ck_assert_int_eq(fd, CLIENT_FD);
+    ck_assert_str_eq(content, ":irc.server.com 433 john :Nickname is already in use");
+
+    ck_assert_ptr_null(get_client_user(server->clients[CLIENT_FD_IDX]));
+    ck_assert_int_eq(get_client_state_type(server->clients[CLIENT_FD_IDX]), START_REGISTRATION);
+    ck_assert_ptr_eq(find_user_in_hash_table(server->session, "john"), otherUser);
+
+    unregister_user(server->session, otherUser);
+
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(USER), "USER john 127.0.0.1 * :john jones");
 
     user = find_user_in_hash_table(server->session, "john");
-    content = dequeue_from_user_queue(user);
+    content = dequeue_from_user_queue(user, NULL);
     ck_assert_str_eq(content, ":irc.server.com 001 john :Welcome to the IRC Network");
+    ck_assert_ptr_eq(get_client_user(server->clients[CLIENT_FD_IDX]), user);
 
     ck_assert_int_eq(get_client_state_type(server->clients[CLIENT_FD_IDX]), REGISTERED);
 
@@ -255,11 +344,11 @@ START_TEST(test_cmd_join) {
     initialize_user_session(&user, &userChannels, "john", NULL, NULL, NULL);
 
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(JOIN), "JOIN");
-    content = dequeue_from_user_queue(user);
+    content = dequeue_from_user_queue(user, NULL);
     ck_assert_str_eq(content, ":irc.server.com 461 john JOIN :Not enough parameters");
     
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(JOIN), "JOIN $linux");
-    content = dequeue_from_user_queue(user);
+    content = dequeue_from_user_queue(user, NULL);
     ck_assert_str_eq(content, ":irc.server.com 479 john $linux :Illegal channel name");  
 
     Channel *channel = NULL;
@@ -267,29 +356,29 @@ START_TEST(test_cmd_join) {
     initialize_channel_session("#general", "football weekend", &channel, &channelUsers);
 
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(JOIN), "JOIN #general");
-    content = dequeue_from_channel_queue(channel);
+    content = dequeue_from_channel_queue(channel, NULL);
     ck_assert_str_eq(content, ":john!@ JOIN #general");
 
-    content = dequeue_from_user_queue(user);
+    content = dequeue_from_user_queue(user, NULL);
     ck_assert_str_eq(content, ":irc.server.com 332 john #general :football weekend");
     
-    content = dequeue_from_user_queue(user);
+    content = dequeue_from_user_queue(user, NULL);
     ck_assert_str_eq(content, ":irc.server.com 353 john #general :john");
       
-    content = dequeue_from_user_queue(user);
+    content = dequeue_from_user_queue(user, NULL);
     ck_assert_str_eq(content, ":irc.server.com 366 john #general :End of /NAMES list");
       
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(JOIN), "JOIN #linux");
     Channel *newChannel = find_channel_in_hash_table(server->session, "#linux");
-    content = dequeue_from_channel_queue(newChannel);
+    content = dequeue_from_channel_queue(newChannel, NULL);
     ck_assert_str_eq(content, ":john!@ JOIN #linux");
-    content = dequeue_from_user_queue(user);
+    content = dequeue_from_user_queue(user, NULL);
     ck_assert_str_eq(content, ":irc.server.com 331 john #linux :No topic is set");
 
-    content = dequeue_from_user_queue(user);
+    content = dequeue_from_user_queue(user, NULL);
     ck_assert_str_eq(content, ":irc.server.com 353 john #linux :john");
 
-    content = dequeue_from_user_queue(user);
+    content = dequeue_from_user_queue(user, NULL);
     ck_assert_str_eq(content, ":irc.server.com 366 john #linux :End of /NAMES list");
 
     cleanup_test();
@@ -315,7 +404,7 @@ START_TEST(test_cmd_part) {
     initialize_user_session(&user2, &userChannels2, "mark", NULL, NULL, NULL);
 
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(PART), "PART #general");
-    char *content = dequeue_from_user_queue(user1);
+    const char *content = dequeue_from_user_queue(user1, NULL);
     ck_assert_str_eq(content, ":irc.server.com 403 john #general :No such channel");
 
     Channel *channel = NULL;
@@ -323,29 +412,26 @@ START_TEST(test_cmd_part) {
     initialize_channel_session("#general", NULL, &channel, &channelUsers);
 
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(PART), "PART #general");
-    content = dequeue_from_user_queue(user1);
+    content = dequeue_from_user_queue(user1, NULL);
     ck_assert_str_eq(content, ":irc.server.com 442 john #general :You're not on that channel");
 
-    add_user_to_channel_users(channelUsers, user1);
-    add_channel_to_user_channels(userChannels1, channel);
+    add_channel_member(userChannels1, channelUsers);
 
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(PART), "PART #general");
-    ck_assert_int_eq(get_total_items(server->session->channels), 0);
-    ck_assert_int_eq(server->session->channelUsersLL->count, 0);
+    ck_assert_int_eq(get_flat_table_count(server->session->channels), 0);
+    ck_assert_int_eq(get_flat_table_count(server->session->channelUsers), 0);
     ck_assert_int_eq(userChannels1->count, 0);
 
     set_client_state_type(server->clients[CLIENT_FD_IDX], IN_CHANNEL);
 
     initialize_channel_session("#general", NULL, &channel, &channelUsers);
 
-    add_user_to_channel_users(channelUsers, user1);
-    add_channel_to_user_channels(userChannels1, channel);
-    add_user_to_channel_users(channelUsers, user2);
-    add_channel_to_user_channels(userChannels2, channel);
+    add_channel_member(userChannels1, channelUsers);
+    add_channel_member(userChannels2, channelUsers);
 
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(PART), "PART #general :bye");
-    ck_assert_int_eq(get_total_items(server->session->channels), 1);
-    content = dequeue_from_channel_queue(channel);
+    ck_assert_int_eq(get_flat_table_count(server->session->channels), 1);
+    content = dequeue_from_channel_queue(channel, NULL);
     ck_assert_str_eq(content, ":john!@ PART #general :bye");
 
     cleanup_test();
@@ -371,11 +457,11 @@ START_TEST(test_cmd_privmsg) {
     initialize_user_session(&user2, &userChannels2, "mark", NULL, NULL, NULL);
 
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(PRIVMSG), "PRIVMSG steve :hello");
-    char *content = dequeue_from_user_queue(user1);
+    const char *content = dequeue_from_user_queue(user1, NULL);
     ck_assert_str_eq(content, ":irc.server.com 401 john steve :No such nick");
 
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(PRIVMSG), "PRIVMSG mark :hello");
-    content = dequeue_from_user_queue(user2);
+    content = dequeue_from_user_queue(user2, NULL);
     ck_assert_str_eq(content, ":john!@ PRIVMSG mark :hello");
     
     Channel *channel = NULL;
@@ -383,20 +469,29 @@ START_TEST(test_cmd_privmsg) {
     initialize_channel_session("#general", NULL, &channel, &channelUsers);
 
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(PRIVMSG), "PRIVMSG #linux :hello");
-    content = dequeue_from_user_queue(user1);
+    content = dequeue_from_user_queue(user1, NULL);
     ck_assert_str_eq(content, ":irc.server.com 403 john #linux :No such channel");
     
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(PRIVMSG), "PRIVMSG #general :hello");
-    content = dequeue_from_user_queue(user1);
+    content = dequeue_from_user_queue(user1, NULL);
     ck_assert_str_eq(content, ":irc.server.com 442 john #general :You're not on that channel");
     
-    add_user_to_channel_users(channelUsers, user1);
-    add_channel_to_user_channels(userChannels1, channel);
+    add_channel_member(userChannels1, channelUsers);
 
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(PRIVMSG), "PRIVMSG #general :hello");
-    content = dequeue_from_channel_queue(channel);
+    content = dequeue_from_channel_queue(channel, NULL);
     ck_assert_str_eq(content, ":john!@ PRIVMSG #general :hello");
 
+    /* the sender is asked to try again once the 
+        recipient's queue is full */
+    set_user_queue_policy(user2, QP_BLOCK);
+
+    while (!get_ring_dropped_count(get_user_queue(user2))) {
+        execute_command(server->clients[CLIENT_FD_IDX], get_command_function(PRIVMSG), "PRIVMSG mark :hello");
+    }
+    content = dequeue_from_user_queue(user1, NULL);
+    ck_assert_str_eq(content, ":irc.server.com 263 john PRIVMSG :Please wait a while and try again.");
+
     cleanup_test();
 
 }
@@ -420,11 +515,11 @@ START_TEST(test_cmd_whois) {
     initialize_user_session(&user2, &userChannels2, "mark", "mjohnson", "irc2.client.com", "Mark Johnson");
 
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(WHOIS), "WHOIS steve");
-    const char *content = dequeue_from_user_queue(user1);
+    const char *content = dequeue_from_user_queue(user1, NULL);
     ck_assert_str_eq(content, ":irc.server.com 401 john steve :No such nick");
     
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(WHOIS), "WHOIS mark");
-    content = dequeue_from_user_queue(user1);
+    content = dequeue_from_user_queue(user1, NULL);
     ck_assert_str_eq(content, ":irc.server.com 311 john mark mjohnson irc2.client.com :Mark Johnson");
     
     cleanup_test();
@@ -449,22 +544,40 @@ START_TEST(test_cmd_quit) {
     initialize_user_session(&user1, &userChannels1, "john", NULL, NULL, NULL);
     initialize_user_session(&user2, &userChannels2, "mark", NULL, NULL, NULL);
 
-    ck_assert_int_eq(get_total_items(server->session->users), 2);
+    ck_assert_int_eq(get_flat_table_count(server->session->users), 2);
 
     Channel *channel = NULL;
     ChannelUsers *channelUsers = NULL;
     initialize_channel_session("#general", NULL, &channel, &channelUsers);
 
-    add_user_to_channel_users(channelUsers, user1);
-    add_channel_to_user_channels(userChannels1, channel);
-    add_user_to_channel_users(channelUsers, user2);
-    add_channel_to_user_channels(userChannels2, channel);
+    add_channel_member(userChannels1, channelUsers);
+    add_channel_member(userChannels2, channelUsers);
+
+    initialize_channel_session("#linux", NULL, &channel, &channelUsers);
 
+    add_channel_member(userChannels1, channelUsers);
+    add_channel_member(userChannels2, channelUsers);
+
+    /* the users share two channels, but the message 
+        is sent once */
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(QUIT), "QUIT :bye");
-    const char *content = dequeue_from_channel_queue(channel);
+    const char *content = dequeue_from_user_queue(user2, NULL);
     ck_assert_str_eq(content, ":john!@ QUIT :bye");
+    ck_assert_ptr_null(dequeue_from_user_queue(user2, NULL));
     
-    ck_assert_int_eq(get_total_items(server->session->users), 1);
+    ck_assert_int_eq(get_flat_table_count(server->session->users), 1);
+
+    /* a client may quit before its registration is 
+        complete */
+    set_client_data(server, CLIENT_FD_IDX + 2, CLIENT_FD + 2, CLIENT_IDENTIFIER, HOSTNAME, 50103);
+    set_fd_client_idx(server->fdTable, CLIENT_FD + 2, CLIENT_FD_IDX + 2);
+    set_server_client_nickname(server, server->clients[CLIENT_FD_IDX + 2], "jane");
+    set_client_state_type(server->clients[CLIENT_FD_IDX + 2], START_REGISTRATION);
+
+    execute_command(server->clients[CLIENT_FD_IDX + 2], get_command_function(QUIT), "QUIT :bye");
+
+    ck_assert_ptr_null(find_client(server, "jane"));
+    ck_assert_int_eq(get_flat_table_count(server->session->users), 1);
 
     cleanup_test();
 
@@ -483,7 +596,7 @@ START_TEST(test_cmd_unknown) {
     initialize_user_session(&user, &userChannels, "john", NULL, NULL, NULL);
 
     execute_command(server->clients[CLIENT_FD_IDX], get_command_function(UNKNOWN_COMMAND_TYPE), "TEST");
-    const char *content = dequeue_from_user_queue(user);
+    const char *content = dequeue_from_user_queue(user, NULL);
     ck_assert_str_eq(content, ":irc.server.com 421 TEST :Unknown command");
 
     cleanup_test();
@@ -0,0 +1,178 @@
+#ifndef TEST
+#define TEST
+#endif
+
+#include "../src/priv_mt_core.h"
+#include "../src/config.h"
+#include "../../libs/src/settings.h"
+#include "../../libs/src/priv_shared_buffer.h"
+
+#include <check.h>
+#include <string.h>
+
+#define READER_COUNT 2
+#define CAPACITY 4
+#define CLIENT_FD 10
+
+static Settings *settings = NULL;
+static TCPServer *server = NULL;
+
+static void initialize_test_suite(void) {
+
+    settings = create_settings(SERVER_OT_COUNT);
+    initialize_server_settings();
+}
+
+static void cleanup_test_suite(void) {
+
+    delete_settings(settings);
+}
+
+static void initialize_test(void) {
+
+    server = create_server(CAPACITY);
+    create_readers(server, READER_COUNT, CAPACITY);
+}
+
+static void cleanup_test(void) {
+
+    stop_concurrent_server();
+    delete_server(server);
+}
+
+START_TEST(test_create_readers) {
+
+    initialize_test();
+
+    MtContext *mtContext = get_mt_context();
+
+    ck_assert_int_eq(mtContext->readerCount, READER_COUNT);
+    ck_assert_int_eq(mtContext->slotCount, CAPACITY);
+
+    /* readers share the session, but own separate
+        ranges of client slots */
+    for (int i = 0; i < READER_COUNT; i++) {
+
+        Reader *reader = &mtContext->readers[i];
+
+        ck_assert_ptr_eq(get_session(reader->tcpServer), get_session(server));
+        ck_assert_int_eq(get_start_idx(reader->threadData), i * CAPACITY / READER_COUNT);
+        ck_assert_int_eq(get_end_idx(reader->threadData), (i + 1) * CAPACITY / READER_COUNT);
+        ck_assert_int_eq(get_server_capacity(reader->tcpServer), CAPACITY / READER_COUNT);
+    }
+
+    cleanup_test();
+}
+END_TEST
+
+START_TEST(test_assign_client_slot) {
+
+    initialize_test();
+
+    MtContext *mtContext = get_mt_context();
+
+    /* clients are spread evenly between the readers */
+    ck_assert_int_eq(assign_client_slot(CLIENT_FD), 0);
+    ck_assert_int_eq(assign_client_slot(CLIENT_FD + 1), 1);
+    ck_assert_int_eq(assign_client_slot(CLIENT_FD + 2), 0);
+    ck_assert_int_eq(assign_client_slot(CLIENT_FD + 3), 1);
+    ck_assert_int_eq(assign_client_slot(CLIENT_FD + 4), UNASSIGNED);
+
+    ck_assert_int_eq(mtContext->fdSlots[CLIENT_FD], 0);
+    ck_assert_int_eq(mtContext->fdSlots[CLIENT_FD + 1], 2);
+    ck_assert_int_eq(mtContext->fdSlots[CLIENT_FD + 2], 1);
+    ck_assert_int_eq(mtContext->fdSlots[CLIENT_FD + 3], 3);
+
+    ck_assert_int_eq(find_fd_reader(CLIENT_FD + 2), 0);
+    ck_assert_int_eq(find_fd_reader(CLIENT_FD + 3), 1);
+    ck_assert_int_eq(find_fd_reader(CLIENT_FD + 4), UNASSIGNED);
+
+    /* released slot is reused */
+    release_client_slot(CLIENT_FD + 2);
+
+    ck_assert_int_eq(find_fd_reader(CLIENT_FD + 2), UNASSIGNED);
+    ck_assert_int_eq(mtContext->readers[0].clientCount, 1);
+
+    ck_assert_int_eq(assign_client_slot(CLIENT_FD + 4), 0);
+    ck_assert_int_eq(mtContext->fdSlots[CLIENT_FD + 4], 1);
+
+    cleanup_test();
+}
+END_TEST
+
+START_TEST(test_forward_message) {
+
+    initialize_test();
+
+    MtContext *mtContext = get_mt_context();
+
+    SharedBuffer *buffer = create_shared_buffer("message", strlen("message"), CRLF);
+
+    /* unknown clients aren't forwarded */
+    ck_assert_int_eq(forward_to_reader(CLIENT_FD, buffer), 0);
+
+    assign_client_slot(CLIENT_FD);
+    assign_client_slot(CLIENT_FD + 1);
+
+    ck_assert_int_eq(forward_to_reader(CLIENT_FD + 1, buffer), 1);
+
+    Reader *reader = &mtContext->readers[1];
+
+    ck_assert_int_eq(reader->eventLoop->mailCount, 1);
+    ck_assert_int_eq(reader->eventLoop->mailbox[0].fd, CLIENT_FD + 1);
+    ck_assert_ptr_eq(reader->eventLoop->mailbox[0].buffer, buffer);
+    ck_assert_int_eq(get_shared_buffer_ref_count(buffer), 2);
+    ck_assert_int_eq(mtContext->readers[0].eventLoop->mailCount, 0);
+
+    /* mail for a client which has left is dropped */
+    release_client_slot(CLIENT_FD + 1);
+    deliver_mail(reader->eventLoop);
+
+    ck_assert_int_eq(reader->eventLoop->mailCount, 0);
+    ck_assert_int_eq(get_shared_buffer_ref_count(buffer), 1);
+
+    release_shared_buffer(buffer);
+
+    cleanup_test();
+}
+END_TEST
+
+Suite* mt_core_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("MT core");
+    tc_core = tcase_create("Core");
+
+    // Add the test case to the test suite
+    tcase_add_test(tc_core, test_create_readers);
+    tcase_add_test(tc_core, test_assign_client_slot);
+    tcase_add_test(tc_core, test_forward_message);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+#ifdef TEST
+
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = mt_core_suite();
+    sr = srunner_create(s);
+
+    initialize_test_suite();
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    cleanup_test_suite();
+
+    return (number_failed == 0) ? 0 : 1;
+}
+
+#endif
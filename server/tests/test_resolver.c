@@ -0,0 +1,225 @@
+#ifndef TEST
+#define TEST
+#endif
+
+#include "../src/priv_resolver.h"
+#include "../../libs/src/string_utils.h"
+
+#include <check.h>
+#include <string.h>
+#include <unistd.h>
+
+#define THREAD_COUNT 2
+#define CACHE_CAPACITY 2
+#define CACHE_TTL 60
+#define WAIT_INTERVAL 1000
+#define MAX_WAIT 5000
+
+static int resolveCount = 0;
+
+/* lookups are resolved without DNS */
+static bool resolve_stub(char *buffer, int size, const char *ipAddress) {
+
+    __atomic_add_fetch(&resolveCount, 1, __ATOMIC_SEQ_CST);
+
+    if (strcmp(ipAddress, "127.0.0.1") == 0) {
+        safe_copy(buffer, size, "localhost");
+        return 1;
+    }
+    if (strcmp(ipAddress, "127.0.0.2") == 0) {
+        safe_copy(buffer, size, "localhost2");
+        return 1;
+    }
+    return 0;
+}
+
+static void wait_for_lookups(Resolver *resolver, int lookupCount) {
+
+    for (int i = 0; i < MAX_WAIT && get_resolver_lookup_count(resolver) < lookupCount; i++) {
+        usleep(WAIT_INTERVAL);
+    }
+}
+
+START_TEST(test_resolve_hostname) {
+
+    resolveCount = 0;
+
+    Resolver *resolver = create_resolver(THREAD_COUNT, CACHE_CAPACITY, CACHE_TTL, resolve_stub);
+    LookupQueue *lookupQueue = create_lookup_queue(-1);
+
+    char hostname[MAX_CHARS + 1] = {'\0'};
+
+    /* the first lookup is queued */
+    ck_assert_int_eq(resolve_hostname(resolver, lookupQueue, 5, "127.0.0.1", hostname, sizeof(hostname)), 0);
+    wait_for_lookups(resolver, 1);
+
+    HostLookup lookups[2];
+
+    ck_assert_int_eq(get_completed_lookups(lookupQueue, lookups, 2), 1);
+    ck_assert_int_eq(lookups[0].fd, 5);
+    ck_assert_str_eq(lookups[0].ipAddress, "127.0.0.1");
+    ck_assert_str_eq(lookups[0].hostname, "localhost");
+    ck_assert_int_eq(lookups[0].resolved, 1);
+    ck_assert_int_eq(get_completed_lookups(lookupQueue, lookups, 2), 0);
+
+    /* the second lookup is served from the cache */
+    ck_assert_int_eq(resolve_hostname(resolver, lookupQueue, 6, "127.0.0.1", hostname, sizeof(hostname)), 1);
+    ck_assert_str_eq(hostname, "localhost");
+    ck_assert_int_eq(get_resolver_lookup_count(resolver), 1);
+    ck_assert_int_eq(resolveCount, 1);
+
+    delete_lookup_queue(lookupQueue);
+    delete_resolver(resolver);
+}
+END_TEST
+
+START_TEST(test_failed_lookup) {
+
+    resolveCount = 0;
+
+    Resolver *resolver = create_resolver(THREAD_COUNT, CACHE_CAPACITY, CACHE_TTL, resolve_stub);
+    LookupQueue *lookupQueue = create_lookup_queue(-1);
+
+    char hostname[MAX_CHARS + 1] = {'\0'};
+    HostLookup lookups[1];
+
+    /* failed lookups aren't reported */
+    ck_assert_int_eq(resolve_hostname(resolver, lookupQueue, 5, "10.0.0.1", hostname, sizeof(hostname)), 0);
+    wait_for_lookups(resolver, 1);
+
+    ck_assert_int_eq(get_completed_lookups(lookupQueue, lookups, 1), 0);
+
+    /* but they are cached */
+    ck_assert_int_eq(resolve_hostname(resolver, lookupQueue, 5, "10.0.0.1", hostname, sizeof(hostname)), 0);
+    ck_assert_int_eq(resolver->cacheCount, 1);
+    ck_assert_int_eq(is_queue_empty(resolver->requests), 1);
+    ck_assert_int_eq(resolveCount, 1);
+
+    delete_lookup_queue(lookupQueue);
+    delete_resolver(resolver);
+}
+END_TEST
+
+START_TEST(test_cache_eviction) {
+
+    Resolver *resolver = create_resolver(THREAD_COUNT, CACHE_CAPACITY, CACHE_TTL, resolve_stub);
+
+    HostLookup lookup1 = {.ipAddress = "127.0.0.1", .hostname = "localhost", .resolved = 1};
+    HostLookup lookup2 = {.ipAddress = "127.0.0.2", .hostname = "localhost2", .resolved = 1};
+    HostLookup lookup3 = {.ipAddress = "127.0.0.3", .hostname = "", .resolved = 0};
+
+    pthread_mutex_lock(&resolver->mutex);
+
+    add_cache_entry(resolver, &lookup1);
+    add_cache_entry(resolver, &lookup2);
+
+    ck_assert_int_eq(resolver->cacheCount, 2);
+    ck_assert_str_eq(resolver->lruHead->ipAddress, "127.0.0.2");
+    ck_assert_str_eq(resolver->lruTail->ipAddress, "127.0.0.1");
+
+    /* the least recently used entry is evicted */
+    move_cache_entry_to_front(resolver, find_cache_entry(resolver, "127.0.0.1"));
+    add_cache_entry(resolver, &lookup3);
+
+    ck_assert_int_eq(resolver->cacheCount, 2);
+    ck_assert_ptr_null(find_cache_entry(resolver, "127.0.0.2"));
+    ck_assert_str_eq(resolver->lruHead->ipAddress, "127.0.0.3");
+    ck_assert_str_eq(resolver->lruTail->ipAddress, "127.0.0.1");
+
+    pthread_mutex_unlock(&resolver->mutex);
+
+    delete_resolver(resolver);
+}
+END_TEST
+
+START_TEST(test_cache_expiry) {
+
+    Resolver *resolver = create_resolver(THREAD_COUNT, CACHE_CAPACITY, 0, resolve_stub);
+
+    HostLookup lookup = {.ipAddress = "127.0.0.1", .hostname = "localhost", .resolved = 1};
+
+    pthread_mutex_lock(&resolver->mutex);
+
+    add_cache_entry(resolver, &lookup);
+    ck_assert_int_eq(resolver->cacheCount, 1);
+
+    /* expired entries are removed */
+    ck_assert_ptr_null(find_cache_entry(resolver, "127.0.0.1"));
+    ck_assert_int_eq(resolver->cacheCount, 0);
+    ck_assert_ptr_null(resolver->lruHead);
+    ck_assert_ptr_null(resolver->lruTail);
+
+    pthread_mutex_unlock(&resolver->mutex);
+
+    delete_resolver(resolver);
+}
+END_TEST
+
+START_TEST(test_complete_lookup) {
+
+    int pipeFd[2];
+    ck_assert_int_eq(pipe(pipeFd), 0);
+
+    LookupQueue *lookupQueue = create_lookup_queue(pipeFd[1]);
+
+    HostLookup lookup = {.fd = 5, .ipAddress = "127.0.0.1", .hostname = "localhost", .resolved = 1};
+
+    complete_lookup(lookupQueue, &lookup);
+    complete_lookup(lookupQueue, &lookup);
+
+    /* the event loop is woken up for every lookup */
+    char buffer[64] = {'\0'};
+    ck_assert_int_eq(read(pipeFd[0], buffer, sizeof(buffer) - 1), 2 * strlen("resolved\r\n"));
+    ck_assert_str_eq(buffer, "resolved\r\nresolved\r\n");
+
+    HostLookup lookups[1];
+
+    ck_assert_int_eq(get_completed_lookups(lookupQueue, lookups, 1), 1);
+    ck_assert_int_eq(lookupQueue->count, 1);
+    ck_assert_int_eq(get_completed_lookups(lookupQueue, lookups, 1), 1);
+    ck_assert_int_eq(lookupQueue->count, 0);
+
+    delete_lookup_queue(lookupQueue);
+
+    close(pipeFd[0]);
+    close(pipeFd[1]);
+}
+END_TEST
+
+Suite* resolver_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+
+    s = suite_create("Resolver");
+    tc_core = tcase_create("Core");
+
+    // Add the test case to the test suite
+    tcase_add_test(tc_core, test_resolve_hostname);
+    tcase_add_test(tc_core, test_failed_lookup);
+    tcase_add_test(tc_core, test_cache_eviction);
+    tcase_add_test(tc_core, test_cache_expiry);
+    tcase_add_test(tc_core, test_complete_lookup);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+#ifdef TEST
+
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = resolver_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
+
+#endif
@@ -5,25 +5,21 @@
 #include "../src/priv_session.h"
 #include "../src/priv_user.h"
 #include "../src/priv_channel.h"
-#include "../../libs/src/priv_hash_table.h"
+#include "../../libs/src/priv_flat_table.h"
 #include "../../libs/src/priv_linked_list.h"
 
 #include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
-static int count_removable_channels(Session *session, UserChannels *userChannels) {
-
-    LinkedList *channels = get_channels_from_user_channels(userChannels);
-    reset_iterator(channels);
+static int count_removable_channels(UserChannels *userChannels) {
 
     int removableChannels = 0;
-    Node *node = NULL;
-
-    while ((node = iterator_next(channels)) != NULL) {
 
-        Channel *channel = get_data(node);
-        ChannelUsers *channelUsers = find_channel_users(session, channel);
+    for (int i = 0; i < userChannels->count; i++) {
 
-        if (channelUsers != NULL && get_channel_users_count(channelUsers) == 1) {
+        if (get_channel_users_count(userChannels->channels[i].channelUsers) == 1) {
             removableChannels++;
         }
     }
@@ -38,8 +34,8 @@ START_TEST(test_create_session) {
     ck_assert_ptr_ne(session->readyList, NULL);
     ck_assert_ptr_ne(session->users, NULL);
     ck_assert_ptr_ne(session->channels, NULL);
-    ck_assert_ptr_ne(session->userChannelsLL, NULL);
-    ck_assert_ptr_ne(session->channelUsersLL, NULL);
+    ck_assert_ptr_ne(session->userChannels, NULL);
+    ck_assert_ptr_ne(session->channelUsers, NULL);
 
     delete_session(session);
 }
@@ -49,11 +45,35 @@ START_TEST(test_add_user_to_hash_table) {
 
     Session *session = create_session();
 
-    User *user = create_user(0, "john", NULL, NULL, NULL);
+    User *user1 = create_user(0, "john", NULL, NULL, NULL);
+    User *user2 = create_user(0, "JOHN", NULL, NULL, NULL);
 
-    add_user_to_hash_table(session, user);
+    ck_assert_int_eq(add_user_to_hash_table(session, user1), 1);
+    ck_assert_int_eq(add_user_to_hash_table(session, user2), 0);
 
-    ck_assert_int_eq(get_total_items(session->users), 1);
+    ck_assert_int_eq(get_flat_table_count(session->users), 1);
+
+    delete_user(user2);
+    delete_session(session);
+}
+END_TEST
+
+START_TEST(test_reserve_nickname) {
+
+    Session *session = create_session();
+
+    int holder1 = 0, holder2 = 0;
+
+    ck_assert_int_eq(reserve_nickname(session, "john", &holder1), 1);
+    ck_assert_int_eq(reserve_nickname(session, "JOHN", &holder2), 0);
+    ck_assert_ptr_eq(find_nickname_holder(session, "John"), &holder1);
+
+    /* only the holder releases the nickname */
+    release_nickname(session, "john", &holder2);
+    ck_assert_ptr_eq(find_nickname_holder(session, "john"), &holder1);
+
+    release_nickname(session, "john", &holder1);
+    ck_assert_ptr_null(find_nickname_holder(session, "john"));
 
     delete_session(session);
 }
@@ -68,7 +88,7 @@ START_TEST(test_remove_user_from_hash_table) {
     add_user_to_hash_table(session, user);
     remove_user_from_hash_table(session, user);
 
-    ck_assert_int_eq(get_total_items(session->users), 0);
+    ck_assert_int_eq(get_flat_table_count(session->users), 0);
 
     delete_session(session);
 }
@@ -79,38 +99,45 @@ START_TEST(test_find_user_in_hash_table) {
     Session *session = create_session();
 
     User *user1 = create_user(0, "john", NULL, NULL, NULL);
-    User *user2 = create_user(0, "mark", NULL, NULL, NULL);
+    User *user2 = create_user(0, "mark[1]", NULL, NULL, NULL);
     add_user_to_hash_table(session, user1);
     add_user_to_hash_table(session, user2);
 
-    User *user = find_user_in_hash_table(session, "mark");
+    User *user = find_user_in_hash_table(session, "mark[1]");
 
     ck_assert_ptr_eq(user, user2);
-    ck_assert_str_eq(user2->nickname, "mark");
+    ck_assert_str_eq(user2->nickname, "mark[1]");
+
+    /* nicknames are compared with rfc 1459 casemapping */
+    ck_assert_ptr_eq(find_user_in_hash_table(session, "MARK{1}"), user2);
+    ck_assert_ptr_eq(find_user_in_hash_table(session, "John"), user1);
 
     delete_session(session);
 }
 END_TEST
 
-START_TEST(test_change_user_in_hash_table) {
+START_TEST(test_rename_user_in_hash_table) {
 
     Session *session = create_session();
 
-    User *oldUser = create_user(0, "john", NULL, NULL, NULL);
-    User *newUser = create_user(0, "mark", NULL, NULL, NULL);
-    add_user_to_hash_table(session, oldUser);
+    User *user = create_user(0, "john", NULL, NULL, NULL);
+    register_user(session, user);
 
-    User *user = find_user_in_hash_table(session, "john");
-    ck_assert_ptr_eq(user, oldUser);
+    Channel *channel = create_channel("#general", NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
+    register_new_channel_join(session, channel, user);
 
-    change_user_in_hash_table(session, oldUser, newUser);
+    enqueue_to_user_queue(user, "hello", strlen("hello"));
 
-    ck_assert_int_eq(get_total_items(session->users), 1);
+    rename_user_in_hash_table(session, user, "mark");
 
-    user = find_user_in_hash_table(session, "mark");
-    ck_assert_ptr_eq(user, newUser);
-    user = find_user_in_hash_table(session, "john");
-    ck_assert_ptr_eq(user, NULL);
+    ck_assert_int_eq(get_flat_table_count(session->users), 1);
+    ck_assert_ptr_eq(find_user_in_hash_table(session, "mark"), user);
+    ck_assert_ptr_eq(find_user_in_hash_table(session, "john"), NULL);
+    ck_assert_str_eq(get_user_nickname(user), "mark");
+
+    /* the user keeps its channels and messages */
+    ck_assert_int_eq(is_channel_member(session, channel, user), 1);
+    ck_assert_str_eq(dequeue_from_user_queue(user, NULL), "hello");
 
     delete_session(session);
 }
@@ -120,10 +147,9 @@ START_TEST(test_create_ready_list) {
 
     ReadyList *readyList = create_ready_list();
 
-    ck_assert_ptr_ne(readyList->readyUsers, NULL);
-    ck_assert_ptr_ne(readyList->readyChannels, NULL);
-    ck_assert_int_eq(readyList->readyUsers->count, 0);
-    ck_assert_int_eq(readyList->readyUsers->count, 0);
+    ck_assert_ptr_ne(readyList, NULL);
+    ck_assert_int_eq(get_ready_users_count(readyList), 0);
+    ck_assert_int_eq(get_ready_channels_count(readyList), 0);
 
     delete_ready_list(readyList);
 }
@@ -132,18 +158,27 @@ END_TEST
 START_TEST(test_add_remove_user_ready_list) {
 
     ReadyList *readyList = create_ready_list();
-    User *user = create_user(0, "john", NULL, NULL, NULL);
+    User *user1 = create_user(0, "john", NULL, NULL, NULL);
+    User *user2 = create_user(0, "mark", NULL, NULL, NULL);
 
-    add_user_to_ready_list(user, readyList);
-    ck_assert_int_eq(readyList->readyUsers->count, 1);
+    add_user_to_ready_list(user1, readyList);
+    ck_assert_int_eq(get_ready_users_count(readyList), 1);
 
-    add_user_to_ready_list(user, readyList);
-    ck_assert_int_eq(readyList->readyUsers->count, 1);
+    add_user_to_ready_list(user1, readyList);
+    ck_assert_int_eq(get_ready_users_count(readyList), 1);
 
-    remove_user_from_ready_list(readyList->readyUsers, user);
-    ck_assert_int_eq(readyList->readyUsers->count, 0);
+    add_user_to_ready_list(user2, readyList);
+    remove_user_from_ready_list(readyList, user1);
+    ck_assert_int_eq(get_ready_users_count(readyList), 1);
 
-    delete_user(user);
+    /* users are taken in the order they're added */
+    add_user_to_ready_list(user1, readyList);
+    ck_assert_ptr_eq(pop_ready_user(readyList), user2);
+    ck_assert_ptr_eq(pop_ready_user(readyList), user1);
+    ck_assert_ptr_eq(pop_ready_user(readyList), NULL);
+
+    delete_user(user1);
+    delete_user(user2);
     delete_ready_list(readyList);
 }
 END_TEST
@@ -154,13 +189,17 @@ START_TEST(test_add_remove_channel_ready_list) {
     Channel *channel = create_channel("#general", NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
 
     add_channel_to_ready_list(channel, readyList);
-    ck_assert_int_eq(readyList->readyChannels->count, 1);
+    ck_assert_int_eq(get_ready_channels_count(readyList), 1);
 
     add_channel_to_ready_list(channel, readyList);
-    ck_assert_int_eq(readyList->readyChannels->count, 1);
+    ck_assert_int_eq(get_ready_channels_count(readyList), 1);
 
-    remove_channel_from_ready_list(readyList->readyChannels, channel);
-    ck_assert_int_eq(readyList->readyChannels->count, 0);
+    remove_channel_from_ready_list(readyList, channel);
+    ck_assert_int_eq(get_ready_channels_count(readyList), 0);
+
+    add_channel_to_ready_list(channel, readyList);
+    ck_assert_ptr_eq(pop_ready_channel(readyList), channel);
+    ck_assert_int_eq(get_ready_channels_count(readyList), 0);
 
     delete_channel(channel);
     delete_ready_list(readyList);
@@ -173,7 +212,6 @@ START_TEST(test_create_user_channels) {
     UserChannels *userChannels = create_user_channels(user);
 
     ck_assert_ptr_ne(userChannels, NULL);
-    ck_assert_ptr_ne(userChannels->channels, NULL);
     ck_assert_str_eq(userChannels->user->nickname, "john");
     ck_assert_int_eq(userChannels->capacity, MAX_CHANNELS_PER_USER);
     ck_assert_int_eq(userChannels->count, 0);
@@ -192,7 +230,7 @@ START_TEST(test_add_user_channels) {
 
     add_user_channels(session, userChannels);
 
-    ck_assert_int_eq(session->userChannelsLL->count, 1);
+    ck_assert_int_eq(get_flat_table_count(session->userChannels), 1);
 
     delete_user(user);
     delete_session(session);
@@ -212,11 +250,11 @@ START_TEST(test_remove_user_channels) {
     add_user_channels(session, userChannels1);
     add_user_channels(session, userChannels2);
 
-    ck_assert_int_eq(session->userChannelsLL->count, 2);
+    ck_assert_int_eq(get_flat_table_count(session->userChannels), 2);
 
     remove_user_channels(session, userChannels2);
 
-    ck_assert_int_eq(session->userChannelsLL->count, 1);
+    ck_assert_int_eq(get_flat_table_count(session->userChannels), 1);
 
     delete_user(user1);
     delete_user(user2);
@@ -239,7 +277,7 @@ START_TEST(test_find_user_channels) {
     add_user_channels(session, userChannels1);
     add_user_channels(session, userChannels2);
 
-    ck_assert_int_eq(session->userChannelsLL->count, 2);
+    ck_assert_int_eq(get_flat_table_count(session->userChannels), 2);
 
     UserChannels *userChannels = find_user_channels(session, user2);
 
@@ -251,23 +289,80 @@ START_TEST(test_find_user_channels) {
 }
 END_TEST
 
-START_TEST(test_add_channel_to_user_channels) {
+START_TEST(test_add_channel_member) {
 
     User *user = create_user(0, "john", NULL, NULL, NULL);
     UserChannels *userChannels = create_user_channels(user);
 
     Channel *channel = create_channel("#general", NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
-    add_channel_to_user_channels(userChannels, channel);    
+    ChannelUsers *channelUsers = create_channel_users(channel);
+
+    ck_assert_int_eq(add_channel_member(userChannels, channelUsers), 1);
 
     ck_assert_int_eq(userChannels->count, 1);
+    ck_assert_int_eq(channelUsers->count, 1);
+    ck_assert_ptr_eq(channelUsers->members[0].user, user);
+    ck_assert_int_eq(channelUsers->members[0].channelIdx, 0);
+    ck_assert_int_eq(userChannels->channels[0].memberIdx, 0);
 
     delete_user_channels(userChannels);
+    delete_channel_users(channelUsers);
 
     delete_channel(channel);
     delete_user(user);
 }
 END_TEST
 
+START_TEST(test_add_channel_member_limits) {
+
+    User *user = create_user(0, "john", NULL, NULL, NULL);
+    UserChannels *userChannels = create_user_channels(user);
+
+    Channel *channels[MAX_CHANNELS_PER_USER + 1];
+    ChannelUsers *channelUsers[MAX_CHANNELS_PER_USER + 1];
+
+    for (int i = 0; i <= MAX_CHANNELS_PER_USER; i++) {
+
+        channels[i] = create_channel("#general", NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
+        channelUsers[i] = create_channel_users(channels[i]);
+
+        ck_assert_int_eq(add_channel_member(userChannels, channelUsers[i]), i < MAX_CHANNELS_PER_USER);
+    }
+    ck_assert_int_eq(channelUsers[MAX_CHANNELS_PER_USER]->count, 0);
+
+    /* members grow up to the channel's capacity */
+    User *users[MAX_USERS_PER_CHANNEL];
+    UserChannels *usersChannels[MAX_USERS_PER_CHANNEL];
+
+    for (int i = 1; i < MAX_USERS_PER_CHANNEL; i++) {
+
+        users[i] = create_user(0, "mark", NULL, NULL, NULL);
+        usersChannels[i] = create_user_channels(users[i]);
+
+        ck_assert_int_eq(add_channel_member(usersChannels[i], channelUsers[0]), 1);
+    }
+
+    ck_assert_int_eq(is_channel_full(channelUsers[0]), 1);
+    ck_assert_int_eq(channelUsers[0]->size, MAX_USERS_PER_CHANNEL);
+    ck_assert_int_eq(add_channel_member(usersChannels[1], channelUsers[0]), 0);
+
+    for (int i = 1; i < MAX_USERS_PER_CHANNEL; i++) {
+
+        delete_user_channels(usersChannels[i]);
+        delete_user(users[i]);
+    }
+
+    for (int i = 0; i <= MAX_CHANNELS_PER_USER; i++) {
+
+        delete_channel_users(channelUsers[i]);
+        delete_channel(channels[i]);
+    }
+
+    delete_user_channels(userChannels);
+    delete_user(user);
+}
+END_TEST
+
 START_TEST(test_find_channel_in_user_channels) {
 
     User *user = create_user(0, "john", NULL, NULL, NULL);
@@ -275,64 +370,248 @@ START_TEST(test_find_channel_in_user_channels) {
 
     Channel *channel1 = create_channel("#general", NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
     Channel *channel2 = create_channel("#linux", NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
+    Channel *channel3 = create_channel("#sports", NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
 
-    add_channel_to_user_channels(userChannels, channel1);    
-    add_channel_to_user_channels(userChannels, channel2);   
+    ChannelUsers *channelUsers1 = create_channel_users(channel1);
+    ChannelUsers *channelUsers2 = create_channel_users(channel2);
+
+    add_channel_member(userChannels, channelUsers1);    
+    add_channel_member(userChannels, channelUsers2);   
 
     ck_assert_int_eq(userChannels->count, 2);
     Channel *channel = find_channel_in_user_channels(userChannels, channel2);
 
     ck_assert_ptr_eq(channel, channel2);
+    ck_assert_ptr_eq(find_channel_in_user_channels(userChannels, channel3), NULL);
 
     delete_user_channels(userChannels);
+    delete_channel_users(channelUsers1);
+    delete_channel_users(channelUsers2);
 
     delete_channel(channel1);
     delete_channel(channel2);
+    delete_channel(channel3);
     delete_user(user);
 }
 END_TEST
 
-START_TEST(test_remove_channel_in_user_channels) {
+START_TEST(test_remove_channel_member) {
 
-    User *user = create_user(0, "john", NULL, NULL, NULL);
-    UserChannels *userChannels = create_user_channels(user);
+    User *user1 = create_user(0, "john", NULL, NULL, NULL);
+    User *user2 = create_user(0, "mark", NULL, NULL, NULL);
+    User *user3 = create_user(0, "jane", NULL, NULL, NULL);
+
+    UserChannels *userChannels1 = create_user_channels(user1);
+    UserChannels *userChannels2 = create_user_channels(user2);
+    UserChannels *userChannels3 = create_user_channels(user3);
 
     Channel *channel1 = create_channel("#general", NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
     Channel *channel2 = create_channel("#linux", NULL,  TEMPORARY, MAX_USERS_PER_CHANNEL);
 
-    add_channel_to_user_channels(userChannels, channel1);    
-    add_channel_to_user_channels(userChannels, channel2);  
+    ChannelUsers *channelUsers1 = create_channel_users(channel1);
+    ChannelUsers *channelUsers2 = create_channel_users(channel2);
+
+    add_channel_member(userChannels1, channelUsers1);
+    add_channel_member(userChannels2, channelUsers1);
+    add_channel_member(userChannels3, channelUsers2);
+    add_channel_member(userChannels3, channelUsers1);
 
-    ck_assert_int_eq(userChannels->count, 2);
-    remove_channel_in_user_channels(userChannels, channel2);
+    ck_assert_int_eq(remove_channel_member(userChannels1, channelUsers1), 1);
+    ck_assert_int_eq(remove_channel_member(userChannels1, channelUsers1), 0);
 
-    ck_assert_int_eq(userChannels->count, 1);
+    /* the last member takes the removed position */
+    ck_assert_int_eq(channelUsers1->count, 2);
+    ck_assert_ptr_eq(channelUsers1->members[0].user, user3);
+    ck_assert_int_eq(channelUsers1->members[0].channelIdx, 1);
+    ck_assert_int_eq(userChannels3->channels[1].memberIdx, 0);
 
-    delete_user_channels(userChannels);
+    ck_assert_int_eq(remove_channel_member(userChannels3, channelUsers2), 1);
+
+    /* the last channel takes the removed position */
+    ck_assert_int_eq(userChannels3->count, 1);
+    ck_assert_ptr_eq(userChannels3->channels[0].channelUsers, channelUsers1);
+    ck_assert_int_eq(channelUsers1->members[0].channelIdx, 0);
+    ck_assert_int_eq(channelUsers2->count, 0);
+
+    delete_user_channels(userChannels1);
+    delete_user_channels(userChannels2);
+    delete_user_channels(userChannels3);
+    delete_channel_users(channelUsers1);
+    delete_channel_users(channelUsers2);
 
     delete_channel(channel1);
     delete_channel(channel2);
-    delete_user(user);
-    
+    delete_user(user1);
+    delete_user(user2);
+    delete_user(user3);
 }
 END_TEST
 
-START_TEST(test_change_user_in_user_channels) {
+START_TEST(test_is_channel_member) {
 
-    User *oldUser = create_user(0, "john", NULL, NULL, NULL);
-    User *newUser = create_user(0, "mark", NULL, NULL, NULL);
-    UserChannels *userChannels = create_user_channels(oldUser);
+    Session *session = create_session();
 
-    ck_assert_str_eq(userChannels->user->nickname, "john");
+    User *user1 = create_user(0, "john", NULL, NULL, NULL);
+    User *user2 = create_user(0, "mark", NULL, NULL, NULL);
 
-    change_user_in_user_channels(userChannels, newUser);
+    register_user(session, user1);
+    register_user(session, user2);
 
-    ck_assert_str_eq(userChannels->user->nickname, "mark");
+    Channel *channel = create_channel("#general", NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
+    register_new_channel_join(session, channel, user1);
 
-    delete_user_channels(userChannels);
-    delete_user(oldUser);
-    delete_user(newUser);
+    ck_assert_int_eq(is_channel_member(session, channel, user1), 1);
+    ck_assert_int_eq(is_channel_member(session, channel, user2), 0);
+
+    register_existing_channel_join(session, channel, user2);
+    register_channel_leave(session, channel, user1);
 
+    ck_assert_int_eq(is_channel_member(session, channel, user1), 0);
+    ck_assert_int_eq(is_channel_member(session, channel, user2), 1);
+
+    delete_session(session);
+}
+END_TEST
+
+/* every entry points at the entry which points 
+    back at it */
+static void check_channel_members(Session *session, User **users, int userCount, Channel **channels, int channelCount, bool membership[][channelCount]) {
+
+    for (int i = 0; i < userCount; i++) {
+
+        UserChannels *userChannels = find_user_channels(session, users[i]);
+
+        for (int j = 0; j < userChannels->count; j++) {
+
+            ChannelEntry *channelEntry = &userChannels->channels[j];
+            MemberEntry *memberEntry = &channelEntry->channelUsers->members[channelEntry->memberIdx];
+
+            ck_assert_ptr_eq(memberEntry->userChannels, userChannels);
+            ck_assert_int_eq(memberEntry->channelIdx, j);
+        }
+    }
+
+    for (int i = 0; i < channelCount; i++) {
+
+        ChannelUsers *channelUsers = find_channel_users(session, channels[i]);
+
+        for (int j = 0; j < channelUsers->count; j++) {
+
+            MemberEntry *memberEntry = &channelUsers->members[j];
+            ChannelEntry *channelEntry = &memberEntry->userChannels->channels[memberEntry->channelIdx];
+
+            ck_assert_ptr_eq(channelEntry->channelUsers, channelUsers);
+            ck_assert_int_eq(channelEntry->memberIdx, j);
+        }
+
+        for (int j = 0; j < userCount; j++) {
+            ck_assert_int_eq(is_channel_member(session, channels[i], users[j]), membership[j][i]);
+        }
+    }
+}
+
+START_TEST(test_random_channel_joins) {
+
+    enum {USER_COUNT = 6, CHANNEL_COUNT = MAX_CHANNELS_PER_USER + 2, OPERATION_COUNT = 5000};
+
+    Session *session = create_session();
+
+    User *users[USER_COUNT];
+    Channel *channels[CHANNEL_COUNT];
+    bool membership[USER_COUNT][CHANNEL_COUNT] = {{0}};
+    int channelCounts[USER_COUNT] = {0};
+
+    for (int i = 0; i < USER_COUNT; i++) {
+
+        char nickname[MAX_NICKNAME_LEN + 1];
+        snprintf(nickname, sizeof(nickname), "user%d", i);
+
+        users[i] = create_user(0, nickname, NULL, NULL, NULL);
+        register_user(session, users[i]);
+    }
+
+    for (int i = 0; i < CHANNEL_COUNT; i++) {
+
+        char name[MAX_CHARS + 1];
+        snprintf(name, sizeof(name), "#channel%d", i);
+
+        channels[i] = create_channel(name, NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
+        add_channel_to_hash_table(session, channels[i]);
+        add_channel_users(session, create_channel_users(channels[i]));
+    }
+
+    /* the seed is fixed, so that a failure is 
+        reproducible */
+    srand(1);
+
+    for (int i = 0; i < OPERATION_COUNT; i++) {
+
+        int userIdx = rand() % USER_COUNT;
+        int channelIdx = rand() % CHANNEL_COUNT;
+
+        if (membership[userIdx][channelIdx]) {
+
+            register_channel_leave(session, channels[channelIdx], users[userIdx]);
+            membership[userIdx][channelIdx] = 0;
+            channelCounts[userIdx]--;
+        }
+        else if (channelCounts[userIdx] < MAX_CHANNELS_PER_USER) {
+
+            register_existing_channel_join(session, channels[channelIdx], users[userIdx]);
+            membership[userIdx][channelIdx] = 1;
+            channelCounts[userIdx]++;
+        }
+
+        check_channel_members(session, users, USER_COUNT, channels, CHANNEL_COUNT, membership);
+    }
+
+    delete_session(session);
+}
+END_TEST
+
+static void count_peer(void *user, void *arg) {
+
+    (*(int*) arg)++;
+}
+
+START_TEST(test_iterate_channel_peers) {
+
+    Session *session = create_session();
+
+    User *user1 = create_user(0, "john", NULL, NULL, NULL);
+    User *user2 = create_user(0, "mark", NULL, NULL, NULL);
+    User *user3 = create_user(0, "jane", NULL, NULL, NULL);
+
+    register_user(session, user1);
+    register_user(session, user2);
+    register_user(session, user3);
+
+    Channel *channel1 = create_channel("#general", NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
+    Channel *channel2 = create_channel("#linux", NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
+
+    register_new_channel_join(session, channel1, user1);
+    register_existing_channel_join(session, channel1, user2);
+    register_new_channel_join(session, channel2, user1);
+    register_existing_channel_join(session, channel2, user2);
+    register_existing_channel_join(session, channel2, user3);
+
+    /* users in both channels are visited once */
+    int peerCount = 0;
+    iterate_channel_peers(session, user1, count_peer, &peerCount);
+    ck_assert_int_eq(peerCount, 3);
+
+    peerCount = 0;
+    iterate_channel_peers(session, user3, count_peer, &peerCount);
+    ck_assert_int_eq(peerCount, 3);
+
+    enqueue_to_channel_peers(session, user1, "bye", strlen("bye"), 0);
+
+    ck_assert_ptr_null(dequeue_from_user_queue(user1, NULL));
+    ck_assert_str_eq(dequeue_from_user_queue(user2, NULL), "bye");
+    ck_assert_ptr_null(dequeue_from_user_queue(user2, NULL));
+    ck_assert_int_eq(get_ready_users_count(get_ready_list(session)), 2);
+
+    delete_session(session);
 }
 END_TEST
 
@@ -348,34 +627,27 @@ START_TEST(test_find_removable_channels) {
 
     Channel *channel1 = create_channel("#general", NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
     Channel *channel2 = create_channel("#linux", NULL, TEMPORARY, MAX_USERS_PER_CHANNEL);
-    
-    add_channel_to_user_channels(userChannels1, channel1);  
-    add_channel_to_user_channels(userChannels1, channel2); 
-    add_channel_to_user_channels(userChannels2, channel1);
-
-    ck_assert_int_eq(userChannels1->count, 2);
-    ck_assert_int_eq(userChannels2->count, 1);
 
     ChannelUsers *channelUsers1 = create_channel_users(channel1);
     ChannelUsers *channelUsers2 = create_channel_users(channel2);
 
     add_channel_users(session, channelUsers1);
     add_channel_users(session, channelUsers2);
+    
+    add_channel_member(userChannels1, channelUsers1);  
+    add_channel_member(userChannels1, channelUsers2); 
+    add_channel_member(userChannels2, channelUsers1);
 
-    add_user_to_channel_users(channelUsers1, user1);  
-    add_user_to_channel_users(channelUsers1, user2); 
-    add_user_to_channel_users(channelUsers2, user1);
+    ck_assert_int_eq(userChannels1->count, 2);
+    ck_assert_int_eq(userChannels2->count, 1);
 
     ck_assert_int_eq(channelUsers1->count, 2);
     ck_assert_int_eq(channelUsers2->count, 1);
 
-    LinkedList *channels = get_channels_from_user_channels(userChannels1);
-    reset_iterator(channels);
-
-    int removableChannels1 = count_removable_channels(session, userChannels1);
+    int removableChannels1 = count_removable_channels(userChannels1);
     ck_assert_int_eq(removableChannels1, 1);
 
-    int removableChannels2 = count_removable_channels(session, userChannels2);
+    int removableChannels2 = count_removable_channels(userChannels2);
     ck_assert_int_eq(removableChannels2, 0);
 
     delete_user_channels(userChannels1);
@@ -390,25 +662,6 @@ START_TEST(test_find_removable_channels) {
 }
 END_TEST
 
-START_TEST(test_are_user_channels_equal) {
-
-    User *user1 = create_user(0, "john", NULL, NULL, NULL);
-    User *user2 = create_user(0, "mark", NULL, NULL, NULL);
-
-    UserChannels *userChannels1 = create_user_channels(user1);
-    UserChannels *userChannels2 = create_user_channels(user2);
-
-    int equal = are_user_channels_equal(userChannels1, userChannels2);
-
-    ck_assert_int_eq(equal, 0);
-
-    delete_user_channels(userChannels1);
-    delete_user_channels(userChannels2);
-    delete_user(user1);
-    delete_user(user2);
-}
-END_TEST
-
 
 Suite* session_suite(void) {
     Suite *s;
@@ -420,9 +673,10 @@ Suite* session_suite(void) {
     // Add the test case to the test suite
     tcase_add_test(tc_core, test_create_session);
     tcase_add_test(tc_core, test_add_user_to_hash_table);
+    tcase_add_test(tc_core, test_reserve_nickname);
     tcase_add_test(tc_core, test_remove_user_from_hash_table);
     tcase_add_test(tc_core, test_find_user_in_hash_table);
-    tcase_add_test(tc_core, test_change_user_in_hash_table);    
+    tcase_add_test(tc_core, test_rename_user_in_hash_table);
     tcase_add_test(tc_core, test_create_ready_list);
     tcase_add_test(tc_core, test_add_remove_user_ready_list);
     tcase_add_test(tc_core, test_add_remove_channel_ready_list);
@@ -430,12 +684,14 @@ Suite* session_suite(void) {
     tcase_add_test(tc_core, test_add_user_channels);
     tcase_add_test(tc_core, test_remove_user_channels);
     tcase_add_test(tc_core, test_find_user_channels);
-    tcase_add_test(tc_core, test_add_channel_to_user_channels);
+    tcase_add_test(tc_core, test_add_channel_member);
+    tcase_add_test(tc_core, test_add_channel_member_limits);
     tcase_add_test(tc_core, test_find_channel_in_user_channels);
-    tcase_add_test(tc_core, test_remove_channel_in_user_channels);
-    tcase_add_test(tc_core, test_change_user_in_user_channels);
+    tcase_add_test(tc_core, test_remove_channel_member);
+    tcase_add_test(tc_core, test_is_channel_member);
+    tcase_add_test(tc_core, test_random_channel_joins);
+    tcase_add_test(tc_core, test_iterate_channel_peers);
     tcase_add_test(tc_core, test_find_removable_channels);
-    tcase_add_test(tc_core, test_are_user_channels_equal);
 
     suite_add_tcase(s, tc_core);
 
@@ -7,6 +7,7 @@
 #include "../../libs/src/mock.h"
 
 #include <check.h>
+#include <string.h>
 #include <unistd.h>
 
 #define LISTEN_FD 3
@@ -22,6 +23,19 @@ static void set_mock_data(int fd, int port, int initialFdCount) {
     set_initial_fd_count(get_mock_fd());
 }
 
+static bool fail_lookup(char *buffer, int size, const char *ipAddress) {
+
+    return 0;
+}
+
+static int forwardedFd = UNASSIGNED;
+
+static bool forward_message(int fd, SharedBuffer *buffer) {
+
+    forwardedFd = fd;
+    return 1;
+}
+
 static void decode_message(char *buffer, int size, int *fd, const char **content, const char *message) {
 
     if (message != NULL && count_delimiters(message, "|") == 1) {
@@ -45,7 +59,8 @@ START_TEST(test_create_server) {
     ck_assert_ptr_ne(server->clients, NULL);
     ck_assert_ptr_ne(server->session, NULL);
     ck_assert_ptr_ne(server->outQueue, NULL);
-    ck_assert_ptr_ne(server->fdsIdxMap, NULL);
+    ck_assert_ptr_ne(server->fdTable, NULL);
+    ck_assert_int_eq(server->sharedFdTable, 0);
     ck_assert_int_eq(server->count, 0);
     ck_assert_int_eq(server->capacity, DEF_FDS);
 
@@ -53,16 +68,20 @@ START_TEST(test_create_server) {
 }
 END_TEST
 
-START_TEST(test_find_client_fd_idx) {
+START_TEST(test_allocate_client_slot) {
 
-    TCPServer *server = create_server(0);
+    TCPServer *server = create_server(2);
 
-    int fdIdx = find_client_fd_idx(server, UNASSIGNED);
+    ck_assert_int_eq(allocate_client_slot(server), 0);
+    ck_assert_int_eq(allocate_client_slot(server), 1);
+    ck_assert_int_eq(allocate_client_slot(server), UNASSIGNED);
 
-    ck_assert_int_eq(fdIdx, CLIENT_FD_IDX);
+    /* freed slot is reused */
+    free_client_slot(server, 0);
 
-    delete_server(server);
+    ck_assert_int_eq(allocate_client_slot(server), 0);
 
+    delete_server(server);
 }
 END_TEST
 
@@ -128,9 +147,11 @@ START_TEST(test_add_client) {
     
     ck_assert_int_eq(server->count, 1);
 
+    /* without a resolver, the client keeps its IP 
+        address */
     ck_assert_int_eq(server->clients[CLIENT_FD_IDX]->fd, CLIENT_FD);
-    ck_assert_str_eq(server->clients[CLIENT_FD_IDX]->clientIdentifier, "localhost");
-    ck_assert_int_eq(server->clients[CLIENT_FD_IDX]->identifierType, HOSTNAME);
+    ck_assert_str_eq(server->clients[CLIENT_FD_IDX]->clientIdentifier, "127.0.0.1");
+    ck_assert_int_eq(server->clients[CLIENT_FD_IDX]->identifierType, IP_ADDRESS);
     ck_assert_int_eq(server->clients[CLIENT_FD_IDX]->port, CLIENT_PORT);
     ck_assert_int_eq(server->clients[CLIENT_FD_IDX]->stateType, CONNECTED);
 
@@ -138,6 +159,42 @@ START_TEST(test_add_client) {
 }
 END_TEST
 
+START_TEST(test_update_client_hostnames) {
+
+    set_mock_data(LISTEN_FD, CLIENT_PORT, get_mock_fd());
+
+    struct sockaddr_in sa;
+    memset((struct sockaddr_in *) &sa, 0, sizeof(struct sockaddr_in));
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(CLIENT_PORT);
+    inet_pton(AF_INET, "127.0.0.1", &sa.sin_addr);
+
+    set_mock_sockaddr(&sa);
+
+    TCPServer *server = create_server(0);
+    set_server_listen_fd(server, LISTEN_FD);
+
+    Resolver *resolver = create_resolver(1, 1, DEF_RESOLVER_CACHE_TTL, fail_lookup);
+    set_server_resolver(server, resolver, -1);
+
+    add_client(server, NULL);
+
+    ck_assert_str_eq(server->clients[CLIENT_FD_IDX]->clientIdentifier, "127.0.0.1");
+
+    /* completed lookup replaces the IP address */
+    HostLookup lookup = {.fd = CLIENT_FD, .ipAddress = "127.0.0.1", .hostname = CLIENT_IDENTIFIER, .resolved = 1};
+    complete_lookup(server->lookupQueue, &lookup);
+
+    update_client_hostnames(server);
+
+    ck_assert_str_eq(server->clients[CLIENT_FD_IDX]->clientIdentifier, CLIENT_IDENTIFIER);
+    ck_assert_int_eq(server->clients[CLIENT_FD_IDX]->identifierType, HOSTNAME);
+
+    delete_server(server);
+    delete_resolver(resolver);
+}
+END_TEST
+
 START_TEST(test_remove_client) {
 
     set_mock_data(LISTEN_FD, CLIENT_PORT, get_mock_fd());
@@ -145,13 +202,20 @@ START_TEST(test_remove_client) {
     TCPServer *server = create_server(0);
     set_server_listen_fd(server, LISTEN_FD);
 
+    /* the server may use a shared fd table */
+    FdTable *fdTable = create_fd_table(0);
+    set_server_fd_table(server, fdTable);
+
     add_client(server, NULL);
 
     ck_assert_int_eq(server->clients[CLIENT_FD_IDX]->fd, CLIENT_FD);
+    ck_assert_int_eq(get_client_fd_idx(server, CLIENT_FD), CLIENT_FD_IDX);
+    ck_assert_int_eq(get_fd_client_idx(fdTable, CLIENT_FD), CLIENT_FD_IDX);
 
     remove_client(server, NULL, CLIENT_FD);
 
     ck_assert_int_eq(server->count, 0);
+    ck_assert_int_eq(get_client_fd_idx(server, CLIENT_FD), UNASSIGNED);
     ck_assert_int_eq(server->clients[CLIENT_FD_IDX]->fd, UNASSIGNED);
     ck_assert_str_eq(server->clients[CLIENT_FD_IDX]->clientIdentifier, "");
     ck_assert_int_eq(server->clients[CLIENT_FD_IDX]->identifierType, UNKNOWN_HOST_IDENTIFIER);
@@ -159,6 +223,7 @@ START_TEST(test_remove_client) {
     ck_assert_int_eq(server->clients[CLIENT_FD_IDX]->stateType, DISCONNECTED);
 
     delete_server(server);
+    delete_fd_table(fdTable);
 }
 END_TEST
 
@@ -171,16 +236,30 @@ START_TEST(test_find_client) {
   
     add_client(server, NULL);
     ck_assert_int_ne(server->clients[CLIENT_FD_IDX]->fd, UNASSIGNED);
-    set_client_nickname(server->clients[CLIENT_FD_IDX], "john");
+    set_server_client_nickname(server, server->clients[CLIENT_FD_IDX], "john");
 
     add_client(server, NULL);
     ck_assert_int_ne(server->clients[CLIENT_FD_IDX + 1]->fd, UNASSIGNED);
-    set_client_nickname(server->clients[CLIENT_FD_IDX + 1], "mark");
+    set_server_client_nickname(server, server->clients[CLIENT_FD_IDX + 1], "mark");
 
     Client *client = find_client(server, "mark");
 
     ck_assert_int_eq(client->fd, CLIENT_FD + 1);
 
+    /* nicknames are case insensitive */
+    ck_assert_ptr_eq(find_client(server, "JOHN"), server->clients[CLIENT_FD_IDX]);
+
+    /* the index follows nickname changes */
+    set_server_client_nickname(server, server->clients[CLIENT_FD_IDX], "john707");
+
+    ck_assert_ptr_null(find_client(server, "john"));
+    ck_assert_ptr_eq(find_client(server, "john707"), server->clients[CLIENT_FD_IDX]);
+
+    remove_client(server, NULL, CLIENT_FD + 1);
+
+    ck_assert_ptr_null(find_client(server, "mark"));
+    ck_assert_str_eq(get_client_nickname(server->clients[CLIENT_FD_IDX + 1]), "");
+
     delete_server(server);
 }
 END_TEST
@@ -197,7 +276,7 @@ START_TEST(test_add_message_to_queue) {
     set_client_nickname(server->clients[CLIENT_FD_IDX], "john");
     set_client_state_type(server->clients[CLIENT_FD_IDX], CONNECTED);
 
-    add_message_to_queue(server, server->clients[CLIENT_FD_IDX], "message");
+    add_message_to_queue(server, server->clients[CLIENT_FD_IDX], "message", strlen("message"));
     ck_assert_int_eq(server->outQueue->count, 1);
 
     const char *message = dequeue_from_server_queue(server);
@@ -287,7 +366,14 @@ START_TEST(test_server_write) {
 
     set_mock_fd(CLIENT_FD);
 
-    server_write(server, NULL, CLIENT_FD, input);
+    server_write(server, NULL, CLIENT_FD, input, strlen(input));
+
+    ck_assert_str_eq(output, "");
+    ck_assert_int_eq(get_client_output_count(server->clients[CLIENT_FD_IDX]), 1);
+    ck_assert_int_eq(get_client_output_len(server->clients[CLIENT_FD_IDX]), strlen("This is a full sentence\r\n"));
+    ck_assert_int_eq(server->pendingCount, 1);
+
+    ck_assert_int_eq(server_flush(server, NULL, CLIENT_FD), 0);
 
     ck_assert_str_eq(output, "This is a full sentence\r\n");
     ck_assert_int_eq(server->clients[CLIENT_FD_IDX]->inBuffer[0], '\0');
@@ -296,6 +382,86 @@ START_TEST(test_server_write) {
 }
 END_TEST
 
+START_TEST(test_buffer_client_data) {
+
+    TCPServer *server = create_server(0);
+
+    set_client_data(server, CLIENT_FD_IDX, CLIENT_FD, CLIENT_IDENTIFIER, HOSTNAME, CLIENT_PORT);
+    set_fd_client_idx(server->fdTable, CLIENT_FD, CLIENT_FD_IDX);
+
+    int bytesBuffered = buffer_client_data(server, CLIENT_FD, "message\r\n", strlen("message\r\n"));
+
+    ck_assert_int_eq(bytesBuffered, strlen("message\r\n"));
+    ck_assert_str_eq(server->clients[CLIENT_FD_IDX]->inBuffer, "message\r\n");
+
+    char data[MAX_CHARS * 2] = {'\0'};
+    memset(data, 'a', ARRAY_SIZE(data));
+
+    bytesBuffered = buffer_client_data(server, CLIENT_FD, data, ARRAY_SIZE(data));
+
+    ck_assert_int_eq(bytesBuffered, MAX_CHARS - strlen("message\r\n"));
+
+    delete_server(server);
+}
+END_TEST
+
+START_TEST(test_pending_write) {
+
+    TCPServer *server = create_server(0);
+
+    add_pending_write(server, server->clients[CLIENT_FD_IDX]);
+    add_pending_write(server, server->clients[CLIENT_FD_IDX]);
+
+    ck_assert_int_eq(server->pendingCount, 1);
+    ck_assert_ptr_eq(pop_pending_write(server), server->clients[CLIENT_FD_IDX]);
+    ck_assert_ptr_eq(pop_pending_write(server), NULL);
+
+    delete_server(server);
+}
+END_TEST
+
+START_TEST(test_find_client_shared_session) {
+
+    TCPServer *server1 = create_server(0);
+    TCPServer *server2 = create_server(0);
+
+    set_server_session(server2, get_session(server1));
+
+    /* nicknames are reserved across the servers 
+        which share the session */
+    set_server_client_nickname(server1, server1->clients[CLIENT_FD_IDX], "john");
+    ck_assert_ptr_eq(find_client(server2, "JOHN"), server1->clients[CLIENT_FD_IDX]);
+
+    set_server_client_nickname(server1, server1->clients[CLIENT_FD_IDX], "");
+    ck_assert_ptr_null(find_client(server2, "john"));
+
+    delete_server(server2);
+    delete_server(server1);
+}
+END_TEST
+
+START_TEST(test_server_forward) {
+
+    TCPServer *server1 = create_server(0);
+    TCPServer *server2 = create_server(0);
+
+    set_server_session(server2, get_session(server1));
+    ck_assert_ptr_eq(get_session(server2), get_session(server1));
+
+    /* messages for clients of other servers are 
+        forwarded */
+    ck_assert_int_eq(server_write(server2, NULL, CLIENT_FD, "message", strlen("message")), 0);
+
+    set_server_forward_func(server2, forward_message);
+
+    ck_assert_int_eq(server_write(server2, NULL, CLIENT_FD, "message", strlen("message")), 1);
+    ck_assert_int_eq(forwardedFd, CLIENT_FD);
+    ck_assert_int_eq(server2->pendingCount, 0);
+
+    delete_server(server2);
+    delete_server(server1);
+}
+END_TEST
 
 Suite* tcpserver_suite(void) {
     Suite *s;
@@ -306,17 +472,22 @@ Suite* tcpserver_suite(void) {
 
     // Add the test case to the test suite
     tcase_add_test(tc_core, test_create_server);
-    tcase_add_test(tc_core, test_find_client_fd_idx);
+    tcase_add_test(tc_core, test_allocate_client_slot);
     tcase_add_test(tc_core, test_set_unset_client_data);
     tcase_add_test(tc_core, test_is_server_empty);
     tcase_add_test(tc_core, test_is_server_full);
     tcase_add_test(tc_core, test_add_client);
+    tcase_add_test(tc_core, test_update_client_hostnames);
     tcase_add_test(tc_core, test_remove_client);
     tcase_add_test(tc_core, test_find_client);
+    tcase_add_test(tc_core, test_find_client_shared_session);
     tcase_add_test(tc_core, test_add_message_to_queue);
     tcase_add_test(tc_core, test_enqueue_dequeue_server);
     tcase_add_test(tc_core, test_server_read);
     tcase_add_test(tc_core, test_server_write);
+    tcase_add_test(tc_core, test_buffer_client_data);
+    tcase_add_test(tc_core, test_pending_write);
+    tcase_add_test(tc_core, test_server_forward);
 
     suite_add_tcase(s, tc_core);
 
@@ -2,6 +2,9 @@
 #include "../../libs/src/common.h"
 
 #include <check.h>
+#include <string.h>
+
+#define MESSAGE_COUNT 30
 
 START_TEST(test_create_user) {
 
@@ -19,36 +22,57 @@ START_TEST(test_create_user) {
 }
 END_TEST
 
-START_TEST(test_copy_user) {
+START_TEST(test_enqueue_dequeue_user) {
 
-    User *user = create_user(0, "john", NULL, NULL, NULL);
-    User *userCopy = copy_user(user);
+    User *user = create_user(0, "mark", NULL, NULL, NULL);
 
-    ck_assert_ptr_ne(user, NULL);
-    ck_assert_ptr_ne(user, userCopy);
+    enqueue_to_user_queue(user, "message", strlen("message"));
 
-    ck_assert_int_eq(userCopy->fd, 0);
-    ck_assert_str_eq(userCopy->nickname, "john");
-    ck_assert_str_eq(userCopy->username, "");
-    ck_assert_ptr_ne(userCopy->outQueue, NULL);
+    ck_assert_int_eq(user->outQueue->count, 1);
+
+    const char *message = dequeue_from_user_queue(user, NULL);
+
+    ck_assert_int_eq(user->outQueue->count, 0);
+    ck_assert_str_eq(message, "message");
 
-    delete_user(userCopy);
     delete_user(user);
 }
 END_TEST
 
-START_TEST(test_enqueue_dequeue_user) {
+START_TEST(test_user_queue_policy) {
 
     User *user = create_user(0, "mark", NULL, NULL, NULL);
 
-    enqueue_to_user_queue(user, "message");
+    /* the queue references the messages */
+    const char *messages = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
 
-    ck_assert_int_eq(user->outQueue->count, 1);
+    ck_assert_int_eq(get_user_queue_policy(user), QP_DROP_OLDEST);
 
-    char *message = dequeue_from_user_queue(user);
+    /* the new messages are refused once the queue 
+        is full */
+    set_user_queue_policy(user, QP_DROP_NEWEST);
 
-    ck_assert_int_eq(user->outQueue->count, 0);
-    ck_assert_str_eq(message, "message");
+    int queued = 0;
+
+    for (int i = 0; i < MESSAGE_COUNT; i++) {
+        queued += enqueue_to_user_queue(user, messages + i, 1);
+    }
+
+    ck_assert_int_lt(queued, MESSAGE_COUNT);
+    ck_assert_int_eq(get_ring_dropped_count(user->outQueue), MESSAGE_COUNT - queued);
+    ck_assert_int_eq(is_user_queue_overflowed(user), 0);
+
+    int len = 0;
+
+    ck_assert_int_eq(dequeue_from_user_queue(user, &len)[0], 'A');
+    ck_assert_int_eq(len, 1);
+
+    /* the user is marked for disconnection */
+    set_user_queue_policy(user, QP_DISCONNECT);
+    
+    enqueue_to_user_queue(user, messages, 1);
+    ck_assert_int_eq(enqueue_to_user_queue(user, messages, 1), 0);
+    ck_assert_int_eq(is_user_queue_overflowed(user), 1);
 
     delete_user(user);
 }
@@ -89,15 +113,19 @@ START_TEST(test_add_nickname_to_list) {
 }
 END_TEST
 
-START_TEST(test_create_user_info) {
+START_TEST(test_get_user_prefix) {
 
     User *user = create_user(0, "jdoe", "john", "irc.client.com", NULL);
 
-    char userInfo[MAX_CHARS + 1] = {'\0'};
+    ck_assert_str_eq(get_user_prefix(user), ":jdoe!john@irc.client.com");
+    ck_assert_ptr_eq(get_user_prefix(user), user->prefix);
 
-    create_user_info(userInfo, MAX_CHARS, user);
+    /* the prefix is rebuilt after a nickname change */
+    set_user_nickname(user, "john");
+    ck_assert_str_eq(get_user_prefix(user), ":john!john@irc.client.com");
 
-    ck_assert_str_eq(userInfo, "jdoe!john@irc.client.com");
+    set_user_hostname(user, "client.irc.com");
+    ck_assert_str_eq(get_user_prefix(user), ":john!john@client.irc.com");
 
     delete_user(user);
 
@@ -128,11 +156,11 @@ Suite* user_suite(void) {
 
     // Add the test case to the test suite
     tcase_add_test(tc_core, test_create_user);
-    tcase_add_test(tc_core, test_copy_user);
     tcase_add_test(tc_core, test_enqueue_dequeue_user);
+    tcase_add_test(tc_core, test_user_queue_policy);
     tcase_add_test(tc_core, test_are_users_equal);
     tcase_add_test(tc_core, test_add_nickname_to_list);
-    tcase_add_test(tc_core, test_create_user_info);
+    tcase_add_test(tc_core, test_get_user_prefix);
     tcase_add_test(tc_core, test_get_user_data);
     
     suite_add_tcase(s, tc_core);